@@ -0,0 +1,556 @@
+/*
+ * grid_smt.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Pietro Incardona
+ */
+
+#ifndef OPENFPM_DATA_SRC_GRID_GEOMETRY_GRID_SMT_HPP_
+#define OPENFPM_DATA_SRC_GRID_GEOMETRY_GRID_SMT_HPP_
+
+#include <type_traits>
+#include "Grid/grid_sm.hpp"
+#include "Grid/Geometry/grid_smb.hpp"
+
+template<unsigned int dim, unsigned int tileEdgeSize, typename indexT> class grid_key_dx_iterator_tiled;
+
+/*! \brief Tiled linearizer for dense grids
+ *
+ * The grid is stored as a sequence of tiles (bricks) of tileEdgeSize^dim points. Tiles are linearized
+ * with the standard striding (x fastest), and inside each tile the points are linearized again with the
+ * standard striding. The block-linearization math is the one of grid_smb, this class add what grid_base_impl
+ * need to use it as a linearizer (storage size, sizes in size_t, sub-iterators) and handle grids that are
+ * not a multiple of the tile size (the last tile on each direction is padded).
+ *
+ * Used with memory_traits_inte every property is stored tile by tile, so inside a tile the layout is SoA
+ * and a stencil in 3D touch few tiles instead of few planes
+ *
+ * Only copy_to and resize of grid_base_impl follow the tiles. getIterator and getSubIterator (of the
+ * linearizer and of the grid) stay row-major: x is the fastest direction and a row cross all the tiles
+ * on x. To visit the points in memory order (tile by tile, like getMortonIterator of grid_zm) use
+ * getTileIterator and getTileSubIterator
+ *
+ * \code{.cpp}
+ * grid_base<3,aggregate<float,float[3]>,HeapMemory,typename memory_traits_inte<aggregate<float,float[3]>>::type,grid_smt<3,8>> g(sz);
+ * \endcode
+ *
+ * \tparam dim dimensionality
+ * \tparam tileEdgeSize number of points of a tile on each direction
+ * \tparam indexT type of the linearized index
+ *
+ */
+template<unsigned int dim, unsigned int tileEdgeSize = 8, typename indexT = long int>
+class grid_smt
+{
+	//! block linearization
+	grid_smb<dim,tileEdgeSize,indexT> gb;
+
+	//! size of the grid on each direction
+	size_t sz[dim];
+
+	//! number of tiles on each direction
+	size_t n_tiles[dim];
+
+	//! Box enclosing the grid
+	Box<dim,size_t> box;
+
+	/*! \brief Initialize the sizes
+	 *
+	 * \param sz_ size of the grid on each direction
+	 *
+	 */
+	inline void init(const size_t (& sz_)[dim])
+	{
+		for (size_t i = 0 ; i < dim ; i++)
+		{
+			sz[i] = sz_[i];
+			n_tiles[i] = sz_[i] / tileEdgeSize + ((sz_[i] % tileEdgeSize) != 0);
+
+			box.setLow(i,0);
+			box.setHigh(i,sz_[i]);
+		}
+
+		gb = grid_smb<dim,tileEdgeSize,indexT>(sz_);
+	}
+
+public:
+
+	//! number of points on each direction of a tile
+	static constexpr unsigned int tileEdge = tileEdgeSize;
+
+	//! number of points in a tile
+	static constexpr indexT tileSize = IntPow<tileEdgeSize, dim>::value;
+
+	//! Default constructor
+	grid_smt()
+	{
+		size_t sz_[dim];
+		for (size_t i = 0 ; i < dim ; i++)
+		{sz_[i] = 0;}
+
+		init(sz_);
+	}
+
+	/*! \brief Construct a grid with the same size on each direction
+	 *
+	 * \param sz_ size on each direction
+	 *
+	 */
+	grid_smt(const size_t sz_)
+	{
+		size_t sz_d[dim];
+		for (size_t i = 0 ; i < dim ; i++)
+		{sz_d[i] = sz_;}
+
+		init(sz_d);
+	}
+
+	/*! \brief Construct a grid of a specified size
+	 *
+	 * \param sz_ size of the grid on each dimension
+	 *
+	 */
+	grid_smt(const size_t (& sz_)[dim])
+	{
+		init(sz_);
+	}
+
+	/*! \brief Reset the dimension of the grid
+	 *
+	 * \param dims size of the grid on each dimension
+	 *
+	 */
+	inline void setDimensions(const size_t (& dims)[dim])
+	{
+		init(dims);
+	}
+
+	/*! \brief The linearizer does not contain pointers
+	 *
+	 * \return true
+	 *
+	 */
+	static bool noPointers() {return true;}
+
+	/*! \brief Return the box enclosing the grid
+	 *
+	 * \return the box
+	 *
+	 */
+	inline Box<dim,size_t> getBox() const
+	{
+		return box;
+	}
+
+	/*! \brief Linearize the key
+	 *
+	 * \param gk key
+	 *
+	 * \return tile_id * tileSize + the linearized position inside the tile
+	 *
+	 */
+	template<typename ids_type>
+	__host__ __device__ inline indexT LinId(const grid_key_dx<dim,ids_type> & gk) const
+	{
+		return gb.LinId(gk);
+	}
+
+	/*! \brief Linearize the position of a point given the tile and the position inside the tile
+	 *
+	 * \param tile tile coordinates
+	 * \param loc position inside the tile
+	 *
+	 * \return the linearized index
+	 *
+	 */
+	template<typename ids_type>
+	__host__ __device__ inline indexT LinId(const grid_key_dx<dim,ids_type> & tile, const grid_key_dx<dim,ids_type> & loc) const
+	{
+		indexT tid = tile.get(dim-1);
+		indexT lid = loc.get(dim-1);
+		for (int d = dim - 2 ; d >= 0 ; d--)
+		{
+			tid = tid*n_tiles[d] + tile.get(d);
+			lid = lid*tileEdgeSize + loc.get(d);
+		}
+
+		return tid*tileSize + lid;
+	}
+
+	/*! \brief Invert the linearization
+	 *
+	 * \param id linearized index
+	 *
+	 * \return the key of the point
+	 *
+	 */
+	inline grid_key_dx<dim> InvLinId(indexT id) const
+	{
+		grid_key_dx<dim,int> k = gb.InvLinId(id);
+
+		grid_key_dx<dim> key;
+		for (size_t i = 0 ; i < dim ; i++)
+		{key.set_d(i,k.get(i));}
+
+		return key;
+	}
+
+	/*! \brief Number of linearized indexes (the number of points padded to full tiles)
+	 *
+	 * This is the number of elements the grid must allocate
+	 *
+	 * \return the storage size
+	 *
+	 */
+	inline size_t size() const
+	{
+		size_t tot = tileSize;
+
+		for (size_t i = 0 ; i < dim ; i++)
+		{tot *= n_tiles[i];}
+
+		return tot;
+	}
+
+	/*! \brief Size of the grid on the direction i
+	 *
+	 * \param i direction
+	 *
+	 * \return the size
+	 *
+	 */
+	inline size_t size(unsigned int i) const
+	{
+		return sz[i];
+	}
+
+	/*! \brief Return the size of the grid
+	 *
+	 * \return the size on each direction
+	 *
+	 */
+	inline const size_t (& getSize() const)[dim]
+	{
+		return sz;
+	}
+
+	/*! \brief Number of tiles on the direction i
+	 *
+	 * \param i direction
+	 *
+	 * \return the number of tiles
+	 *
+	 */
+	inline size_t size_tiles(unsigned int i) const
+	{
+		return n_tiles[i];
+	}
+
+	/*! \brief Number of tiles
+	 *
+	 * \return the number of tiles
+	 *
+	 */
+	inline size_t size_tiles() const
+	{
+		size_t tot = 1;
+
+		for (size_t i = 0 ; i < dim ; i++)
+		{tot *= n_tiles[i];}
+
+		return tot;
+	}
+
+	/*! \brief Return a sub-grid iterator (row-major order, it does not follow the tiles)
+	 *
+	 * To visit the points in memory order use getTileSubIterator
+	 *
+	 * \param start start point
+	 * \param stop stop point
+	 *
+	 * \return a sub-grid iterator
+	 *
+	 */
+	inline grid_key_dx_iterator_sub<dim> getSubIterator(const grid_key_dx<dim> & start, const grid_key_dx<dim> & stop) const
+	{
+		grid_sm<dim,void> g(sz);
+
+		return grid_key_dx_iterator_sub<dim>(g,start,stop);
+	}
+
+	/*! \brief Return an iterator that visit the points tile by tile (memory order)
+	 *
+	 * \return the tile iterator
+	 *
+	 */
+	inline grid_key_dx_iterator_tiled<dim,tileEdgeSize,indexT> getTileIterator() const
+	{
+		return grid_key_dx_iterator_tiled<dim,tileEdgeSize,indexT>(*this);
+	}
+
+	/*! \brief Return an iterator that visit the points of a box tile by tile (memory order)
+	 *
+	 * \param start start point
+	 * \param stop stop point
+	 *
+	 * \return the tile iterator
+	 *
+	 */
+	inline grid_key_dx_iterator_tiled<dim,tileEdgeSize,indexT> getTileSubIterator(const grid_key_dx<dim> & start, const grid_key_dx<dim> & stop) const
+	{
+		return grid_key_dx_iterator_tiled<dim,tileEdgeSize,indexT>(*this,start,stop);
+	}
+
+	/*! \brief Check if two linearizer are the same
+	 *
+	 * \param g linearizer to compare
+	 *
+	 * \return true if they have the same size
+	 *
+	 */
+	inline bool operator==(const grid_smt<dim,tileEdgeSize,indexT> & g) const
+	{
+		for (size_t i = 0 ; i < dim ; i++)
+		{
+			if (sz[i] != g.sz[i])
+			{return false;}
+		}
+
+		return true;
+	}
+
+	/*! \brief Check if two linearizer are different
+	 *
+	 * \param g linearizer to compare
+	 *
+	 * \return true if they differ
+	 *
+	 */
+	inline bool operator!=(const grid_smt<dim,tileEdgeSize,indexT> & g) const
+	{
+		return !this->operator==(g);
+	}
+
+	/*! \brief swap the linearizer informations
+	 *
+	 * \param g linearizer to swap with
+	 *
+	 */
+	inline void swap(grid_smt<dim,tileEdgeSize,indexT> & g)
+	{
+		gb.swap(g.gb);
+
+		for (size_t i = 0 ; i < dim ; i++)
+		{
+			std::swap(sz[i],g.sz[i]);
+			std::swap(n_tiles[i],g.n_tiles[i]);
+		}
+
+		Box<dim,size_t> tmp = box;
+		box = g.box;
+		g.box = tmp;
+	}
+};
+
+/*! \brief Iterator that visit the points of a box of a tiled grid tile by tile
+ *
+ * Tiles are visited in linearized order and the points inside each tile in linearized order,
+ * so the access pattern follow the memory. Points outside the box (or in the padding of the
+ * last tiles) are skipped
+ *
+ * \tparam dim dimensionality
+ * \tparam tileEdgeSize number of points of a tile on each direction
+ * \tparam indexT type of the linearized index
+ *
+ */
+template<unsigned int dim, unsigned int tileEdgeSize, typename indexT>
+class grid_key_dx_iterator_tiled
+{
+	//! first tile of the box
+	grid_key_dx<dim> tile_start;
+
+	//! last tile of the box
+	grid_key_dx<dim> tile_stop;
+
+	//! start of the box
+	grid_key_dx<dim> start;
+
+	//! stop of the box
+	grid_key_dx<dim> stop;
+
+	//! current tile
+	grid_key_dx<dim> tile;
+
+	//! start of the box inside the current tile
+	grid_key_dx<dim> loc_start;
+
+	//! stop of the box inside the current tile
+	grid_key_dx<dim> loc_stop;
+
+	//! current point
+	grid_key_dx<dim> pnt;
+
+	//! true when the iteration is ended
+	bool end;
+
+	/*! \brief Compute the part of the box inside the current tile
+	 *
+	 */
+	inline void set_tile()
+	{
+		for (size_t i = 0 ; i < dim ; i++)
+		{
+			long int t_low = tile.get(i)*tileEdgeSize;
+			long int t_high = t_low + tileEdgeSize - 1;
+
+			loc_start.set_d(i,(start.get(i) > t_low)?start.get(i):t_low);
+			loc_stop.set_d(i,(stop.get(i) < t_high)?stop.get(i):t_high);
+			pnt.set_d(i,loc_start.get(i));
+		}
+	}
+
+	/*! \brief Initialize the iterator
+	 *
+	 */
+	inline void initialize()
+	{
+		end = false;
+
+		for (size_t i = 0 ; i < dim ; i++)
+		{
+			if (stop.get(i) < start.get(i))
+			{
+				end = true;
+				return;
+			}
+
+			tile_start.set_d(i,start.get(i) / tileEdgeSize);
+			tile_stop.set_d(i,stop.get(i) / tileEdgeSize);
+			tile.set_d(i,tile_start.get(i));
+		}
+
+		set_tile();
+	}
+
+public:
+
+	/*! \brief Iterate across all the points of the grid
+	 *
+	 * \param g tiled linearizer
+	 *
+	 */
+	grid_key_dx_iterator_tiled(const grid_smt<dim,tileEdgeSize,indexT> & g)
+	{
+		for (size_t i = 0 ; i < dim ; i++)
+		{
+			start.set_d(i,0);
+			stop.set_d(i,(long int)g.size(i) - 1);
+		}
+
+		initialize();
+	}
+
+	/*! \brief Iterate across the points of the box [start,stop]
+	 *
+	 * \param g tiled linearizer
+	 * \param start start point
+	 * \param stop stop point
+	 *
+	 */
+	grid_key_dx_iterator_tiled(const grid_smt<dim,tileEdgeSize,indexT> & /*g*/,
+							   const grid_key_dx<dim> & start,
+							   const grid_key_dx<dim> & stop)
+	:start(start),stop(stop)
+	{
+		initialize();
+	}
+
+	/*! \brief Get the next point
+	 *
+	 * \return itself
+	 *
+	 */
+	inline grid_key_dx_iterator_tiled<dim,tileEdgeSize,indexT> & operator++()
+	{
+		// next point in the tile
+		size_t i = 0;
+		for ( ; i < dim ; i++)
+		{
+			if (pnt.get(i) < loc_stop.get(i))
+			{
+				pnt.set_d(i,pnt.get(i)+1);
+				break;
+			}
+
+			pnt.set_d(i,loc_start.get(i));
+		}
+
+		if (i != dim)
+		{return *this;}
+
+		// next tile
+		for (i = 0 ; i < dim ; i++)
+		{
+			if (tile.get(i) < tile_stop.get(i))
+			{
+				tile.set_d(i,tile.get(i)+1);
+				break;
+			}
+
+			tile.set_d(i,tile_start.get(i));
+		}
+
+		if (i == dim)
+		{end = true;}
+		else
+		{set_tile();}
+
+		return *this;
+	}
+
+	/*! \brief Check if there is a next point
+	 *
+	 * \return true if there is a next point
+	 *
+	 */
+	inline bool isNext() const
+	{
+		return !end;
+	}
+
+	/*! \brief Get the current point
+	 *
+	 * \return the key of the point
+	 *
+	 */
+	inline const grid_key_dx<dim> & get() const
+	{
+		return pnt;
+	}
+
+	/*! \brief Get the current tile
+	 *
+	 * \return the tile coordinates
+	 *
+	 */
+	inline const grid_key_dx<dim> & getTile() const
+	{
+		return tile;
+	}
+};
+
+/*! \brief Check if a linearizer is a tiled linearizer
+ *
+ * \tparam T linearizer
+ *
+ */
+template<typename T>
+struct is_grid_smt: public std::false_type
+{};
+
+//! Specialization for grid_smt
+template<unsigned int dim, unsigned int tileEdgeSize, typename indexT>
+struct is_grid_smt<grid_smt<dim,tileEdgeSize,indexT>>: public std::true_type
+{};
+
+#endif /* OPENFPM_DATA_SRC_GRID_GEOMETRY_GRID_SMT_HPP_ */
@@ -7,6 +7,7 @@
 #include <boost/test/unit_test.hpp>
 #include "Grid/Geometry/grid_smb.hpp"
 #include "Grid/Geometry/grid_zmb.hpp"
+#include "Grid/Geometry/grid_smt.hpp"
 
 template <unsigned int dim, typename BGT>
 void testStandardLinearizations(BGT geometry)
@@ -99,6 +100,34 @@ BOOST_AUTO_TEST_CASE(testSwap)
 
     test_swap<grid_smb<dim, 8>>();
     test_swap<grid_zmb<dim, 8, long int>>();
+    test_swap<grid_smt<dim, 8>>();
+}
+
+BOOST_AUTO_TEST_CASE(testTiledLinId)
+{
+	constexpr unsigned int dim = 2;
+	const size_t sz[dim] = {3*8,7*8};
+	grid_smt<dim, 8> geometry(sz);
+
+	testStandardLinearizations<dim>(geometry);
+
+	// not multiple of the tile, the storage is padded to full tiles
+	const size_t sz2[dim] = {3*8+1,7*8-3};
+	grid_smt<dim, 8> geometry2(sz2);
+
+	BOOST_REQUIRE_EQUAL(geometry2.size(0),3*8+1);
+	BOOST_REQUIRE_EQUAL(geometry2.size(1),7*8-3);
+	BOOST_REQUIRE_EQUAL(geometry2.size_tiles(0),4);
+	BOOST_REQUIRE_EQUAL(geometry2.size_tiles(1),7);
+	BOOST_REQUIRE_EQUAL(geometry2.size(),4*7*64);
+
+	grid_key_dx<dim> k({24,52});
+	grid_key_dx<dim> tile({3,6});
+	grid_key_dx<dim> loc({0,4});
+
+	BOOST_REQUIRE_EQUAL(geometry2.LinId(k),geometry2.LinId(tile,loc));
+	BOOST_REQUIRE_EQUAL(geometry2.LinId(k),(6*4+3)*64+4*8);
+	BOOST_REQUIRE(geometry2.InvLinId(geometry2.LinId(k)) == k);
 }
 
 BOOST_AUTO_TEST_SUITE_END()
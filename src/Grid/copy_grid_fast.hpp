@@ -9,6 +9,9 @@
 #define OPENFPM_DATA_SRC_GRID_COPY_GRID_FAST_HPP_
 
 #include "Grid/iterators/grid_key_dx_iterator.hpp"
+#include "util/openmp_util.hpp"
+#include <type_traits>
+#include <cstring>
 
 template<unsigned int dim>
 struct striding
@@ -430,6 +433,66 @@ struct copy_ndim_fast_selector<2>
 };
 
 
+/*! \brief Split the copy of a box along the outermost direction across threads
+ *
+ * Each thread copy a slab of the box with the long-x/short-x specializations of
+ * copy_ndim_fast_selector
+ *
+ * \tparam dim dimensionality
+ *
+ */
+template<unsigned int dim>
+struct copy_ndim_fast_parallel
+{
+	/*! \brief Copy the box bx_src
+	 *
+	 * \param ptr_src pointer to the first element of the source box
+	 * \param ptr_dst pointer to the first element of the destination box
+	 * \param sr striding
+	 * \param bx_src source box
+	 *
+	 */
+	template<unsigned int object_size>
+	static void call(unsigned char * ptr_src,
+					 unsigned char * ptr_dst,
+					 striding<dim> & sr,
+		   const Box<dim,size_t> & bx_src)
+	{
+		size_t n_ele = 1;
+
+		for (size_t i = 0 ; i < dim ; i++)
+		{
+			// empty box
+			if (bx_src.getHigh(i) < bx_src.getLow(i))
+			{return;}
+
+			n_ele *= bx_src.getHigh(i) - bx_src.getLow(i) + 1;
+		}
+
+		size_t n_out = bx_src.getHigh(dim-1) - bx_src.getLow(dim-1) + 1;
+
+		#pragma omp parallel if (n_ele >= OPENFPM_OMP_MIN_ELEMENTS && n_out > 1)
+		{
+			size_t start;
+			size_t stop;
+			openfpm_omp_static_range(n_out,openfpm_omp_num_threads(),openfpm_omp_thread_num(),start,stop);
+
+			if (start < stop)
+			{
+				Box<dim,size_t> bx_t = bx_src;
+				bx_t.setLow(dim-1,bx_src.getLow(dim-1) + start);
+				bx_t.setHigh(dim-1,bx_src.getLow(dim-1) + stop - 1);
+
+				striding<dim> sr_t = sr;
+
+				copy_ndim_fast_selector<dim>::template call<object_size>(ptr_src + start*sr.striding_src[dim-2],
+						                                                 ptr_dst + start*sr.striding_dst[dim-2],
+						                                                 sr_t,bx_t);
+			}
+		}
+	}
+};
+
 template<unsigned int dim_prp, unsigned int prp,typename grid_type>
 struct get_pointer
 {
@@ -514,7 +577,7 @@ struct mp_funct_impl
 		unsigned char * ptr_src = (unsigned char *)(&gd_src.template get<prp>(bx_src.getKP1()));
 		unsigned char * ptr_dst = (unsigned char *)(&gd_dst.template get<prp>(bx_dst.getKP1()));
 
-		copy_ndim_fast_selector<dim>::template call<sizeof(T)>(ptr_src,ptr_dst,sr,bx_src);
+		copy_ndim_fast_parallel<dim>::template call<sizeof(T)>(ptr_src,ptr_dst,sr,bx_src);
 	}
 };
 
@@ -534,7 +597,7 @@ struct mp_funct_impl<dim,T[N1]>
 			unsigned char * ptr_src = (unsigned char *)(&gd_src.template get<prp>(bx_src.getKP1())[id[0]]);
 			unsigned char * ptr_dst = (unsigned char *)(&gd_dst.template get<prp>(bx_dst.getKP1())[id[0]]);
 
-			copy_ndim_fast_selector<dim>::template call<sizeof(T)>(ptr_src,ptr_dst,sr,bx_src);
+			copy_ndim_fast_parallel<dim>::template call<sizeof(T)>(ptr_src,ptr_dst,sr,bx_src);
 		}
 	}
 };
@@ -558,7 +621,7 @@ struct mp_funct_impl<dim,T[N1][N2]>
 				unsigned char * ptr_src = (unsigned char *)(&gd_src.template get<prp>(bx_src.getKP1())[id[1]][id[0]]);
 				unsigned char * ptr_dst = (unsigned char *)(&gd_dst.template get<prp>(bx_dst.getKP1())[id[1]][id[0]]);
 
-				copy_ndim_fast_selector<dim>::template call<sizeof(T)>(ptr_src,ptr_dst,sr,bx_src);
+				copy_ndim_fast_parallel<dim>::template call<sizeof(T)>(ptr_src,ptr_dst,sr,bx_src);
 			}
 		}
 	}
@@ -673,6 +736,513 @@ struct copy_grid_fast<false,2,grid,ginfo>
 	}
 };
 
+//////////////////// Copy of a box with memcpy of rows (any dimension)
+
+/*! \brief Check if all the properties of the aggregate T are trivially copyable
+ *
+ * In this case a grid of T can be copied with memcpy
+ *
+ * \tparam T aggregate
+ *
+ */
+template<typename T, unsigned int np = T::max_prop>
+struct is_all_prp_trivially_copyable
+{
+	//! type of the property np-1
+	typedef typename boost::mpl::at<typename T::type,boost::mpl::int_<np-1>>::type prp_type;
+
+	//! true if the properties from 0 to np-1 are trivially copyable
+	static const bool value = std::is_trivially_copyable<prp_type>::value && is_all_prp_trivially_copyable<T,np-1>::value;
+};
+
+//! Terminator of is_all_prp_trivially_copyable
+template<typename T>
+struct is_all_prp_trivially_copyable<T,0>
+{
+	//! true
+	static const bool value = true;
+};
+
+/*! \brief Copy an N-dimensional box from one buffer to another with memcpy
+ *
+ * The leading directions where the box cover the full extent of both buffers are merged into
+ * a single row (if the box differ only on the last direction the full box is one memcpy). The
+ * rows are distributed across threads with a static schedule, a single row is split in bytes
+ *
+ * \param ptr_src pointer to the first element of the box in the source
+ * \param ptr_dst pointer to the first element of the box in the destination
+ * \param stride_src stride in byte of the source for each direction (stride_src[0] is the object size)
+ * \param stride_dst stride in byte of the destination for each direction (stride_dst[0] is the object size)
+ * \param sz size of the box in each direction
+ *
+ */
+template<unsigned int dim>
+void copy_grid_fast_rows(const unsigned char * ptr_src,
+						 unsigned char * ptr_dst,
+						 const size_t (& stride_src)[dim],
+						 const size_t (& stride_dst)[dim],
+						 const size_t (& sz)[dim])
+{
+	size_t row = sz[0]*stride_src[0];
+	size_t n_ele = 1;
+
+	for (size_t i = 0 ; i < dim ; i++)
+	{n_ele *= sz[i];}
+
+	if (n_ele == 0)	{return;}
+
+	// merge the directions that are contiguous in both buffers
+	unsigned int d = 1;
+	for ( ; d < dim ; d++)
+	{
+		if (stride_src[d] != row || stride_dst[d] != row)
+		{break;}
+
+		row *= sz[d];
+	}
+
+	size_t n_rows = n_ele / (row / stride_src[0]);
+
+	if (n_rows == 1)
+	{
+		#pragma omp parallel if (n_ele >= OPENFPM_OMP_MIN_ELEMENTS)
+		{
+			size_t start;
+			size_t stop;
+			openfpm_omp_static_range(row,openfpm_omp_num_threads(),openfpm_omp_thread_num(),start,stop);
+
+			if (start < stop)
+			{memcpy(ptr_dst + start,ptr_src + start,stop - start);}
+		}
+
+		return;
+	}
+
+	#pragma omp parallel if (n_ele >= OPENFPM_OMP_MIN_ELEMENTS)
+	{
+		size_t start;
+		size_t stop;
+		openfpm_omp_static_range(n_rows,openfpm_omp_num_threads(),openfpm_omp_thread_num(),start,stop);
+
+		if (start < stop)
+		{
+			// coordinates and offsets of the first row of the thread
+			size_t key[dim];
+			size_t off_src = 0;
+			size_t off_dst = 0;
+			size_t rs = start;
+
+			for (unsigned int i = 0 ; i < dim ; i++)
+			{key[i] = 0;}
+
+			for (unsigned int i = d ; i < dim ; i++)
+			{
+				key[i] = rs % sz[i];
+				rs /= sz[i];
+
+				off_src += key[i]*stride_src[i];
+				off_dst += key[i]*stride_dst[i];
+			}
+
+			for (size_t r = start ; r < stop ; r++)
+			{
+				memcpy(ptr_dst + off_dst,ptr_src + off_src,row);
+
+				// next row
+				unsigned int i = d;
+				key[i]++;
+				off_src += stride_src[i];
+				off_dst += stride_dst[i];
+
+				while (key[i] == sz[i] && i + 1 < dim)
+				{
+					off_src -= sz[i]*stride_src[i];
+					off_dst -= sz[i]*stride_dst[i];
+					key[i] = 0;
+
+					i++;
+					key[i]++;
+					off_src += stride_src[i];
+					off_dst += stride_dst[i];
+				}
+			}
+		}
+	}
+}
+
+/*! \brief Calculate the strides in byte of a grid buffer of object_size elements
+ *
+ * \param gs grid info
+ * \param object_size size of the element
+ * \param stride output strides
+ *
+ */
+template<unsigned int dim, typename ginfo>
+inline void copy_grid_fast_strides(const ginfo & gs, size_t object_size, size_t (& stride)[dim])
+{
+	stride[0] = object_size;
+
+	for (size_t i = 1 ; i < dim ; i++)
+	{stride[i] = gs.size_s(i-1)*object_size;}
+}
+
+/*! \brief this class is a functor for "for_each" algorithm
+ *
+ * For each property of a memory_traits_inte grid it copy a box with memcpy.
+ * Array properties are stored component by component, each component is copied
+ * as a separate buffer
+ *
+ * \tparam grid type of grid
+ *
+ */
+template<typename grid>
+struct copy_grid_fast_memcpy_inte_prp
+{
+	//! source grid
+	const grid & gd_src;
+
+	//! destination grid
+	grid & gd_dst;
+
+	//! source box
+	const Box<grid::dims,size_t> & bx_src;
+
+	//! destination box
+	const Box<grid::dims,size_t> & bx_dst;
+
+	/*! \brief constructor
+	 *
+	 * \param gd_src source grid
+	 * \param gd_dst destination grid
+	 * \param bx_src source box
+	 * \param bx_dst destination box
+	 *
+	 */
+	copy_grid_fast_memcpy_inte_prp(const grid & gd_src, grid & gd_dst,
+								   const Box<grid::dims,size_t> & bx_src, const Box<grid::dims,size_t> & bx_dst)
+	:gd_src(gd_src),gd_dst(gd_dst),bx_src(bx_src),bx_dst(bx_dst)
+	{}
+
+	//! It call the copy function for each property
+	template<typename T>
+	inline void operator()(T& /*t*/) const
+	{
+		typedef typename boost::mpl::at<typename grid::value_type::type,boost::mpl::int_<T::value>>::type prp_type;
+		typedef typename std::remove_all_extents<prp_type>::type comp_type;
+
+		size_t stride_src[grid::dims];
+		size_t stride_dst[grid::dims];
+		size_t sz[grid::dims];
+
+		copy_grid_fast_strides(gd_src.getGrid(),sizeof(comp_type),stride_src);
+		copy_grid_fast_strides(gd_dst.getGrid(),sizeof(comp_type),stride_dst);
+
+		for (size_t i = 0 ; i < grid::dims ; i++)
+		{sz[i] = bx_src.getHigh(i) - bx_src.getLow(i) + 1;}
+
+		const unsigned char * ptr_src = (const unsigned char *)gd_src.template getPointer<T::value>() + gd_src.getGrid().LinId(bx_src.getKP1())*sizeof(comp_type);
+		unsigned char * ptr_dst = (unsigned char *)gd_dst.template getPointer<T::value>() + gd_dst.getGrid().LinId(bx_dst.getKP1())*sizeof(comp_type);
+
+		for (size_t c = 0 ; c < sizeof(prp_type) / sizeof(comp_type) ; c++)
+		{
+			copy_grid_fast_rows<grid::dims>(ptr_src,ptr_dst,stride_src,stride_dst,sz);
+
+			ptr_src += gd_src.getGrid().size()*sizeof(comp_type);
+			ptr_dst += gd_dst.getGrid().size()*sizeof(comp_type);
+		}
+	}
+};
+
+/*! \brief Copy a box of a grid into another grid with memcpy of the rows
+ *
+ * The grids must have only trivially copyable properties (is_all_prp_trivially_copyable)
+ *
+ * \tparam is_inte true if the grid layout is memory_traits_inte
+ *
+ */
+template<bool is_inte>
+struct copy_grid_fast_memcpy
+{
+	/*! \brief Copy the box bx_src of gd_src into the box bx_dst of gd_dst
+	 *
+	 * \param gd_src source grid
+	 * \param gd_dst destination grid
+	 * \param bx_src source box
+	 * \param bx_dst destination box (same size of bx_src)
+	 *
+	 */
+	template<typename grid>
+	static void copy(const grid & gd_src, grid & gd_dst,
+					 const Box<grid::dims,size_t> & bx_src, const Box<grid::dims,size_t> & bx_dst)
+	{
+		typedef typename grid::value_type::type object_type;
+
+		size_t stride_src[grid::dims];
+		size_t stride_dst[grid::dims];
+		size_t sz[grid::dims];
+
+		copy_grid_fast_strides(gd_src.getGrid(),sizeof(object_type),stride_src);
+		copy_grid_fast_strides(gd_dst.getGrid(),sizeof(object_type),stride_dst);
+
+		for (size_t i = 0 ; i < grid::dims ; i++)
+		{sz[i] = bx_src.getHigh(i) - bx_src.getLow(i) + 1;}
+
+		const unsigned char * ptr_src = (const unsigned char *)gd_src.getPointer() + gd_src.getGrid().LinId(bx_src.getKP1())*sizeof(object_type);
+		unsigned char * ptr_dst = (unsigned char *)gd_dst.getPointer() + gd_dst.getGrid().LinId(bx_dst.getKP1())*sizeof(object_type);
+
+		copy_grid_fast_rows<grid::dims>(ptr_src,ptr_dst,stride_src,stride_dst,sz);
+	}
+};
+
+/*! \brief Copy a box of a grid into another grid with memcpy of the rows
+ *
+ * Specialization for memory_traits_inte, each property is a separate buffer
+ *
+ */
+template<>
+struct copy_grid_fast_memcpy<true>
+{
+	/*! \brief Copy the box bx_src of gd_src into the box bx_dst of gd_dst
+	 *
+	 * \param gd_src source grid
+	 * \param gd_dst destination grid
+	 * \param bx_src source box
+	 * \param bx_dst destination box (same size of bx_src)
+	 *
+	 */
+	template<typename grid>
+	static void copy(const grid & gd_src, grid & gd_dst,
+					 const Box<grid::dims,size_t> & bx_src, const Box<grid::dims,size_t> & bx_dst)
+	{
+		copy_grid_fast_memcpy_inte_prp<grid> cp(gd_src,gd_dst,bx_src,bx_dst);
+
+		boost::mpl::for_each_ref<boost::mpl::range_c<int,0,grid::value_type::max_prop>>(cp);
+	}
+};
+
+/*! \brief Copy a box of a tiled buffer into another tiled buffer with memcpy
+ *
+ * The destination tiles that intersect the box are distributed across threads. Inside a tile a row in x
+ * is contiguous, the corresponding row in the source is contiguous up to the end of the source tile, so
+ * each row is copied with at most two memcpy
+ *
+ * \param ptr_src pointer to the source buffer
+ * \param ptr_dst pointer to the destination buffer
+ * \param gs source tiled linearizer
+ * \param gd destination tiled linearizer
+ * \param bx_src source box
+ * \param bx_dst destination box (same size of bx_src)
+ * \param obj_size size of the element
+ *
+ */
+template<unsigned int dim, typename lin_type>
+void copy_grid_tiled_rows(const unsigned char * ptr_src,
+						  unsigned char * ptr_dst,
+						  const lin_type & gs,
+						  const lin_type & gd,
+						  const Box<dim,size_t> & bx_src,
+						  const Box<dim,size_t> & bx_dst,
+						  size_t obj_size)
+{
+	constexpr long int edge = lin_type::tileEdge;
+
+	size_t tile_low[dim];
+	size_t n_t[dim];
+	long int off[dim];
+	size_t n_tiles = 1;
+	size_t n_ele = 1;
+
+	for (size_t i = 0 ; i < dim ; i++)
+	{
+		if (bx_dst.getHigh(i) < bx_dst.getLow(i))	{return;}
+
+		tile_low[i] = bx_dst.getLow(i) / edge;
+		n_t[i] = bx_dst.getHigh(i) / edge - tile_low[i] + 1;
+		off[i] = (long int)bx_src.getLow(i) - (long int)bx_dst.getLow(i);
+
+		n_tiles *= n_t[i];
+		n_ele *= bx_dst.getHigh(i) - bx_dst.getLow(i) + 1;
+	}
+
+	#pragma omp parallel if (n_ele >= OPENFPM_OMP_MIN_ELEMENTS && n_tiles > 1)
+	{
+		size_t start;
+		size_t stop;
+		openfpm_omp_static_range(n_tiles,openfpm_omp_num_threads(),openfpm_omp_thread_num(),start,stop);
+
+		for (size_t t = start ; t < stop ; t++)
+		{
+			// part of the box inside the tile
+			grid_key_dx<dim> lo;
+			grid_key_dx<dim> hi;
+			size_t r = t;
+
+			for (size_t i = 0 ; i < dim ; i++)
+			{
+				long int t_low = (tile_low[i] + r % n_t[i])*edge;
+				long int t_high = t_low + edge - 1;
+				r /= n_t[i];
+
+				lo.set_d(i,((long int)bx_dst.getLow(i) > t_low)?(long int)bx_dst.getLow(i):t_low);
+				hi.set_d(i,((long int)bx_dst.getHigh(i) < t_high)?(long int)bx_dst.getHigh(i):t_high);
+			}
+
+			long int len = hi.get(0) - lo.get(0) + 1;
+			grid_key_dx<dim> kd = lo;
+
+			while (true)
+			{
+				grid_key_dx<dim> ks;
+				for (size_t i = 0 ; i < dim ; i++)
+				{ks.set_d(i,kd.get(i) + off[i]);}
+
+				unsigned char * row_dst = ptr_dst + gd.LinId(kd)*obj_size;
+
+				// the source row can cross the border of a tile
+				long int seg = edge - ks.get(0) % edge;
+				if (seg > len)	{seg = len;}
+
+				memcpy(row_dst,ptr_src + gs.LinId(ks)*obj_size,seg*obj_size);
+
+				if (seg < len)
+				{
+					ks.set_d(0,ks.get(0) + seg);
+					memcpy(row_dst + seg*obj_size,ptr_src + gs.LinId(ks)*obj_size,(len - seg)*obj_size);
+				}
+
+				// next row
+				size_t i = 1;
+				for ( ; i < dim ; i++)
+				{
+					if (kd.get(i) < hi.get(i))
+					{
+						kd.set_d(i,kd.get(i)+1);
+						break;
+					}
+
+					kd.set_d(i,lo.get(i));
+				}
+
+				if (i >= dim)	{break;}
+			}
+		}
+	}
+}
+
+/*! \brief this class is a functor for "for_each" algorithm
+ *
+ * For each property of a memory_traits_inte tiled grid it copy a box with memcpy.
+ * Array properties are stored component by component, each component is copied
+ * as a separate buffer
+ *
+ * \tparam grid type of grid
+ *
+ */
+template<typename grid>
+struct copy_grid_tiled_memcpy_inte_prp
+{
+	//! source grid
+	const grid & gd_src;
+
+	//! destination grid
+	grid & gd_dst;
+
+	//! source box
+	const Box<grid::dims,size_t> & bx_src;
+
+	//! destination box
+	const Box<grid::dims,size_t> & bx_dst;
+
+	/*! \brief constructor
+	 *
+	 * \param gd_src source grid
+	 * \param gd_dst destination grid
+	 * \param bx_src source box
+	 * \param bx_dst destination box
+	 *
+	 */
+	copy_grid_tiled_memcpy_inte_prp(const grid & gd_src, grid & gd_dst,
+									const Box<grid::dims,size_t> & bx_src, const Box<grid::dims,size_t> & bx_dst)
+	:gd_src(gd_src),gd_dst(gd_dst),bx_src(bx_src),bx_dst(bx_dst)
+	{}
+
+	//! It call the copy function for each property
+	template<typename T>
+	inline void operator()(T& /*t*/) const
+	{
+		typedef typename boost::mpl::at<typename grid::value_type::type,boost::mpl::int_<T::value>>::type prp_type;
+		typedef typename std::remove_all_extents<prp_type>::type comp_type;
+
+		const unsigned char * ptr_src = (const unsigned char *)gd_src.template getPointer<T::value>();
+		unsigned char * ptr_dst = (unsigned char *)gd_dst.template getPointer<T::value>();
+
+		for (size_t c = 0 ; c < sizeof(prp_type) / sizeof(comp_type) ; c++)
+		{
+			copy_grid_tiled_rows<grid::dims>(ptr_src,ptr_dst,gd_src.getGrid(),gd_dst.getGrid(),bx_src,bx_dst,sizeof(comp_type));
+
+			ptr_src += gd_src.getGrid().size()*sizeof(comp_type);
+			ptr_dst += gd_dst.getGrid().size()*sizeof(comp_type);
+		}
+	}
+};
+
+/*! \brief Copy a box of a tiled grid (grid_smt) into another tiled grid with memcpy
+ *
+ * The grids must have only trivially copyable properties (is_all_prp_trivially_copyable)
+ *
+ * \tparam is_inte true if the grid layout is memory_traits_inte
+ *
+ */
+template<bool is_inte>
+struct copy_grid_tiled_memcpy
+{
+	/*! \brief Copy the box bx_src of gd_src into the box bx_dst of gd_dst
+	 *
+	 * \param gd_src source grid
+	 * \param gd_dst destination grid
+	 * \param bx_src source box
+	 * \param bx_dst destination box (same size of bx_src)
+	 *
+	 */
+	template<typename grid>
+	static void copy(const grid & gd_src, grid & gd_dst,
+					 const Box<grid::dims,size_t> & bx_src, const Box<grid::dims,size_t> & bx_dst)
+	{
+		typedef typename grid::value_type::type object_type;
+
+		copy_grid_tiled_rows<grid::dims>((const unsigned char *)gd_src.getPointer(),
+										 (unsigned char *)gd_dst.getPointer(),
+										 gd_src.getGrid(),gd_dst.getGrid(),
+										 bx_src,bx_dst,sizeof(object_type));
+	}
+};
+
+/*! \brief Copy a box of a tiled grid (grid_smt) into another tiled grid with memcpy
+ *
+ * Specialization for memory_traits_inte, each property is a separate buffer
+ *
+ */
+template<>
+struct copy_grid_tiled_memcpy<true>
+{
+	/*! \brief Copy the box bx_src of gd_src into the box bx_dst of gd_dst
+	 *
+	 * \param gd_src source grid
+	 * \param gd_dst destination grid
+	 * \param bx_src source box
+	 * \param bx_dst destination box (same size of bx_src)
+	 *
+	 */
+	template<typename grid>
+	static void copy(const grid & gd_src, grid & gd_dst,
+					 const Box<grid::dims,size_t> & bx_src, const Box<grid::dims,size_t> & bx_dst)
+	{
+		copy_grid_tiled_memcpy_inte_prp<grid> cp(gd_src,gd_dst,bx_src,bx_dst);
+
+		boost::mpl::for_each_ref<boost::mpl::range_c<int,0,grid::value_type::max_prop>>(cp);
+	}
+};
+
 //////////////////// Pack grid fast
 
 
@@ -282,6 +282,80 @@ BOOST_AUTO_TEST_CASE( copy_grid_test_invalid)
 	}
 }
 
+template<unsigned int dim, typename grid>
+void Test_copy_grid_to_inte(const size_t (& sz_src)[dim], const size_t (& sz_dst)[dim],
+		                    const Box<dim,long int> & bsrc, const Box<dim,long int> & bdst)
+{
+	grid g_src(sz_src);
+	grid g_dst(sz_dst);
+	g_src.setMemory();
+	g_dst.setMemory();
+
+	auto it = g_src.getIterator();
+
+	while (it.isNext())
+	{
+		auto key = it.get();
+		size_t lin = g_src.getGrid().LinId(key);
+
+		g_src.template get<0>(key) = lin;
+		g_src.template get<1>(key)[0] = lin + 1;
+		g_src.template get<1>(key)[1] = lin + 2;
+		g_src.template get<1>(key)[2] = lin + 3;
+
+		++it;
+	}
+
+	g_dst.copy_to(g_src,bsrc,bdst);
+
+	bool match = true;
+
+	grid_key_dx_iterator_sub<dim, no_stencil> its(g_src.getGrid(),bsrc.getKP1(), bsrc.getKP2());
+	grid_key_dx_iterator_sub<dim, no_stencil> itd(g_dst.getGrid(),bdst.getKP1(), bdst.getKP2());
+
+	while (its.isNext())
+	{
+		auto key_s = its.get();
+		auto key_d = itd.get();
+
+		match &= g_src.template get<0>(key_s) == g_dst.template get<0>(key_d);
+		match &= g_src.template get<1>(key_s)[0] == g_dst.template get<1>(key_d)[0];
+		match &= g_src.template get<1>(key_s)[1] == g_dst.template get<1>(key_d)[1];
+		match &= g_src.template get<1>(key_s)[2] == g_dst.template get<1>(key_d)[2];
+
+		++its;
+		++itd;
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+}
+
+BOOST_AUTO_TEST_CASE( copy_grid_test_large_box )
+{
+	typedef aggregate<float,float[3]> T;
+
+	size_t sz2_src[2] = {300,250};
+	size_t sz2_dst[2] = {310,270};
+	Box<2,long int> bsrc_2({3,5},{250,240});
+	Box<2,long int> bdst_2({7,11},{254,246});
+
+	Test_copy_grid_to_inte<2,grid_cpu<2,T>>(sz2_src,sz2_dst,bsrc_2,bdst_2);
+	Test_copy_grid_to_inte<2,grid_base<2,T,HeapMemory,typename memory_traits_inte<T>::type>>(sz2_src,sz2_dst,bsrc_2,bdst_2);
+
+	size_t sz3_src[3] = {40,50,60};
+	size_t sz3_dst[3] = {45,52,61};
+	Box<3,long int> bsrc_3({1,2,3},{39,48,57});
+	Box<3,long int> bdst_3({4,1,0},{42,47,54});
+
+	Box<3,long int> bsrc_3s({1,2,3},{4,48,57});
+	Box<3,long int> bdst_3s({4,1,0},{7,47,54});
+
+	Test_copy_grid_to_inte<3,grid_cpu<3,T>>(sz3_src,sz3_dst,bsrc_3,bdst_3);
+	Test_copy_grid_to_inte<3,grid_base<3,T,HeapMemory,typename memory_traits_inte<T>::type>>(sz3_src,sz3_dst,bsrc_3,bdst_3);
+	Test_copy_grid_to_inte<3,grid_cpu<3,T>>(sz3_src,sz3_dst,bsrc_3s,bdst_3s);
+	Test_copy_grid_to_inte<3,grid_base<3,T,HeapMemory,typename memory_traits_inte<T>::type>>(sz3_src,sz3_dst,bsrc_3s,bdst_3s);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 
@@ -8,12 +8,16 @@
 #ifndef OPENFPM_DATA_SRC_GRID_GRID_BASE_IMPLEMENTATION_HPP_
 #define OPENFPM_DATA_SRC_GRID_GRID_BASE_IMPLEMENTATION_HPP_
 
+#include <algorithm>
 #include "grid_base_impl_layout.hpp"
 #include "util/cuda_util.hpp"
 #include "cuda/cuda_grid_gpu_funcs.cuh"
 #include "util/create_vmpl_sequence.hpp"
 #include "util/cuda_launch.hpp"
 #include "util/object_si_di.hpp"
+#include "Geometry/grid_smt.hpp"
+#include "grid_zm.hpp"
+#include "Packer_Unpacker/Checkpoint_fwd.hpp"
 
 constexpr int DATA_ON_HOST = 32;
 constexpr int DATA_ON_DEVICE = 64;
@@ -325,6 +329,95 @@ void move_work_to_blocks(ite_gpu<dim> & ite)
 #endif
 
 #include "copy_grid_fast.hpp"
+#include "grid_expression.hpp"
+
+//! Implementation of grid_base_impl::conv, defined in Grid/grid_conv.hpp
+template<typename stencil>
+struct grid_conv_call;
+
+/*! \brief Select the memcpy copy of a box for the linearizer of the grid
+ *
+ * \tparam is_tiled true if the grid is linearized by tiles (grid_smt)
+ * \tparam is_inte true if the grid layout is memory_traits_inte
+ *
+ */
+template<bool is_tiled, bool is_inte>
+struct copy_grid_memcpy_sel
+{
+	//! row major linearization
+	typedef copy_grid_fast_memcpy<is_inte> type;
+};
+
+//! Tiled linearization
+template<bool is_inte>
+struct copy_grid_memcpy_sel<true,is_inte>
+{
+	//! copy tile by tile
+	typedef copy_grid_tiled_memcpy<is_inte> type;
+};
+
+/*! \brief Copy the surviving part of a grid on resize with memcpy of the rows
+ *
+ * In case the grid cannot be copied with memcpy it does nothing and return false
+ *
+ * \tparam is_memcpy true if the grid can be copied with memcpy
+ *
+ */
+template<bool is_memcpy>
+struct resize_host_memcpy
+{
+	/*! \brief Copy the box [0,sz_c) of the old grid into the new grid
+	 *
+	 * \param grid_old old grid
+	 * \param grid_new new grid
+	 * \param sz_c size of the box to copy
+	 *
+	 * \return false
+	 *
+	 */
+	template<typename grid_type>
+	static bool copy(const grid_type & /*grid_old*/, grid_type & /*grid_new*/, const size_t (& /*sz_c*/)[grid_type::dims])
+	{
+		return false;
+	}
+};
+
+/*! \brief Copy the surviving part of a grid on resize with memcpy of the rows
+ *
+ * Specialization for trivially copyable properties
+ *
+ */
+template<>
+struct resize_host_memcpy<true>
+{
+	/*! \brief Copy the box [0,sz_c) of the old grid into the new grid
+	 *
+	 * \param grid_old old grid
+	 * \param grid_new new grid
+	 * \param sz_c size of the box to copy
+	 *
+	 * \return true
+	 *
+	 */
+	template<typename grid_type>
+	static bool copy(const grid_type & grid_old, grid_type & grid_new, const size_t (& sz_c)[grid_type::dims])
+	{
+		Box<grid_type::dims,size_t> bx;
+
+		for (size_t i = 0 ; i < grid_type::dims ; i++)
+		{
+			if (sz_c[i] == 0)	{return true;}
+
+			bx.setLow(i,0);
+			bx.setHigh(i,sz_c[i]-1);
+		}
+
+		copy_grid_memcpy_sel<is_grid_smt<typename grid_type::linearizer_type>::value,
+		                     is_layout_inte<typename grid_type::layout_base_>::value>::type::copy(grid_old,grid_new,bx,bx);
+
+		return true;
+	}
+};
 
 template<typename T>
 struct copy_grid_fast_caller
@@ -361,6 +454,102 @@ struct copy_grid_fast_caller<index_tuple_sq<prp ...>>
 	}
 };
 
+/*! \brief Copy a box of a grid into another grid with the same linearizer
+ *
+ * \tparam lin_sel linearizer of the grid, 0 row major (grid_sm), 1 tiled (grid_smt), 2 Morton (grid_zm)
+ * \tparam is_memcpy true if all the properties are trivially copyable
+ * \tparam prp_seq properties sequence (used for the row major linearization)
+ *
+ */
+template<unsigned int lin_sel, bool is_memcpy, typename prp_seq>
+struct copy_grid_to_caller
+{
+	/*! \brief Copy the box box_src of gs into the box box_dst of gd
+	 *
+	 * \param gd destination grid
+	 * \param gs source grid
+	 * \param box_src source box
+	 * \param box_dst destination box
+	 *
+	 */
+	template<typename grid_type>
+	static void call(grid_type & gd, const grid_type & gs, const Box<grid_type::dims,size_t> & box_src, const Box<grid_type::dims,size_t> & box_dst)
+	{
+		copy_grid_fast_caller<prp_seq>::call(gd,gs,box_src,box_dst);
+	}
+};
+
+//! Tiled grid with trivially copyable properties, the rows inside the tiles are copied with memcpy
+template<typename prp_seq>
+struct copy_grid_to_caller<1,true,prp_seq>
+{
+	template<typename grid_type>
+	static void call(grid_type & gd, const grid_type & gs, const Box<grid_type::dims,size_t> & box_src, const Box<grid_type::dims,size_t> & box_dst)
+	{
+		copy_grid_tiled_memcpy<is_layout_inte<typename grid_type::layout_base_>::value>::copy(gs,gd,box_src,box_dst);
+	}
+};
+
+//! Tiled grid with complex properties, the points are copied one by one in tile order
+template<typename prp_seq>
+struct copy_grid_to_caller<1,false,prp_seq>
+{
+	template<typename grid_type>
+	static void call(grid_type & gd, const grid_type & gs, const Box<grid_type::dims,size_t> & box_src, const Box<grid_type::dims,size_t> & box_dst)
+	{
+		grid_key_dx<grid_type::dims> off;
+
+		for (size_t i = 0 ; i < grid_type::dims ; i++)
+		{
+			if (box_dst.getHigh(i) < box_dst.getLow(i))	{return;}
+
+			off.set_d(i,(long int)box_src.getLow(i) - (long int)box_dst.getLow(i));
+		}
+
+		auto it = gd.getGrid().getTileSubIterator(box_dst.getKP1(),box_dst.getKP2());
+
+		while (it.isNext())
+		{
+			grid_key_dx<grid_type::dims> key_src = it.get();
+			key_src += off;
+
+			gd.get_o(it.get()) = gs.get_o(key_src);
+
+			++it;
+		}
+	}
+};
+
+//! Morton grid, the points are copied one by one following the Morton order of the destination
+template<bool is_memcpy, typename prp_seq>
+struct copy_grid_to_caller<2,is_memcpy,prp_seq>
+{
+	template<typename grid_type>
+	static void call(grid_type & gd, const grid_type & gs, const Box<grid_type::dims,size_t> & box_src, const Box<grid_type::dims,size_t> & box_dst)
+	{
+		grid_key_dx<grid_type::dims> off;
+
+		for (size_t i = 0 ; i < grid_type::dims ; i++)
+		{
+			if (box_dst.getHigh(i) < box_dst.getLow(i))	{return;}
+
+			off.set_d(i,(long int)box_src.getLow(i) - (long int)box_dst.getLow(i));
+		}
+
+		auto it = gd.getGrid().getMortonSubIterator(box_dst.getKP1(),box_dst.getKP2());
+
+		while (it.isNext())
+		{
+			grid_key_dx<grid_type::dims> key_src = it.get();
+			key_src += off;
+
+			gd.get_o(it.get()) = gs.get_o(key_src);
+
+			++it;
+		}
+	}
+};
+
 /*! \brief
  *
  * Implementation of a N-dimensional grid
@@ -540,7 +729,7 @@ private:
 	 * \param key2
 	 *
 	 */
-	template<typename Mem> inline void check_bound(const grid_base_impl<dim,T,Mem,layout_base> & g,const size_t & key2) const
+	template<typename Mem> inline void check_bound(const grid_base_impl<dim,T,Mem,layout_base,ord_type> & g,const size_t & key2) const
 	{
 #ifndef __CUDA_ARCH__
 		if (key2 >= g.getGrid().size())
@@ -590,6 +779,11 @@ private:
 		for (size_t i = 0 ; i < dim ; i++)
 		{sz_c[i] = (g1.size(i) < sz[i])?g1.size(i):sz[i];}
 
+		// copy the rows with memcpy if the properties are trivially copyable
+		if (resize_host_memcpy<is_all_prp_trivially_copyable<T>::value &&
+		                       (std::is_same<ord_type,grid_sm<dim,void>>::value || is_grid_smt<ord_type>::value)>::copy(*this,grid_new,sz_c) == true)
+		{return;}
+
 		grid_sm<dim,void> g1_c(sz_c);
 
 		//! create a source grid iterator
@@ -699,7 +893,7 @@ public:
 	 * \return itself
 	 *
 	 */
-	grid_base_impl<dim,T,S,layout_base> & operator=(const grid_base_impl<dim,T,S,layout_base> & g)
+	grid_base_impl<dim,T,S,layout_base,ord_type> & operator=(const grid_base_impl<dim,T,S,layout_base,ord_type> & g)
 	{
 		swap(g.duplicate());
 
@@ -720,7 +914,7 @@ public:
 	 * \return itself
 	 *
 	 */
-	grid_base_impl<dim,T,S,layout_base> & operator=(grid_base_impl<dim,T,S,layout_base> && g)
+	grid_base_impl<dim,T,S,layout_base,ord_type> & operator=(grid_base_impl<dim,T,S,layout_base,ord_type> && g)
 	{
 		swap(g);
 
@@ -740,7 +934,7 @@ public:
 	 * \return true if they match
 	 *
 	 */
-	bool operator==(const grid_base_impl<dim,T,S,layout_base> & g)
+	bool operator==(const grid_base_impl<dim,T,S,layout_base,ord_type> & g)
 	{
 		// check if the have the same size
 		if (g1 != g.g1)
@@ -766,11 +960,11 @@ public:
 	 * \return a duplicated version of the grid
 	 *
 	 */
-	grid_base_impl<dim,T,S,layout_base> duplicate() const THROW
+	grid_base_impl<dim,T,S,layout_base,ord_type> duplicate() const THROW
 	{
 		//! Create a completely new grid with sz
 
-		grid_base_impl<dim,T,S,layout_base> grid_new(g1.getSize());
+		grid_base_impl<dim,T,S,layout_base,ord_type> grid_new(g1.getSize());
 
 		//! Set the allocator and allocate the memory
 		grid_new.setMemory();
@@ -786,7 +980,7 @@ public:
 			//! N-D copy
 
 			//! create a source grid iterator
-			grid_key_dx_iterator<dim> it(g1);
+			grid_key_dx_iterator<dim> it = getIterator();
 
 			while(it.isNext())
 			{
@@ -953,6 +1147,124 @@ public:
 		return mem_getpointer<decltype(data_),layout_base_>::template getPointer<p>(data_);
 	}
 
+	/*! \brief Apply a stencil on the box [start,stop] and write the result in prop_dst
+	 *
+	 * The function receive an array of Vc::Vector (one for each stencil point, in the order of the stencil)
+	 * containing consecutive points along x, and return the Vc::Vector to write in prop_dst
+	 *
+	 * \code{.cpp}
+	 * g.template conv<stencil_3D_7p,0,1>(start,stop,[](Vc::Vector<float> (& xs)[7])
+	 *                                    {return xs[1] + xs[2] + xs[3] + xs[4] + xs[5] + xs[6] - 6.0f*xs[0];});
+	 * \endcode
+	 *
+	 * \note Grid/grid_conv.hpp must be included to use conv
+	 *
+	 * \tparam stencil stencil (grid_stencil_offsets)
+	 * \tparam prop_src source property
+	 * \tparam prop_dst destination property (must be different from prop_src)
+	 *
+	 * \param start start point
+	 * \param stop stop point
+	 * \param func function to apply
+	 * \param args additional arguments passed to func
+	 *
+	 */
+	template<typename stencil, unsigned int prop_src, unsigned int prop_dst, typename lambda_f, typename ... ArgsT>
+	void conv(const grid_key_dx<dim> & start, const grid_key_dx<dim> & stop, lambda_f func, ArgsT ... args)
+	{
+		typedef typename boost::mpl::at<typename T::type,boost::mpl::int_<prop_src>>::type prop_src_type;
+		typedef typename boost::mpl::at<typename T::type,boost::mpl::int_<prop_dst>>::type prop_dst_type;
+
+		static_assert(stencil::dims == dim,"the dimensionality of the stencil does not match the grid");
+		static_assert(prop_src != prop_dst,"the source and destination property must be different");
+		static_assert(std::is_arithmetic<prop_src_type>::value && std::is_same<prop_src_type,prop_dst_type>::value,
+		              "conv require source and destination property of the same arithmetic type");
+		static_assert(std::is_same<ord_type,grid_sm<dim,void>>::value,"conv require the standard linearization (grid_sm)");
+
+		for (size_t i = 0 ; i < dim ; i++)
+		{
+			if (stop.get(i) < start.get(i))	{return;}
+
+			for (size_t s = 0 ; s < stencil::nsp ; s++)
+			{
+				if (start.get(i) + stencil::get(s,i) < 0 || stop.get(i) + stencil::get(s,i) >= (long int)g1.size(i))
+				{
+					std::cerr << "Error " << __FILE__ << ":" << __LINE__ << " the stencil applied on the box " << start.to_string() << " " << stop.to_string() << " go out of the grid" << std::endl;
+					return;
+				}
+			}
+		}
+
+		grid_conv_call<stencil>::template conv<prop_src,prop_dst>(*this,start,stop,func,args ...);
+	}
+
+
+	/*! \brief Property p of the full grid as a grid expression
+	 *
+	 * Assigning an expression evaluate it on all the points in a single pass without temporaries
+	 *
+	 * \code{.cpp}
+	 * g.template prop<0>() = a * g.template prop<1>() + g.template prop<2>();
+	 * \endcode
+	 *
+	 * \tparam p property
+	 *
+	 * \return the grid expression
+	 *
+	 */
+	template<unsigned int p>
+	grid_expression_prop<p,dim,grid_base_impl<dim,T,S,layout_base,ord_type>,ord_type> prop()
+	{
+		return grid_expression_prop<p,dim,grid_base_impl<dim,T,S,layout_base,ord_type>,ord_type>(*this,g1);
+	}
+
+	/*! \brief Property p of the full grid as a read-only grid expression
+	 *
+	 * \tparam p property
+	 *
+	 * \return the grid expression
+	 *
+	 */
+	template<unsigned int p>
+	grid_expression_prop<p,dim,const grid_base_impl<dim,T,S,layout_base,ord_type>,ord_type> prop() const
+	{
+		return grid_expression_prop<p,dim,const grid_base_impl<dim,T,S,layout_base,ord_type>,ord_type>(*this,g1);
+	}
+
+	/*! \brief Property p as a grid expression, assigning an expression write only the box [start,stop]
+	 *
+	 * \code{.cpp}
+	 * g.template prop<0>(start,stop) = g.template prop<1>() - g2.template prop<0>();
+	 * \endcode
+	 *
+	 * \tparam p property
+	 *
+	 * \param start start point
+	 * \param stop stop point
+	 *
+	 * \return the grid expression
+	 *
+	 */
+	template<unsigned int p>
+	grid_expression_prop<p,dim,grid_base_impl<dim,T,S,layout_base,ord_type>,ord_type> prop(const grid_key_dx<dim> & start, const grid_key_dx<dim> & stop)
+	{
+		static_assert(std::is_same<ord_type,grid_sm<dim,void>>::value,"prop on a box require the standard linearization (grid_sm)");
+
+		grid_key_dx<dim> stop_ = stop;
+
+		for (size_t i = 0 ; i < dim ; i++)
+		{
+			if (start.get(i) < 0 || stop.get(i) >= (long int)g1.size(i))
+			{
+				std::cerr << "Error " << __FILE__ << ":" << __LINE__ << " the box " << start.to_string() << " " << stop.to_string() << " go out of the grid" << std::endl;
+
+				// empty box, the assignment does nothing
+				stop_.set_d(0,start.get(0) - 1);
+			}
+		}
+
+		return grid_expression_prop<p,dim,grid_base_impl<dim,T,S,layout_base,ord_type>,ord_type>(*this,g1,start,stop_);
+	}
 
 	/*! \brief In this case insert is equivalent to get
 	 *
@@ -1092,14 +1404,14 @@ public:
 	 * \return the const reference of the element
 	 *
 	 */
-	template <unsigned int p, typename r_type=decltype(layout_base<T>::template get_lin<p>(data_,g1,0))>
+	template <unsigned int p, typename r_type=decltype(layout_base<T>::template get_lin_c<p>(data_,g1,0))>
 	__device__ __host__ inline const r_type get(size_t lin_id) const
 	{
 #ifdef SE_CLASS1
 		check_init();
 		check_bound(lin_id);
 #endif
-		return layout_base<T>::template get_lin_const(data_,g1,lin_id);
+		return layout_base<T>::template get_lin_c<p>(data_,g1,lin_id);
 	}
 
 
@@ -1266,7 +1578,7 @@ public:
 	 * \param box_dst destination box
 	 *
 	 */
-	void copy_to(const grid_base_impl<dim,T,S,layout_base> & grid_src,
+	void copy_to(const grid_base_impl<dim,T,S,layout_base,ord_type> & grid_src,
 			     const Box<dim,long int> & box_src,
 				 const Box<dim,long int> & box_dst)
 	{
@@ -1304,7 +1616,8 @@ public:
 
         typedef typename to_int_sequence<0,T::max_prop>::type result;
 
-        copy_grid_fast_caller<result>::call(*this,grid_src,box_src_,box_dst_);
+        copy_grid_to_caller<2*is_grid_zm<ord_type>::value + is_grid_smt<ord_type>::value,
+                            is_all_prp_trivially_copyable<T>::value,result>::call(*this,grid_src,box_src_,box_dst_);
 
 /*        copy_grid_fast<!is_contiguos<prp...>::type::value || has_pack_gen<typename device_grid::value_type>::value,
                                    dim,
@@ -1329,7 +1642,7 @@ public:
 	 *
 	 */
 	template<unsigned int ... prp>
-	void copy_to_prp(const grid_base_impl<dim,T,S,layout_base> & grid_src,
+	void copy_to_prp(const grid_base_impl<dim,T,S,layout_base,ord_type> & grid_src,
 			     const Box<dim,size_t> & box_src,
 				 const Box<dim,size_t> & box_dst)
 	{
@@ -1368,7 +1681,7 @@ public:
 	 *
 	 */
 	template<template<typename,typename> class op, unsigned int ... prp>
-	void copy_to_op(const grid_base_impl<dim,T,S,layout_base> & gs,
+	void copy_to_op(const grid_base_impl<dim,T,S,layout_base,ord_type> & gs,
 			     const Box<dim,size_t> & bx_src,
 				 const Box<dim,size_t> & bx_dst)
 	{
@@ -1445,7 +1758,7 @@ public:
 	{
 		//! Create a completely new grid with sz
 
-		grid_base_impl<dim,T,S,layout_base> grid_new(sz);
+		grid_base_impl<dim,T,S,layout_base,ord_type> grid_new(sz);
 
 		resize_impl_memset(grid_new);
 		resize_impl_host(sz,grid_new);
@@ -1505,7 +1818,7 @@ public:
 	 *
 	 */
 
-	void swap_nomode(grid_base_impl<dim,T,S,layout_base> & grid)
+	void swap_nomode(grid_base_impl<dim,T,S,layout_base,ord_type> & grid)
 	{
 		mem_swap<T,layout_base<T>,decltype(data_),decltype(grid)>::template swap_nomode<S>(data_,grid.data_);
 
@@ -1564,11 +1877,75 @@ public:
 	 *
 	 */
 
-	void swap(grid_base_impl<dim,T,S,layout_base> && grid)
+	void swap(grid_base_impl<dim,T,S,layout_base,ord_type> && grid)
 	{
 		swap(grid);
 	}
 
+	/*! \brief Save the grid in a checkpoint file
+	 *
+	 * The checkpoint contain the description of the properties and the layout of the data, so it can be
+	 * loaded by a grid with a different layout (memory_traits_lin/memory_traits_inte)
+	 *
+	 * \note Packer_Unpacker/Checkpoint.hpp must be included to use save and load
+	 *
+	 * \param path file
+	 * \param n_stripe split the data in n_stripe files written in parallel
+	 *
+	 * \return true if succeed
+	 *
+	 */
+	bool save(const std::string & path, size_t n_stripe = 1) const
+	{
+		std::vector<uint64_t> sz(dim);
+		for (size_t i = 0 ; i < dim ; i++)
+		{sz[i] = g1.size(i);}
+
+		size_t n = (is_mem_init == true)?g1.size():0;
+
+		return checkpoint_call<T>::template save_dense<layout_base<T>>(path,*this,CHECKPOINT_GRID,checkpoint_order(),sz,n,n,n_stripe);
+	}
+
+	/*! \brief Load the grid from a checkpoint file
+	 *
+	 * The grid is resized to the size stored in the checkpoint
+	 *
+	 * \note Packer_Unpacker/Checkpoint.hpp must be included to use save and load
+	 *
+	 * \param path file
+	 *
+	 * \return true if succeed
+	 *
+	 */
+	bool load(const std::string & path)
+	{
+		auto resize = [this](const std::vector<uint64_t> & sz) -> size_t
+		{
+			size_t sz_[dim];
+			for (size_t i = 0 ; i < dim ; i++)
+			{sz_[i] = sz[i];}
+
+			grid_base_impl<dim,T,S,layout_base,ord_type> g_new(sz_);
+			g_new.setMemory();
+			this->swap(g_new);
+
+			return this->g1.size();
+		};
+
+		return checkpoint_call<T>::template load_dense<layout_base<T>>(path,*this,CHECKPOINT_GRID,checkpoint_order(),dim,resize);
+	}
+
+	/*! \brief Order of the elements in a checkpoint of this grid
+	 *
+	 * \return the order
+	 *
+	 */
+	static uint32_t checkpoint_order()
+	{
+		return (is_grid_zm<ord_type>::value == true)?CHECKPOINT_ORDER_MORTON:
+		       ((is_grid_smt<ord_type>::value == true)?CHECKPOINT_ORDER_TILED:CHECKPOINT_ORDER_ROW);
+	}
+
 	/*! \brief set only some properties
 	 *
 	 * \param key1 destination point
@@ -1602,7 +1979,7 @@ public:
 #endif
 
 		// create the object to copy the properties
-		copy_cpu_encap<dim,grid_base_impl<dim,T,S,layout_base>,layout> cp(dx,*this,obj);
+		copy_cpu_encap<dim,grid_base_impl<dim,T,S,layout_base,ord_type>,layout> cp(dx,*this,obj);
 
 		// copy each property
 		boost::mpl::for_each_ref< boost::mpl::range_c<int,0,T::max_prop> >(cp);
@@ -1637,7 +2014,7 @@ public:
 	 */
 
 	inline void set(const grid_key_dx<dim> & key1,
-			        const grid_base_impl<dim,T,S,layout_base> & g,
+			        const grid_base_impl<dim,T,S,layout_base,ord_type> & g,
 					const grid_key_dx<dim> & key2)
 	{
 #ifdef SE_CLASS1
@@ -1658,7 +2035,7 @@ public:
 	 */
 
 	inline void set(const size_t key1,
-			        const grid_base_impl<dim,T,S,layout_base> & g,
+			        const grid_base_impl<dim,T,S,layout_base,ord_type> & g,
 					const size_t key2)
 	{
 #ifdef SE_CLASS1
@@ -1678,7 +2055,7 @@ public:
 	 *
 	 */
 
-	template<typename Mem> inline void set(const grid_key_dx<dim> & key1,const grid_base_impl<dim,T,Mem,layout_base> & g, const grid_key_dx<dim> & key2)
+	template<typename Mem> inline void set(const grid_key_dx<dim> & key1,const grid_base_impl<dim,T,Mem,layout_base,ord_type> & g, const grid_key_dx<dim> & key2)
 	{
 #ifdef SE_CLASS1
 		check_init();
@@ -0,0 +1,290 @@
+/*
+ * grid_conv.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Pietro Incardona
+ */
+
+#ifndef OPENFPM_DATA_SRC_GRID_GRID_CONV_HPP_
+#define OPENFPM_DATA_SRC_GRID_GRID_CONV_HPP_
+
+#include <type_traits>
+#include "util/openmp_util.hpp"
+
+#if !defined(__NVCC__) || defined(CUDA_ON_CPU) || defined(__HIP__)
+#include <Vc/Vc>
+#endif
+
+/*! \brief Compile-time list of stencil points
+ *
+ * The offsets are given point by point, dim components each
+ *
+ * \code{.cpp}
+ * // center, x-1, x+1
+ * typedef grid_stencil_offsets<2, 0,0, -1,0, 1,0> my_stencil;
+ * \endcode
+ *
+ * \tparam dim dimensionality
+ * \tparam off offsets of the stencil points
+ *
+ */
+template<unsigned int dim, int ... off>
+struct grid_stencil_offsets
+{
+	static_assert(sizeof...(off) % dim == 0,"the number of offsets must be a multiple of the dimensionality");
+
+	//! dimensionality
+	static const unsigned int dims = dim;
+
+	//! number of stencil points
+	static const unsigned int nsp = sizeof...(off) / dim;
+
+	/*! \brief Get the component d of the offset of the stencil point s
+	 *
+	 * \param s stencil point
+	 * \param d component
+	 *
+	 * \return the offset
+	 *
+	 */
+	static constexpr int get(unsigned int s, unsigned int d)
+	{
+		const int o[] = {off ...};
+		return o[s*dim + d];
+	}
+};
+
+//! 2D 5 points stencil (center, x-1, x+1, y-1, y+1)
+typedef grid_stencil_offsets<2, 0,0, -1,0, 1,0, 0,-1, 0,1> stencil_2D_5p;
+
+//! 3D 7 points stencil (center, x-1, x+1, y-1, y+1, z-1, z+1)
+typedef grid_stencil_offsets<3, 0,0,0, -1,0,0, 1,0,0, 0,-1,0, 0,1,0, 0,0,-1, 0,0,1> stencil_3D_7p;
+
+//! 3D 19 points stencil (the 7 points stencil followed by the 12 edges, x fastest)
+typedef grid_stencil_offsets<3, 0,0,0, -1,0,0, 1,0,0, 0,-1,0, 0,1,0, 0,0,-1, 0,0,1,
+								-1,-1,0, 1,-1,0, -1,1,0, 1,1,0,
+								-1,0,-1, 1,0,-1, -1,0,1, 1,0,1,
+								0,-1,-1, 0,1,-1, 0,-1,1, 0,1,1> stencil_3D_19p;
+
+//! 3D 27 points stencil (the full 3x3x3 cube, x fastest)
+typedef grid_stencil_offsets<3, -1,-1,-1, 0,-1,-1, 1,-1,-1, -1,0,-1, 0,0,-1, 1,0,-1, -1,1,-1, 0,1,-1, 1,1,-1,
+								-1,-1,0,  0,-1,0,  1,-1,0,  -1,0,0,  0,0,0,  1,0,0,  -1,1,0,  0,1,0,  1,1,0,
+								-1,-1,1,  0,-1,1,  1,-1,1,  -1,0,1,  0,0,1,  1,0,1,  -1,1,1,  0,1,1,  1,1,1> stencil_3D_27p;
+
+#if !defined(__NVCC__) || defined(CUDA_ON_CPU) || defined(__HIP__)
+
+/*! \brief Load the stencil points of a row segment
+ *
+ * \tparam is_inte true if the grid layout is memory_traits_inte (the row is contiguous in memory)
+ *
+ */
+template<bool is_inte>
+struct grid_conv_load
+{
+	/*! \brief Load n points (n <= Size) starting from the linearized index lin for each stencil point
+	 *
+	 * \param g grid
+	 * \param xs output vectors (one for each stencil point)
+	 * \param lin linearized index of the first point
+	 * \param off linearized offsets of the stencil points
+	 * \param n number of points
+	 *
+	 */
+	template<unsigned int prp, unsigned int nsp, typename vect, typename grid_type>
+	static inline void load(grid_type & g, vect (& xs)[nsp], size_t lin, const long int (& off)[nsp], int n)
+	{
+		for (unsigned int s = 0 ; s < nsp ; s++)
+		{
+			xs[s] = vect::Zero();
+
+			for (int l = 0 ; l < n ; l++)
+			{xs[s][l] = g.template get<prp>(lin + off[s] + l);}
+		}
+	}
+
+	/*! \brief Store n points (n <= Size) starting from the linearized index lin
+	 *
+	 * \param g grid
+	 * \param res vector to store
+	 * \param lin linearized index of the first point
+	 * \param n number of points
+	 *
+	 */
+	template<unsigned int prp, typename vect, typename grid_type>
+	static inline void store(grid_type & g, const vect & res, size_t lin, int n)
+	{
+		for (int l = 0 ; l < n ; l++)
+		{g.template get<prp>(lin + l) = res[l];}
+	}
+};
+
+//! memory_traits_inte layout the rows are loaded with vector loads
+template<>
+struct grid_conv_load<true>
+{
+	template<unsigned int prp, unsigned int nsp, typename vect, typename grid_type>
+	static inline void load(const grid_type & g, vect (& xs)[nsp], size_t lin, const long int (& off)[nsp], int n)
+	{
+		typedef typename vect::EntryType prop_type;
+
+		const prop_type * src = (const prop_type *)g.template getPointer<prp>() + lin;
+
+		if (n == vect::Size)
+		{
+			for (unsigned int s = 0 ; s < nsp ; s++)
+			{xs[s].load(src + off[s],Vc::Unaligned);}
+		}
+		else
+		{
+			// masked tail, we do not read after the end of the row
+			for (unsigned int s = 0 ; s < nsp ; s++)
+			{
+				xs[s] = vect::Zero();
+
+				for (int l = 0 ; l < n ; l++)
+				{xs[s][l] = src[off[s] + l];}
+			}
+		}
+	}
+
+	template<unsigned int prp, typename vect, typename grid_type>
+	static inline void store(grid_type & g, const vect & res, size_t lin, int n)
+	{
+		typedef typename vect::EntryType prop_type;
+
+		prop_type * dst = (prop_type *)g.template getPointer<prp>() + lin;
+
+		if (n == vect::Size)
+		{res.store(dst,Vc::Unaligned);}
+		else
+		{
+			Vc::Mask<prop_type> m;
+
+			for (int l = 0 ; l < vect::Size ; l++)
+			{m[l] = l < n;}
+
+			res.store(dst,m,Vc::Unaligned);
+		}
+	}
+};
+
+/*! \brief Apply a stencil with a function on the box [start,stop] of a dense grid
+ *
+ * The linearized offsets of the stencil points are calculated once, the linearized index is
+ * calculated once per row and the rows are processed Vc::Vector<T>::Size points at time.
+ * The rows are distributed across threads
+ *
+ * \tparam stencil stencil (grid_stencil_offsets)
+ * \tparam prp_src source property
+ * \tparam prp_dst destination property
+ *
+ * \param g grid
+ * \param start start point
+ * \param stop stop point
+ * \param func function, it receive the array of vectors (one for each stencil point) and the args
+ * \param args arguments
+ *
+ */
+template<typename stencil, unsigned int prp_src, unsigned int prp_dst, typename grid_type, typename lambda_f, typename ... ArgsT>
+void grid_conv_impl(grid_type & g,
+					const grid_key_dx<grid_type::dims> & start,
+					const grid_key_dx<grid_type::dims> & stop,
+					lambda_f & func,
+					ArgsT & ... args)
+{
+	constexpr unsigned int dim = grid_type::dims;
+	constexpr unsigned int nsp = stencil::nsp;
+
+	typedef typename boost::mpl::at<typename grid_type::value_type::type,boost::mpl::int_<prp_src>>::type prop_type;
+	typedef Vc::Vector<prop_type> vect;
+	typedef grid_conv_load<is_layout_inte<typename grid_type::layout_base_>::value> ld;
+
+	// linearized offsets of the stencil points
+	long int off[nsp];
+	long int stride[dim];
+
+	stride[0] = 1;
+	for (size_t i = 1 ; i < dim ; i++)
+	{stride[i] = g.getGrid().size_s(i-1);}
+
+	for (unsigned int s = 0 ; s < nsp ; s++)
+	{
+		off[s] = 0;
+		for (unsigned int i = 0 ; i < dim ; i++)
+		{off[s] += stencil::get(s,i)*stride[i];}
+	}
+
+	size_t n_rows = 1;
+	for (size_t i = 1 ; i < dim ; i++)
+	{n_rows *= stop.get(i) - start.get(i) + 1;}
+
+	int nx = stop.get(0) - start.get(0) + 1;
+
+	#pragma omp parallel if (n_rows*nx >= OPENFPM_OMP_MIN_ELEMENTS)
+	{
+		size_t r_start;
+		size_t r_stop;
+		openfpm_omp_static_range(n_rows,openfpm_omp_num_threads(),openfpm_omp_thread_num(),r_start,r_stop);
+
+		for (size_t r = r_start ; r < r_stop ; r++)
+		{
+			// linearized index of the first point of the row
+			grid_key_dx<dim> key;
+			size_t rs = r;
+
+			key.set_d(0,start.get(0));
+			for (size_t i = 1 ; i < dim ; i++)
+			{
+				size_t ext = stop.get(i) - start.get(i) + 1;
+				key.set_d(i,start.get(i) + rs % ext);
+				rs /= ext;
+			}
+
+			size_t lin = g.getGrid().LinId(key);
+
+			for (int i = 0 ; i < nx ; i += vect::Size)
+			{
+				int n = (nx - i < (int)vect::Size)?(nx - i):(int)vect::Size;
+
+				vect xs[nsp];
+				ld::template load<prp_src>(g,xs,lin + i,off,n);
+
+				vect res = func(xs,args ...);
+
+				ld::template store<prp_dst>(g,res,lin + i,n);
+			}
+		}
+	}
+}
+
+/*! \brief Implementation of grid_base_impl::conv
+ *
+ * \tparam stencil stencil (grid_stencil_offsets)
+ *
+ */
+template<typename stencil>
+struct grid_conv_call
+{
+	/*! \brief Apply the stencil (see grid_conv_impl)
+	 *
+	 * \param g grid
+	 * \param start start point
+	 * \param stop stop point
+	 * \param func function
+	 * \param args arguments
+	 *
+	 */
+	template<unsigned int prp_src, unsigned int prp_dst, typename grid_type, typename lambda_f, typename ... ArgsT>
+	static void conv(grid_type & g,
+					 const grid_key_dx<grid_type::dims> & start,
+					 const grid_key_dx<grid_type::dims> & stop,
+					 lambda_f & func,
+					 ArgsT & ... args)
+	{
+		grid_conv_impl<stencil,prp_src,prp_dst>(g,start,stop,func,args ...);
+	}
+};
+
+#endif
+
+#endif /* OPENFPM_DATA_SRC_GRID_GRID_CONV_HPP_ */
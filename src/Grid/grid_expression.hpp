@@ -0,0 +1,572 @@
+/*
+ * grid_expression.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Pietro Incardona
+ */
+
+#ifndef OPENFPM_DATA_SRC_GRID_GRID_EXPRESSION_HPP_
+#define OPENFPM_DATA_SRC_GRID_GRID_EXPRESSION_HPP_
+
+#include <type_traits>
+#include <boost/mpl/at.hpp>
+#include "util/common.hpp"
+#include "util/openmp_util.hpp"
+#include "memory_ly/memory_conf.hpp"
+
+#define GRID_EXP_SUM 1
+#define GRID_EXP_SUB 2
+#define GRID_EXP_MUL 3
+#define GRID_EXP_DIV 4
+#define GRID_EXP_SUB_UNI 5
+
+/*! \brief Check if a type is a grid expression
+ *
+ * return true if T::is_grid_expression is a valid type
+ *
+ */
+template<typename T, typename Sfinae = void>
+struct is_grid_expression: std::false_type {};
+
+//! T is a grid expression
+template<typename T>
+struct is_grid_expression<T, typename Void<typename T::is_grid_expression>::type> : std::true_type
+{};
+
+/*! \brief Apply the operation op
+ *
+ * \tparam op operation
+ *
+ */
+template<unsigned int op>
+struct grid_expression_apply
+{};
+
+//! sum
+template<>
+struct grid_expression_apply<GRID_EXP_SUM>
+{
+	template<typename T1, typename T2>
+	static inline auto eval(const T1 & a, const T2 & b) -> decltype(a + b)
+	{
+		return a + b;
+	}
+};
+
+//! subtraction
+template<>
+struct grid_expression_apply<GRID_EXP_SUB>
+{
+	template<typename T1, typename T2>
+	static inline auto eval(const T1 & a, const T2 & b) -> decltype(a - b)
+	{
+		return a - b;
+	}
+};
+
+//! multiplication
+template<>
+struct grid_expression_apply<GRID_EXP_MUL>
+{
+	template<typename T1, typename T2>
+	static inline auto eval(const T1 & a, const T2 & b) -> decltype(a * b)
+	{
+		return a * b;
+	}
+};
+
+//! division
+template<>
+struct grid_expression_apply<GRID_EXP_DIV>
+{
+	template<typename T1, typename T2>
+	static inline auto eval(const T1 & a, const T2 & b) -> decltype(a / b)
+	{
+		return a / b;
+	}
+};
+
+/*! \brief Constant used in a grid expression
+ *
+ * \tparam T type of the constant
+ *
+ */
+template<typename T>
+class grid_expression_const
+{
+	//! constant
+	T d;
+
+public:
+
+	//! indicate that this class encapsulate a grid expression
+	typedef int is_grid_expression;
+
+	/*! \brief constructor from a value
+	 *
+	 * \param d value
+	 *
+	 */
+	inline grid_expression_const(const T & d)
+	:d(d)
+	{}
+
+	/*! \brief A constant can be combined with any grid
+	 *
+	 * \param gs linearizer of the destination
+	 *
+	 * \return true
+	 *
+	 */
+	template<typename lin_type>
+	inline bool check(const lin_type & /*gs*/) const
+	{
+		return true;
+	}
+
+	/*! \brief Evaluate the expression
+	 *
+	 * \param lin linearized index
+	 *
+	 * \return the constant
+	 *
+	 */
+	inline T value(size_t /*lin*/) const
+	{
+		return d;
+	}
+};
+
+/*! \brief Binary operation between two grid expressions
+ *
+ * \tparam exp1 expression1
+ * \tparam exp2 expression2
+ * \tparam op operation
+ *
+ */
+template<typename exp1, typename exp2, unsigned int op>
+class grid_expression_op
+{
+	//! first expression
+	const exp1 o1;
+
+	//! second expression
+	const exp2 o2;
+
+public:
+
+	//! indicate that this class encapsulate a grid expression
+	typedef int is_grid_expression;
+
+	/*! \brief Constructor from 2 grid expressions
+	 *
+	 * \param o1 expression1
+	 * \param o2 expression2
+	 *
+	 */
+	inline grid_expression_op(const exp1 & o1, const exp2 & o2)
+	:o1(o1),o2(o2)
+	{}
+
+	/*! \brief Check that the grids in the expression have the linearization gs
+	 *
+	 * \param gs linearizer of the destination
+	 *
+	 * \return true if the expression can be evaluated on gs
+	 *
+	 */
+	template<typename lin_type>
+	inline bool check(const lin_type & gs) const
+	{
+		return o1.check(gs) && o2.check(gs);
+	}
+
+	/*! \brief Evaluate the expression on the point with linearized index lin
+	 *
+	 * \param lin linearized index
+	 *
+	 * \return the value of the expression
+	 *
+	 */
+	inline auto value(size_t lin) const -> decltype(grid_expression_apply<op>::eval(o1.value(lin),o2.value(lin)))
+	{
+		return grid_expression_apply<op>::eval(o1.value(lin),o2.value(lin));
+	}
+};
+
+/*! \brief Unary minus of a grid expression
+ *
+ * \tparam exp1 expression
+ *
+ */
+template<typename exp1>
+class grid_expression_op<exp1,void,GRID_EXP_SUB_UNI>
+{
+	//! expression
+	const exp1 o1;
+
+public:
+
+	//! indicate that this class encapsulate a grid expression
+	typedef int is_grid_expression;
+
+	/*! \brief Constructor from a grid expression
+	 *
+	 * \param o1 expression
+	 *
+	 */
+	inline grid_expression_op(const exp1 & o1)
+	:o1(o1)
+	{}
+
+	/*! \brief Check that the grids in the expression have the linearization gs
+	 *
+	 * \param gs linearizer of the destination
+	 *
+	 * \return true if the expression can be evaluated on gs
+	 *
+	 */
+	template<typename lin_type>
+	inline bool check(const lin_type & gs) const
+	{
+		return o1.check(gs);
+	}
+
+	/*! \brief Evaluate the expression on the point with linearized index lin
+	 *
+	 * \param lin linearized index
+	 *
+	 * \return the value of the expression
+	 *
+	 */
+	inline auto value(size_t lin) const -> decltype(-o1.value(lin))
+	{
+		return -o1.value(lin);
+	}
+};
+
+/*! \brief Property of a grid (or an openfpm::vector) used in a grid expression
+ *
+ * It is a strided view on the property, for memory_traits_inte the stride is the size of the property
+ * (contiguous buffer, the evaluation loops vectorize), for memory_traits_lin it is the size of the full
+ * aggregate. Assigning an expression evaluate it in a single pass, distributed across threads, without
+ * temporaries
+ *
+ * \code{.cpp}
+ * g.template prop<0>() = a * g.template prop<1>() + g.template prop<2>();
+ * g.template prop<0>(start,stop) = 2.0 * g.template prop<0>();
+ * \endcode
+ *
+ * \tparam prp property
+ * \tparam dim dimensionality
+ * \tparam container grid or vector (const qualified for read-only access)
+ * \tparam lin_type linearizer of the container
+ *
+ */
+template<unsigned int prp, unsigned int dim, typename container, typename lin_type>
+class grid_expression_prop
+{
+	//! container without qualifiers
+	typedef typename std::remove_const<container>::type container_nc;
+
+	//! type of the object stored
+	typedef typename container_nc::value_type value_type;
+
+	//! type of the property
+	typedef typename boost::mpl::at<typename value_type::type,boost::mpl::int_<prp>>::type prp_type;
+
+	//! byte type with the constness of the container
+	typedef typename std::conditional<std::is_const<container>::value,const unsigned char,unsigned char>::type byte_type;
+
+	static_assert(std::is_arithmetic<prp_type>::value,"grid expressions work only on arithmetic properties");
+
+	//! distance in byte between two consecutive elements
+	static const size_t stride = (is_layout_inte<typename container_nc::layout_base_>::value)?sizeof(prp_type):sizeof(typename value_type::type);
+
+	//! pointer to the property of the first element
+	byte_type * base;
+
+	//! linearizer of the container
+	lin_type gs;
+
+	//! true if the assignment is restricted to the box [start,stop]
+	bool is_box;
+
+	//! start of the box
+	grid_key_dx<dim> start;
+
+	//! stop of the box
+	grid_key_dx<dim> stop;
+
+	/*! \brief Get the property of the element lin
+	 *
+	 * \param lin linearized index
+	 *
+	 * \return reference to the property
+	 *
+	 */
+	inline prp_type & ref(size_t lin) const
+	{
+		return *(prp_type *)(base + lin*stride);
+	}
+
+	/*! \brief Evaluate the expression on all the elements of the container
+	 *
+	 * \param e expression
+	 *
+	 */
+	template<typename exp>
+	void assign_all(const exp & e)
+	{
+		size_t n = gs.size();
+
+		#pragma omp parallel if (n >= OPENFPM_OMP_MIN_ELEMENTS)
+		{
+			size_t r_start;
+			size_t r_stop;
+			openfpm_omp_static_range(n,openfpm_omp_num_threads(),openfpm_omp_thread_num(),r_start,r_stop);
+
+			#pragma omp simd
+			for (size_t i = r_start ; i < r_stop ; i++)
+			{ref(i) = e.value(i);}
+		}
+	}
+
+	/*! \brief Evaluate the expression on the box [start,stop], row by row
+	 *
+	 * \param e expression
+	 *
+	 */
+	template<typename exp>
+	void assign_box(const exp & e)
+	{
+		size_t n_rows = 1;
+		for (size_t i = 1 ; i < dim ; i++)
+		{n_rows *= stop.get(i) - start.get(i) + 1;}
+
+		size_t nx = stop.get(0) - start.get(0) + 1;
+
+		#pragma omp parallel if (n_rows*nx >= OPENFPM_OMP_MIN_ELEMENTS)
+		{
+			size_t r_start;
+			size_t r_stop;
+			openfpm_omp_static_range(n_rows,openfpm_omp_num_threads(),openfpm_omp_thread_num(),r_start,r_stop);
+
+			for (size_t r = r_start ; r < r_stop ; r++)
+			{
+				// linearized index of the first point of the row
+				grid_key_dx<dim> key;
+				size_t rs = r;
+
+				key.set_d(0,start.get(0));
+				for (size_t i = 1 ; i < dim ; i++)
+				{
+					size_t ext = stop.get(i) - start.get(i) + 1;
+					key.set_d(i,start.get(i) + rs % ext);
+					rs /= ext;
+				}
+
+				size_t lin = gs.LinId(key);
+
+				#pragma omp simd
+				for (size_t x = lin ; x < lin + nx ; x++)
+				{ref(x) = e.value(x);}
+			}
+		}
+	}
+
+public:
+
+	//! indicate that this class encapsulate a grid expression
+	typedef int is_grid_expression;
+
+	/*! \brief Constructor, the expression cover the full container
+	 *
+	 * \param c container
+	 * \param gs linearizer of the container
+	 *
+	 */
+	grid_expression_prop(container & c, const lin_type & gs)
+	:base(NULL),gs(gs),is_box(false)
+	{
+		if (gs.size() != 0)
+		{base = (byte_type *)&const_cast<container_nc &>(c).template get<prp>((size_t)0);}
+	}
+
+	/*! \brief Constructor, an assignment write only the box [start,stop]
+	 *
+	 * The container must use the standard linearization (grid_sm) and the box must be inside
+	 *
+	 * \param c container
+	 * \param gs linearizer of the container
+	 * \param start start point
+	 * \param stop stop point
+	 *
+	 */
+	grid_expression_prop(container & c, const lin_type & gs, const grid_key_dx<dim> & start, const grid_key_dx<dim> & stop)
+	:base(NULL),gs(gs),is_box(true),start(start),stop(stop)
+	{
+		if (gs.size() != 0)
+		{base = (byte_type *)&const_cast<container_nc &>(c).template get<prp>((size_t)0);}
+	}
+
+	/*! \brief Copy constructor, the copy refer to the same property of the same container
+	 *
+	 * \param e expression to copy
+	 *
+	 */
+	grid_expression_prop(const grid_expression_prop & e) = default;
+
+	/*! \brief Check that the container has the linearization gs
+	 *
+	 * \param gs linearizer of the destination
+	 *
+	 * \return true if the container has the same size of gs
+	 *
+	 */
+	inline bool check(const lin_type & gs) const
+	{
+		for (size_t i = 0 ; i < dim ; i++)
+		{
+			if (this->gs.size(i) != gs.size(i))	{return false;}
+		}
+
+		return true;
+	}
+
+	/*! \brief Evaluate the property on the point with linearized index lin
+	 *
+	 * \param lin linearized index
+	 *
+	 * \return the value of the property
+	 *
+	 */
+	inline prp_type value(size_t lin) const
+	{
+		return ref(lin);
+	}
+
+	/*! \brief Evaluate the expression and write the result in the property
+	 *
+	 * \param e expression
+	 *
+	 * \return itself
+	 *
+	 */
+	template<typename exp, typename sfinae = typename std::enable_if<::is_grid_expression<exp>::value>::type>
+	grid_expression_prop & operator=(const exp & e)
+	{
+		static_assert(std::is_const<container>::value == false,"the destination of a grid expression cannot be const");
+
+		if (e.check(gs) == false)
+		{
+			std::cerr << "Error " << __FILE__ << ":" << __LINE__ << " the grids in the expression have a different size from the destination" << std::endl;
+			return *this;
+		}
+
+		if (base == NULL)	{return *this;}
+
+		if (is_box == true)
+		{
+			for (size_t i = 0 ; i < dim ; i++)
+			{
+				if (stop.get(i) < start.get(i))	{return *this;}
+			}
+
+			assign_box(e);
+		}
+		else
+		{assign_all(e);}
+
+		return *this;
+	}
+
+	/*! \brief Copy the property of another container (or another property)
+	 *
+	 * \param e property to copy
+	 *
+	 * \return itself
+	 *
+	 */
+	grid_expression_prop & operator=(const grid_expression_prop & e)
+	{
+		return this->operator=<grid_expression_prop>(e);
+	}
+
+	/*! \brief Fill the property with a value
+	 *
+	 * \param d value
+	 *
+	 * \return itself
+	 *
+	 */
+	grid_expression_prop & operator=(prp_type d)
+	{
+		return this->operator=(grid_expression_const<prp_type>(d));
+	}
+};
+
+/*! \brief Check if the two operands can produce a grid expression
+ *
+ * At least one operand must be a grid expression, the other can be a grid expression or a number
+ *
+ */
+template<typename T1, typename T2>
+struct grid_expression_operands
+{
+	//! true if the operator must produce a grid expression
+	static const bool value = (is_grid_expression<T1>::value && is_grid_expression<T2>::value) ||
+	                          (is_grid_expression<T1>::value && std::is_arithmetic<T2>::value) ||
+	                          (std::is_arithmetic<T1>::value && is_grid_expression<T2>::value);
+};
+
+/*! \brief Wrap the numbers into grid_expression_const
+ *
+ * \tparam T operand
+ *
+ */
+template<typename T, bool is_number = std::is_arithmetic<T>::value>
+struct grid_expression_wrap
+{
+	//! expression type
+	typedef T type;
+};
+
+//! a number is wrapped into a constant
+template<typename T>
+struct grid_expression_wrap<T,true>
+{
+	//! expression type
+	typedef grid_expression_const<T> type;
+};
+
+#define CREATE_GRID_EXP_OPERATOR(OP,OP_ID) \
+template<typename T1, typename T2, typename sfinae = typename std::enable_if<grid_expression_operands<T1,T2>::value>::type> \
+inline grid_expression_op<typename grid_expression_wrap<T1>::type,typename grid_expression_wrap<T2>::type,OP_ID> \
+operator OP(const T1 & e1, const T2 & e2) \
+{ \
+	typedef typename grid_expression_wrap<T1>::type exp1; \
+	typedef typename grid_expression_wrap<T2>::type exp2; \
+\
+	return grid_expression_op<exp1,exp2,OP_ID>(exp1(e1),exp2(e2)); \
+}
+
+CREATE_GRID_EXP_OPERATOR(+,GRID_EXP_SUM)
+CREATE_GRID_EXP_OPERATOR(-,GRID_EXP_SUB)
+CREATE_GRID_EXP_OPERATOR(*,GRID_EXP_MUL)
+CREATE_GRID_EXP_OPERATOR(/,GRID_EXP_DIV)
+
+/*! \brief Unary minus of a grid expression
+ *
+ * \param e1 expression
+ *
+ * \return the expression -e1
+ *
+ */
+template<typename T1, typename sfinae = typename std::enable_if<is_grid_expression<T1>::value>::type>
+inline grid_expression_op<T1,void,GRID_EXP_SUB_UNI> operator-(const T1 & e1)
+{
+	return grid_expression_op<T1,void,GRID_EXP_SUB_UNI>(e1);
+}
+
+#endif /* OPENFPM_DATA_SRC_GRID_GRID_EXPRESSION_HPP_ */
@@ -44,7 +44,7 @@ static bool packMem()
 template<bool sel, int ... prp>
 struct pack_simple_cond
 {
-	static inline void pack(const grid_base_impl<dim,T,S,layout_base> & obj, ExtPreAlloc<S> & mem, Pack_stat & sts)
+	static inline void pack(const grid_base_impl<dim,T,S,layout_base,ord_type> & obj, ExtPreAlloc<S> & mem, Pack_stat & sts)
 	{
 #ifdef SE_CLASS1
 		if (mem.ref() == 0)
@@ -58,7 +58,7 @@ struct pack_simple_cond
 		}
 
 		// Sending property object and vector
-		typedef object<typename object_creator<typename grid_base_impl<dim,T,S,layout_base>::value_type::type,prp...>::type> prp_object;
+		typedef object<typename object_creator<typename grid_base_impl<dim,T,S,layout_base,ord_type>::value_type::type,prp...>::type> prp_object;
 		typedef openfpm::vector<prp_object,ExtPreAlloc<S>,layout_base,openfpm::grow_policy_identity> dtype;
 
 		// Create an object over the preallocated memory (No allocation is produced)
@@ -78,7 +78,7 @@ struct pack_simple_cond
 							decltype(obj),
 							   encap_src,
 		 	 	 	 	 	   encap_dst,
-							   typename grid_base_impl<dim,T,S,layout_base>::value_type::type,
+							   typename grid_base_impl<dim,T,S,layout_base,ord_type>::value_type::type,
 							   decltype(it),
 							   dtype,
 							   prp...>::pack(obj,it,dest);
@@ -92,7 +92,7 @@ struct pack_simple_cond
 template<int ... prp>
 struct pack_simple_cond<true, prp ...>
 {
-	static inline void pack(const grid_base_impl<dim,T,S,layout_base> & obj, ExtPreAlloc<S> & mem, Pack_stat & sts)
+	static inline void pack(const grid_base_impl<dim,T,S,layout_base,ord_type> & obj, ExtPreAlloc<S> & mem, Pack_stat & sts)
 	{
 #ifdef SE_CLASS1
 		if (mem.ref() == 0)
@@ -382,9 +382,9 @@ struct unpack_simple_cond<true, prp ...>
 			std::cerr << "Error : " << __FILE__ << ":" << __LINE__ << " the reference counter of mem should never be zero when packing \n";
 #endif
 
-		// Sending property object
+		// Sending property object, the sub-grid is packed as an array of objects (for any layout) as the unpack read it
 		typedef object<typename object_creator<typename grid_base_impl<dim,T,S,layout_base,ord_type>::value_type::type,prp...>::type> prp_object;
-		typedef openfpm::vector<prp_object,ExtPreAlloc<S>, layout_base,openfpm::grow_policy_identity> dtype;
+		typedef openfpm::vector<prp_object,ExtPreAlloc<S>, memory_traits_lin,openfpm::grow_policy_identity> dtype;
 
 		// Create an object over the preallocated memory (No allocation is produced)
 		dtype dest;
@@ -396,7 +396,10 @@ struct unpack_simple_cond<true, prp ...>
 		// destination object type
 		typedef encapc<1,prp_object,typename dtype::layout_type > encap_dst;
 
-		pack_with_iterator<sizeof...(prp) != T::max_prop || has_pack_gen<prp_object>::value,
+		// the strided memcpy pack work only for all the properties of a linear row-major grid
+		pack_with_iterator<sizeof...(prp) != T::max_prop || has_pack_gen<prp_object>::value ||
+						   is_layout_mlin<layout_base<T>>::value == false ||
+						   std::is_same<ord_type,grid_sm<dim,void>>::value == false,
 						   dims,
 						   decltype(*this),
 						   encap_src,
@@ -422,7 +425,7 @@ struct unpack_simple_cond<true, prp ...>
 	 */
 	template<int ... prp> void packRequest(grid_key_dx_iterator_sub<dims> & sub, size_t & req)
 	{
-		typedef openfpm::vector<typename grid_base_impl<dim,T,S,layout_base,ord_type>::value_type,ExtPreAlloc<S>,layout_base,openfpm::grow_policy_identity> dtype;
+		typedef openfpm::vector<typename grid_base_impl<dim,T,S,layout_base,ord_type>::value_type,ExtPreAlloc<S>,memory_traits_lin,openfpm::grow_policy_identity> dtype;
 		dtype dvect;
 
 		// Calculate the required memory for packing
@@ -431,6 +434,181 @@ struct unpack_simple_cond<true, prp ...>
 		req += alloc_ele;
 	}
 
+	//! Copy a row of a sub-grid in the pack buffer object by object
+	template<bool is_mcpy, int ... prp>
+	struct pack_parallel_row
+	{
+		/*! \brief Copy nx points starting from key
+		 *
+		 * \param obj grid to pack
+		 * \param key first point of the row
+		 * \param nx number of points in the row
+		 * \param dest buffer where to pack
+		 * \param id position in dest of the first point
+		 *
+		 */
+		template<typename dtype>
+		static inline void pack(const grid_base_impl<dim,T,S,layout_base,ord_type> & obj, grid_key_dx<dim> key, size_t nx, dtype & dest, size_t id)
+		{
+			typedef typename dtype::value_type prp_object;
+
+			typedef encapc<dim,value_type,layout > encap_src;
+			typedef encapc<1,prp_object,typename dtype::layout_type > encap_dst;
+
+			for (size_t x = 0 ; x < nx ; x++)
+			{
+				// Copy only the selected properties
+				object_si_d<encap_src,encap_dst,OBJ_ENCAP,prp...>(obj.get_o(key),dest.get(id + x));
+
+				key.set_d(0,key.get(0) + 1);
+			}
+		}
+	};
+
+	//! Copy a row of a sub-grid in the pack buffer with a memcpy (all the properties of a linear layout)
+	template<int ... prp>
+	struct pack_parallel_row<true,prp...>
+	{
+		/*! \brief Copy nx points starting from key
+		 *
+		 * \param obj grid to pack
+		 * \param key first point of the row
+		 * \param nx number of points in the row
+		 * \param dest buffer where to pack
+		 * \param id position in dest of the first point
+		 *
+		 */
+		template<typename dtype>
+		static inline void pack(const grid_base_impl<dim,T,S,layout_base,ord_type> & obj, grid_key_dx<dim> key, size_t nx, dtype & dest, size_t id)
+		{
+			typedef typename dtype::value_type prp_object;
+
+			memcpy((unsigned char *)dest.getPointer() + id*sizeof(prp_object),
+				   &obj.template get<first_variadic<prp...>::type::value>(key),
+				   nx*sizeof(prp_object));
+		}
+	};
+
+	/*! \brief Insert an allocation request for a set of sub-grids packed with the parallel pack
+	 *
+	 * Together with the size it calculate the offset of each sub-grid from the beginning of the request,
+	 * sub-grid k is packed in [offsets.get(k),offsets.get(k+1)), each sub-grid is stored as the pack with
+	 * a single sub-grid iterator would do
+	 *
+	 * \tparam prp set of properties to pack
+	 *
+	 * \param subs sub-grids to pack
+	 * \param offsets offset of each sub-grid (subs.size() + 1 elements)
+	 * \param req request
+	 *
+	 */
+	template<int ... prp> void packRequest(const std::vector<grid_key_dx_iterator_sub<dims>> & subs, std::vector<size_t> & offsets, size_t & req) const
+	{
+		typedef object<typename object_creator<typename grid_base_impl<dim,T,S,layout_base,ord_type>::value_type::type,prp...>::type> prp_object;
+		typedef openfpm::vector<prp_object,ExtPreAlloc<S>,memory_traits_lin,openfpm::grow_policy_identity> dtype;
+
+		offsets.resize(subs.size() + 1);
+		offsets[0] = 0;
+
+		for (size_t k = 0 ; k < subs.size() ; k++)
+		{
+			size_t vol = Box<dims,long int>::getVolumeKey(subs[k].getStart().get_k(),subs[k].getStop().get_k());
+			offsets[k+1] = offsets[k] + dtype::calculateMem(vol,0);
+		}
+
+		req += offsets[subs.size()];
+	}
+
+	/*! \brief Pack a set of sub-grids in parallel
+	 *
+	 * The rows of all the sub-grids are distributed across the threads, each thread write its rows in a
+	 * disjoint region of the buffer given by the offsets calculated by packRequest. The result is the same
+	 * as packing the sub-grids one by one with a sub-grid iterator and can be unpacked in the same way.
+	 * As for the single sub-grid pack, every sub-grid is stored as an array of objects for any layout
+	 *
+	 * \tparam prp properties to pack
+	 *
+	 * \param mem preallocated memory where to pack the objects
+	 * \param subs sub-grids to pack
+	 * \param offsets offset of each sub-grid calculated by packRequest
+	 * \param sts pack statistic
+	 *
+	 */
+	template<int ... prp> void pack(ExtPreAlloc<S> & mem, const std::vector<grid_key_dx_iterator_sub<dims>> & subs, const std::vector<size_t> & offsets, Pack_stat & sts) const
+	{
+#ifdef SE_CLASS1
+		if (mem.ref() == 0)
+			std::cerr << "Error : " << __FILE__ << ":" << __LINE__ << " the reference counter of mem should never be zero when packing \n";
+#endif
+
+		if (offsets.size() != subs.size() + 1)
+		{
+			std::cerr << "Error " << __FILE__ << ":" << __LINE__ << " the offsets does not match the sub-grids, call packRequest with the same sub-grids" << std::endl;
+			return;
+		}
+
+		// Sending property object
+		typedef object<typename object_creator<typename grid_base_impl<dim,T,S,layout_base,ord_type>::value_type::type,prp...>::type> prp_object;
+		typedef openfpm::vector<prp_object,ExtPreAlloc<S>,memory_traits_lin,openfpm::grow_policy_identity> dtype;
+
+		// a row can be copied with a memcpy if we pack all the properties of a linear layout
+		typedef pack_parallel_row<sizeof...(prp) == T::max_prop &&
+								  has_pack_gen<prp_object>::value == false &&
+								  is_layout_mlin<layout_base<T>>::value &&
+								  std::is_same<ord_type,grid_sm<dim,void>>::value,prp...> row_copy;
+
+		// Create an object over the preallocated memory (No allocation is produced)
+		dtype dest;
+		dest.setMemory(mem);
+		dest.resize(offsets[subs.size()] / sizeof(prp_object));
+
+		// number of rows before each sub-grid
+		std::vector<size_t> row_off(subs.size() + 1);
+		row_off[0] = 0;
+
+		for (size_t k = 0 ; k < subs.size() ; k++)
+		{
+			size_t vol = Box<dims,long int>::getVolumeKey(subs[k].getStart().get_k(),subs[k].getStop().get_k());
+			size_t nx = subs[k].getStop().get(0) - subs[k].getStart().get(0) + 1;
+
+			row_off[k+1] = row_off[k] + ((vol == 0)?0:vol / nx);
+		}
+
+		#pragma omp parallel if (dest.size() >= OPENFPM_OMP_MIN_ELEMENTS)
+		{
+			size_t start;
+			size_t stop;
+			openfpm_omp_static_range(row_off[subs.size()],openfpm_omp_num_threads(),openfpm_omp_thread_num(),start,stop);
+
+			size_t k = std::upper_bound(row_off.begin(),row_off.end(),start) - row_off.begin() - 1;
+
+			for (size_t r = start ; r < stop ; r++)
+			{
+				while (r >= row_off[k+1])	{k++;}
+
+				const grid_key_dx<dims> & sk = subs[k].getStart();
+				const grid_key_dx<dims> & ek = subs[k].getStop();
+				size_t nx = ek.get(0) - sk.get(0) + 1;
+
+				// first point of the row
+				grid_key_dx<dims> key = sk;
+				size_t rr = r - row_off[k];
+				for (size_t i = 1 ; i < dims ; i++)
+				{
+					size_t ext = ek.get(i) - sk.get(i) + 1;
+					key.set_d(i,sk.get(i) + rr % ext);
+					rr /= ext;
+				}
+
+				row_copy::pack(*this,key,nx,dest,offsets[k] / sizeof(prp_object) + (r - row_off[k])*nx);
+			}
+		}
+
+		// Update statistic (one request for each sub-grid)
+		for (size_t k = 0 ; k < subs.size() ; k++)
+		{sts.incReq();}
+	}
+
 
 	/*! \brief unpack the sub-grid object
 	 *
@@ -364,6 +364,13 @@ public:
 		}
 	}
 
+	/*! \brief Copy constructor
+	 *
+	 * \param g grid info
+	 *
+	 */
+	grid_sm(const grid_sm<N,T> & g) = default;
+
 	// Static element to calculate total size
 
 	inline size_t totalSize(const size_t sz)
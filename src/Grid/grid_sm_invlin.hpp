@@ -0,0 +1,159 @@
+/*
+ * grid_sm_invlin.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Pietro Incardona
+ */
+
+#ifndef OPENFPM_DATA_SRC_GRID_GRID_SM_INVLIN_HPP_
+#define OPENFPM_DATA_SRC_GRID_GRID_SM_INVLIN_HPP_
+
+#include "Grid/grid_sm.hpp"
+#include "util/mathutil.hpp"
+
+/*! \brief Host side inversion of the grid_sm linearization with precomputed reciprocals
+ *
+ * The magic numbers of the division by the size of the grid on each direction are calculated
+ * once in the constructor (or in setDimensions) and reused by every InvLinId call. grid_sm does not
+ * store them, so it stay small when it is passed by value to the GPU kernels
+ *
+ * \code{.cpp}
+ * grid_sm<3,void> gs(sz);
+ * grid_sm_invlin<3> gi(gs);
+ *
+ * gi.InvLinId(&ids[0],&keys[0],ids.size());
+ * \endcode
+ *
+ * \tparam N dimensionality
+ *
+ */
+template<unsigned int N>
+class grid_sm_invlin
+{
+	//! size of the grid on each direction
+	size_t sz[N];
+
+	//! total number of points
+	size_t size_tot;
+
+	//! division by the size of the grid on each direction
+	openfpm::math::fast_div sz_div[N];
+
+public:
+
+	//! Default constructor
+	grid_sm_invlin()
+	:size_tot(0)
+	{
+		for (size_t i = 0 ; i < N ; i++)
+		{
+			sz[i] = 0;
+			sz_div[i].init(0);
+		}
+	}
+
+	/*! \brief Construct the inverse linearizer of a grid
+	 *
+	 * \param gs grid info
+	 *
+	 */
+	template<typename T> grid_sm_invlin(const grid_sm<N,T> & gs)
+	{
+		setDimensions(gs);
+	}
+
+	/*! \brief Calculate the magic numbers for the grid gs
+	 *
+	 * \param gs grid info
+	 *
+	 */
+	template<typename T> void setDimensions(const grid_sm<N,T> & gs)
+	{
+		size_tot = gs.size();
+
+		for (size_t i = 0 ; i < N ; i++)
+		{
+			sz[i] = gs.size(i);
+			sz_div[i].init(sz[i]);
+		}
+	}
+
+	/*! \brief inversion of the linearization of the grid_key_dx
+	 *
+	 * \param id of the object
+	 * \return key of the grid that id identify
+	 *
+	 */
+	inline grid_key_dx<N> InvLinId(mem_id id) const
+	{
+		grid_key_dx<N> gk;
+		size_t idu = id;
+
+		for (size_t i = 0 ; i < N ; i++)
+		{
+			size_t q = sz_div[i].div(idu);
+			gk.set_d(i,idu - q*sz[i]);
+			idu = q;
+		}
+
+		return gk;
+	}
+
+	/*! \brief Construct the grid keys of an array of linearized ids
+	 *
+	 * When the grid has less than 2^32 points the 32 bit magic numbers are used and the loops
+	 * over the ids can be vectorized
+	 *
+	 * \param ids linearized ids
+	 * \param keys output keys (n elements)
+	 * \param n number of ids
+	 *
+	 */
+	template<typename ids_type>
+	inline void InvLinId(const mem_id * ids, grid_key_dx<N,ids_type> * keys, size_t n) const
+	{
+		if (size_tot >= ((size_t)1 << 32))
+		{
+			for (size_t j = 0 ; j < n ; j++)
+			{
+				size_t idu = ids[j];
+
+				for (size_t i = 0 ; i < N ; i++)
+				{
+					size_t q = sz_div[i].div(idu);
+					keys[j].set_d(i,idu - q*sz[i]);
+					idu = q;
+				}
+			}
+
+			return;
+		}
+
+		const size_t chunk = 256;
+		unsigned int idu[chunk];
+
+		for (size_t c = 0 ; c < n ; c += chunk)
+		{
+			size_t nc = (n - c < chunk)?(n - c):chunk;
+
+			for (size_t j = 0 ; j < nc ; j++)
+			{idu[j] = ids[c + j];}
+
+			for (size_t i = 0 ; i < N ; i++)
+			{
+				const openfpm::math::fast_div dv = sz_div[i];
+				const unsigned int d = sz[i];
+
+				#pragma omp simd
+				for (size_t j = 0 ; j < nc ; j++)
+				{
+					unsigned int q = dv.div32(idu[j]);
+					keys[c + j].set_d(i,idu[j] - q*d);
+					idu[j] = q;
+				}
+			}
+		}
+	}
+};
+
+#endif /* OPENFPM_DATA_SRC_GRID_GRID_SM_INVLIN_HPP_ */
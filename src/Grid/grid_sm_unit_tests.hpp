@@ -10,6 +10,7 @@
 
 #include "iterators/grid_key_dx_iterator_sub_bc.hpp"
 #include "grid_key_dx_iterator_hilbert.hpp"
+#include "grid_sm_invlin.hpp"
 
 BOOST_AUTO_TEST_SUITE( grid_sm_test )
 
@@ -45,6 +46,102 @@ BOOST_AUTO_TEST_CASE( grid_sm_linearization )
 }
 
 
+BOOST_AUTO_TEST_CASE( grid_sm_fast_div )
+{
+	bool match = true;
+	size_t r = 12345;
+
+	for (size_t d = 1 ; d < 2000 ; d++)
+	{
+		openfpm::math::fast_div fd;
+		fd.init(d);
+
+		for (size_t j = 0 ; j < 200 ; j++)
+		{
+			r = r * 6364136223846793005ul + 1442695040888963407ul;
+
+			size_t n = (j < 100)?(r >> (j % 64)):j;
+
+			match &= fd.div(n) == n / d;
+			match &= fd.div32((unsigned int)n) == (unsigned int)n / d;
+		}
+
+		match &= fd.div32(0xFFFFFFFF) == 0xFFFFFFFF / d;
+		match &= fd.div(0xFFFFFFFFFFFFFFFF) == 0xFFFFFFFFFFFFFFFF / d;
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+}
+
+template<unsigned int dim>
+void test_grid_sm_invlinid(const size_t (& sz)[dim])
+{
+	grid_sm<dim,void> gs(sz);
+
+	bool match = true;
+
+	std::vector<mem_id> ids;
+	size_t r = 54321;
+
+	for (size_t j = 0 ; j < 1000 ; j++)
+	{
+		r = r * 6364136223846793005ul + 1442695040888963407ul;
+		ids.push_back((r >> 11) % gs.size());
+	}
+
+	ids.push_back(0);
+	ids.push_back(gs.size() - 1);
+
+	grid_sm_invlin<dim> gi(gs);
+
+	for (size_t j = 0 ; j < ids.size() ; j++)
+	{
+		grid_key_dx<dim> key = gs.InvLinId(ids[j]);
+
+		for (size_t i = 0 ; i < dim ; i++)
+		{match &= key.get(i) >= 0 && key.get(i) < (long int)sz[i];}
+
+		match &= gs.LinId(key) == ids[j];
+		match &= gi.InvLinId(ids[j]) == key;
+	}
+
+	std::vector<grid_key_dx<dim>> keys(ids.size());
+	gi.InvLinId(&ids[0],&keys[0],ids.size());
+
+	for (size_t j = 0 ; j < ids.size() ; j++)
+	{match &= keys[j] == gs.InvLinId(ids[j]);}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+}
+
+BOOST_AUTO_TEST_CASE( grid_sm_inv_linearization )
+{
+	size_t sz1[3] = {37,21,19};
+	size_t sz2[3] = {64,32,16};
+	size_t sz3[3] = {64,13,128};
+	size_t sz4[2] = {1,1000};
+	size_t sz5[3] = {100000,70000,3};
+	size_t sz6[4] = {7,3,11,5};
+
+	test_grid_sm_invlinid<3>(sz1);
+	test_grid_sm_invlinid<3>(sz2);
+	test_grid_sm_invlinid<3>(sz3);
+	test_grid_sm_invlinid<2>(sz4);
+	test_grid_sm_invlinid<3>(sz5);
+	test_grid_sm_invlinid<4>(sz6);
+
+	// the inverse linearizer is rebuilt when the grid change
+	grid_sm<3,void> g1(sz1);
+	grid_sm<3,void> g2(sz3);
+	grid_sm_invlin<3> gi(g1);
+
+	grid_key_dx<3> k({5,7,9});
+	BOOST_REQUIRE(gi.InvLinId(g1.LinId(k)) == k);
+
+	gi.setDimensions(g2);
+	BOOST_REQUIRE(gi.InvLinId(g2.LinId(k)) == k);
+}
+
 BOOST_AUTO_TEST_CASE( grid_iterator_sub_p )
 {
 	const grid_key_dx<3> key1(4,4,4);
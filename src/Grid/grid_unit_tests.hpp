@@ -3,6 +3,7 @@
 
 #include "config.h"
 #include "map_grid.hpp"
+#include "grid_conv.hpp"
 #include "Point_test.hpp"
 #include "Space/Shape/HyperCube.hpp"
 #include "timer.hpp"
@@ -772,6 +773,556 @@ BOOST_AUTO_TEST_CASE(grid_resize_less)
 	BOOST_REQUIRE_EQUAL(g1.size(),25ul);
 }
 
+template<typename grid_type>
+void test_grid_resize_memcpy(const size_t (& sz1)[3], const size_t (& sz2)[3])
+{
+	grid_type g1(sz1);
+	g1.setMemory();
+
+	auto it = g1.getIterator();
+
+	while (it.isNext())
+	{
+		auto key = it.get();
+		size_t lin = g1.getGrid().LinId(key);
+
+		g1.template get<0>(key) = lin;
+		g1.template get<1>(key)[0] = lin + 1;
+		g1.template get<1>(key)[1] = lin + 2;
+		g1.template get<1>(key)[2] = lin + 3;
+
+		++it;
+	}
+
+	typename grid_type::linearizer_type g_old(sz1);
+
+	g1.resize(sz2);
+
+	bool match = true;
+
+	auto it2 = g1.getIterator();
+
+	while (it2.isNext())
+	{
+		auto key = it2.get();
+
+		if (key.get(0) < (long int)sz1[0] && key.get(1) < (long int)sz1[1] && key.get(2) < (long int)sz1[2])
+		{
+			size_t lin = g_old.LinId(key);
+
+			match &= g1.template get<0>(key) == lin;
+			match &= g1.template get<1>(key)[0] == lin + 1;
+			match &= g1.template get<1>(key)[1] == lin + 2;
+			match &= g1.template get<1>(key)[2] == lin + 3;
+		}
+
+		++it2;
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+}
+
+BOOST_AUTO_TEST_CASE(grid_resize_memcpy)
+{
+	typedef aggregate<size_t,size_t[3]> T;
+
+	size_t sz1[] = {33,17,20};
+	size_t sz_grow[] = {40,21,23};
+	size_t sz_mix[] = {20,30,9};
+	size_t sz_last[] = {33,17,64};
+
+	test_grid_resize_memcpy<grid_cpu<3,T>>(sz1,sz_grow);
+	test_grid_resize_memcpy<grid_cpu<3,T>>(sz1,sz_mix);
+	test_grid_resize_memcpy<grid_cpu<3,T>>(sz1,sz_last);
+
+	test_grid_resize_memcpy<grid_base<3,T,HeapMemory,typename memory_traits_inte<T>::type>>(sz1,sz_grow);
+	test_grid_resize_memcpy<grid_base<3,T,HeapMemory,typename memory_traits_inte<T>::type>>(sz1,sz_mix);
+	test_grid_resize_memcpy<grid_base<3,T,HeapMemory,typename memory_traits_inte<T>::type>>(sz1,sz_last);
+
+	test_grid_resize_memcpy<grid_cpu<3,T,grid_smt<3,8>>>(sz1,sz_grow);
+	test_grid_resize_memcpy<grid_cpu<3,T,grid_smt<3,8>>>(sz1,sz_mix);
+	test_grid_resize_memcpy<grid_base<3,T,HeapMemory,typename memory_traits_inte<T>::type,grid_smt<3,8>>>(sz1,sz_grow);
+	test_grid_resize_memcpy<grid_base<3,T,HeapMemory,typename memory_traits_inte<T>::type,grid_smt<3,8>>>(sz1,sz_last);
+}
+
+template<typename grid_type>
+void test_grid_smt_copy_to(const size_t (& sz_src)[3], const size_t (& sz_dst)[3], const Box<3,long int> & bx_src, const Box<3,long int> & bx_dst)
+{
+	grid_type g_src(sz_src);
+	grid_type g_dst(sz_dst);
+	g_src.setMemory();
+	g_dst.setMemory();
+
+	auto it = g_src.getIterator();
+
+	while (it.isNext())
+	{
+		auto key = it.get();
+		float val = key.get(0) + key.get(1)*100 + key.get(2)*10000;
+
+		g_src.template get<0>(key) = val;
+		g_src.template get<1>(key)[0] = val + 1;
+		g_src.template get<1>(key)[1] = val + 2;
+		g_src.template get<1>(key)[2] = val + 3;
+
+		++it;
+	}
+
+	auto it2 = g_dst.getIterator();
+
+	while (it2.isNext())
+	{
+		g_dst.template get<0>(it2.get()) = -1;
+		++it2;
+	}
+
+	g_dst.copy_to(g_src,bx_src,bx_dst);
+
+	bool match = true;
+	it2 = g_dst.getIterator();
+
+	while (it2.isNext())
+	{
+		auto key = it2.get();
+
+		if (bx_dst.isInsideKey(key) == true)
+		{
+			float val = key.get(0) - bx_dst.getLow(0) + bx_src.getLow(0) +
+					    (key.get(1) - bx_dst.getLow(1) + bx_src.getLow(1))*100 +
+						(key.get(2) - bx_dst.getLow(2) + bx_src.getLow(2))*10000;
+
+			match &= g_dst.template get<0>(key) == val;
+			match &= g_dst.template get<1>(key)[0] == val + 1;
+			match &= g_dst.template get<1>(key)[2] == val + 3;
+		}
+		else
+		{
+			match &= g_dst.template get<0>(key) == -1;
+		}
+
+		++it2;
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+}
+
+BOOST_AUTO_TEST_CASE( grid_use_smt )
+{
+	typedef aggregate<float,float[3]> T;
+
+	size_t sz[3] = {13,13,13};
+
+	// access, with a size that is not a multiple of the tile
+	{grid_cpu<3, Point_test<float>, grid_smt<3,4> > c3(sz);
+	c3.setMemory();
+	BOOST_REQUIRE_EQUAL(c3.getGrid().size(),16ul*16ul*16ul);
+	test_layout_grid3d(c3,13);}
+
+	{grid_base<3, Point_test<float>, HeapMemory, typename memory_traits_inte<Point_test<float>>::type, grid_smt<3,4> > c3(sz);
+	c3.setMemory();
+	test_layout_grid3d(c3,13);}
+
+	// the tile iterator visit every point once following the memory
+	grid_smt<3,4> gt(sz);
+	grid_key_dx<3> start({1,2,3});
+	grid_key_dx<3> stop({11,9,12});
+
+	auto it = gt.getTileSubIterator(start,stop);
+
+	size_t cnt = 0;
+	long int lin_prev = -1;
+	bool ordered = true;
+
+	while (it.isNext())
+	{
+		auto key = it.get();
+
+		for (size_t i = 0 ; i < 3 ; i++)
+		{ordered &= key.get(i) >= start.get(i) && key.get(i) <= stop.get(i);}
+
+		long int lin = gt.LinId(key);
+		ordered &= lin > lin_prev;
+		ordered &= gt.InvLinId(lin) == key;
+		lin_prev = lin;
+
+		cnt++;
+		++it;
+	}
+
+	BOOST_REQUIRE_EQUAL(ordered,true);
+	BOOST_REQUIRE_EQUAL(cnt,11ul*8ul*10ul);
+
+	// copy_to with a source not aligned to the tiles
+	size_t sz_src[3] = {30,21,19};
+	size_t sz_dst[3] = {27,29,17};
+	Box<3,long int> bx_src({3,1,2},{22,20,13});
+	Box<3,long int> bx_dst({5,8,0},{24,27,11});
+
+	test_grid_smt_copy_to<grid_cpu<3,T,grid_smt<3,8>>>(sz_src,sz_dst,bx_src,bx_dst);
+	test_grid_smt_copy_to<grid_base<3,T,HeapMemory,typename memory_traits_inte<T>::type,grid_smt<3,8>>>(sz_src,sz_dst,bx_src,bx_dst);
+
+	Box<3,long int> bx_src_a({8,0,8},{23,15,15});
+	Box<3,long int> bx_dst_a({0,8,0},{15,23,7});
+
+	test_grid_smt_copy_to<grid_base<3,T,HeapMemory,typename memory_traits_inte<T>::type,grid_smt<3,8>>>(sz_src,sz_dst,bx_src_a,bx_dst_a);
+}
+
+template<unsigned int dim>
+void test_grid_zm_iterator(const grid_key_dx<dim> & start, const grid_key_dx<dim> & stop)
+{
+	size_t sz[dim];
+	size_t vol = 1;
+	for (size_t i = 0 ; i < dim ; i++)
+	{
+		sz[i] = stop.get(i) + 3;
+		vol *= stop.get(i) - start.get(i) + 1;
+	}
+
+	grid_zm<dim,void> gz(sz);
+
+	auto it = gz.getMortonSubIterator(start,stop);
+
+	size_t cnt = 0;
+	long int lin_prev = -1;
+	bool ordered = true;
+
+	while (it.isNext())
+	{
+		auto key = it.get();
+
+		for (size_t i = 0 ; i < dim ; i++)
+		{ordered &= key.get(i) >= start.get(i) && key.get(i) <= stop.get(i);}
+
+		long int lin = gz.LinId(key);
+		ordered &= lin > lin_prev;
+		ordered &= lin == (long int)it.getLinId();
+		ordered &= gz.InvLinId(lin) == key;
+		lin_prev = lin;
+
+		cnt++;
+		++it;
+	}
+
+	BOOST_REQUIRE_EQUAL(ordered,true);
+	BOOST_REQUIRE_EQUAL(cnt,vol);
+}
+
+BOOST_AUTO_TEST_CASE( grid_use_zm )
+{
+	typedef aggregate<float,float[3]> T;
+
+	size_t sz[3] = {13,13,13};
+
+	// access, with a size that is not a power of two
+	{grid_cpu<3, Point_test<float>, grid_zm<3,void> > c3(sz);
+	c3.setMemory();
+	BOOST_REQUIRE_EQUAL(c3.getGrid().size(),c3.getGrid().LinId(grid_key_dx<3>({12,12,12})) + 1);
+	test_layout_grid3d(c3,13);}
+
+	{grid_base<3, Point_test<float>, HeapMemory, typename memory_traits_inte<Point_test<float>>::type, grid_zm<3,void> > c3(sz);
+	c3.setMemory();
+	test_layout_grid3d(c3,13);}
+
+	// the Morton iterator visit every point once following the memory
+	test_grid_zm_iterator<3>(grid_key_dx<3>({1,2,3}),grid_key_dx<3>({11,9,12}));
+	test_grid_zm_iterator<3>(grid_key_dx<3>({0,0,0}),grid_key_dx<3>({16,16,16}));
+	test_grid_zm_iterator<3>(grid_key_dx<3>({5,37,2}),grid_key_dx<3>({70,41,29}));
+	test_grid_zm_iterator<3>(grid_key_dx<3>({300,3,511}),grid_key_dx<3>({301,7,520}));
+	test_grid_zm_iterator<2>(grid_key_dx<2>({3,1}),grid_key_dx<2>({100,33}));
+	test_grid_zm_iterator<2>(grid_key_dx<2>({0,0}),grid_key_dx<2>({0,0}));
+
+	// copy_to and resize
+	size_t sz_src[3] = {30,21,19};
+	size_t sz_dst[3] = {27,29,17};
+	Box<3,long int> bx_src({3,1,2},{22,20,13});
+	Box<3,long int> bx_dst({5,8,0},{24,27,11});
+
+	test_grid_smt_copy_to<grid_cpu<3,T,grid_zm<3,void>>>(sz_src,sz_dst,bx_src,bx_dst);
+	test_grid_smt_copy_to<grid_base<3,T,HeapMemory,typename memory_traits_inte<T>::type,grid_zm<3,void>>>(sz_src,sz_dst,bx_src,bx_dst);
+
+	typedef aggregate<size_t,size_t[3]> Ts;
+	size_t sz1[] = {33,17,20};
+	size_t sz_grow[] = {40,21,23};
+	size_t sz_mix[] = {20,30,9};
+
+	test_grid_resize_memcpy<grid_cpu<3,Ts,grid_zm<3,void>>>(sz1,sz_grow);
+	test_grid_resize_memcpy<grid_base<3,Ts,HeapMemory,typename memory_traits_inte<Ts>::type,grid_zm<3,void>>>(sz1,sz_mix);
+
+	// pack and unpack
+	typedef grid_cpu<3,T,grid_zm<3,void>> grid_z;
+
+	grid_z g(sz_src);
+	g.setMemory();
+
+	auto it = g.getIterator();
+
+	while (it.isNext())
+	{
+		auto key = it.get();
+
+		g.template get<0>(key) = key.get(0) + key.get(1)*100 + key.get(2)*10000;
+		g.template get<1>(key)[1] = key.get(0);
+
+		++it;
+	}
+
+	size_t req = 0;
+	g.template packRequest<>(req);
+
+	HeapMemory pmem;
+	pmem.allocate(req);
+	ExtPreAlloc<HeapMemory> & mem = *(new ExtPreAlloc<HeapMemory>(req,pmem));
+	mem.incRef();
+
+	Pack_stat sts;
+	g.template pack<>(mem,sts);
+
+	Unpack_stat ps;
+	grid_z g2;
+	g2.template unpack<>(mem,ps);
+
+	bool match = true;
+	auto it2 = g.getIterator();
+
+	while (it2.isNext())
+	{
+		auto key = it2.get();
+
+		match &= g2.template get<0>(key) == g.template get<0>(key);
+		match &= g2.template get<1>(key)[1] == g.template get<1>(key)[1];
+
+		++it2;
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+	BOOST_REQUIRE_EQUAL(g2.getGrid().size(1),sz_src[1]);
+
+	mem.decRef();
+	delete &mem;
+}
+
+template<typename stencil, typename grid_type>
+void test_grid_conv(const size_t (& sz)[grid_type::dims], const grid_key_dx<grid_type::dims> & start, const grid_key_dx<grid_type::dims> & stop)
+{
+	constexpr unsigned int dim = grid_type::dims;
+	typedef typename boost::mpl::at<typename grid_type::value_type::type,boost::mpl::int_<0>>::type prop_type;
+
+	grid_type g(sz);
+	g.setMemory();
+
+	// quadratic field, exactly representable
+	auto it = g.getIterator();
+
+	while (it.isNext())
+	{
+		auto key = it.get();
+
+		prop_type val = 0;
+		for (size_t i = 0 ; i < dim ; i++)
+		{val += (i+1)*key.get(i)*key.get(i);}
+
+		g.template get<0>(key) = val;
+		g.template get<1>(key) = -1;
+
+		++it;
+	}
+
+	// different weight for each stencil point
+	prop_type w[stencil::nsp];
+	for (size_t s = 0 ; s < stencil::nsp ; s++)
+	{w[s] = s + 1;}
+
+	g.template conv<stencil,0,1>(start,stop,[](Vc::Vector<prop_type> (& xs)[stencil::nsp], prop_type * w)
+	                                         {
+	                                         	Vc::Vector<prop_type> res = w[0]*xs[0];
+	                                         	for (size_t s = 1 ; s < stencil::nsp ; s++)
+	                                         	{res += w[s]*xs[s];}
+	                                         	return res;
+	                                         },(prop_type *)w);
+
+	bool match = true;
+	auto it2 = g.getIterator();
+
+	while (it2.isNext())
+	{
+		auto key = it2.get();
+
+		bool inside = true;
+		for (size_t i = 0 ; i < dim ; i++)
+		{inside &= key.get(i) >= start.get(i) && key.get(i) <= stop.get(i);}
+
+		prop_type ref = -1;
+
+		if (inside == true)
+		{
+			ref = 0;
+			for (size_t s = 0 ; s < stencil::nsp ; s++)
+			{
+				grid_key_dx<dim> kn = key;
+				for (size_t i = 0 ; i < dim ; i++)
+				{kn.set_d(i,key.get(i) + stencil::get(s,i));}
+
+				ref += w[s]*g.template get<0>(kn);
+			}
+		}
+
+		match &= g.template get<1>(key) == ref;
+
+		++it2;
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+}
+
+BOOST_AUTO_TEST_CASE( grid_conv_stencil )
+{
+	typedef aggregate<float,float> T;
+	typedef aggregate<double,double> Td;
+
+	typedef grid_cpu<3,T> g3_lin;
+	typedef grid_base<3,T,HeapMemory,typename memory_traits_inte<T>::type> g3_inte;
+	typedef grid_base<3,Td,HeapMemory,typename memory_traits_inte<Td>::type> g3_inte_d;
+
+	// the x extension is not a multiple of the vector size
+	size_t sz3[3] = {37,21,19};
+	grid_key_dx<3> start3({1,1,1});
+	grid_key_dx<3> stop3({35,19,17});
+
+	test_grid_conv<stencil_3D_7p,g3_lin>(sz3,start3,stop3);
+	test_grid_conv<stencil_3D_7p,g3_inte>(sz3,start3,stop3);
+	test_grid_conv<stencil_3D_19p,g3_inte>(sz3,start3,stop3);
+	test_grid_conv<stencil_3D_27p,g3_inte>(sz3,start3,stop3);
+	test_grid_conv<stencil_3D_27p,g3_lin>(sz3,start3,stop3);
+	test_grid_conv<stencil_3D_19p,g3_inte_d>(sz3,start3,stop3);
+
+	// large enough to be split across threads
+	size_t sz3l[3] = {45,40,40};
+	grid_key_dx<3> stop3l({43,38,38});
+	test_grid_conv<stencil_3D_7p,g3_inte>(sz3l,start3,stop3l);
+
+	// sub-box with a row shorter than the vector size
+	grid_key_dx<3> start3s({4,3,2});
+	grid_key_dx<3> stop3s({6,10,12});
+	test_grid_conv<stencil_3D_27p,g3_inte>(sz3,start3s,stop3s);
+
+	typedef grid_cpu<2,T> g2_lin;
+	typedef grid_base<2,T,HeapMemory,typename memory_traits_inte<T>::type> g2_inte;
+
+	size_t sz2[2] = {83,29};
+	grid_key_dx<2> start2({1,1});
+	grid_key_dx<2> stop2({81,27});
+
+	test_grid_conv<stencil_2D_5p,g2_lin>(sz2,start2,stop2);
+	test_grid_conv<stencil_2D_5p,g2_inte>(sz2,start2,stop2);
+}
+
+template<typename grid_type>
+void test_grid_expression()
+{
+	size_t sz[3] = {37,40,21};
+
+	grid_type g(sz);
+	g.setMemory();
+	grid_type g2(sz);
+	g2.setMemory();
+
+	auto it = g.getIterator();
+
+	while (it.isNext())
+	{
+		auto key = it.get();
+
+		g.template get<1>(key) = key.get(0) + 2*key.get(1);
+		g.template get<2>(key) = key.get(2) + 1;
+		g2.template get<0>(key) = key.get(0);
+
+		++it;
+	}
+
+	float a = 3.0;
+
+	// full grid
+	g.template prop<0>() = a * g.template prop<1>() + g.template prop<2>() / 2.0f - g2.template prop<0>();
+
+	bool match = true;
+	auto it2 = g.getIterator();
+
+	while (it2.isNext())
+	{
+		auto key = it2.get();
+
+		match &= g.template get<0>(key) == a * g.template get<1>(key) + g.template get<2>(key) / 2.0f - g2.template get<0>(key);
+
+		++it2;
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+
+	// the destination appear in the expression, box assignment
+	grid_key_dx<3> start({3,5,7});
+	grid_key_dx<3> stop({30,31,12});
+
+	g2.template prop<1>() = 1.0f;
+	g.template prop<0>(start,stop) = -g.template prop<0>() + g2.template prop<1>();
+
+	auto it3 = g.getIterator();
+
+	while (it3.isNext())
+	{
+		auto key = it3.get();
+
+		float v = a * g.template get<1>(key) + g.template get<2>(key) / 2.0f - g2.template get<0>(key);
+
+		bool in = true;
+		for (size_t i = 0 ; i < 3 ; i++)
+		{in &= key.get(i) >= start.get(i) && key.get(i) <= stop.get(i);}
+
+		match &= g.template get<0>(key) == ((in == true)?(-v + 1.0f):v);
+
+		++it3;
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+
+	// copy of the same property
+	g2.template prop<2>() = g.template prop<2>();
+
+	const grid_type & g_c = g;
+	g2.template prop<1>() = g_c.template prop<1>() * 2;
+
+	auto it4 = g.getIterator();
+
+	while (it4.isNext())
+	{
+		auto key = it4.get();
+
+		match &= g2.template get<2>(key) == g.template get<2>(key);
+		match &= g2.template get<1>(key) == 2*g.template get<1>(key);
+
+		++it4;
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+
+	// grids of different size are not evaluated
+	size_t sz_o[3] = {10,10,10};
+	grid_type g3(sz_o);
+	g3.setMemory();
+
+	float old = g.template get<2>(start);
+	g.template prop<2>() = g3.template prop<1>();
+
+	BOOST_REQUIRE_EQUAL(g.template get<2>(start),old);
+}
+
+BOOST_AUTO_TEST_CASE( grid_expression_test )
+{
+	typedef aggregate<float,float,float> T;
+
+	test_grid_expression<grid_cpu<3,T>>();
+	test_grid_expression<grid_base<3,T,HeapMemory,typename memory_traits_inte<T>::type>>();
+}
+
 BOOST_AUTO_TEST_CASE(copy_encap_vector_fusion_test)
 {
 	size_t sz2[] = {5,5};
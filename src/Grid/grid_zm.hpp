@@ -8,10 +8,21 @@
 #ifndef GRID_ZM_HPP_
 #define GRID_ZM_HPP_
 
+#include <type_traits>
 #include "util/zmorton.hpp"
 
+template<unsigned int dim> class grid_key_dx_iterator_zm;
+
 /*! \brief class that store the information of the grid like number of point on each direction and
- *  define the index linearization by stride
+ *  define the index linearization by Z-order (Morton) curve
+ *
+ * Used as linearizer of grid_base_impl the points are stored in Morton order, points close in space
+ * are close in memory in all directions. When the grid is not a power of two on each direction the
+ * storage is padded up to the Morton index of the last point
+ *
+ * \code{.cpp}
+ * grid_cpu<3,aggregate<float>,grid_zm<3,void>> g(sz);
+ * \endcode
  *
  * \param N dimensionality
  * \param T type of object is going to store the grid
@@ -20,6 +31,30 @@
 template<unsigned int N, typename T>
 class grid_zm : private grid_sm<N,T>
 {
+	//! number of elements to allocate (Morton index of the last point + 1)
+	size_t sz_zm;
+
+	/*! \brief Calculate the number of elements to allocate
+	 *
+	 */
+	inline void set_size_zm()
+	{
+		grid_key_dx<N> last;
+
+		for (size_t i = 0 ; i < N ; i++)
+		{
+			if (size(i) == 0)
+			{
+				sz_zm = 0;
+				return;
+			}
+
+			last.set_d(i,size(i) - 1);
+		}
+
+		// the Morton index grow on each direction, the last point has the biggest index
+		sz_zm = lin_zid(last) + 1;
+	}
 
 public:
 
@@ -32,9 +67,12 @@ public:
 	inline void setDimensions(const size_t  (& dims)[N])
 	{
 		((grid_sm<N,T> *)this)->setDimensions(dims);
+		set_size_zm();
 	}
 
-	grid_zm(){};
+	grid_zm()
+	:sz_zm(0)
+	{};
 
 	/*! \brief construct a grid from another grid
 	 *
@@ -46,7 +84,7 @@ public:
 
 	template<typename S> inline grid_zm(const grid_zm<N,S> & g)
 	{
-		this->setDimensions(this->getSize());
+		this->setDimensions(g.getSize());
 	}
 
 
@@ -60,7 +98,9 @@ public:
 
 	inline grid_zm(const size_t & sz)
 	:grid_sm<N,T>(sz)
-	{}
+	{
+		set_size_zm();
+	}
 
 	/*! \brief Construct a grid of a specified size
 	 *
@@ -78,6 +118,16 @@ public:
 	//! Destructor
 	~grid_zm() {};
 
+	/*! \brief It return false if this linearizer does not contain pointers
+	 *
+	 * \return false
+	 *
+	 */
+	static bool noPointers()
+	{
+		return true;
+	}
+
 	/*! \brief Linearization of the grid_key_dx
 	 *
 	 * Linearization of the grid_key_dx given a key, it spit out a number that is just the 1D linearization
@@ -91,6 +141,21 @@ public:
 		return lin_zid(gk);
 	}
 
+	/*! \brief Construct the grid key from the Morton index
+	 *
+	 * \param id Morton index
+	 *
+	 * \return the grid key
+	 *
+	 */
+	inline grid_key_dx<N> InvLinId(mem_id id) const
+	{
+		grid_key_dx<N> key;
+		invlin_zid(id,key);
+
+		return key;
+	}
+
 
 	/*! \brief Copy the grid from another grid
 	 *
@@ -101,6 +166,7 @@ public:
 	__device__ __host__ inline grid_zm<N,T> & operator=(const grid_zm<N,T> & g)
 	{
 		((grid_sm<N,T> *)this)->operator=(g);
+		sz_zm = g.sz_zm;
 
 		return *this;
 	}
@@ -113,7 +179,7 @@ public:
 	 *
 	 */
 
-	inline bool operator==(const grid_zm<N,T> & g)
+	inline bool operator==(const grid_zm<N,T> & g) const
 	{
 		return ((grid_sm<N,T> *)this)->operator==(g);
 	}
@@ -124,7 +190,7 @@ public:
 	 *
 	 */
 
-	inline bool operator!=(const grid_zm<N,T> & g)
+	inline bool operator!=(const grid_zm<N,T> & g) const
 	{
 		return ((grid_sm<N,T> *)this)->operator!=(g);
 	}
@@ -137,6 +203,10 @@ public:
 	inline void swap(grid_zm<N,T> & g)
 	{
 		((grid_sm<N,T> *)this)->swap(g);
+
+		size_t tmp = sz_zm;
+		sz_zm = g.sz_zm;
+		g.sz_zm = tmp;
 	}
 
 	/**
@@ -154,19 +224,265 @@ public:
 
 	/**
 	 *
-	 * Get the total size of the grid
+	 * Get the number of elements to allocate, it include the padding when the sizes are not power of two
 	 *
-	 * \return the total size on the grid
+	 * \return the number of elements to allocate
 	 *
 	 */
 	inline size_t size() const
 	{
-		return ((grid_sm<N,T> *)this)->size();
+		return sz_zm;
+	}
+
+	/*! \brief Return the size of the grid
+	 *
+	 * \return the size of the grid on each direction
+	 *
+	 */
+	inline const size_t (& getSize() const)[N]
+	{
+		return ((grid_sm<N,T> *)this)->getSize();
+	}
+
+	/*! \brief Return the box enclosing the grid
+	 *
+	 * \return the box
+	 *
+	 */
+	inline const Box<N,size_t> getBox() const
+	{
+		return ((grid_sm<N,T> *)this)->getBox();
+	}
+
+	/*! \brief Return a sub-grid iterator (row major order)
+	 *
+	 * \param start start point
+	 * \param stop stop point
+	 *
+	 * \return a sub-grid iterator
+	 *
+	 */
+	inline grid_key_dx_iterator_sub<N> getSubIterator(const grid_key_dx<N> & start, const grid_key_dx<N> & stop) const
+	{
+		return ((grid_sm<N,T> *)this)->getSubIterator(start,stop);
+	}
+
+	/*! \brief Return an iterator that visit the grid in Morton order (the order of the memory)
+	 *
+	 * \return the iterator
+	 *
+	 */
+	inline grid_key_dx_iterator_zm<N> getMortonIterator() const
+	{
+		grid_key_dx<N> start;
+		grid_key_dx<N> stop;
+
+		for (size_t i = 0 ; i < N ; i++)
+		{
+			start.set_d(i,0);
+			stop.set_d(i,(long int)size(i) - 1);
+		}
+
+		return grid_key_dx_iterator_zm<N>(start,stop);
+	}
+
+	/*! \brief Return an iterator that visit the box [start,stop] in Morton order
+	 *
+	 * \param start start point
+	 * \param stop stop point
+	 *
+	 * \return the iterator
+	 *
+	 */
+	inline grid_key_dx_iterator_zm<N> getMortonSubIterator(const grid_key_dx<N> & start, const grid_key_dx<N> & stop) const
+	{
+		return grid_key_dx_iterator_zm<N>(start,stop);
 	}
 
 	//!  It simply mean that all the classes grid are friend of all its specialization
 	template <unsigned int,typename> friend class grid_zm;
 };
 
+/*! \brief Iterate the points of a box in Morton (Z-order) order
+ *
+ * The Morton index and the key are updated incrementally. Going from the index m to m + 2^(dim*l)
+ * the bits below the first zero bit t of m (from the position dim*l) are cleared and the bit t is set,
+ * the same happen to the bits of the coordinates, so no interleaving or de-interleaving is needed.
+ * Aligned blocks of 2^l points per direction that are outside the box are skipped at once
+ *
+ * \tparam dim dimensionality
+ *
+ */
+template<unsigned int dim>
+class grid_key_dx_iterator_zm
+{
+	//! start of the box
+	grid_key_dx<dim> start;
+
+	//! stop of the box
+	grid_key_dx<dim> stop;
+
+	//! current point
+	grid_key_dx<dim> key;
+
+	//! current Morton index
+	size_t m;
+
+	//! Morton index after the last point of the box
+	size_t m_end;
+
+	//! biggest block level (2^lmax points per direction cover the box)
+	size_t lmax;
+
+	/*! \brief Move to the block that follow the block of level lvl starting at m
+	 *
+	 * \param lvl level of the block
+	 *
+	 */
+	inline void advance(size_t lvl)
+	{
+		size_t sh = dim*lvl;
+		size_t t = __builtin_ctzl(~(m >> sh)) + sh;
+
+		m += (size_t)1 << sh;
+
+		// the bits of the index below t are cleared and t is set, same for the coordinates
+		for (size_t d = 0 ; d < dim ; d++)
+		{
+			size_t nl = (t > d)?(t - d + dim - 1) / dim:0;
+			key.set_d(d,key.get(d) & ~(((long int)1 << nl) - 1));
+		}
+
+		key.set_d(t % dim,key.get(t % dim) | ((long int)1 << (t / dim)));
+	}
+
+	/*! \brief Level of the biggest block starting at m
+	 *
+	 * \return the level
+	 *
+	 */
+	inline size_t level() const
+	{
+		if (m == 0)	{return lmax;}
+
+		size_t lvl = __builtin_ctzl(m) / dim;
+		return (lvl < lmax)?lvl:lmax;
+	}
+
+	/*! \brief From the current position find the first point inside the box
+	 *
+	 * \param lvl level of the block starting at m
+	 *
+	 */
+	inline void find(size_t lvl)
+	{
+		while (m < m_end)
+		{
+			bool inside = true;
+			long int bs = ((long int)1 << lvl) - 1;
+
+			for (size_t i = 0 ; i < dim ; i++)
+			{inside &= key.get(i) <= stop.get(i) && key.get(i) + bs >= start.get(i);}
+
+			if (inside == true)
+			{
+				if (lvl == 0)	{return;}
+
+				// descend in the first sub-block
+				lvl--;
+			}
+			else
+			{
+				advance(lvl);
+				lvl = level();
+			}
+		}
+	}
+
+public:
+
+	/*! \brief Iterate the box [start,stop]
+	 *
+	 * \param start start point
+	 * \param stop stop point
+	 *
+	 */
+	grid_key_dx_iterator_zm(const grid_key_dx<dim> & start, const grid_key_dx<dim> & stop)
+	:start(start),stop(stop),m(0),m_end(0),lmax(0)
+	{
+		key.zero();
+
+		long int max_c = 0;
+		for (size_t i = 0 ; i < dim ; i++)
+		{
+			if (stop.get(i) < start.get(i) || start.get(i) < 0)	{return;}
+
+			max_c = (stop.get(i) > max_c)?stop.get(i):max_c;
+		}
+
+		while (((long int)1 << lmax) <= max_c)	{lmax++;}
+
+		m_end = lin_zid(stop) + 1;
+
+		find(lmax);
+	}
+
+	/*! \brief Get the next point
+	 *
+	 * \return itself
+	 *
+	 */
+	inline grid_key_dx_iterator_zm<dim> & operator++()
+	{
+		advance(0);
+		find(level());
+
+		return *this;
+	}
+
+	/*! \brief Check if there is a next point
+	 *
+	 * \return true if there is a next point
+	 *
+	 */
+	inline bool isNext() const
+	{
+		return m < m_end;
+	}
+
+	/*! \brief Get the current point
+	 *
+	 * \return the key of the point
+	 *
+	 */
+	inline const grid_key_dx<dim> & get() const
+	{
+		return key;
+	}
+
+	/*! \brief Get the Morton index of the current point (the linearized id in a grid_zm)
+	 *
+	 * \return the Morton index
+	 *
+	 */
+	inline size_t getLinId() const
+	{
+		return m;
+	}
+};
+
+/*! \brief Check if a linearizer is a Morton linearizer
+ *
+ * \tparam T linearizer
+ *
+ */
+template<typename T>
+struct is_grid_zm: public std::false_type
+{};
+
+//! Specialization for grid_zm
+template<unsigned int N, typename T>
+struct is_grid_zm<grid_zm<N,T>>: public std::true_type
+{};
 
 #endif /* GRID_ZM_HPP_ */
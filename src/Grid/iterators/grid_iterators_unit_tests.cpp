@@ -11,6 +11,7 @@
 #include "Grid/map_grid.hpp"
 #include "data_type/aggregate.hpp"
 #include "Grid/iterators/grid_key_dx_iterator_sub_bc.hpp"
+#include "Grid/iterators/grid_temporal_blocking.hpp"
 
 BOOST_AUTO_TEST_SUITE( grid_iterators_tests )
 
@@ -220,6 +221,223 @@ BOOST_AUTO_TEST_CASE( grid_iterator_sub_stencil_test )
 
 
 
+BOOST_AUTO_TEST_CASE( grid_iterator_sub_split )
+{
+	size_t sz[] = {20,17,11};
+	grid_sm<3,void> g_sm(sz);
+
+	grid_key_dx<3> start({1,2,3});
+	grid_key_dx<3> stop({18,15,7});
+
+	size_t n_split[] = {1,3,5,7,64};
+
+	for (size_t s = 0 ; s < sizeof(n_split)/sizeof(size_t) ; s++)
+	{
+		grid_cpu<3,aggregate<int>> cnt(sz);
+		cnt.setMemory();
+		cnt.fill<0>(0);
+
+		grid_key_dx_iterator_sub<3,stencil_offset_compute<3,7>> gsi(g_sm,start,stop,star_stencil_3D);
+
+		auto its = gsi.split(n_split[s]);
+
+		BOOST_REQUIRE_EQUAL(its.size(),n_split[s]);
+
+		bool ret = true;
+
+		for (size_t i = 0 ; i < its.size() ; i++)
+		{
+			while (its[i].isNext())
+			{
+				auto key = its[i].get();
+
+				cnt.template get<0>(key) += 1;
+
+				// the stencil offsets are correct for every sub-iterator
+				ret &= g_sm.LinId(key) == (long int)its[i].getStencil<0>();
+				ret &= g_sm.LinId(key.move(2,-1)) == (long int)its[i].getStencil<1>();
+				ret &= g_sm.LinId(key.move(0,1)) == (long int)its[i].getStencil<6>();
+
+				++its[i];
+			}
+		}
+
+		auto it = cnt.getIterator();
+
+		while (it.isNext())
+		{
+			auto key = it.get();
+
+			bool inside = true;
+			for (size_t i = 0 ; i < 3 ; i++)
+			{inside &= key.get(i) >= start.get(i) && key.get(i) <= stop.get(i);}
+
+			ret &= cnt.template get<0>(key) == ((inside)?1:0);
+
+			++it;
+		}
+
+		BOOST_REQUIRE_EQUAL(ret,true);
+	}
+
+	// split in 0 parts return the full iterator
+
+	grid_key_dx_iterator_sub<3,stencil_offset_compute<3,7>> gsi(g_sm,start,stop,star_stencil_3D);
+
+	auto its = gsi.split(0);
+
+	BOOST_REQUIRE_EQUAL(its.size(),1ul);
+
+	size_t n_pnt = 0;
+
+	while (its[0].isNext())
+	{
+		n_pnt++;
+		++its[0];
+	}
+
+	BOOST_REQUIRE_EQUAL(n_pnt,18ul*14ul*5ul);
+}
+
+BOOST_AUTO_TEST_CASE( grid_parallel_for_test )
+{
+	size_t sz[] = {52,52,52};
+
+	grid_cpu<3,aggregate<long int>> gtest(sz);
+	grid_cpu<3,aggregate<long int>> glap(sz);
+	gtest.setMemory();
+	glap.setMemory();
+
+	Box<3,long int> domain({0,0,0},{51,51,51});
+
+	parallel_for(gtest,domain,[&](const grid_key_dx<3> & key)
+	{
+		gtest.template get<0>(key) = key.get(0) + key.get(1) + key.get(2);
+		glap.template get<0>(key) = -1;
+	});
+
+	Box<3,long int> inner({1,1,1},{50,50,50});
+
+	parallel_for(gtest,inner,star_stencil_3D,[&](const grid_key_dx<3> & key, grid_key_dx_iterator_sub<3,stencil_offset_compute<3,7>> & it)
+	{
+		glap.template get<0>(key) = 6*gtest.template get<0>(it.getStencil<0>()) -
+				                    gtest.template get<0>(it.getStencil<1>()) -
+				                    gtest.template get<0>(it.getStencil<2>()) -
+				                    gtest.template get<0>(it.getStencil<3>()) -
+				                    gtest.template get<0>(it.getStencil<4>()) -
+				                    gtest.template get<0>(it.getStencil<5>()) -
+				                    gtest.template get<0>(it.getStencil<6>());
+	});
+
+	bool ret = true;
+	auto it = glap.getIterator();
+
+	while (it.isNext())
+	{
+		auto key = it.get();
+
+		ret &= glap.template get<0>(key) == ((inner.isInsideKey(key) == true)?0:-1);
+
+		++it;
+	}
+
+	BOOST_REQUIRE_EQUAL(ret,true);
+}
+
+template<typename grid_type>
+void test_temporal_blocking(size_t n_sweep, long int radius, size_t tile)
+{
+	size_t sz[] = {23,19,37};
+
+	grid_type g_a(sz);
+	grid_type g_b(sz);
+	grid_type g_ref(sz);
+	grid_type g_ref2(sz);
+	g_a.setMemory();
+	g_b.setMemory();
+	g_ref.setMemory();
+	g_ref2.setMemory();
+
+	auto it = g_a.getIterator();
+
+	while (it.isNext())
+	{
+		auto key = it.get();
+
+		g_a.template get<0>(key) = (key.get(0)*7 + key.get(1)*13 + key.get(2)*key.get(2)) % 17;
+		g_b.template get<0>(key) = -1.0;
+		g_ref.template get<0>(key) = g_a.template get<0>(key);
+		g_ref2.template get<0>(key) = g_a.template get<0>(key);
+
+		++it;
+	}
+
+	Box<3,long int> domain({radius,radius,radius},{(long int)sz[0]-1-radius,(long int)sz[1]-1-radius,(long int)sz[2]-1-radius});
+
+	// star stencil of the given radius
+	auto jacobi = [radius](const grid_type & src, grid_type & dst, const grid_key_dx<3> & key)
+	{
+		double sum = src.template get<0>(key);
+
+		for (size_t i = 0 ; i < 3 ; i++)
+		{
+			for (long int r = 1 ; r <= radius ; r++)
+			{sum += src.template get<0>(key.move(i,r)) + src.template get<0>(key.move(i,-r));}
+		}
+
+		dst.template get<0>(key) = sum / (6*radius + 1);
+	};
+
+	grid_type & res = temporal_blocking(g_a,g_b,domain,radius,n_sweep,jacobi,tile);
+
+	BOOST_REQUIRE_EQUAL(&res,(n_sweep % 2 == 0)?&g_a:&g_b);
+
+	// reference, one full sweep after the other
+	grid_type * gr[2] = {&g_ref,&g_ref2};
+
+	for (size_t s = 0 ; s < n_sweep ; s++)
+	{
+		auto it2 = g_ref.getSubIterator(domain.getKP1(),domain.getKP2());
+
+		while (it2.isNext())
+		{
+			jacobi(*gr[s % 2],*gr[(s + 1) % 2],it2.get());
+
+			++it2;
+		}
+	}
+
+	bool match = true;
+	auto it3 = res.getIterator();
+
+	while (it3.isNext())
+	{
+		auto key = it3.get();
+
+		match &= res.template get<0>(key) == gr[n_sweep % 2]->template get<0>(key);
+
+		++it3;
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+}
+
+BOOST_AUTO_TEST_CASE( grid_temporal_blocking_test )
+{
+	typedef grid_cpu<3,aggregate<double>> grid_type;
+
+	test_temporal_blocking<grid_type>(1,1,4);
+	test_temporal_blocking<grid_type>(4,1,1);
+	test_temporal_blocking<grid_type>(5,1,3);
+	test_temporal_blocking<grid_type>(6,1,0);
+	test_temporal_blocking<grid_type>(3,2,5);
+	test_temporal_blocking<grid_type>(7,2,100);
+
+	// the wavefront does not fit in the cache, the tile is clamped to 1
+	test_temporal_blocking<grid_type>(80,2,0);
+	test_temporal_blocking<grid_cpu<3,aggregate<double>,grid_smt<3,4>>>(5,1,3);
+}
+
 BOOST_AUTO_TEST_CASE( grid_iterator_sub_bc )
 {
 	{
@@ -8,8 +8,10 @@
 #ifndef OPENFPM_DATA_SRC_GRID_ITERATORS_GRID_KEY_DX_ITERATOR_SUB_HPP_
 #define OPENFPM_DATA_SRC_GRID_ITERATORS_GRID_KEY_DX_ITERATOR_SUB_HPP_
 
+#include <vector>
 #include "grid_key_dx_iterator.hpp"
 #include "Grid/grid_key.hpp"
+#include "util/openmp_util.hpp"
 
 /* \brief grid_key_dx_iterator_sub can adjust the domain if the border go out-of-side
  *        in this case a warning is produced
@@ -658,6 +660,85 @@ public:
 		this->initialized = true;
 #endif
 	}
+
+	/*! \brief Split the iterator into n sub-iterators
+	 *
+	 * The box is divided along the outermost direction that has at least n points (the longest
+	 * direction if no one has), the sub-iterators get a balanced number of slices and together
+	 * they cover every point of this iterator exactly once. Each sub-iterator start from the
+	 * beginning of its part with the stencil offsets recalculated, so they can be consumed
+	 * independently (for example one for each thread). If there are more sub-iterators than slices
+	 * the exceeding ones are empty
+	 *
+	 * \param n number of sub-iterators (with 0 the iterator is not split)
+	 *
+	 * \return the sub-iterators
+	 *
+	 */
+	std::vector<grid_key_dx_iterator_sub<dim,stencil,linearizer,warn>> split(size_t n) const
+	{
+		std::vector<grid_key_dx_iterator_sub<dim,stencil,linearizer,warn>> its;
+
+		if (n == 0)
+		{
+			std::cerr << "Error " << __FILE__ << ":" << __LINE__ << " an iterator cannot be split in 0 parts, it is not split" << std::endl;
+			n = 1;
+		}
+
+		bool empty = false;
+		size_t ext[dim];
+
+		for (size_t i = 0 ; i < dim ; i++)
+		{
+			if (gk_stop.get(i) < gk_start.get(i))
+			{
+				empty = true;
+				ext[i] = 0;
+			}
+			else
+			{ext[i] = gk_stop.get(i) - gk_start.get(i) + 1;}
+		}
+
+		// direction to split
+		long int d = dim - 1;
+		for ( ; d >= 0 ; d--)
+		{
+			if (ext[d] >= n)	{break;}
+		}
+
+		if (d < 0)
+		{
+			d = dim - 1;
+			for (long int i = dim - 1 ; i >= 0 ; i--)
+			{
+				if (ext[i] > ext[d])	{d = i;}
+			}
+		}
+
+		for (size_t k = 0 ; k < n ; k++)
+		{
+			its.push_back(*this);
+			grid_key_dx_iterator_sub<dim,stencil,linearizer,warn> & it = its.back();
+
+			size_t start;
+			size_t stop;
+			openfpm_omp_static_range(ext[d],n,k,start,stop);
+
+			if (empty == true || start == stop)
+			{
+				it.invalidate();
+				continue;
+			}
+
+			it.gk_start.set_d(d,gk_start.get(d) + start);
+			it.gk_stop.set_d(d,gk_start.get(d) + stop - 1);
+
+			it.Initialize();
+			it.calc_stencil_offset(it.gk);
+		}
+
+		return its;
+	}
 };
 
 
@@ -0,0 +1,132 @@
+/*
+ * grid_parallel_for.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Pietro Incardona
+ */
+
+#ifndef OPENFPM_DATA_SRC_GRID_ITERATORS_GRID_PARALLEL_FOR_HPP_
+#define OPENFPM_DATA_SRC_GRID_ITERATORS_GRID_PARALLEL_FOR_HPP_
+
+#include "grid_key_dx_iterator_sub.hpp"
+#include "util/openmp_util.hpp"
+
+/*! \brief Run the sub-iterators produced by split on the threads
+ *
+ * \param its sub-iterators
+ * \param n_ele number of points covered by the sub-iterators
+ * \param f function to call for each point, it receive the sub-iterator positioned on the point
+ *
+ */
+template<typename it_type, typename lambda_f>
+inline void parallel_for_run(std::vector<it_type> & its, size_t n_ele, lambda_f & f)
+{
+	#pragma omp parallel for schedule(static,1) if (n_ele >= OPENFPM_OMP_MIN_ELEMENTS && its.size() > 1)
+	for (long int t = 0 ; t < (long int)its.size() ; t++)
+	{
+		it_type & it = its[t];
+
+		while (it.isNext())
+		{
+			f(it);
+
+			++it;
+		}
+	}
+}
+
+/*! \brief Number of points of a sub-grid iterator
+ *
+ * \param it sub-grid iterator
+ *
+ * \return the number of points
+ *
+ */
+template<unsigned int dim, typename it_type>
+inline size_t parallel_for_volume(const it_type & it)
+{
+	size_t n_ele = 1;
+
+	for (size_t i = 0 ; i < dim ; i++)
+	{
+		if (it.getStop().get(i) < it.getStart().get(i))	{return 0;}
+
+		n_ele *= it.getStop().get(i) - it.getStart().get(i) + 1;
+	}
+
+	return n_ele;
+}
+
+/*! \brief Call f for every point of the box of the grid, distributing the points across threads
+ *
+ * The box is cropped to the grid and split with grid_key_dx_iterator_sub::split, one part for each
+ * thread. f must be safe to call concurrently on different points
+ *
+ * \code{.cpp}
+ * parallel_for(g,box,[&](const grid_key_dx<3> & key){g.template get<0>(key) = 1.0;});
+ * \endcode
+ *
+ * \param g grid
+ * \param box box to iterate (inclusive)
+ * \param f function called with the key of each point
+ *
+ */
+template<typename grid_type, typename lambda_f>
+void parallel_for(grid_type & g, const Box<grid_type::dims,long int> & box, lambda_f f)
+{
+	constexpr unsigned int dim = grid_type::dims;
+
+	size_t sz[dim];
+
+	for (size_t i = 0 ; i < dim ; i++)
+	{sz[i] = g.getGrid().size(i);}
+
+	grid_sm<dim,void> gvoid(sz);
+
+	grid_key_dx_iterator_sub<dim> it(gvoid,box.getKP1(),box.getKP2());
+
+	auto its = it.split(openfpm_omp_max_threads());
+
+	auto f_key = [&f](grid_key_dx_iterator_sub<dim> & it_t){f(it_t.get());};
+
+	parallel_for_run(its,parallel_for_volume<dim>(it),f_key);
+}
+
+/*! \brief Call f for every point of the box of the grid, distributing the points across threads,
+ *         with the offsets of the stencil points
+ *
+ * Every thread has its own grid_key_dx_iterator_sub with stencil_offset_compute, f receive the key
+ * and the iterator, the linearized index of the stencil point id is it.template getStencil<id>().
+ * The grid must use the standard linearization (grid_sm)
+ *
+ * \code{.cpp}
+ * parallel_for(g,box,star_stencil_3D,[&](const grid_key_dx<3> & key, auto & it)
+ *                                     {g2.template get<0>(key) = g.template get<0>(it.template getStencil<1>()) + ...;});
+ * \endcode
+ *
+ * \param g grid
+ * \param box box to iterate (inclusive)
+ * \param stencil_pnt stencil points
+ * \param f function called with the key of each point and the iterator
+ *
+ */
+template<unsigned int Np, typename grid_type, typename lambda_f>
+void parallel_for(grid_type & g,
+				  const Box<grid_type::dims,long int> & box,
+				  const grid_key_dx<grid_type::dims> (& stencil_pnt)[Np],
+				  lambda_f f)
+{
+	constexpr unsigned int dim = grid_type::dims;
+
+	typedef grid_key_dx_iterator_sub<dim,stencil_offset_compute<dim,Np>> it_type;
+
+	it_type it(g.getGrid(),box.getKP1(),box.getKP2(),stencil_pnt);
+
+	auto its = it.split(openfpm_omp_max_threads());
+
+	auto f_key = [&f](it_type & it_t){f(it_t.get(),it_t);};
+
+	parallel_for_run(its,parallel_for_volume<dim>(it),f_key);
+}
+
+#endif /* OPENFPM_DATA_SRC_GRID_ITERATORS_GRID_PARALLEL_FOR_HPP_ */
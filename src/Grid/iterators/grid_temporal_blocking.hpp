@@ -0,0 +1,190 @@
+/*
+ * grid_temporal_blocking.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Pietro Incardona
+ */
+
+#ifndef OPENFPM_DATA_SRC_GRID_ITERATORS_GRID_TEMPORAL_BLOCKING_HPP_
+#define OPENFPM_DATA_SRC_GRID_ITERATORS_GRID_TEMPORAL_BLOCKING_HPP_
+
+#include "grid_skin_iterator.hpp"
+#include "grid_parallel_for.hpp"
+
+/*! \brief Size in byte of the cache the wavefront of temporal_blocking try to fit in
+ *
+ */
+#ifndef OPENFPM_TEMPORAL_BLOCKING_CACHE
+#define OPENFPM_TEMPORAL_BLOCKING_CACHE (1024*1024)
+#endif
+
+/*! \brief Copy the points of the grid outside the domain from g_src to g_dst
+ *
+ * The domain must be at least one point away from the border of the grid
+ *
+ * \param g_src source grid
+ * \param g_dst destination grid
+ * \param domain domain
+ *
+ */
+template<typename grid_type>
+void temporal_blocking_copy_skin(const grid_type & g_src, grid_type & g_dst, const Box<grid_type::dims,long int> & domain)
+{
+	constexpr unsigned int dim = grid_type::dims;
+
+	size_t sz[dim];
+	size_t bc[dim];
+	Box<dim,size_t> A;
+	Box<dim,size_t> B;
+
+	for (size_t i = 0 ; i < dim ; i++)
+	{
+		sz[i] = g_src.getGrid().size(i);
+		bc[i] = NON_PERIODIC;
+
+		// the skin iterator remove A without its border
+		A.setLow(i,domain.getLow(i) - 1);
+		A.setHigh(i,domain.getHigh(i) + 1);
+		B.setLow(i,0);
+		B.setHigh(i,sz[i] - 1);
+	}
+
+	grid_sm<dim,void> gvoid(sz);
+
+	grid_skin_iterator_bc<dim> it(gvoid,A,B,bc);
+
+	while (it.isNext())
+	{
+		auto key = it.get();
+
+		g_dst.set(key,g_src,key);
+
+		++it;
+	}
+}
+
+/*! \brief Execute n_sweep sweeps of a stencil on the domain of a grid with temporal blocking
+ *
+ * Every sweep read from one grid and write in the other (Jacobi-like double buffering), the first sweep
+ * read from g_a. Instead of streaming the full grid n_sweep times, the domain is cut into slabs along
+ * the last (slowest) direction of thickness tile. For each slab position the sweeps are executed one after
+ * the other on slabs skewed backward by the radius of the stencil, so that the data of a wavefront
+ * is reused from cache by all the sweeps
+ *
+ \verbatim
+
+   sweep
+     2                     +-----+
+     1                  +-----+
+     0               +-----+
+                 -----------------> last direction
+                     <- r ->
+
+ \endverbatim
+ *
+ * The slabs are cut only along the last direction, the other directions are never tiled. The wavefront
+ * cover tile + (n_sweep + 1)*radius slices of both grids, when not even one point of thickness fit in
+ * OPENFPM_TEMPORAL_BLOCKING_CACHE (big cross section of the grid, many sweeps or big radius) the automatic
+ * tile is clamped to 1 and a warning is printed, the result is still correct but the data of the wavefront
+ * is not reused from cache. In this case reduce n_sweep or increase OPENFPM_TEMPORAL_BLOCKING_CACHE
+ *
+ * Every slab is iterated with grid_key_dx_iterator_sub boxes distributed across threads (parallel_for),
+ * the points outside the domain are copied from g_a to g_b with grid_skin_iterator_bc so that both
+ * buffers see the same boundary
+ *
+ * \code{.cpp}
+ * auto & res = temporal_blocking(g_a,g_b,domain,1,8,[](const grid & src, grid & dst, const grid_key_dx<3> & key)
+ *              {dst.template get<0>(key) = (src.template get<0>(key.move(0,1)) + src.template get<0>(key.move(0,-1)) + ...) / 6.0;});
+ * \endcode
+ *
+ * \param g_a grid with the initial data
+ * \param g_b second buffer (same size of g_a)
+ * \param domain points updated by the sweeps, the stencil must not read outside the grid
+ * \param radius radius of the stencil (maximum offset in any direction)
+ * \param n_sweep number of sweeps
+ * \param f function called with (source grid, destination grid, key) for each point of each sweep,
+ *        it must write only the point key of the destination
+ * \param tile thickness of the slabs, 0 calculate it from OPENFPM_TEMPORAL_BLOCKING_CACHE (at least 1)
+ *
+ * \return the grid with the result of the last sweep (g_a if n_sweep is even, g_b otherwise)
+ *
+ */
+template<typename grid_type, typename lambda_f>
+grid_type & temporal_blocking(grid_type & g_a,
+							  grid_type & g_b,
+							  const Box<grid_type::dims,long int> & domain,
+							  long int radius,
+							  size_t n_sweep,
+							  lambda_f f,
+							  size_t tile = 0)
+{
+	constexpr unsigned int dim = grid_type::dims;
+	constexpr unsigned int ld = dim - 1;
+
+	for (size_t i = 0 ; i < dim ; i++)
+	{
+		if (g_a.getGrid().size(i) != g_b.getGrid().size(i) || radius < 1 ||
+			domain.getLow(i) < radius || domain.getHigh(i) + radius >= (long int)g_a.getGrid().size(i))
+		{
+			std::cerr << "Error " << __FILE__ << ":" << __LINE__ << " the grids must have the same size and the stencil of radius " << radius << " must not go out of the grid" << std::endl;
+			return g_a;
+		}
+
+		if (domain.getHigh(i) < domain.getLow(i))	{return g_a;}
+	}
+
+	if (n_sweep == 0)	{return g_a;}
+
+	temporal_blocking_copy_skin(g_a,g_b,domain);
+
+	if (tile == 0)
+	{
+		// the wavefront cover tile + (n_sweep + 1)*radius slices of both grids
+		size_t slice = sizeof(typename grid_type::value_type);
+		for (size_t i = 0 ; i < ld ; i++)
+		{slice *= g_a.getGrid().size(i);}
+
+		long int fit = (long int)(OPENFPM_TEMPORAL_BLOCKING_CACHE / (2*slice)) - (long int)(n_sweep + 1)*radius;
+
+		if (fit < 1)
+		{
+			std::cerr << "Warning: " << __FILE__ << ":" << __LINE__ << " the wavefront of " << n_sweep << " sweeps with radius " << radius << " does not fit in OPENFPM_TEMPORAL_BLOCKING_CACHE, slabs of thickness 1 are used and the data is not reused from cache" << std::endl;
+			fit = 1;
+		}
+
+		tile = fit;
+	}
+
+	grid_type * g[2] = {&g_a,&g_b};
+
+	long int lo = domain.getLow(ld);
+	long int hi = domain.getHigh(ld);
+
+	// last slab of the last sweep start from hi - (n_sweep-1)*radius
+	long int n_wave = (hi - lo + 1 + (long int)(n_sweep - 1)*radius + (long int)tile - 1) / (long int)tile;
+
+	for (long int w = 0 ; w < n_wave ; w++)
+	{
+		for (size_t s = 0 ; s < n_sweep ; s++)
+		{
+			Box<dim,long int> slab = domain;
+
+			long int start = lo + w*(long int)tile - (long int)s*radius;
+			long int stop = start + tile - 1;
+
+			slab.setLow(ld,(start < lo)?lo:start);
+			slab.setHigh(ld,(stop > hi)?hi:stop);
+
+			if (slab.getHigh(ld) < slab.getLow(ld))	{continue;}
+
+			const grid_type & src = *g[s % 2];
+			grid_type & dst = *g[(s + 1) % 2];
+
+			parallel_for(dst,slab,[&](const grid_key_dx<dim> & key){f(src,dst,key);});
+		}
+	}
+
+	return *g[n_sweep % 2];
+}
+
+#endif /* OPENFPM_DATA_SRC_GRID_ITERATORS_GRID_TEMPORAL_BLOCKING_HPP_ */
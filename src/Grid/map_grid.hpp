@@ -47,6 +47,7 @@
 #include "iterators/grid_key_dx_iterator_sub.hpp"
 #include "iterators/grid_key_dx_iterator_sp.hpp"
 #include "iterators/grid_key_dx_iterator_sub_bc.hpp"
+#include "iterators/grid_parallel_for.hpp"
 #include "Packer_Unpacker/Packer_util.hpp"
 #include "Packer_Unpacker/has_pack_agg.hpp"
 #include "cuda/cuda_grid_gpu_funcs.cuh"
@@ -122,7 +123,7 @@ public:
 
 	//! Object container for T, it is the return type of get_o it return a object type trough
 	// you can access all the properties of T
-	typedef typename grid_base_impl<dim,T,S, memory_traits_lin>::container container;
+	typedef typename grid_base_impl<dim,T,S, memory_traits_lin,linearizer>::container container;
 
 	//! grid_base has no grow policy
 	typedef void grow_policy;
@@ -134,7 +135,7 @@ public:
 	typedef grid_key_dx_iterator_sub<dim> sub_grid_iterator_type;
 
 	//! linearizer type Z-morton Hilbert curve , normal striding
-	typedef typename grid_base_impl<dim,T,S, memory_traits_lin>::linearizer_type linearizer_type;
+	typedef typename grid_base_impl<dim,T,S, memory_traits_lin,linearizer>::linearizer_type linearizer_type;
 
 	//! Default constructor
 	inline grid_base() THROW
@@ -149,7 +150,7 @@ public:
 	 * \param mem memory object (only used for template deduction)
 	 *
 	 */
-	inline grid_base(const grid_base<dim,T,S,typename memory_traits_lin<T>::type> & g) THROW
+	inline grid_base(const grid_base<dim,T,S,typename memory_traits_lin<T>::type,linearizer> & g) THROW
 	:grid_base_impl<dim,T,S,memory_traits_lin, linearizer>(g)
 	{
 	}
@@ -9,6 +9,8 @@
 #define OPENFPM_DATA_SRC_GRID_GRID_PERFORMANCE_TESTS_HPP_
 
 #include "Grid/grid_util_test.hpp"
+#include "Grid/grid_conv.hpp"
+#include "Grid/grid_sm_invlin.hpp"
 #include "util/stat/common_statistics.hpp"
 
 // Property tree
@@ -195,6 +197,312 @@ BOOST_AUTO_TEST_CASE(grid_performance_duplicate)
 	report_grid_funcs.graphs.put("performance.grid.set(3).y.data.dev",dev);
 }
 
+template<typename grid_type>
+void grid_performance_copy_to_impl(size_t id, const std::string & name)
+{
+	size_t sz[] = {128,128,128};
+	size_t sz_dst[] = {130,130,130};
+
+	report_grid_funcs.graphs.put("performance.grid.set(" + std::to_string(id) + ").grid.x",sz[0]);
+	report_grid_funcs.graphs.put("performance.grid.set(" + std::to_string(id) + ").grid.y",sz[1]);
+	report_grid_funcs.graphs.put("performance.grid.set(" + std::to_string(id) + ").grid.z",sz[2]);
+
+	grid_type c3(sz);
+	c3.setMemory();
+
+	grid_type c1(sz_dst);
+	c1.setMemory();
+
+	fill_grid<3>(c3);
+
+	// ghost like box copy, the box is shifted by one in the destination
+	Box<3,long int> bx_src({0,0,0},{127,127,127});
+	Box<3,long int> bx_dst({1,1,1},{128,128,128});
+
+	std::vector<double> times(N_STAT_SMALL + 1);
+
+	for (size_t i = 0 ; i < N_STAT_SMALL+1 ; i++)
+	{
+		timer t;
+		t.start();
+
+		c1.copy_to(c3,bx_src,bx_dst);
+
+		t.stop();
+
+		times[i] = t.getwct();
+	}
+
+	double mean;
+	double dev;
+	standard_deviation(times,mean,dev);
+
+	report_grid_funcs.graphs.put("performance.grid.set(" + std::to_string(id) + ").x.data.name",name);
+	report_grid_funcs.graphs.put("performance.grid.set(" + std::to_string(id) + ").y.data.mean",mean);
+	report_grid_funcs.graphs.put("performance.grid.set(" + std::to_string(id) + ").y.data.dev",dev);
+}
+
+BOOST_AUTO_TEST_CASE(grid_performance_copy_to)
+{
+	grid_performance_copy_to_impl<grid_cpu<3, Point_test<float>>>(4,"Grid_cp_lin");
+	grid_performance_copy_to_impl<grid_base<3, Point_test<float>, HeapMemory, typename memory_traits_inte<Point_test<float>>::type>>(5,"Grid_cp_inte");
+}
+
+template<typename grid_type>
+void grid_performance_conv_impl(size_t id, const std::string & name)
+{
+	size_t sz[] = {128,128,128};
+
+	report_grid_funcs.graphs.put("performance.grid.set(" + std::to_string(id) + ").grid.x",sz[0]);
+	report_grid_funcs.graphs.put("performance.grid.set(" + std::to_string(id) + ").grid.y",sz[1]);
+	report_grid_funcs.graphs.put("performance.grid.set(" + std::to_string(id) + ").grid.z",sz[2]);
+
+	grid_type c3(sz);
+	c3.setMemory();
+
+	auto it = c3.getIterator();
+
+	while (it.isNext())
+	{
+		c3.template get<0>(it.get()) = it.get().get(0) + it.get().get(1) + it.get().get(2);
+
+		++it;
+	}
+
+	grid_key_dx<3> start({1,1,1});
+	grid_key_dx<3> stop({126,126,126});
+
+	std::vector<double> times(N_STAT_SMALL + 1);
+
+	for (size_t i = 0 ; i < N_STAT_SMALL+1 ; i++)
+	{
+		timer t;
+		t.start();
+
+		c3.template conv<stencil_3D_7p,0,1>(start,stop,[](Vc::Vector<float> (& xs)[7])
+		                                    {return xs[1] + xs[2] + xs[3] + xs[4] + xs[5] + xs[6] - 6.0f*xs[0];});
+
+		t.stop();
+
+		times[i] = t.getwct();
+	}
+
+	double mean;
+	double dev;
+	standard_deviation(times,mean,dev);
+
+	report_grid_funcs.graphs.put("performance.grid.set(" + std::to_string(id) + ").x.data.name",name);
+	report_grid_funcs.graphs.put("performance.grid.set(" + std::to_string(id) + ").y.data.mean",mean);
+	report_grid_funcs.graphs.put("performance.grid.set(" + std::to_string(id) + ").y.data.dev",dev);
+}
+
+BOOST_AUTO_TEST_CASE(grid_performance_conv)
+{
+	grid_performance_conv_impl<grid_cpu<3, aggregate<float,float>>>(6,"Grid_conv_lin");
+	grid_performance_conv_impl<grid_base<3, aggregate<float,float>, HeapMemory, typename memory_traits_inte<aggregate<float,float>>::type>>(7,"Grid_conv_inte");
+}
+
+/*! \brief Iterator that follow the memory of the grid
+ *
+ * \tparam is_zm true if the grid is linearized with grid_zm
+ *
+ */
+template<bool is_zm>
+struct grid_performance_mem_iterator
+{
+	template<typename grid_type>
+	static auto get(const grid_type & g, const grid_key_dx<3> & start, const grid_key_dx<3> & stop) -> decltype(g.getSubIterator(start,stop))
+	{
+		return g.getSubIterator(start,stop);
+	}
+};
+
+//! Morton order
+template<>
+struct grid_performance_mem_iterator<true>
+{
+	template<typename grid_type>
+	static auto get(const grid_type & g, const grid_key_dx<3> & start, const grid_key_dx<3> & stop) -> decltype(g.getGrid().getMortonSubIterator(start,stop))
+	{
+		return g.getGrid().getMortonSubIterator(start,stop);
+	}
+};
+
+template<typename grid_type>
+void grid_performance_order_impl(size_t id, const std::string & name)
+{
+	typedef Point_test<float> P;
+
+	size_t sz[] = {128,128,128};
+
+	grid_type c3(sz);
+	c3.setMemory();
+
+	fill_grid<3>(c3);
+
+	grid_key_dx<3> start({1,1,1});
+	grid_key_dx<3> stop({126,126,126});
+
+	// 7 points stencil following the memory order
+	std::vector<double> times(N_STAT_SMALL + 1);
+
+	for (size_t i = 0 ; i < N_STAT_SMALL+1 ; i++)
+	{
+		timer t;
+		t.start();
+
+		auto it = grid_performance_mem_iterator<is_grid_zm<typename grid_type::linearizer_type>::value>::get(c3,start,stop);
+
+		while (it.isNext())
+		{
+			auto key = it.get();
+
+			c3.template get<P::y>(key) = c3.template get<P::x>(key.move(0,1)) + c3.template get<P::x>(key.move(0,-1)) +
+			                             c3.template get<P::x>(key.move(1,1)) + c3.template get<P::x>(key.move(1,-1)) +
+			                             c3.template get<P::x>(key.move(2,1)) + c3.template get<P::x>(key.move(2,-1)) -
+			                             6.0*c3.template get<P::x>(key);
+
+			++it;
+		}
+
+		t.stop();
+
+		times[i] = t.getwct();
+	}
+
+	double mean;
+	double dev;
+	standard_deviation(times,mean,dev);
+
+	report_grid_funcs.graphs.put("performance.grid.set(" + std::to_string(id) + ").grid.x",sz[0]);
+	report_grid_funcs.graphs.put("performance.grid.set(" + std::to_string(id) + ").x.data.name",name + "_stencil");
+	report_grid_funcs.graphs.put("performance.grid.set(" + std::to_string(id) + ").y.data.mean",mean);
+	report_grid_funcs.graphs.put("performance.grid.set(" + std::to_string(id) + ").y.data.dev",dev);
+
+	// random access
+	for (size_t i = 0 ; i < N_STAT_SMALL+1 ; i++)
+	{
+		timer t;
+		t.start();
+
+		size_t r = 12345;
+		float sum = 0.0;
+
+		for (size_t j = 0 ; j < 1024*1024 ; j++)
+		{
+			r = r * 6364136223846793005ul + 1442695040888963407ul;
+
+			grid_key_dx<3> key({(long int)((r >> 20) % sz[0]),(long int)((r >> 30) % sz[1]),(long int)((r >> 40) % sz[2])});
+
+			sum += c3.template get<P::x>(key);
+		}
+
+		t.stop();
+
+		times[i] = t.getwct() + 0.0*sum;
+	}
+
+	standard_deviation(times,mean,dev);
+
+	report_grid_funcs.graphs.put("performance.grid.set(" + std::to_string(id+1) + ").grid.x",sz[0]);
+	report_grid_funcs.graphs.put("performance.grid.set(" + std::to_string(id+1) + ").x.data.name",name + "_random");
+	report_grid_funcs.graphs.put("performance.grid.set(" + std::to_string(id+1) + ").y.data.mean",mean);
+	report_grid_funcs.graphs.put("performance.grid.set(" + std::to_string(id+1) + ").y.data.dev",dev);
+}
+
+BOOST_AUTO_TEST_CASE(grid_performance_order)
+{
+	grid_performance_order_impl<grid_cpu<3, Point_test<float>>>(8,"Grid_rowmajor");
+	grid_performance_order_impl<grid_cpu<3, Point_test<float>, grid_zm<3,void>>>(10,"Grid_morton");
+}
+
+/*! \brief Time the inversion of the linearization of 1M random ids
+ *
+ * \param id set id
+ * \param name name of the test
+ * \param f function that invert the ids
+ *
+ */
+template<typename lambda_f>
+void grid_performance_invlinid_impl(size_t id, const std::string & name, lambda_f f)
+{
+	size_t sz[3] = {127,111,93};
+	grid_sm<3,void> gs(sz);
+
+	std::vector<mem_id> ids(1024*1024);
+	std::vector<grid_key_dx<3>> keys(ids.size());
+
+	size_t r = 12345;
+	for (size_t j = 0 ; j < ids.size() ; j++)
+	{
+		r = r * 6364136223846793005ul + 1442695040888963407ul;
+		ids[j] = (r >> 20) % gs.size();
+	}
+
+	std::vector<double> times(N_STAT_SMALL + 1);
+
+	for (size_t i = 0 ; i < N_STAT_SMALL+1 ; i++)
+	{
+		timer t;
+		t.start();
+
+		f(gs,ids,keys);
+
+		t.stop();
+
+		times[i] = t.getwct();
+	}
+
+	double mean;
+	double dev;
+	standard_deviation(times,mean,dev);
+
+	report_grid_funcs.graphs.put("performance.grid.set(" + std::to_string(id) + ").grid.x",sz[0]);
+	report_grid_funcs.graphs.put("performance.grid.set(" + std::to_string(id) + ").grid.y",sz[1]);
+	report_grid_funcs.graphs.put("performance.grid.set(" + std::to_string(id) + ").grid.z",sz[2]);
+	report_grid_funcs.graphs.put("performance.grid.set(" + std::to_string(id) + ").x.data.name",name);
+	report_grid_funcs.graphs.put("performance.grid.set(" + std::to_string(id) + ").y.data.mean",mean);
+	report_grid_funcs.graphs.put("performance.grid.set(" + std::to_string(id) + ").y.data.dev",dev);
+}
+
+BOOST_AUTO_TEST_CASE(grid_performance_invlinid)
+{
+	// hardware division
+	grid_performance_invlinid_impl(12,"Grid_invlinid_div",[](const grid_sm<3,void> & gs, const std::vector<mem_id> & ids, std::vector<grid_key_dx<3>> & keys)
+	{
+		for (size_t j = 0 ; j < ids.size() ; j++)
+		{
+			mem_id lid = ids[j];
+
+			for (size_t i = 0 ; i < 3 ; i++)
+			{
+				keys[j].set_d(i,lid % gs.size(i));
+				lid /= gs.size(i);
+			}
+		}
+	});
+
+	grid_performance_invlinid_impl(13,"Grid_invlinid",[](const grid_sm<3,void> & gs, const std::vector<mem_id> & ids, std::vector<grid_key_dx<3>> & keys)
+	{
+		grid_sm_invlin<3> gi(gs);
+
+		for (size_t j = 0 ; j < ids.size() ; j++)
+		{
+			grid_key_dx<3> k = gi.InvLinId(ids[j]);
+
+			for (size_t i = 0 ; i < 3 ; i++)
+			{keys[j].set_d(i,k.get(i));}
+		}
+	});
+
+	grid_performance_invlinid_impl(14,"Grid_invlinid_bulk",[](const grid_sm<3,void> & gs, const std::vector<mem_id> & ids, std::vector<grid_key_dx<3>> & keys)
+	{
+		grid_sm_invlin<3> gi(gs);
+
+		gi.InvLinId(&ids[0],&keys[0],ids.size());
+	});
+}
+
 /////// THIS IS NOT A TEST IT WRITE THE PERFORMANCE RESULT ///////
 
 BOOST_AUTO_TEST_CASE(grid_performance_write_report)
@@ -202,7 +510,7 @@ BOOST_AUTO_TEST_CASE(grid_performance_write_report)
 	// Create a graphs
 
 	report_grid_funcs.graphs.put("graphs.graph(0).type","line");
-	report_grid_funcs.graphs.add("graphs.graph(0).title","Grid set functions (so/sog/soge) and duplicate (dup) performance");
+	report_grid_funcs.graphs.add("graphs.graph(0).title","Grid set functions (so/sog/soge), duplicate (dup), copy_to (cp), 7 points conv, row-major/Morton order and InvLinId performance");
 	report_grid_funcs.graphs.add("graphs.graph(0).x.title","Tests");
 	report_grid_funcs.graphs.add("graphs.graph(0).y.title","Time seconds");
 	report_grid_funcs.graphs.add("graphs.graph(0).y.data(0).source","performance.grid.set(#).y.data.mean");
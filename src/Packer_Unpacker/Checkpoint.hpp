@@ -0,0 +1,1308 @@
+/*
+ * Checkpoint.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Pietro Incardona
+ */
+
+#ifndef OPENFPM_DATA_SRC_PACKER_UNPACKER_CHECKPOINT_HPP_
+#define OPENFPM_DATA_SRC_PACKER_UNPACKER_CHECKPOINT_HPP_
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <type_traits>
+#include <boost/mpl/range_c.hpp>
+#include <boost/mpl/at.hpp>
+#include <boost/fusion/include/at_c.hpp>
+#include "util/for_each_ref.hpp"
+#include "memory_ly/memory_conf.hpp"
+#include "util/openmp_util.hpp"
+#include "Checkpoint_fwd.hpp"
+
+//! identifier of a checkpoint file
+#define CHECKPOINT_MAGIC "OFPMCKPT"
+//! version of the checkpoint format
+#define CHECKPOINT_VERSION 1
+//! marker to detect the endianness of the writer
+#define CHECKPOINT_ENDIAN 0x01020304
+
+//! data stored element by element (memory_traits_lin)
+#define CHECKPOINT_LAYOUT_LIN 0
+//! data stored property by property and component by component (memory_traits_inte)
+#define CHECKPOINT_LAYOUT_INTE 1
+
+//! maximum rank of an array property
+#define CHECKPOINT_MAX_RANK 4
+
+//! alignment of the data section in a non-striped checkpoint
+#define CHECKPOINT_DATA_ALIGN 4096
+
+//! maximum size of a single pwrite/pread
+#define CHECKPOINT_IO_MAX ((size_t)1 << 30)
+
+//! size of the buffer used to convert the data section while loading
+#ifndef CHECKPOINT_CONVERT_BUFFER
+#define CHECKPOINT_CONVERT_BUFFER ((size_t)1 << 24)
+#endif
+
+/*! \brief Identifier of the type of the components of a property, 0 for types without identifier
+ *
+ * \tparam T type
+ *
+ */
+template<typename T> struct checkpoint_type_id {static const uint32_t value = 0;};
+
+template<> struct checkpoint_type_id<bool> {static const uint32_t value = 1;};
+template<> struct checkpoint_type_id<char> {static const uint32_t value = 2;};
+template<> struct checkpoint_type_id<signed char> {static const uint32_t value = 3;};
+template<> struct checkpoint_type_id<unsigned char> {static const uint32_t value = 4;};
+template<> struct checkpoint_type_id<short> {static const uint32_t value = 5;};
+template<> struct checkpoint_type_id<unsigned short> {static const uint32_t value = 6;};
+template<> struct checkpoint_type_id<int> {static const uint32_t value = 7;};
+template<> struct checkpoint_type_id<unsigned int> {static const uint32_t value = 8;};
+template<> struct checkpoint_type_id<long int> {static const uint32_t value = 9;};
+template<> struct checkpoint_type_id<unsigned long int> {static const uint32_t value = 10;};
+template<> struct checkpoint_type_id<long long int> {static const uint32_t value = 11;};
+template<> struct checkpoint_type_id<unsigned long long int> {static const uint32_t value = 12;};
+template<> struct checkpoint_type_id<float> {static const uint32_t value = 13;};
+template<> struct checkpoint_type_id<double> {static const uint32_t value = 14;};
+template<> struct checkpoint_type_id<long double> {static const uint32_t value = 15;};
+
+/*! \brief Header of a checkpoint file
+ *
+ * The header is followed by n_prp checkpoint_prop and by dim uint64_t with the sizes of the container.
+ * The data section start at data_off. With memory_traits_lin layout it contain the n_ele elements, with
+ * memory_traits_inte layout it contain for each property and for each component the n_ele values.
+ * A sparse grid store before the properties the keys of the points (dim int64_t for each point).
+ * With n_stripe > 1 the data section is split in n_stripe files path.0 ... path.(n_stripe-1) of almost
+ * equal size
+ *
+ */
+struct checkpoint_header
+{
+	//! CHECKPOINT_MAGIC
+	char magic[8];
+
+	//! CHECKPOINT_VERSION
+	uint32_t version;
+
+	//! CHECKPOINT_ENDIAN written with the byte order of the writer
+	uint32_t endian;
+
+	//! type of container
+	uint32_t kind;
+
+	//! layout of the data section
+	uint32_t layout;
+
+	//! order of the elements
+	uint32_t order;
+
+	//! dimensionality
+	uint32_t dim;
+
+	//! number of properties
+	uint32_t n_prp;
+
+	//! number of files the data section is split
+	uint32_t n_stripe;
+
+	//! number of elements
+	uint64_t n_ele;
+
+	//! size of an element with memory_traits_lin layout
+	uint64_t ele_size;
+
+	//! offset of the data section
+	uint64_t data_off;
+
+	//! size of the data section
+	uint64_t data_size;
+};
+
+/*! \brief Description of a property in the checkpoint header
+ *
+ */
+struct checkpoint_prop
+{
+	//! type of the components (checkpoint_type_id)
+	uint32_t type;
+
+	//! size of a component
+	uint32_t comp_size;
+
+	//! rank (0 for scalar)
+	uint32_t rank;
+
+	//! extents of the array
+	uint32_t ext[CHECKPOINT_MAX_RANK];
+
+	//! size of the property
+	uint64_t size;
+
+	//! offset of the property in the element (memory_traits_lin layout)
+	uint64_t aos_off;
+
+	/*! \brief Number of components
+	 *
+	 * \return the number of components
+	 *
+	 */
+	size_t n_comp() const
+	{
+		return size / comp_size;
+	}
+};
+
+/*! \brief Contiguous piece of memory written or read from the data section
+ *
+ */
+struct checkpoint_block
+{
+	//! pointer
+	unsigned char * ptr;
+
+	//! size in byte
+	size_t size;
+};
+
+/*! \brief Swap the bytes of n values of size s
+ *
+ * \param ptr values
+ * \param n number of values
+ * \param s size of a value
+ *
+ */
+inline void checkpoint_swap(void * ptr, size_t n, size_t s)
+{
+	unsigned char * p = (unsigned char *)ptr;
+
+	for (size_t i = 0 ; i < n ; i++, p += s)
+	{
+		for (size_t j = 0 ; j < s / 2 ; j++)
+		{std::swap(p[j],p[s - 1 - j]);}
+	}
+}
+
+//! Extents of an array property
+template<typename T, unsigned int rank = std::rank<T>::value>
+struct checkpoint_extents
+{
+	static void fill(uint32_t (& ext)[CHECKPOINT_MAX_RANK], size_t i = 0)
+	{
+		ext[i] = std::extent<T>::value;
+		checkpoint_extents<typename std::remove_extent<T>::type>::fill(ext,i+1);
+	}
+};
+
+//! Extents of a scalar property
+template<typename T>
+struct checkpoint_extents<T,0>
+{
+	static void fill(uint32_t (& /*ext*/)[CHECKPOINT_MAX_RANK], size_t /*i*/ = 0)
+	{}
+};
+
+/*! \brief Fill the description of the properties of an aggregate
+ *
+ * \tparam T aggregate
+ *
+ */
+template<typename T>
+struct checkpoint_schema
+{
+	//! description of the properties
+	std::vector<checkpoint_prop> & prp;
+
+	//! an element to calculate the offset of the properties
+	typename T::type ele;
+
+	/*! \brief Constructor
+	 *
+	 * \param prp description of the properties
+	 *
+	 */
+	checkpoint_schema(std::vector<checkpoint_prop> & prp)
+	:prp(prp)
+	{}
+
+	//! Fill the description of the property
+	template<typename t_prp> inline void operator()(t_prp & /*t*/)
+	{
+		typedef typename boost::mpl::at<typename T::type,t_prp>::type prp_type;
+		typedef typename std::remove_all_extents<prp_type>::type comp_type;
+
+		static_assert(std::rank<prp_type>::value <= CHECKPOINT_MAX_RANK,"checkpoint support arrays with rank up to CHECKPOINT_MAX_RANK");
+
+		checkpoint_prop p;
+		memset(&p,0,sizeof(p));
+
+		p.type = checkpoint_type_id<comp_type>::value;
+		p.comp_size = sizeof(comp_type);
+		p.rank = std::rank<prp_type>::value;
+		checkpoint_extents<prp_type>::fill(p.ext);
+		p.size = sizeof(prp_type);
+		p.aos_off = (unsigned char *)&boost::fusion::at_c<t_prp::value>(ele) - (unsigned char *)&ele;
+
+		prp.push_back(p);
+	}
+
+	/*! \brief Description of the properties of T
+	 *
+	 * \param prp description of the properties
+	 *
+	 */
+	static void fill(std::vector<checkpoint_prop> & prp)
+	{
+		prp.clear();
+
+		checkpoint_schema<T> cs(prp);
+		boost::mpl::for_each_ref<boost::mpl::range_c<int,0,T::max_prop>>(cs);
+	}
+};
+
+/*! \brief Collect the pointers of the properties of a container
+ *
+ * With memory_traits_lin layout all the pointers are the beginning of the elements
+ *
+ * \tparam cont_type container
+ *
+ */
+template<typename cont_type>
+struct checkpoint_pointers
+{
+	//! container
+	cont_type & cont;
+
+	//! pointers
+	std::vector<unsigned char *> & ptr;
+
+	/*! \brief Constructor
+	 *
+	 * \param cont container
+	 * \param ptr pointers
+	 *
+	 */
+	checkpoint_pointers(cont_type & cont, std::vector<unsigned char *> & ptr)
+	:cont(cont),ptr(ptr)
+	{}
+
+	//! Get the pointer of the property
+	template<typename t_prp> inline void operator()(t_prp & /*t*/)
+	{
+		ptr.push_back((unsigned char *)cont.template getPointer<t_prp::value>());
+	}
+};
+
+/*! \brief Blocks of a dense container in the layout of the container
+ *
+ * \param prp description of the properties
+ * \param ptr pointers of the properties
+ * \param is_inte true if the container has memory_traits_inte layout
+ * \param n number of elements
+ * \param n_mem number of elements allocated (stride between the components with memory_traits_inte)
+ * \param ele_size size of an element
+ * \param blocks blocks
+ *
+ */
+inline void checkpoint_dense_blocks(const std::vector<checkpoint_prop> & prp, const std::vector<unsigned char *> & ptr,
+									bool is_inte, size_t n, size_t n_mem, size_t ele_size, std::vector<checkpoint_block> & blocks)
+{
+	if (is_inte == false)
+	{
+		blocks.push_back({ptr[0],n*ele_size});
+		return;
+	}
+
+	for (size_t p = 0 ; p < prp.size() ; p++)
+	{
+		for (size_t c = 0 ; c < prp[p].n_comp() ; c++)
+		{blocks.push_back({ptr[p] + c*n_mem*prp[p].comp_size,n*prp[p].comp_size});}
+	}
+}
+
+/*! \brief Size of the data section
+ *
+ * \param blocks blocks
+ *
+ * \return the size
+ *
+ */
+inline size_t checkpoint_data_size(const std::vector<checkpoint_block> & blocks)
+{
+	size_t tot = 0;
+
+	for (size_t i = 0 ; i < blocks.size() ; i++)
+	{tot += blocks[i].size;}
+
+	return tot;
+}
+
+/*! \brief Write or read the range [start,stop) of the data section
+ *
+ * \param fd file
+ * \param wr true to write, false to read
+ * \param blocks blocks of the data section
+ * \param start start of the range in the data section
+ * \param stop end of the range in the data section
+ * \param f_off offset in the file of the beginning of the range
+ *
+ * \return false in case of I/O error
+ *
+ */
+inline bool checkpoint_range_io(int fd, bool wr, const std::vector<checkpoint_block> & blocks, size_t start, size_t stop, size_t f_off)
+{
+	size_t b_start = 0;
+
+	for (size_t i = 0 ; i < blocks.size() && b_start < stop ; i++)
+	{
+		size_t b_stop = b_start + blocks[i].size;
+
+		size_t s = (start > b_start)?start:b_start;
+		size_t e = (stop < b_stop)?stop:b_stop;
+
+		while (s < e)
+		{
+			size_t c = (e - s < CHECKPOINT_IO_MAX)?(e - s):CHECKPOINT_IO_MAX;
+			unsigned char * ptr = blocks[i].ptr + (s - b_start);
+			off_t off = f_off + (s - start);
+
+			ssize_t r = (wr == true)?pwrite(fd,ptr,c,off):pread(fd,ptr,c,off);
+
+			if (r <= 0)	{return false;}
+
+			s += r;
+		}
+
+		b_start = b_stop;
+	}
+
+	return true;
+}
+
+/*! \brief Name of a stripe of the data section
+ *
+ * \param path checkpoint
+ * \param k stripe
+ *
+ * \return the file name
+ *
+ */
+inline std::string checkpoint_stripe_name(const std::string & path, size_t k)
+{
+	return path + "." + std::to_string(k);
+}
+
+/*! \brief Write or read the data section, the stripes are processed in parallel
+ *
+ * \param path checkpoint
+ * \param fd checkpoint file (already open)
+ * \param wr true to write, false to read
+ * \param hd header
+ * \param blocks blocks of the data section
+ *
+ * \return false in case of I/O error
+ *
+ */
+inline bool checkpoint_data_io(const std::string & path, int fd, bool wr, const checkpoint_header & hd, const std::vector<checkpoint_block> & blocks)
+{
+	if (hd.n_stripe <= 1)
+	{return checkpoint_range_io(fd,wr,blocks,0,hd.data_size,hd.data_off);}
+
+	bool ok = true;
+
+	#pragma omp parallel for schedule(dynamic) reduction(&&:ok)
+	for (size_t k = 0 ; k < hd.n_stripe ; k++)
+	{
+		size_t start = hd.data_size * k / hd.n_stripe;
+		size_t stop = hd.data_size * (k+1) / hd.n_stripe;
+
+		std::string name = checkpoint_stripe_name(path,k);
+		int fd_s = (wr == true)?open(name.c_str(),O_WRONLY | O_CREAT | O_TRUNC,0644):open(name.c_str(),O_RDONLY);
+
+		if (fd_s < 0)	{ok = false; continue;}
+
+		ok = ok && checkpoint_range_io(fd_s,wr,blocks,start,stop,0);
+
+		close(fd_s);
+	}
+
+	return ok;
+}
+
+/*! \brief Write a checkpoint
+ *
+ * \param path file
+ * \param hd header (data_off, data_size and n_stripe are filled)
+ * \param prp description of the properties
+ * \param sz sizes of the container
+ * \param blocks data section
+ * \param n_stripe number of files the data section is split (1 means the data are in the same file of the header)
+ *
+ * \return true if succeed
+ *
+ */
+inline bool checkpoint_write(const std::string & path, checkpoint_header & hd, const std::vector<checkpoint_prop> & prp,
+							 const std::vector<uint64_t> & sz, const std::vector<checkpoint_block> & blocks, size_t n_stripe)
+{
+	memcpy(hd.magic,CHECKPOINT_MAGIC,sizeof(hd.magic));
+	hd.version = CHECKPOINT_VERSION;
+	hd.endian = CHECKPOINT_ENDIAN;
+	hd.dim = sz.size();
+	hd.n_prp = prp.size();
+	hd.n_stripe = (n_stripe == 0)?1:n_stripe;
+	hd.data_size = checkpoint_data_size(blocks);
+
+	size_t hd_size = sizeof(hd) + prp.size()*sizeof(checkpoint_prop) + sz.size()*sizeof(uint64_t);
+	hd.data_off = (hd.n_stripe == 1)?(hd_size + CHECKPOINT_DATA_ALIGN - 1) / CHECKPOINT_DATA_ALIGN * CHECKPOINT_DATA_ALIGN:0;
+
+	std::vector<unsigned char> buf(hd_size);
+	memcpy(&buf[0],&hd,sizeof(hd));
+	if (prp.size() != 0)	{memcpy(&buf[sizeof(hd)],&prp[0],prp.size()*sizeof(checkpoint_prop));}
+	if (sz.size() != 0)	{memcpy(&buf[sizeof(hd) + prp.size()*sizeof(checkpoint_prop)],&sz[0],sz.size()*sizeof(uint64_t));}
+
+	int fd = open(path.c_str(),O_WRONLY | O_CREAT | O_TRUNC,0644);
+
+	if (fd < 0)
+	{
+		std::cerr << "Error " << __FILE__ << ":" << __LINE__ << " cannot open the file " << path << std::endl;
+		return false;
+	}
+
+	std::vector<checkpoint_block> hd_block({{&buf[0],hd_size}});
+
+	bool ok = checkpoint_range_io(fd,true,hd_block,0,hd_size,0);
+	ok = ok && checkpoint_data_io(path,fd,true,hd,blocks);
+
+	close(fd);
+
+	if (ok == false)
+	{std::cerr << "Error " << __FILE__ << ":" << __LINE__ << " error writing the checkpoint " << path << std::endl;}
+
+	return ok;
+}
+
+/*! \brief Read the header of a checkpoint
+ *
+ * The header is converted to the byte order of the reader
+ *
+ * \param path file
+ * \param hd header
+ * \param prp description of the properties
+ * \param sz sizes of the container
+ * \param swap true if the checkpoint was written with a different byte order
+ *
+ * \return true if succeed
+ *
+ */
+inline bool checkpoint_read_header(const std::string & path, checkpoint_header & hd, std::vector<checkpoint_prop> & prp,
+								   std::vector<uint64_t> & sz, bool & swap)
+{
+	int fd = open(path.c_str(),O_RDONLY);
+
+	if (fd < 0)
+	{
+		std::cerr << "Error " << __FILE__ << ":" << __LINE__ << " cannot open the file " << path << std::endl;
+		return false;
+	}
+
+	std::vector<checkpoint_block> hd_block({{(unsigned char *)&hd,sizeof(hd)}});
+	bool ok = checkpoint_range_io(fd,false,hd_block,0,sizeof(hd),0);
+
+	if (ok == false || memcmp(hd.magic,CHECKPOINT_MAGIC,sizeof(hd.magic)) != 0)
+	{
+		std::cerr << "Error " << __FILE__ << ":" << __LINE__ << " the file " << path << " is not a checkpoint" << std::endl;
+		close(fd);
+		return false;
+	}
+
+	swap = (hd.endian != CHECKPOINT_ENDIAN);
+
+	if (swap == true)
+	{
+		checkpoint_swap(&hd.version,8,sizeof(uint32_t));
+		checkpoint_swap(&hd.n_ele,4,sizeof(uint64_t));
+	}
+
+	if (hd.version != CHECKPOINT_VERSION || hd.endian != CHECKPOINT_ENDIAN)
+	{
+		std::cerr << "Error " << __FILE__ << ":" << __LINE__ << " unsupported checkpoint version " << hd.version << std::endl;
+		close(fd);
+		return false;
+	}
+
+	prp.resize(hd.n_prp);
+	sz.resize(hd.dim);
+
+	std::vector<checkpoint_block> blocks;
+	if (prp.size() != 0)	{blocks.push_back({(unsigned char *)&prp[0],prp.size()*sizeof(checkpoint_prop)});}
+	if (sz.size() != 0)	{blocks.push_back({(unsigned char *)&sz[0],sz.size()*sizeof(uint64_t)});}
+
+	ok = checkpoint_range_io(fd,false,blocks,0,checkpoint_data_size(blocks),sizeof(hd));
+	close(fd);
+
+	if (ok == false)
+	{
+		std::cerr << "Error " << __FILE__ << ":" << __LINE__ << " error reading the header of " << path << std::endl;
+		return false;
+	}
+
+	if (swap == true)
+	{
+		for (size_t i = 0 ; i < prp.size() ; i++)
+		{
+			checkpoint_swap(&prp[i].type,3 + CHECKPOINT_MAX_RANK,sizeof(uint32_t));
+			checkpoint_swap(&prp[i].size,2,sizeof(uint64_t));
+		}
+
+		checkpoint_swap(sz.data(),sz.size(),sizeof(uint64_t));
+	}
+
+	return true;
+}
+
+/*! \brief Read the data section of a checkpoint
+ *
+ * \param path file
+ * \param hd header
+ * \param blocks where to read (the total size must be the size of the data section)
+ *
+ * \return true if succeed
+ *
+ */
+inline bool checkpoint_read_data(const std::string & path, const checkpoint_header & hd, const std::vector<checkpoint_block> & blocks)
+{
+	if (checkpoint_data_size(blocks) != hd.data_size)
+	{
+		std::cerr << "Error " << __FILE__ << ":" << __LINE__ << " the data section of " << path << " does not match the container" << std::endl;
+		return false;
+	}
+
+	int fd = open(path.c_str(),O_RDONLY);
+
+	if (fd < 0)
+	{
+		std::cerr << "Error " << __FILE__ << ":" << __LINE__ << " cannot open the file " << path << std::endl;
+		return false;
+	}
+
+	bool ok = checkpoint_data_io(path,fd,false,hd,blocks);
+	close(fd);
+
+	if (ok == false)
+	{std::cerr << "Error " << __FILE__ << ":" << __LINE__ << " error reading the checkpoint " << path << std::endl;}
+
+	return ok;
+}
+
+/*! \brief Open the files of the data section of a checkpoint for reading
+ *
+ * \param path checkpoint
+ * \param hd header
+ * \param fds opened files (one for each stripe, or the checkpoint itself)
+ *
+ * \return false if a file cannot be opened (the files already opened are closed)
+ *
+ */
+inline bool checkpoint_open_data(const std::string & path, const checkpoint_header & hd, std::vector<int> & fds)
+{
+	size_t n_file = (hd.n_stripe <= 1)?1:hd.n_stripe;
+
+	for (size_t k = 0 ; k < n_file ; k++)
+	{
+		std::string name = (n_file == 1)?path:checkpoint_stripe_name(path,k);
+		int fd = open(name.c_str(),O_RDONLY);
+
+		if (fd < 0)
+		{
+			std::cerr << "Error " << __FILE__ << ":" << __LINE__ << " cannot open the file " << name << std::endl;
+
+			for (size_t j = 0 ; j < fds.size() ; j++)
+			{close(fds[j]);}
+
+			fds.clear();
+			return false;
+		}
+
+		fds.push_back(fd);
+	}
+
+	return true;
+}
+
+/*! \brief Read the range [start,stop) of the data section of a checkpoint
+ *
+ * \param fds files of the data section (checkpoint_open_data)
+ * \param hd header
+ * \param buf where to read (stop - start bytes)
+ * \param start start of the range in the data section
+ * \param stop end of the range in the data section
+ *
+ * \return false in case of I/O error
+ *
+ */
+inline bool checkpoint_read_range(const std::vector<int> & fds, const checkpoint_header & hd, unsigned char * buf, size_t start, size_t stop)
+{
+	if (fds.size() == 1)
+	{
+		std::vector<checkpoint_block> blocks({{buf,stop - start}});
+		return checkpoint_range_io(fds[0],false,blocks,0,stop - start,hd.data_off + start);
+	}
+
+	for (size_t k = 0 ; k < fds.size() ; k++)
+	{
+		size_t s_start = hd.data_size * k / fds.size();
+		size_t s_stop = hd.data_size * (k+1) / fds.size();
+
+		size_t s = (start > s_start)?start:s_start;
+		size_t e = (stop < s_stop)?stop:s_stop;
+
+		if (s >= e)	{continue;}
+
+		std::vector<checkpoint_block> blocks({{buf + (s - start),e - s}});
+		if (checkpoint_range_io(fds[k],false,blocks,0,e - s,s - s_start) == false)	{return false;}
+	}
+
+	return true;
+}
+
+/*! \brief Check that the properties in the checkpoint match the properties of the container
+ *
+ * \param path file (for the error message)
+ * \param f_prp properties in the checkpoint
+ * \param prp properties of the container
+ *
+ * \return true if they match
+ *
+ */
+inline bool checkpoint_check_schema(const std::string & path, const std::vector<checkpoint_prop> & f_prp, const std::vector<checkpoint_prop> & prp)
+{
+	if (f_prp.size() != prp.size())
+	{
+		std::cerr << "Error " << __FILE__ << ":" << __LINE__ << " the checkpoint " << path << " has " << f_prp.size() << " properties, the container " << prp.size() << std::endl;
+		return false;
+	}
+
+	for (size_t i = 0 ; i < prp.size() ; i++)
+	{
+		bool match = f_prp[i].type == prp[i].type && f_prp[i].comp_size == prp[i].comp_size &&
+					 f_prp[i].rank == prp[i].rank && f_prp[i].size == prp[i].size;
+
+		for (size_t j = 0 ; j < prp[i].rank && j < CHECKPOINT_MAX_RANK ; j++)
+		{match &= f_prp[i].ext[j] == prp[i].ext[j];}
+
+		if (match == false)
+		{
+			std::cerr << "Error " << __FILE__ << ":" << __LINE__ << " the property " << i << " of the checkpoint " << path << " does not match the container" << std::endl;
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/*! \brief Byte swap the components of the data section of a dense container
+ *
+ * \param data data section
+ * \param hd header
+ * \param prp properties
+ *
+ */
+inline void checkpoint_swap_data(unsigned char * data, const checkpoint_header & hd, const std::vector<checkpoint_prop> & prp)
+{
+	if (hd.layout == CHECKPOINT_LAYOUT_INTE)
+	{
+		for (size_t p = 0 ; p < prp.size() ; p++)
+		{
+			checkpoint_swap(data,hd.n_ele*prp[p].n_comp(),prp[p].comp_size);
+			data += hd.n_ele*prp[p].size;
+		}
+
+		return;
+	}
+
+	#pragma omp parallel for if (hd.n_ele >= OPENFPM_OMP_MIN_ELEMENTS)
+	for (size_t e = 0 ; e < hd.n_ele ; e++)
+	{
+		for (size_t p = 0 ; p < prp.size() ; p++)
+		{checkpoint_swap(data + e*hd.ele_size + prp[p].aos_off,prp[p].n_comp(),prp[p].comp_size);}
+	}
+}
+
+/*! \brief Copy the data section of a checkpoint into a dense container converting the layout
+ *
+ * \param data data section (or a piece of it with the same layout and hd.n_ele elements)
+ * \param hd header
+ * \param f_prp properties in the checkpoint
+ * \param prp properties of the container
+ * \param ptr pointers of the properties of the container
+ * \param is_inte true if the container has memory_traits_inte layout
+ * \param n_mem number of elements allocated in the container
+ * \param ele_size size of an element of the container
+ * \param e_start element of the container where the first element of data is copied
+ *
+ */
+inline void checkpoint_convert(const unsigned char * data, const checkpoint_header & hd, const std::vector<checkpoint_prop> & f_prp,
+							   const std::vector<checkpoint_prop> & prp, const std::vector<unsigned char *> & ptr,
+							   bool is_inte, size_t n_mem, size_t ele_size, size_t e_start = 0)
+{
+	size_t n = hd.n_ele;
+
+	// offset of each property in the data section of a checkpoint with memory_traits_inte layout
+	std::vector<size_t> f_off(prp.size());
+	for (size_t p = 0, off = 0 ; p < prp.size() ; p++)
+	{
+		f_off[p] = off;
+		off += n*f_prp[p].size;
+	}
+
+	#pragma omp parallel for if (n >= OPENFPM_OMP_MIN_ELEMENTS)
+	for (size_t e = 0 ; e < n ; e++)
+	{
+		for (size_t p = 0 ; p < prp.size() ; p++)
+		{
+			size_t cs = prp[p].comp_size;
+
+			for (size_t c = 0 ; c < prp[p].n_comp() ; c++)
+			{
+				const unsigned char * src = (hd.layout == CHECKPOINT_LAYOUT_INTE)?data + f_off[p] + (c*n + e)*cs:data + e*hd.ele_size + f_prp[p].aos_off + c*cs;
+				unsigned char * dst = (is_inte == true)?ptr[p] + (c*n_mem + e_start + e)*cs:ptr[0] + (e_start + e)*ele_size + prp[p].aos_off + c*cs;
+
+				memcpy(dst,src,cs);
+			}
+		}
+	}
+}
+
+/*! \brief Save a dense container (openfpm::vector or grid)
+ *
+ * The data are written directly from the memory of the container
+ *
+ * \tparam T aggregate
+ * \tparam layout_base layout of the container
+ *
+ * \param path file
+ * \param cont container
+ * \param kind CHECKPOINT_VECTOR or CHECKPOINT_GRID
+ * \param order CHECKPOINT_ORDER_ROW, CHECKPOINT_ORDER_MORTON or CHECKPOINT_ORDER_TILED
+ * \param sz sizes of the container
+ * \param n number of elements
+ * \param n_mem number of elements allocated
+ * \param n_stripe number of files the data section is split
+ *
+ * \return true if succeed
+ *
+ */
+template<typename T, typename layout_base, typename cont_type>
+bool checkpoint_save_dense(const std::string & path, const cont_type & cont, uint32_t kind, uint32_t order,
+						   const std::vector<uint64_t> & sz, size_t n, size_t n_mem, size_t n_stripe)
+{
+	std::vector<checkpoint_prop> prp;
+	checkpoint_schema<T>::fill(prp);
+
+	bool is_inte = is_layout_inte<layout_base>::value;
+
+	std::vector<unsigned char *> ptr;
+	checkpoint_pointers<const cont_type> cp(cont,ptr);
+	boost::mpl::for_each_ref<boost::mpl::range_c<int,0,T::max_prop>>(cp);
+
+	std::vector<checkpoint_block> blocks;
+	if (n != 0)	{checkpoint_dense_blocks(prp,ptr,is_inte,n,n_mem,sizeof(typename T::type),blocks);}
+
+	checkpoint_header hd;
+	memset(&hd,0,sizeof(hd));
+
+	hd.kind = kind;
+	hd.layout = (is_inte == true)?CHECKPOINT_LAYOUT_INTE:CHECKPOINT_LAYOUT_LIN;
+	hd.order = order;
+	hd.n_ele = n;
+	hd.ele_size = sizeof(typename T::type);
+
+	return checkpoint_write(path,hd,prp,sz,blocks,n_stripe);
+}
+
+/*! \brief Load a dense container (openfpm::vector or grid)
+ *
+ * When the checkpoint has the same layout of the container the data are read directly into the memory
+ * of the container, otherwise the data section is read and converted in pieces of CHECKPOINT_CONVERT_BUFFER
+ * bytes
+ *
+ * \tparam T aggregate
+ * \tparam layout_base layout of the container
+ *
+ * \param path file
+ * \param cont container
+ * \param kind CHECKPOINT_VECTOR or CHECKPOINT_GRID
+ * \param order CHECKPOINT_ORDER_ROW, CHECKPOINT_ORDER_MORTON or CHECKPOINT_ORDER_TILED
+ * \param dim dimensionality of the container
+ * \param resize function called with the sizes in the checkpoint, it resize the container and return the number of elements allocated
+ *
+ * \return true if succeed
+ *
+ */
+template<typename T, typename layout_base, typename cont_type, typename resize_type>
+bool checkpoint_load_dense(const std::string & path, cont_type & cont, uint32_t kind, uint32_t order, size_t dim, resize_type resize)
+{
+	checkpoint_header hd;
+	std::vector<checkpoint_prop> f_prp;
+	std::vector<uint64_t> sz;
+	bool swap;
+
+	if (checkpoint_read_header(path,hd,f_prp,sz,swap) == false)	{return false;}
+
+	std::vector<checkpoint_prop> prp;
+	checkpoint_schema<T>::fill(prp);
+
+	if (hd.kind != kind || hd.order != order || hd.dim != dim)
+	{
+		std::cerr << "Error " << __FILE__ << ":" << __LINE__ << " the checkpoint " << path << " contain a different type of container" << std::endl;
+		return false;
+	}
+
+	if (checkpoint_check_schema(path,f_prp,prp) == false)	{return false;}
+
+	size_t n = hd.n_ele;
+	size_t n_mem = resize(sz);
+
+	if (n > n_mem)
+	{
+		std::cerr << "Error " << __FILE__ << ":" << __LINE__ << " the checkpoint " << path << " contain " << n << " elements but the container allocated " << n_mem << std::endl;
+		return false;
+	}
+
+	bool is_inte = is_layout_inte<layout_base>::value;
+
+	std::vector<unsigned char *> ptr;
+	checkpoint_pointers<cont_type> cp(cont,ptr);
+	boost::mpl::for_each_ref<boost::mpl::range_c<int,0,T::max_prop>>(cp);
+
+	if (n == 0)	{return true;}
+
+	bool same_layout = (hd.layout == ((is_inte == true)?CHECKPOINT_LAYOUT_INTE:CHECKPOINT_LAYOUT_LIN));
+
+	if (same_layout == true && swap == false && hd.ele_size == sizeof(typename T::type))
+	{
+		std::vector<checkpoint_block> blocks;
+		checkpoint_dense_blocks(prp,ptr,is_inte,n,n_mem,sizeof(typename T::type),blocks);
+
+		return checkpoint_read_data(path,hd,blocks);
+	}
+
+	// size of an element in the data section
+	size_t f_ele = hd.ele_size;
+
+	if (hd.layout == CHECKPOINT_LAYOUT_INTE)
+	{
+		f_ele = 0;
+		for (size_t p = 0 ; p < f_prp.size() ; p++)
+		{f_ele += f_prp[p].size;}
+	}
+
+	if (hd.data_size != n*f_ele)
+	{
+		std::cerr << "Error " << __FILE__ << ":" << __LINE__ << " the data section of " << path << " does not match the container" << std::endl;
+		return false;
+	}
+
+	std::vector<int> fds;
+	if (checkpoint_open_data(path,hd,fds) == false)	{return false;}
+
+	// read and convert in pieces of at most CHECKPOINT_CONVERT_BUFFER bytes, every piece is a
+	// data section of n_c elements with the layout of the checkpoint
+	size_t n_c = (CHECKPOINT_CONVERT_BUFFER / f_ele == 0)?1:(CHECKPOINT_CONVERT_BUFFER / f_ele);
+	if (n_c > n)	{n_c = n;}
+
+	std::vector<unsigned char> data(n_c*f_ele);
+	checkpoint_header hd_c = hd;
+	bool ok = true;
+
+	for (size_t e = 0 ; e < n && ok == true ; e += n_c)
+	{
+		hd_c.n_ele = (n - e < n_c)?(n - e):n_c;
+
+		if (hd.layout == CHECKPOINT_LAYOUT_INTE)
+		{
+			unsigned char * dst = data.data();
+			size_t f_off = 0;
+
+			for (size_t p = 0 ; p < f_prp.size() && ok == true ; p++)
+			{
+				size_t cs = f_prp[p].comp_size;
+
+				for (size_t c = 0 ; c < f_prp[p].n_comp() && ok == true ; c++)
+				{
+					size_t start = f_off + (c*n + e)*cs;
+					ok = checkpoint_read_range(fds,hd,dst,start,start + hd_c.n_ele*cs);
+					dst += hd_c.n_ele*cs;
+				}
+
+				f_off += n*f_prp[p].size;
+			}
+		}
+		else
+		{ok = checkpoint_read_range(fds,hd,data.data(),e*f_ele,(e + hd_c.n_ele)*f_ele);}
+
+		if (ok == false)	{break;}
+
+		if (swap == true)	{checkpoint_swap_data(data.data(),hd_c,f_prp);}
+
+		checkpoint_convert(data.data(),hd_c,f_prp,prp,ptr,is_inte,n_mem,sizeof(typename T::type),e);
+	}
+
+	for (size_t k = 0 ; k < fds.size() ; k++)
+	{close(fds[k]);}
+
+	if (ok == false)
+	{std::cerr << "Error " << __FILE__ << ":" << __LINE__ << " error reading the checkpoint " << path << std::endl;}
+
+	return ok;
+}
+
+/*! \brief Copy a property of a point of a sparse grid from/to the data section (memory_traits_inte layout)
+ *
+ * \tparam T type of the property
+ *
+ */
+template<typename T, unsigned int rank = std::rank<T>::value>
+struct checkpoint_sparse_cp
+{
+	typedef typename std::remove_all_extents<T>::type comp_type;
+
+	static_assert(rank == 1,"checkpoint of a sparse grid support scalar and 1D array properties");
+
+	/*! \brief Copy the property into the data section
+	 *
+	 * \param v property
+	 * \param base data of the property in the data section
+	 * \param n number of points
+	 * \param i point
+	 *
+	 */
+	template<typename v_type> static inline void gather(const v_type & v, unsigned char * base, size_t n, size_t i)
+	{
+		for (size_t c = 0 ; c < std::extent<T>::value ; c++)
+		{
+			comp_type tmp = v[c];
+			memcpy(base + (c*n + i)*sizeof(comp_type),&tmp,sizeof(comp_type));
+		}
+	}
+
+	/*! \brief Copy the property from the data section
+	 *
+	 * \param v property
+	 * \param base data of the property in the data section
+	 * \param n number of points
+	 * \param i point
+	 *
+	 */
+	template<typename v_type> static inline void scatter(v_type && v, const unsigned char * base, size_t n, size_t i)
+	{
+		for (size_t c = 0 ; c < std::extent<T>::value ; c++)
+		{
+			comp_type tmp;
+			memcpy(&tmp,base + (c*n + i)*sizeof(comp_type),sizeof(comp_type));
+			v[c] = tmp;
+		}
+	}
+};
+
+//! Copy a scalar property of a point of a sparse grid from/to the data section
+template<typename T>
+struct checkpoint_sparse_cp<T,0>
+{
+	template<typename v_type> static inline void gather(const v_type & v, unsigned char * base, size_t /*n*/, size_t i)
+	{
+		T tmp = v;
+		memcpy(base + i*sizeof(T),&tmp,sizeof(T));
+	}
+
+	template<typename v_type> static inline void scatter(v_type && v, const unsigned char * base, size_t /*n*/, size_t i)
+	{
+		T tmp;
+		memcpy(&tmp,base + i*sizeof(T),sizeof(T));
+		v = tmp;
+	}
+};
+
+/*! \brief Copy the properties of a point of a sparse grid into the data section
+ *
+ * \tparam T aggregate
+ * \tparam grid_type sparse grid
+ * \tparam key_type key of the point
+ *
+ */
+template<typename T, typename grid_type, typename key_type>
+struct checkpoint_sparse_gather
+{
+	//! sparse grid
+	const grid_type & g;
+
+	//! point
+	const key_type & key;
+
+	//! data of the properties
+	const std::vector<unsigned char *> & ptr;
+
+	//! number of points
+	size_t n;
+
+	//! index of the point
+	size_t i;
+
+	/*! \brief Constructor
+	 *
+	 * \param g sparse grid
+	 * \param key point
+	 * \param ptr data of the properties
+	 * \param n number of points
+	 * \param i index of the point
+	 *
+	 */
+	checkpoint_sparse_gather(const grid_type & g, const key_type & key, const std::vector<unsigned char *> & ptr, size_t n, size_t i)
+	:g(g),key(key),ptr(ptr),n(n),i(i)
+	{}
+
+	//! Copy the property
+	template<typename t_prp> inline void operator()(t_prp & /*t*/)
+	{
+		typedef typename boost::mpl::at<typename T::type,t_prp>::type prp_type;
+
+		checkpoint_sparse_cp<prp_type>::gather(g.template get<t_prp::value>(key),ptr[t_prp::value],n,i);
+	}
+};
+
+/*! \brief Insert a point in a sparse grid with the properties in the data section
+ *
+ * \tparam T aggregate
+ * \tparam grid_type sparse grid
+ * \tparam key_type key of the point
+ *
+ */
+template<typename T, typename grid_type, typename key_type>
+struct checkpoint_sparse_scatter
+{
+	//! sparse grid
+	grid_type & g;
+
+	//! point
+	const key_type & key;
+
+	//! data of the properties
+	const std::vector<unsigned char *> & ptr;
+
+	//! number of points
+	size_t n;
+
+	//! index of the point
+	size_t i;
+
+	/*! \brief Constructor
+	 *
+	 * \param g sparse grid
+	 * \param key point
+	 * \param ptr data of the properties
+	 * \param n number of points
+	 * \param i index of the point
+	 *
+	 */
+	checkpoint_sparse_scatter(grid_type & g, const key_type & key, const std::vector<unsigned char *> & ptr, size_t n, size_t i)
+	:g(g),key(key),ptr(ptr),n(n),i(i)
+	{}
+
+	//! Insert the property
+	template<typename t_prp> inline void operator()(t_prp & /*t*/)
+	{
+		typedef typename boost::mpl::at<typename T::type,t_prp>::type prp_type;
+
+		checkpoint_sparse_cp<prp_type>::scatter(g.template insert<t_prp::value>(key),ptr[t_prp::value],n,i);
+	}
+};
+
+/*! \brief Save a sparse grid
+ *
+ * The data section contain the keys of the points followed by the properties (memory_traits_inte layout),
+ * the checkpoint does not depend on the chunking of the sparse grid
+ *
+ * \tparam T aggregate
+ * \tparam dim dimensionality
+ *
+ * \param path file
+ * \param g sparse grid
+ * \param n_stripe number of files the data section is split
+ *
+ * \return true if succeed
+ *
+ */
+template<typename T, unsigned int dim, typename grid_type>
+bool checkpoint_save_sparse(const std::string & path, const grid_type & g, size_t n_stripe)
+{
+	std::vector<checkpoint_prop> prp;
+	checkpoint_schema<T>::fill(prp);
+
+	size_t n = g.size();
+
+	std::vector<int64_t> keys(n*dim);
+	std::vector<std::vector<unsigned char>> data(prp.size());
+	std::vector<unsigned char *> ptr(prp.size());
+
+	for (size_t p = 0 ; p < prp.size() ; p++)
+	{
+		data[p].resize(n*prp[p].size);
+		ptr[p] = data[p].data();
+	}
+
+	auto it = g.getIterator();
+
+	for (size_t i = 0 ; it.isNext() && i < n ; i++, ++it)
+	{
+		auto key = it.get();
+
+		for (size_t d = 0 ; d < dim ; d++)
+		{keys[i*dim + d] = key.get(d);}
+
+		checkpoint_sparse_gather<T,grid_type,decltype(key)> cp(g,key,ptr,n,i);
+		boost::mpl::for_each_ref<boost::mpl::range_c<int,0,T::max_prop>>(cp);
+	}
+
+	std::vector<checkpoint_block> blocks;
+	if (n != 0)
+	{
+		blocks.push_back({(unsigned char *)keys.data(),keys.size()*sizeof(int64_t)});
+
+		for (size_t p = 0 ; p < prp.size() ; p++)
+		{blocks.push_back({ptr[p],data[p].size()});}
+	}
+
+	std::vector<uint64_t> sz(dim);
+	for (size_t d = 0 ; d < dim ; d++)
+	{sz[d] = g.getGrid().size(d);}
+
+	checkpoint_header hd;
+	memset(&hd,0,sizeof(hd));
+
+	hd.kind = CHECKPOINT_SPARSE_GRID;
+	hd.layout = CHECKPOINT_LAYOUT_INTE;
+	hd.order = CHECKPOINT_ORDER_ROW;
+	hd.n_ele = n;
+	hd.ele_size = sizeof(typename T::type);
+
+	return checkpoint_write(path,hd,prp,sz,blocks,n_stripe);
+}
+
+/*! \brief Load a sparse grid
+ *
+ * \tparam T aggregate
+ * \tparam dim dimensionality
+ *
+ * \param path file
+ * \param g sparse grid
+ * \param resize function called with the sizes in the checkpoint, it must clear and resize the sparse grid
+ *
+ * \return true if succeed
+ *
+ */
+template<typename T, unsigned int dim, typename grid_type, typename resize_type>
+bool checkpoint_load_sparse(const std::string & path, grid_type & g, resize_type resize)
+{
+	checkpoint_header hd;
+	std::vector<checkpoint_prop> f_prp;
+	std::vector<uint64_t> sz;
+	bool swap;
+
+	if (checkpoint_read_header(path,hd,f_prp,sz,swap) == false)	{return false;}
+
+	std::vector<checkpoint_prop> prp;
+	checkpoint_schema<T>::fill(prp);
+
+	if (hd.kind != CHECKPOINT_SPARSE_GRID || hd.dim != dim || hd.layout != CHECKPOINT_LAYOUT_INTE)
+	{
+		std::cerr << "Error " << __FILE__ << ":" << __LINE__ << " the checkpoint " << path << " contain a different type of container" << std::endl;
+		return false;
+	}
+
+	if (checkpoint_check_schema(path,f_prp,prp) == false)	{return false;}
+
+	resize(sz);
+
+	size_t n = hd.n_ele;
+	if (n == 0)	{return true;}
+
+	std::vector<int64_t> keys(n*dim);
+	std::vector<unsigned char> data(hd.data_size - keys.size()*sizeof(int64_t));
+
+	std::vector<checkpoint_block> blocks({{(unsigned char *)keys.data(),keys.size()*sizeof(int64_t)},{data.data(),data.size()}});
+	if (checkpoint_read_data(path,hd,blocks) == false)	{return false;}
+
+	if (swap == true)
+	{
+		checkpoint_swap(keys.data(),keys.size(),sizeof(int64_t));
+		checkpoint_swap_data(data.data(),hd,f_prp);
+	}
+
+	std::vector<unsigned char *> ptr(prp.size());
+	for (size_t p = 0, off = 0 ; p < prp.size() ; p++)
+	{
+		ptr[p] = data.data() + off;
+		off += n*prp[p].size;
+	}
+
+	typedef typename std::remove_reference<decltype(g.getIterator().get())>::type key_type;
+
+	for (size_t i = 0 ; i < n ; i++)
+	{
+		key_type key;
+
+		for (size_t d = 0 ; d < dim ; d++)
+		{key.set_d(d,keys[i*dim + d]);}
+
+		checkpoint_sparse_scatter<T,grid_type,key_type> cp(g,key,ptr,n,i);
+		boost::mpl::for_each_ref<boost::mpl::range_c<int,0,T::max_prop>>(cp);
+	}
+
+	return true;
+}
+
+/*! \brief Implementation of save/load of the containers
+ *
+ * \tparam T aggregate
+ *
+ */
+template<typename T>
+struct checkpoint_call
+{
+	//! see checkpoint_save_dense
+	template<typename layout_base, typename cont_type>
+	static bool save_dense(const std::string & path, const cont_type & cont, uint32_t kind, uint32_t order,
+						   const std::vector<uint64_t> & sz, size_t n, size_t n_mem, size_t n_stripe)
+	{
+		return checkpoint_save_dense<T,layout_base>(path,cont,kind,order,sz,n,n_mem,n_stripe);
+	}
+
+	//! see checkpoint_load_dense
+	template<typename layout_base, typename cont_type, typename resize_type>
+	static bool load_dense(const std::string & path, cont_type & cont, uint32_t kind, uint32_t order, size_t dim, resize_type resize)
+	{
+		return checkpoint_load_dense<T,layout_base>(path,cont,kind,order,dim,resize);
+	}
+
+	//! see checkpoint_save_sparse
+	template<unsigned int dim, typename grid_type>
+	static bool save_sparse(const std::string & path, const grid_type & g, size_t n_stripe)
+	{
+		return checkpoint_save_sparse<T,dim>(path,g,n_stripe);
+	}
+
+	//! see checkpoint_load_sparse
+	template<unsigned int dim, typename grid_type, typename resize_type>
+	static bool load_sparse(const std::string & path, grid_type & g, resize_type resize)
+	{
+		return checkpoint_load_sparse<T,dim>(path,g,resize);
+	}
+};
+
+#endif /* OPENFPM_DATA_SRC_PACKER_UNPACKER_CHECKPOINT_HPP_ */
@@ -0,0 +1,33 @@
+/*
+ * Checkpoint_fwd.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Pietro Incardona
+ */
+
+#ifndef OPENFPM_DATA_SRC_PACKER_UNPACKER_CHECKPOINT_FWD_HPP_
+#define OPENFPM_DATA_SRC_PACKER_UNPACKER_CHECKPOINT_FWD_HPP_
+
+//! the checkpoint contain an openfpm::vector
+#define CHECKPOINT_VECTOR 0
+//! the checkpoint contain a dense grid
+#define CHECKPOINT_GRID 1
+//! the checkpoint contain a sparse grid
+#define CHECKPOINT_SPARSE_GRID 2
+
+//! elements stored in row-major order
+#define CHECKPOINT_ORDER_ROW 0
+//! elements stored in Morton order (grid_zm)
+#define CHECKPOINT_ORDER_MORTON 1
+//! elements stored in tiles (grid_smt)
+#define CHECKPOINT_ORDER_TILED 2
+
+/*! \brief Implementation of save/load of the containers, defined in Packer_Unpacker/Checkpoint.hpp
+ *
+ * \tparam T aggregate
+ *
+ */
+template<typename T>
+struct checkpoint_call;
+
+#endif /* OPENFPM_DATA_SRC_PACKER_UNPACKER_CHECKPOINT_FWD_HPP_ */
@@ -0,0 +1,1149 @@
+/*
+ * Packer_compress.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Pietro Incardona
+ */
+
+#ifndef OPENFPM_DATA_SRC_PACKER_UNPACKER_PACKER_COMPRESS_HPP_
+#define OPENFPM_DATA_SRC_PACKER_UNPACKER_PACKER_COMPRESS_HPP_
+
+#include <vector>
+#include <cstring>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+#include "Packer_stream.hpp"
+#include "util/variadic_to_vmpl.hpp"
+#include "timer.hpp"
+
+//! Lossless: the bytes of the property are shuffled by significance and compressed with an LZ codec
+#define PACK_COMPRESS_LOSSLESS 0
+//! Lossy (floating point only): quantization on a fixed number of bits, the parameter is the number of bits (1-32)
+#define PACK_COMPRESS_FIXED_RATE 1
+//! Lossy (floating point only): quantization with an absolute error smaller than the parameter
+#define PACK_COMPRESS_ERROR_BOUND 2
+//! Lossless (integers only): delta encoding plus bit-packing, optimal for sorted indexes
+#define PACK_COMPRESS_DELTA 3
+
+//! Number of values bit-packed with the same width in PACK_COMPRESS_DELTA
+#define PACK_COMPRESS_DELTA_BLOCK 128
+
+//! Size of the hash table of the LZ codec (log2)
+#define PACK_COMPRESS_LZ_HASH_BITS 14
+
+/*! \brief Compression mode of each property
+ *
+ * The properties not set are compressed with PACK_COMPRESS_LOSSLESS
+ *
+ * \code{.cpp}
+ * pack_compress_opt opt;
+ * opt.set(0,PACK_COMPRESS_ERROR_BOUND,1e-4).set(2,PACK_COMPRESS_DELTA);
+ * \endcode
+ *
+ */
+class pack_compress_opt
+{
+	//! mode of each property
+	std::vector<int> mode;
+
+	//! parameter of each property
+	std::vector<double> par;
+
+public:
+
+	/*! \brief Set the compression mode of a property
+	 *
+	 * \param prp property
+	 * \param m mode
+	 * \param p parameter of the mode (bits for PACK_COMPRESS_FIXED_RATE, error for PACK_COMPRESS_ERROR_BOUND)
+	 *
+	 * \return itself
+	 *
+	 */
+	pack_compress_opt & set(size_t prp, int m, double p = 0.0)
+	{
+		if (prp >= mode.size())
+		{
+			mode.resize(prp+1,PACK_COMPRESS_LOSSLESS);
+			par.resize(prp+1,0.0);
+		}
+
+		mode[prp] = m;
+		par[prp] = p;
+
+		return *this;
+	}
+
+	/*! \brief Get the compression mode of a property
+	 *
+	 * \param prp property
+	 *
+	 * \return the mode
+	 *
+	 */
+	int getMode(size_t prp) const
+	{
+		return (prp < mode.size())?mode[prp]:PACK_COMPRESS_LOSSLESS;
+	}
+
+	/*! \brief Get the parameter of the compression mode of a property
+	 *
+	 * \param prp property
+	 *
+	 * \return the parameter
+	 *
+	 */
+	double getParameter(size_t prp) const
+	{
+		return (prp < par.size())?par[prp]:0.0;
+	}
+};
+
+/*! \brief Append a value to a byte buffer
+ *
+ * \param out buffer
+ * \param v value
+ *
+ */
+template<typename T> inline void pack_compress_put(std::vector<unsigned char> & out, const T & v)
+{
+	size_t sz = out.size();
+	out.resize(sz + sizeof(T));
+	memcpy(&out[sz],&v,sizeof(T));
+}
+
+/*! \brief Read a value from a byte buffer
+ *
+ * \param ptr position in the buffer (moved after the value)
+ * \param end end of the buffer
+ * \param v value
+ *
+ * \return false if the buffer is too short
+ *
+ */
+template<typename T> inline bool pack_compress_get(const unsigned char * & ptr, const unsigned char * end, T & v)
+{
+	if ((size_t)(end - ptr) < sizeof(T))	{return false;}
+
+	memcpy(&v,ptr,sizeof(T));
+	ptr += sizeof(T);
+
+	return true;
+}
+
+/*! \brief Write values of a given number of bits in a byte buffer
+ *
+ */
+class pack_bit_writer
+{
+	//! output buffer
+	std::vector<unsigned char> & out;
+
+	//! bits not yet written
+	uint64_t acc;
+
+	//! number of bits in acc
+	unsigned int n;
+
+public:
+
+	/*! \brief Constructor
+	 *
+	 * \param out output buffer
+	 *
+	 */
+	pack_bit_writer(std::vector<unsigned char> & out)
+	:out(out),acc(0),n(0)
+	{}
+
+	/*! \brief Write the w less significant bits of v
+	 *
+	 * \param v value
+	 * \param w number of bits (0-64)
+	 *
+	 */
+	inline void write(uint64_t v, unsigned int w)
+	{
+		if (w > 32)
+		{
+			write(v & 0xFFFFFFFF,32);
+			write(v >> 32,w - 32);
+			return;
+		}
+
+		if (w == 0)	{return;}
+
+		acc |= (v & (((uint64_t)1 << w) - 1)) << n;
+		n += w;
+
+		while (n >= 8)
+		{
+			out.push_back(acc & 0xFF);
+			acc >>= 8;
+			n -= 8;
+		}
+	}
+
+	//! Write the remaining bits
+	inline void flush()
+	{
+		if (n != 0)	{out.push_back(acc & 0xFF);}
+
+		acc = 0;
+		n = 0;
+	}
+};
+
+/*! \brief Read values of a given number of bits from a byte buffer
+ *
+ */
+class pack_bit_reader
+{
+	//! position in the buffer
+	const unsigned char * ptr;
+
+	//! end of the buffer
+	const unsigned char * end;
+
+	//! bits not yet read
+	uint64_t acc;
+
+	//! number of bits in acc
+	unsigned int n;
+
+	//! true if we read after the end of the buffer
+	bool err;
+
+public:
+
+	/*! \brief Constructor
+	 *
+	 * \param ptr start of the buffer
+	 * \param end end of the buffer
+	 *
+	 */
+	pack_bit_reader(const unsigned char * ptr, const unsigned char * end)
+	:ptr(ptr),end(end),acc(0),n(0),err(false)
+	{}
+
+	/*! \brief Read a value of w bits
+	 *
+	 * \param w number of bits (0-64)
+	 *
+	 * \return the value
+	 *
+	 */
+	inline uint64_t read(unsigned int w)
+	{
+		if (w > 32)
+		{
+			uint64_t lo = read(32);
+			return lo | (read(w - 32) << 32);
+		}
+
+		if (w == 0)	{return 0;}
+
+		while (n < w)
+		{
+			if (ptr == end)	{err = true; return 0;}
+
+			acc |= (uint64_t)*ptr << n;
+			ptr++;
+			n += 8;
+		}
+
+		uint64_t v = acc & (((uint64_t)1 << w) - 1);
+		acc >>= w;
+		n -= w;
+
+		return v;
+	}
+
+	/*! \brief Position after the last byte used (the remaining bits of the last byte are discarded)
+	 *
+	 * \return the position
+	 *
+	 */
+	inline const unsigned char * position() const
+	{
+		return ptr;
+	}
+
+	/*! \brief Return true if the buffer was too short
+	 *
+	 * \return true in case of error
+	 *
+	 */
+	inline bool error() const
+	{
+		return err;
+	}
+};
+
+/*! \brief Number of bits required to represent v
+ *
+ * \param v value
+ *
+ * \return the number of bits
+ *
+ */
+inline unsigned int pack_compress_width(uint64_t v)
+{
+	return (v == 0)?0:64 - __builtin_clzl(v);
+}
+
+/*! \brief Write a length of the LZ codec (continuation bytes of 255)
+ *
+ * \param out output buffer
+ * \param l length
+ *
+ */
+inline void pack_lz_put_len(std::vector<unsigned char> & out, size_t l)
+{
+	while (l >= 255)
+	{
+		out.push_back(255);
+		l -= 255;
+	}
+
+	out.push_back(l);
+}
+
+/*! \brief Write a sequence of the LZ codec, literals followed by a match
+ *
+ * \param out output buffer
+ * \param lit literals
+ * \param n_lit number of literals
+ * \param off offset of the match
+ * \param n_match length of the match (0 only for the last sequence)
+ *
+ */
+inline void pack_lz_put_seq(std::vector<unsigned char> & out, const unsigned char * lit, size_t n_lit, size_t off, size_t n_match)
+{
+	size_t ml = (n_match == 0)?0:n_match - 4;
+
+	out.push_back(((n_lit < 15)?n_lit:15) << 4 | ((ml < 15)?ml:15));
+
+	if (n_lit >= 15)	{pack_lz_put_len(out,n_lit - 15);}
+
+	out.insert(out.end(),lit,lit + n_lit);
+
+	if (n_match == 0)	{return;}
+
+	out.push_back(off & 0xFF);
+	out.push_back(off >> 8);
+
+	if (ml >= 15)	{pack_lz_put_len(out,ml - 15);}
+}
+
+/*! \brief Compress a buffer with a fast LZ77 codec
+ *
+ * The format is a sequence of (token, literals, offset, match length) like LZ4, the matches are searched
+ * with a hash table of 4 byte sequences in a window of 64KB. The output start with the size of the input
+ *
+ * \param src data to compress
+ * \param n size in byte
+ * \param out compressed data are appended here
+ *
+ */
+inline void pack_lz_compress(const unsigned char * src, size_t n, std::vector<unsigned char> & out)
+{
+	pack_compress_put(out,n);
+
+	std::vector<size_t> table((size_t)1 << PACK_COMPRESS_LZ_HASH_BITS,(size_t)-1);
+
+	size_t i = 0;
+	size_t anchor = 0;
+
+	while (i + 4 <= n)
+	{
+		uint32_t seq;
+		memcpy(&seq,src + i,4);
+
+		size_t h = (seq * 2654435761u) >> (32 - PACK_COMPRESS_LZ_HASH_BITS);
+		size_t cand = table[h];
+		table[h] = i;
+
+		if (cand != (size_t)-1 && i - cand <= 0xFFFF && memcmp(src + cand,src + i,4) == 0)
+		{
+			size_t l = 4;
+			while (i + l < n && src[cand + l] == src[i + l])	{l++;}
+
+			pack_lz_put_seq(out,src + anchor,i - anchor,i - cand,l);
+
+			i += l;
+			anchor = i;
+		}
+		else
+		{
+			// skip faster in data that does not compress
+			i += 1 + ((i - anchor) >> 6);
+		}
+	}
+
+	pack_lz_put_seq(out,src + anchor,n - anchor,0,0);
+}
+
+/*! \brief Read a length of the LZ codec
+ *
+ * \param ptr position in the buffer (moved after the length)
+ * \param end end of the buffer
+ * \param l length (incremented)
+ *
+ * \return false if the buffer is too short
+ *
+ */
+inline bool pack_lz_get_len(const unsigned char * & ptr, const unsigned char * end, size_t & l)
+{
+	unsigned char c;
+
+	do
+	{
+		if (ptr == end)	{return false;}
+
+		c = *ptr++;
+		l += c;
+	} while (c == 255);
+
+	return true;
+}
+
+/*! \brief Decompress a buffer compressed with pack_lz_compress
+ *
+ * \param ptr position of the compressed data (moved after the compressed data)
+ * \param end end of the buffer
+ * \param out decompressed data (resized)
+ *
+ * \return false if the compressed data are corrupted
+ *
+ */
+inline bool pack_lz_decompress(const unsigned char * & ptr, const unsigned char * end, std::vector<unsigned char> & out)
+{
+	size_t n;
+	if (pack_compress_get(ptr,end,n) == false)	{return false;}
+
+	out.resize(n);
+	unsigned char * dst = out.data();
+	size_t o = 0;
+
+	while (true)
+	{
+		if (ptr == end)	{return false;}
+
+		unsigned char token = *ptr++;
+
+		size_t n_lit = token >> 4;
+		if (n_lit == 15 && pack_lz_get_len(ptr,end,n_lit) == false)	{return false;}
+
+		if ((size_t)(end - ptr) < n_lit || n - o < n_lit)	{return false;}
+
+		if (n_lit != 0)
+		{memcpy(dst + o,ptr,n_lit);}
+		ptr += n_lit;
+		o += n_lit;
+
+		if (o == n)	{return true;}
+
+		if (end - ptr < 2)	{return false;}
+
+		size_t off = ptr[0] | (size_t)ptr[1] << 8;
+		ptr += 2;
+
+		size_t ml = token & 0xF;
+		if (ml == 15 && pack_lz_get_len(ptr,end,ml) == false)	{return false;}
+		ml += 4;
+
+		if (off == 0 || off > o || n - o < ml)	{return false;}
+
+		// the match can overlap the output
+		for (size_t j = 0 ; j < ml ; j++, o++)
+		{dst[o] = dst[o - off];}
+	}
+}
+
+/*! \brief Compress a generic buffer (for example the memory of a Packer) with the lossless codec
+ *
+ * \param ptr data
+ * \param sz size in byte
+ * \param out compressed data (appended)
+ * \param sts pack statistic (compression ratio and throughput)
+ *
+ */
+inline void pack_compress_buffer(const void * ptr, size_t sz, std::vector<unsigned char> & out, Pack_stat & sts)
+{
+	timer t;
+	t.start();
+
+	size_t start = out.size();
+	pack_lz_compress((const unsigned char *)ptr,sz,out);
+
+	t.stop();
+	sts.addCompression(sz,out.size() - start,t.getwct());
+}
+
+/*! \brief Decompress a buffer compressed with pack_compress_buffer
+ *
+ * \param ptr compressed data
+ * \param sz size in byte of the compressed data
+ * \param out decompressed data
+ *
+ * \return false if the compressed data are corrupted
+ *
+ */
+inline bool pack_decompress_buffer(const void * ptr, size_t sz, std::vector<unsigned char> & out)
+{
+	const unsigned char * p = (const unsigned char *)ptr;
+
+	if (pack_lz_decompress(p,p + sz,out) == false)
+	{
+		std::cerr << "Error " << __FILE__ << ":" << __LINE__ << " corrupted compressed buffer" << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+/*! \brief Copy a property (array properties component by component)
+ *
+ * It work for properties of memory_traits_lin and memory_traits_inte layout
+ *
+ * \tparam T type of the property
+ *
+ */
+template<typename T, unsigned int rank = std::rank<T>::value>
+struct pack_compress_cp
+{
+	template<typename Ts, typename Td> static inline void copy(Ts && src, Td && dst)
+	{
+		for (size_t i = 0 ; i < std::extent<T>::value ; i++)
+		{pack_compress_cp<typename std::remove_extent<T>::type>::copy(src[i],dst[i]);}
+	}
+};
+
+//! Copy a scalar property
+template<typename T>
+struct pack_compress_cp<T,0>
+{
+	template<typename Ts, typename Td> static inline void copy(Ts && src, Td && dst)
+	{
+		dst = src;
+	}
+};
+
+/*! \brief Codec of a property stream, the stream contain the components of the property
+ *
+ * \tparam T type of the component
+ * \tparam is_fp true for floating point components
+ * \tparam is_int true for integer components
+ *
+ */
+template<typename T, bool is_fp = std::is_floating_point<T>::value && sizeof(T) <= 8, bool is_int = std::is_integral<T>::value>
+struct pack_compress_codec
+{
+	/*! \brief Check if a mode can be used with this component type
+	 *
+	 * \param mode mode
+	 *
+	 * \return true if the mode can be used
+	 *
+	 */
+	static bool valid(int mode)
+	{
+		return mode == PACK_COMPRESS_LOSSLESS;
+	}
+
+	//! lossy modes are not available
+	static void compress(const T * /*v*/, size_t /*n*/, int /*mode*/, double /*par*/, std::vector<unsigned char> & /*out*/)
+	{}
+
+	//! lossy modes are not available
+	static bool decompress(const unsigned char * & /*ptr*/, const unsigned char * /*end*/, T * /*v*/, size_t /*n*/, int /*mode*/)
+	{
+		return false;
+	}
+};
+
+//! Codec of a floating point property stream (quantization)
+template<typename T>
+struct pack_compress_codec<T,true,false>
+{
+	static bool valid(int mode)
+	{
+		return mode == PACK_COMPRESS_LOSSLESS || mode == PACK_COMPRESS_FIXED_RATE || mode == PACK_COMPRESS_ERROR_BOUND;
+	}
+
+	/*! \brief Number of bits to store the quantized components
+	 *
+	 * \param mn minimum
+	 * \param mx maximum
+	 * \param step quantization step
+	 *
+	 * \return the number of bits (64 if the step is too small)
+	 *
+	 */
+	static unsigned int error_bound_width(double mn, double mx, double step)
+	{
+		double q_max = std::floor((mx - mn) / step + 0.5);
+		return (step <= 0.0 || !(q_max < 4503599627370496.0))?64:pack_compress_width((uint64_t)q_max);
+	}
+
+	/*! \brief Check that the components reconstructed as T are within the error bound
+	 *
+	 * \param v components
+	 * \param n number of components
+	 * \param mn minimum
+	 * \param step quantization step
+	 * \param par maximum error
+	 *
+	 * \return true if every reconstructed component is within par
+	 *
+	 */
+	static bool check_bound(const T * v, size_t n, double mn, double step, double par)
+	{
+		for (size_t i = 0 ; i < n ; i++)
+		{
+			uint64_t q = (uint64_t)std::floor((v[i] - mn) / step + 0.5);
+			T r = mn + q*step;
+
+			if (!(std::fabs((double)r - (double)v[i]) <= par))	{return false;}
+		}
+
+		return true;
+	}
+
+	/*! \brief Quantize the components
+	 *
+	 * The bits of the components are stored unchanged when the quantization step is smaller than the
+	 * precision of T at the largest magnitude, or when the components contain NaN or infinite values.
+	 * With PACK_COMPRESS_ERROR_BOUND the step leave room for the rounding of the reconstructed value
+	 * to T, and the reconstructed components are checked against the bound: the step is halved when
+	 * the check fail, and the bits are stored unchanged if it still fail
+	 *
+	 * \param v components
+	 * \param n number of components
+	 * \param mode PACK_COMPRESS_FIXED_RATE or PACK_COMPRESS_ERROR_BOUND
+	 * \param par number of bits or maximum error
+	 * \param out compressed data (appended)
+	 *
+	 */
+	static void compress(const T * v, size_t n, int mode, double par, std::vector<unsigned char> & out)
+	{
+		double mn = (n == 0)?0.0:v[0];
+		double mx = mn;
+		bool finite = true;
+
+		for (size_t i = 0 ; i < n ; i++)
+		{
+			finite &= std::isfinite(v[i]);
+			mn = (v[i] < mn)?v[i]:mn;
+			mx = (v[i] > mx)?v[i]:mx;
+		}
+
+		// distance between two consecutive values of T at the largest magnitude
+		T m_abs = (T)std::max(std::fabs(mn),std::fabs(mx));
+		double ulp = (double)std::nextafter(m_abs,std::numeric_limits<T>::infinity()) - (double)m_abs;
+
+		// the value is reconstructed as mn + q*step
+		double step;
+		unsigned int w;
+
+		if (mode == PACK_COMPRESS_FIXED_RATE)
+		{
+			w = (par < 1.0)?1:((par > 32.0)?32:(unsigned int)par);
+			step = (mx - mn) / (double)(((uint64_t)1 << w) - 1);
+		}
+		else
+		{
+			// the reconstruction mn + q*step is rounded to T, so half ulp of the error goes there
+			step = 2.0*par - ulp;
+			w = error_bound_width(mn,mx,step);
+		}
+
+		if (finite == false || !(step > 0.0) || step < ulp || w > 52)
+		{
+			// constant or not finite data, or a step smaller than the precision, store the bits of the values
+			step = 0.0;
+			w = 8*sizeof(T);
+		}
+		else if (mode == PACK_COMPRESS_ERROR_BOUND)
+		{
+			size_t k = 0;
+
+			for ( ; k < 4 && check_bound(v,n,mn,step,par) == false ; k++)
+			{
+				step *= 0.5;
+				w = error_bound_width(mn,mx,step);
+			}
+
+			if (k == 4 || step < ulp || w > 52)
+			{
+				step = 0.0;
+				w = 8*sizeof(T);
+			}
+		}
+
+		pack_compress_put(out,mn);
+		pack_compress_put(out,step);
+		pack_compress_put(out,(unsigned char)w);
+
+		pack_bit_writer bw(out);
+
+		for (size_t i = 0 ; i < n ; i++)
+		{
+			if (step == 0.0)
+			{
+				uint64_t b = 0;
+				memcpy(&b,&v[i],sizeof(T));
+				bw.write(b,w);
+			}
+			else
+			{bw.write((uint64_t)std::floor((v[i] - mn) / step + 0.5),w);}
+		}
+
+		bw.flush();
+	}
+
+	/*! \brief Reconstruct the quantized components
+	 *
+	 * \param ptr compressed data (moved after the compressed data)
+	 * \param end end of the buffer
+	 * \param v components
+	 * \param n number of components
+	 * \param mode mode
+	 *
+	 * \return false if the data are corrupted
+	 *
+	 */
+	static bool decompress(const unsigned char * & ptr, const unsigned char * end, T * v, size_t n, int /*mode*/)
+	{
+		double mn;
+		double step;
+		unsigned char w;
+
+		if (pack_compress_get(ptr,end,mn) == false || pack_compress_get(ptr,end,step) == false || pack_compress_get(ptr,end,w) == false)
+		{return false;}
+
+		pack_bit_reader br(ptr,end);
+
+		for (size_t i = 0 ; i < n ; i++)
+		{
+			uint64_t q = br.read(w);
+
+			if (step == 0.0)
+			{memcpy(&v[i],&q,sizeof(T));}
+			else
+			{v[i] = mn + q*step;}
+		}
+
+		ptr = br.position();
+		return br.error() == false;
+	}
+};
+
+//! Codec of an integer property stream (delta plus bit-packing)
+template<typename T>
+struct pack_compress_codec<T,false,true>
+{
+	static bool valid(int mode)
+	{
+		return mode == PACK_COMPRESS_LOSSLESS || mode == PACK_COMPRESS_DELTA;
+	}
+
+	/*! \brief Delta encode the components, the zig-zag encoded deltas are bit-packed in blocks
+	 *
+	 * \param v components
+	 * \param n number of components
+	 * \param mode PACK_COMPRESS_DELTA
+	 * \param par unused
+	 * \param out compressed data (appended)
+	 *
+	 */
+	static void compress(const T * v, size_t n, int /*mode*/, double /*par*/, std::vector<unsigned char> & out)
+	{
+		uint64_t d[PACK_COMPRESS_DELTA_BLOCK];
+		int64_t prev = 0;
+
+		for (size_t i = 0 ; i < n ; i += PACK_COMPRESS_DELTA_BLOCK)
+		{
+			size_t nb = (n - i < PACK_COMPRESS_DELTA_BLOCK)?(n - i):PACK_COMPRESS_DELTA_BLOCK;
+			uint64_t all = 0;
+
+			for (size_t j = 0 ; j < nb ; j++)
+			{
+				int64_t delta = (int64_t)((uint64_t)(int64_t)v[i+j] - (uint64_t)prev);
+				d[j] = ((uint64_t)delta << 1) ^ (uint64_t)(delta >> 63);
+				all |= d[j];
+				prev = (int64_t)v[i+j];
+			}
+
+			unsigned char w = pack_compress_width(all);
+			out.push_back(w);
+
+			pack_bit_writer bw(out);
+			for (size_t j = 0 ; j < nb ; j++)
+			{bw.write(d[j],w);}
+			bw.flush();
+		}
+	}
+
+	/*! \brief Reconstruct the delta encoded components
+	 *
+	 * \param ptr compressed data (moved after the compressed data)
+	 * \param end end of the buffer
+	 * \param v components
+	 * \param n number of components
+	 * \param mode mode
+	 *
+	 * \return false if the data are corrupted
+	 *
+	 */
+	static bool decompress(const unsigned char * & ptr, const unsigned char * end, T * v, size_t n, int /*mode*/)
+	{
+		int64_t prev = 0;
+
+		for (size_t i = 0 ; i < n ; i += PACK_COMPRESS_DELTA_BLOCK)
+		{
+			size_t nb = (n - i < PACK_COMPRESS_DELTA_BLOCK)?(n - i):PACK_COMPRESS_DELTA_BLOCK;
+
+			unsigned char w;
+			if (pack_compress_get(ptr,end,w) == false)	{return false;}
+
+			pack_bit_reader br(ptr,end);
+
+			for (size_t j = 0 ; j < nb ; j++)
+			{
+				uint64_t z = br.read(w);
+				int64_t delta = (int64_t)(z >> 1) ^ -(int64_t)(z & 1);
+
+				prev = (int64_t)((uint64_t)prev + (uint64_t)delta);
+				v[i+j] = (T)prev;
+			}
+
+			if (br.error() == true)	{return false;}
+			ptr = br.position();
+		}
+
+		return true;
+	}
+};
+
+/*! \brief Shuffle the bytes of the components by significance (all the first bytes, all the second bytes ...)
+ *
+ * \param src components
+ * \param dst shuffled bytes
+ * \param n number of components
+ * \param s size of a component
+ *
+ */
+inline void pack_compress_shuffle(const unsigned char * src, unsigned char * dst, size_t n, size_t s)
+{
+	for (size_t b = 0 ; b < s ; b++)
+	{
+		for (size_t i = 0 ; i < n ; i++)
+		{dst[b*n + i] = src[i*s + b];}
+	}
+}
+
+/*! \brief Inverse of pack_compress_shuffle
+ *
+ * \param src shuffled bytes
+ * \param dst components
+ * \param n number of components
+ * \param s size of a component
+ *
+ */
+inline void pack_compress_unshuffle(const unsigned char * src, unsigned char * dst, size_t n, size_t s)
+{
+	for (size_t b = 0 ; b < s ; b++)
+	{
+		for (size_t i = 0 ; i < n ; i++)
+		{dst[i*s + b] = src[b*n + i];}
+	}
+}
+
+/*! \brief Compress the properties of a container one by one
+ *
+ * \tparam obj_type container
+ * \tparam prp_seq boost::mpl sequence of the properties
+ *
+ */
+template<typename obj_type, typename prp_seq>
+struct pack_compress_prp
+{
+	typedef pack_stream_access<obj_type> acc;
+
+	//! container
+	const obj_type & obj;
+
+	//! header of the container
+	const size_t (& hd)[acc::n_hd];
+
+	//! options
+	const pack_compress_opt & opt;
+
+	//! output
+	std::vector<unsigned char> & out;
+
+	/*! \brief Constructor
+	 *
+	 * \param obj container
+	 * \param hd header
+	 * \param opt options
+	 * \param out output
+	 *
+	 */
+	pack_compress_prp(const obj_type & obj, const size_t (& hd)[acc::n_hd], const pack_compress_opt & opt, std::vector<unsigned char> & out)
+	:obj(obj),hd(hd),opt(opt),out(out)
+	{}
+
+	//! Compress the property
+	template<typename T> inline void operator()(T & /*t*/)
+	{
+		typedef typename boost::mpl::at<prp_seq,T>::type prp_id;
+		typedef typename boost::mpl::at<typename obj_type::value_type::type,prp_id>::type prp_type;
+		typedef typename std::remove_all_extents<prp_type>::type comp_type;
+		typedef pack_compress_codec<comp_type> codec;
+
+		size_t n_ele = acc::n_ele(hd);
+		size_t n_cmp = n_ele * (sizeof(prp_type) / sizeof(comp_type));
+
+		// gather the property
+		std::vector<comp_type> v(n_cmp);
+		prp_type * vp = (prp_type *)v.data();
+
+		typename acc::key_type key;
+		acc::first(key);
+
+		for (size_t i = 0 ; i < n_ele ; i++)
+		{
+			pack_compress_cp<prp_type>::copy(acc::get(obj,key).template get<prp_id::value>(),vp[i]);
+			acc::next(key,hd);
+		}
+
+		int mode = opt.getMode(prp_id::value);
+
+		if (codec::valid(mode) == false)
+		{
+			std::cerr << "Error " << __FILE__ << ":" << __LINE__ << " compression mode " << mode << " cannot be used for property " << prp_id::value << " lossless compression is used" << std::endl;
+			mode = PACK_COMPRESS_LOSSLESS;
+		}
+
+		pack_compress_put(out,(size_t)mode);
+
+		if (mode == PACK_COMPRESS_LOSSLESS)
+		{
+			std::vector<unsigned char> shf(n_cmp*sizeof(comp_type));
+			pack_compress_shuffle((const unsigned char *)v.data(),shf.data(),n_cmp,sizeof(comp_type));
+			pack_lz_compress(shf.data(),shf.size(),out);
+		}
+		else
+		{codec::compress(v.data(),n_cmp,mode,opt.getParameter(prp_id::value),out);}
+	}
+};
+
+/*! \brief Decompress the properties of a container one by one
+ *
+ * \tparam obj_type container
+ * \tparam prp_seq boost::mpl sequence of the properties
+ *
+ */
+template<typename obj_type, typename prp_seq>
+struct unpack_compress_prp
+{
+	typedef pack_stream_access<obj_type> acc;
+
+	//! container
+	obj_type & obj;
+
+	//! header of the container
+	const size_t (& hd)[acc::n_hd];
+
+	//! position in the compressed buffer
+	const unsigned char * & ptr;
+
+	//! end of the compressed buffer
+	const unsigned char * end;
+
+	//! false if the buffer is corrupted
+	bool ok;
+
+	/*! \brief Constructor
+	 *
+	 * \param obj container
+	 * \param hd header
+	 * \param ptr position in the compressed buffer
+	 * \param end end of the compressed buffer
+	 *
+	 */
+	unpack_compress_prp(obj_type & obj, const size_t (& hd)[acc::n_hd], const unsigned char * & ptr, const unsigned char * end)
+	:obj(obj),hd(hd),ptr(ptr),end(end),ok(true)
+	{}
+
+	//! Decompress the property
+	template<typename T> inline void operator()(T & /*t*/)
+	{
+		typedef typename boost::mpl::at<prp_seq,T>::type prp_id;
+		typedef typename boost::mpl::at<typename obj_type::value_type::type,prp_id>::type prp_type;
+		typedef typename std::remove_all_extents<prp_type>::type comp_type;
+		typedef pack_compress_codec<comp_type> codec;
+
+		if (ok == false)	{return;}
+
+		size_t n_ele = acc::n_ele(hd);
+		size_t n_cmp = n_ele * (sizeof(prp_type) / sizeof(comp_type));
+
+		std::vector<comp_type> v(n_cmp);
+
+		size_t mode;
+		if (pack_compress_get(ptr,end,mode) == false)	{ok = false; return;}
+
+		if (mode == PACK_COMPRESS_LOSSLESS)
+		{
+			std::vector<unsigned char> shf;
+			if (pack_lz_decompress(ptr,end,shf) == false || shf.size() != n_cmp*sizeof(comp_type))	{ok = false; return;}
+
+			pack_compress_unshuffle(shf.data(),(unsigned char *)v.data(),n_cmp,sizeof(comp_type));
+		}
+		else if (codec::valid(mode) == false || codec::decompress(ptr,end,v.data(),n_cmp,mode) == false)
+		{ok = false; return;}
+
+		// scatter the property
+		const prp_type * vp = (const prp_type *)v.data();
+
+		typename acc::key_type key;
+		acc::first(key);
+
+		for (size_t i = 0 ; i < n_ele ; i++)
+		{
+			pack_compress_cp<prp_type>::copy(vp[i],acc::get(obj,key).template get<prp_id::value>());
+			acc::next(key,hd);
+		}
+	}
+};
+
+//! Sequence of the properties to compress
+template<typename T, int ... prp>
+struct pack_compress_seq
+{
+	typedef typename to_boost_vmpl<prp...>::type type;
+};
+
+//! Expand the sequence of all the properties
+template<typename T, typename seq>
+struct pack_compress_seq_all;
+
+//! Expand the sequence of all the properties
+template<typename T, int ... prp>
+struct pack_compress_seq_all<T,std::integer_sequence<int,prp...>>: public pack_compress_seq<T,prp...>
+{};
+
+//! No properties specified, all the properties are compressed
+template<typename T>
+struct pack_compress_seq<T>: public pack_compress_seq_all<T,std::make_integer_sequence<int,T::max_prop>>
+{};
+
+/*! \brief Pack a grid or an openfpm::vector in compressed form
+ *
+ * The properties are compressed one by one (structure of arrays), each with the mode selected in opt.
+ * The buffer can be unpacked only with unpack_compress using the same properties. Only objects without
+ * pack() inside are supported
+ *
+ * \code{.cpp}
+ * pack_compress_opt opt;
+ * opt.set(0,PACK_COMPRESS_ERROR_BOUND,1e-5);
+ *
+ * std::vector<unsigned char> buf;
+ * Pack_stat sts;
+ * pack_compress<0,1>(g,opt,buf,sts);
+ *
+ * std::cout << "ratio: " << sts.getCompressionRatio() << std::endl;
+ * \endcode
+ *
+ * \tparam prp properties to pack (none mean all)
+ *
+ * \param obj grid or vector to pack
+ * \param opt compression mode of each property
+ * \param out compressed data (appended)
+ * \param sts pack statistic (compression ratio and throughput)
+ *
+ */
+template<int ... prp, typename obj_type>
+void pack_compress(const obj_type & obj, const pack_compress_opt & opt, std::vector<unsigned char> & out, Pack_stat & sts)
+{
+	typedef pack_stream_access<obj_type> acc;
+	typedef typename pack_compress_seq<typename obj_type::value_type,prp...>::type prp_seq;
+	typedef typename pack_stream_object<typename obj_type::value_type,prp...>::type prp_object;
+
+	static_assert(has_pack_agg<typename obj_type::value_type,prp...>::result::value == false,"pack_compress support only objects without pack() inside");
+
+	timer t;
+	t.start();
+
+	size_t start = out.size();
+
+	size_t hd[acc::n_hd];
+	acc::header(obj,hd);
+
+	for (size_t i = 0 ; i < acc::n_hd ; i++)
+	{pack_compress_put(out,hd[i]);}
+
+	pack_compress_prp<obj_type,prp_seq> cp(obj,hd,opt,out);
+	boost::mpl::for_each_ref<boost::mpl::range_c<int,0,boost::mpl::size<prp_seq>::value>>(cp);
+
+	t.stop();
+
+	sts.addCompression(sizeof(hd) + acc::n_ele(hd)*sizeof(prp_object),out.size() - start,t.getwct());
+	sts.incReq();
+}
+
+/*! \brief Unpack a grid or an openfpm::vector packed with pack_compress
+ *
+ * \tparam prp properties to unpack (must be the same used by pack_compress)
+ *
+ * \param obj container where to unpack
+ * \param ptr compressed data
+ * \param sz size in byte of the compressed data
+ * \param ps unpack statistic
+ *
+ * \return false if the compressed data are corrupted
+ *
+ */
+template<int ... prp, typename obj_type>
+bool unpack_compress(obj_type & obj, const void * ptr, size_t sz, Unpack_stat & ps)
+{
+	typedef pack_stream_access<obj_type> acc;
+	typedef typename pack_compress_seq<typename obj_type::value_type,prp...>::type prp_seq;
+
+	const unsigned char * p = (const unsigned char *)ptr + ps.getOffset();
+	const unsigned char * end = (const unsigned char *)ptr + sz;
+
+	size_t hd[acc::n_hd];
+
+	bool ok = true;
+	for (size_t i = 0 ; i < acc::n_hd ; i++)
+	{ok &= pack_compress_get(p,end,hd[i]);}
+
+	if (ok == true)
+	{
+		acc::resize(obj,hd);
+
+		unpack_compress_prp<obj_type,prp_seq> cp(obj,hd,p,end);
+		boost::mpl::for_each_ref<boost::mpl::range_c<int,0,boost::mpl::size<prp_seq>::value>>(cp);
+
+		ok = cp.ok;
+	}
+
+	if (ok == false)
+	{
+		std::cerr << "Error " << __FILE__ << ":" << __LINE__ << " corrupted compressed buffer" << std::endl;
+		return false;
+	}
+
+	ps.setOffset(p - (const unsigned char *)ptr);
+	return true;
+}
+
+#endif /* OPENFPM_DATA_SRC_PACKER_UNPACKER_PACKER_COMPRESS_HPP_ */
@@ -0,0 +1,522 @@
+/*
+ * Packer_stream.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Pietro Incardona
+ */
+
+#ifndef OPENFPM_DATA_SRC_PACKER_UNPACKER_PACKER_STREAM_HPP_
+#define OPENFPM_DATA_SRC_PACKER_UNPACKER_PACKER_STREAM_HPP_
+
+#include <vector>
+#include <cstring>
+#include "Vector/map_vector.hpp"
+#include "util/object_si_d.hpp"
+#include "util/object_s_di.hpp"
+
+/*! \brief Default size in byte of the chunks produced by pack_stream
+ *
+ */
+#ifndef OPENFPM_PACK_STREAM_CHUNK
+#define OPENFPM_PACK_STREAM_CHUNK (1024*1024)
+#endif
+
+/*! \brief Access to the container (grid) for the streaming packer
+ *
+ * The header of a grid are the sizes on each direction, the elements are streamed in the order of getIterator()
+ *
+ * \tparam obj_type container
+ * \tparam is_vect true if the container is an openfpm::vector
+ *
+ */
+template<typename obj_type, bool is_vect = is_vector<obj_type>::value>
+struct pack_stream_access
+{
+	//! number of size_t in the header
+	static const unsigned int n_hd = obj_type::dims;
+
+	//! type of the key to access an element
+	typedef grid_key_dx<obj_type::dims> key_type;
+
+	/*! \brief Fill the header
+	 *
+	 * \param obj container
+	 * \param hd header
+	 *
+	 */
+	static inline void header(const obj_type & obj, size_t (& hd)[n_hd])
+	{
+		for (size_t i = 0 ; i < n_hd ; i++)
+		{hd[i] = obj.getGrid().size(i);}
+	}
+
+	/*! \brief Resize the container as specified by the header
+	 *
+	 * resize allocate the memory of the new grid, no setMemory is needed
+	 *
+	 * \param obj container
+	 * \param hd header
+	 *
+	 */
+	static inline void resize(obj_type & obj, const size_t (& hd)[n_hd])
+	{
+		obj.resize(hd);
+	}
+
+	/*! \brief Number of elements given the header
+	 *
+	 * \param hd header
+	 *
+	 * \return the number of elements
+	 *
+	 */
+	static inline size_t n_ele(const size_t (& hd)[n_hd])
+	{
+		size_t n = 1;
+		for (size_t i = 0 ; i < n_hd ; i++)
+		{n *= hd[i];}
+
+		return n;
+	}
+
+	/*! \brief Key of the first element
+	 *
+	 * \param key key to reset
+	 *
+	 */
+	static inline void first(key_type & key)
+	{
+		key.zero();
+	}
+
+	/*! \brief Move the key to the next element (same order of getIterator())
+	 *
+	 * \param key key to move
+	 * \param hd header
+	 *
+	 */
+	static inline void next(key_type & key, const size_t (& hd)[n_hd])
+	{
+		for (size_t i = 0 ; i < n_hd ; i++)
+		{
+			key.set_d(i,key.get(i) + 1);
+
+			if (key.get(i) < (long int)hd[i])	{return;}
+
+			key.set_d(i,0);
+		}
+	}
+
+	/*! \brief Get the element
+	 *
+	 * \param obj container
+	 * \param key element
+	 *
+	 * \return the encapsulated element
+	 *
+	 */
+	template<typename obj_type_c>
+	static inline auto get(obj_type_c & obj, const key_type & key) -> decltype(obj.get_o(key))
+	{
+		return obj.get_o(key);
+	}
+};
+
+//! Access to an openfpm::vector for the streaming packer, the header is the size of the vector
+template<typename obj_type>
+struct pack_stream_access<obj_type,true>
+{
+	//! number of size_t in the header
+	static const unsigned int n_hd = 1;
+
+	//! type of the key to access an element
+	typedef size_t key_type;
+
+	/*! \brief Fill the header
+	 *
+	 * \param obj vector
+	 * \param hd header
+	 *
+	 */
+	static inline void header(const obj_type & obj, size_t (& hd)[n_hd])
+	{
+		hd[0] = obj.size();
+	}
+
+	/*! \brief Resize the vector as specified by the header
+	 *
+	 * \param obj vector
+	 * \param hd header
+	 *
+	 */
+	static inline void resize(obj_type & obj, const size_t (& hd)[n_hd])
+	{
+		obj.resize(hd[0]);
+	}
+
+	/*! \brief Number of elements given the header
+	 *
+	 * \param hd header
+	 *
+	 * \return the number of elements
+	 *
+	 */
+	static inline size_t n_ele(const size_t (& hd)[n_hd])
+	{
+		return hd[0];
+	}
+
+	/*! \brief Key of the first element
+	 *
+	 * \param key key to reset
+	 *
+	 */
+	static inline void first(key_type & key)
+	{
+		key = 0;
+	}
+
+	/*! \brief Move the key to the next element
+	 *
+	 * \param key key to move
+	 * \param hd header (unused, the elements of a vector are contiguous)
+	 *
+	 */
+	static inline void next(key_type & key, const size_t (& /*hd*/)[n_hd])
+	{
+		key++;
+	}
+
+	/*! \brief Get the element
+	 *
+	 * \param obj vector
+	 * \param key element
+	 *
+	 * \return the encapsulated element
+	 *
+	 */
+	template<typename obj_type_c>
+	static inline auto get(obj_type_c & obj, const key_type & key) -> decltype(obj.get(key))
+	{
+		return obj.get(key);
+	}
+};
+
+/*! \brief Object streamed for each element and copy of the selected properties
+ *
+ * \tparam T aggregate stored in the container
+ * \tparam prp properties to stream
+ *
+ */
+template<typename T, int ... prp>
+struct pack_stream_object
+{
+	//! object streamed for each element
+	typedef object<typename object_creator<typename T::type,prp...>::type> type;
+
+	/*! \brief Copy the selected properties of an element into the streamed object
+	 *
+	 * \param src element
+	 * \param dst streamed object
+	 *
+	 */
+	template<typename e_src, typename e_dst>
+	static inline void pack(const e_src & src, e_dst && dst)
+	{
+		object_si_d<e_src,e_dst,OBJ_ENCAP,prp...>(src,dst);
+	}
+
+	/*! \brief Copy the streamed object into the selected properties of an element
+	 *
+	 * \param src streamed object
+	 * \param dst element
+	 *
+	 */
+	template<typename e_src, typename e_dst>
+	static inline void unpack(const e_src & src, e_dst && dst)
+	{
+		object_s_di<e_src,e_dst,OBJ_ENCAP,prp...>(src,dst);
+	}
+};
+
+//! Expand the sequence of all the properties
+template<typename T, typename seq>
+struct pack_stream_object_all;
+
+//! Expand the sequence of all the properties
+template<typename T, int ... prp>
+struct pack_stream_object_all<T,std::integer_sequence<int,prp...>>: public pack_stream_object<T,prp...>
+{};
+
+//! No properties specified, all the properties are streamed
+template<typename T>
+struct pack_stream_object<T>: public pack_stream_object_all<T,std::make_integer_sequence<int,T::max_prop>>
+{};
+
+/*! \brief Serialize a grid or an openfpm::vector emitting chunks of fixed size
+ *
+ * The stream contain the same bytes that the Packer produce for the container with memory_traits_lin layout
+ * (the sizes followed by the selected properties of each element, element by element), but the full buffer
+ * is never allocated: the elements are copied into a staging buffer of chunk bytes that is passed to the sink
+ * every time it is full. The peak extra memory is O(chunk). Only objects without pack() inside are supported
+ *
+ * \code{.cpp}
+ * std::ofstream out("grid.bin",std::ios::binary);
+ * pack_stream<0,2>(g,1024*1024,[&](const void * ptr, size_t sz){out.write((const char *)ptr,sz);});
+ * \endcode
+ *
+ * \tparam prp properties to pack (none mean all)
+ *
+ * \param obj grid or vector to pack
+ * \param chunk size of the chunks in byte (the last chunk can be smaller)
+ * \param sink function called with (pointer, size in byte) for each chunk, the pointer is valid only during the call
+ *
+ * \return the total number of bytes emitted
+ *
+ */
+template<int ... prp, typename obj_type, typename sink_type>
+size_t pack_stream(const obj_type & obj, size_t chunk, sink_type sink)
+{
+	typedef pack_stream_access<obj_type> acc;
+	typedef pack_stream_object<typename obj_type::value_type,prp...> p_obj;
+	typedef typename p_obj::type stage_obj;
+
+	static_assert(has_pack_agg<typename obj_type::value_type,prp...>::result::value == false,"pack_stream support only objects without pack() inside");
+
+	if (chunk == 0)	{chunk = OPENFPM_PACK_STREAM_CHUNK;}
+
+	std::vector<unsigned char> buf(chunk);
+	size_t fill = 0;
+	size_t tot = 0;
+
+	// copy into the chunk buffer and emit it when full
+	auto emit = [&](const unsigned char * ptr, size_t n)
+	{
+		while (n != 0)
+		{
+			size_t c = (n < chunk - fill)?n:(chunk - fill);
+			memcpy(&buf[fill],ptr,c);
+
+			fill += c;
+			ptr += c;
+			n -= c;
+
+			if (fill == chunk)
+			{
+				sink((const void *)&buf[0],chunk);
+				tot += chunk;
+				fill = 0;
+			}
+		}
+	};
+
+	size_t hd[acc::n_hd];
+	acc::header(obj,hd);
+	emit((const unsigned char *)hd,sizeof(hd));
+
+	size_t n_ele = acc::n_ele(hd);
+
+	// the elements are converted in batches that fit the chunk
+	size_t n_b = chunk / sizeof(stage_obj);
+	n_b = (n_b == 0)?1:n_b;
+	n_b = (n_b > n_ele)?n_ele:n_b;
+
+	openfpm::vector<stage_obj,HeapMemory,memory_traits_lin,openfpm::grow_policy_identity> stage;
+	stage.resize(n_b);
+
+	typename acc::key_type key;
+	acc::first(key);
+
+	for (size_t id = 0 ; id < n_ele ; id += n_b)
+	{
+		size_t nc = (n_ele - id < n_b)?(n_ele - id):n_b;
+
+		for (size_t j = 0 ; j < nc ; j++)
+		{
+			p_obj::pack(acc::get(obj,key),stage.get(j));
+			acc::next(key,hd);
+		}
+
+		emit((const unsigned char *)stage.getPointer(),nc*sizeof(stage_obj));
+	}
+
+	if (fill != 0)
+	{
+		sink((const void *)&buf[0],fill);
+		tot += fill;
+	}
+
+	return tot;
+}
+
+/*! \brief De-serialize incrementally a stream produced by pack_stream
+ *
+ * The chunks can be fed as they arrive and can have any size, the elements are written into the
+ * container as soon as they are complete. The container is resized when the header is complete
+ *
+ * \code{.cpp}
+ * unpack_stream<grid_type,0,2> us(g);
+ *
+ * while (us.isComplete() == false)
+ * {
+ *     in.read(buf,sizeof(buf));
+ *     us.feed(buf,in.gcount());
+ * }
+ * \endcode
+ *
+ * \tparam obj_type grid or vector
+ * \tparam prp properties to unpack (must be the same used by pack_stream)
+ *
+ */
+template<typename obj_type, int ... prp>
+class unpack_stream
+{
+	typedef pack_stream_access<obj_type> acc;
+	typedef pack_stream_object<typename obj_type::value_type,prp...> p_obj;
+	typedef typename p_obj::type stage_obj;
+
+	//! destination container
+	obj_type & obj;
+
+	//! header
+	size_t hd[acc::n_hd];
+
+	//! bytes of the header received
+	size_t hd_rcv;
+
+	//! number of elements to receive
+	size_t n_ele;
+
+	//! elements received
+	size_t id;
+
+	//! key of the next element
+	typename acc::key_type key;
+
+	//! bytes received of a partial element
+	size_t part;
+
+	//! staging buffer (at most chunk bytes)
+	openfpm::vector<stage_obj,HeapMemory,memory_traits_lin,openfpm::grow_policy_identity> stage;
+
+	//! maximum number of elements in the staging buffer
+	size_t n_b;
+
+	/*! \brief Write the first nc elements of the staging buffer into the container
+	 *
+	 * \param nc number of elements
+	 *
+	 */
+	inline void flush(size_t nc)
+	{
+		for (size_t j = 0 ; j < nc ; j++)
+		{
+			p_obj::unpack(stage.get(j),acc::get(obj,key));
+			acc::next(key,hd);
+		}
+
+		id += nc;
+	}
+
+public:
+
+	/*! \brief Constructor
+	 *
+	 * \param obj destination container
+	 * \param chunk size of the staging buffer in byte
+	 *
+	 */
+	unpack_stream(obj_type & obj, size_t chunk = OPENFPM_PACK_STREAM_CHUNK)
+	:obj(obj),hd_rcv(0),n_ele(0),id(0),part(0)
+	{
+		n_b = chunk / sizeof(stage_obj);
+		n_b = (n_b == 0)?1:n_b;
+	}
+
+	/*! \brief Feed a chunk of the stream
+	 *
+	 * \param ptr data
+	 * \param sz size in byte
+	 *
+	 * \return the number of bytes consumed, less than sz only when the stream is complete
+	 *
+	 */
+	size_t feed(const void * ptr, size_t sz)
+	{
+		const unsigned char * src = (const unsigned char *)ptr;
+		size_t n = sz;
+
+		// header
+		if (hd_rcv < sizeof(hd))
+		{
+			size_t c = (n < sizeof(hd) - hd_rcv)?n:(sizeof(hd) - hd_rcv);
+			memcpy((unsigned char *)hd + hd_rcv,src,c);
+
+			hd_rcv += c;
+			src += c;
+			n -= c;
+
+			if (hd_rcv < sizeof(hd))	{return sz;}
+
+			acc::resize(obj,hd);
+			n_ele = acc::n_ele(hd);
+			acc::first(key);
+
+			n_b = (n_b > n_ele)?n_ele:n_b;
+			stage.resize((n_b == 0)?1:n_b);
+		}
+
+		// complete the partial element
+		if (part != 0 && n != 0)
+		{
+			size_t c = (n < sizeof(stage_obj) - part)?n:(sizeof(stage_obj) - part);
+			memcpy((unsigned char *)stage.getPointer() + part,src,c);
+
+			part += c;
+			src += c;
+			n -= c;
+
+			if (part < sizeof(stage_obj))	{return sz;}
+
+			part = 0;
+			flush(1);
+		}
+
+		// full elements
+		while (n >= sizeof(stage_obj) && id < n_ele)
+		{
+			size_t nc = n / sizeof(stage_obj);
+			nc = (nc > n_b)?n_b:nc;
+			nc = (nc > n_ele - id)?(n_ele - id):nc;
+
+			memcpy(stage.getPointer(),src,nc*sizeof(stage_obj));
+
+			src += nc*sizeof(stage_obj);
+			n -= nc*sizeof(stage_obj);
+
+			flush(nc);
+		}
+
+		// start of the next element
+		if (n != 0 && id < n_ele)
+		{
+			memcpy(stage.getPointer(),src,n);
+			part = n;
+			n = 0;
+		}
+
+		return sz - n;
+	}
+
+	/*! \brief Return true if all the stream has been received
+	 *
+	 * \return true when the container is complete
+	 *
+	 */
+	bool isComplete() const
+	{
+		return hd_rcv == sizeof(hd) && id == n_ele;
+	}
+};
+
+#endif /* OPENFPM_DATA_SRC_PACKER_UNPACKER_PACKER_STREAM_HPP_ */
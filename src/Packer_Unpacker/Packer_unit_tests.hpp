@@ -12,6 +12,9 @@
 #include "Pack_selector.hpp"
 #include "Packer.hpp"
 #include "Unpacker.hpp"
+#include "Packer_stream.hpp"
+#include "Packer_compress.hpp"
+#include "Checkpoint.hpp"
 #include "Grid/grid_util_test.hpp"
 #include <iostream>
 #include "Vector/vector_test_util.hpp"
@@ -358,6 +361,618 @@ BOOST_AUTO_TEST_CASE ( packer_memory_traits_inte )
 
 }
 
+/*! \brief Pack the container in a stream and unpack it feeding chunks of variable size
+ *
+ * \param obj container to stream
+ * \param obj_test container where to unpack
+ * \param chunk chunk size
+ *
+ * \return the stream
+ *
+ */
+template<int ... prp, typename obj_type, typename obj_type_test>
+std::vector<unsigned char> test_pack_stream(const obj_type & obj, obj_type_test & obj_test, size_t chunk)
+{
+	std::vector<unsigned char> stream;
+	size_t n_chunk = 0;
+	bool fixed = true;
+
+	size_t tot = pack_stream<prp...>(obj,chunk,[&](const void * ptr, size_t sz)
+	{
+		// all the chunks except the last are full
+		fixed &= (stream.size() % chunk == 0);
+
+		stream.insert(stream.end(),(const unsigned char *)ptr,(const unsigned char *)ptr + sz);
+		n_chunk++;
+	});
+
+	BOOST_REQUIRE_EQUAL(tot,stream.size());
+	BOOST_REQUIRE_EQUAL(fixed,true);
+	BOOST_REQUIRE_EQUAL(n_chunk,(stream.size() + chunk - 1) / chunk);
+
+	// feed pieces of size 1,2,3,...
+	unpack_stream<obj_type_test,prp...> us(obj_test,chunk);
+
+	size_t i = 0;
+	size_t ps = 1;
+	while (us.isComplete() == false)
+	{
+		size_t c = (stream.size() - i < ps)?stream.size() - i:ps;
+		BOOST_REQUIRE_EQUAL(us.feed(&stream[i],c),c);
+
+		i += c;
+		ps = (ps % 97) + 1;
+	}
+
+	BOOST_REQUIRE_EQUAL(i,stream.size());
+
+	return stream;
+}
+
+BOOST_AUTO_TEST_CASE ( packer_stream_test )
+{
+	typedef Point_test<float> pt;
+
+	openfpm::vector<pt> v = allocate_openfpm<openfpm::vector<pt>>(1000);
+
+	size_t sz[] = {16,17,9};
+	grid_cpu<3,pt> g(sz);
+	g.setMemory();
+	fill_grid<3>(g);
+
+	// vector, selected properties, same bytes of the Packer
+	size_t req = 0;
+	Packer<openfpm::vector<pt>,HeapMemory>::packRequest<pt::x,pt::v>(v,req);
+
+	HeapMemory pmem;
+	ExtPreAlloc<HeapMemory> & mem = *(new ExtPreAlloc<HeapMemory>(req,pmem));
+	mem.incRef();
+
+	Pack_stat sts;
+	Packer<openfpm::vector<pt>,HeapMemory>::pack<pt::x,pt::v>(mem,v,sts);
+
+	openfpm::vector<pt> v_test;
+	auto stream = test_pack_stream<pt::x,pt::v>(v,v_test,100);
+
+	BOOST_REQUIRE_EQUAL(stream.size(),req);
+	BOOST_REQUIRE_EQUAL(memcmp(&stream[0],pmem.getPointer(),req),0);
+
+	bool match = v_test.size() == v.size();
+	for (size_t i = 0 ; i < v.size() && match ; i++)
+	{
+		match &= v_test.template get<pt::x>(i) == v.template get<pt::x>(i);
+
+		for (size_t j = 0 ; j < 3 ; j++)
+		{match &= v_test.template get<pt::v>(i)[j] == v.template get<pt::v>(i)[j];}
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+
+	mem.decRef();
+	delete &mem;
+
+	// grid all the properties, unpacked into a grid with memory_traits_inte layout
+	grid_base<3,pt,HeapMemory,typename memory_traits_inte<pt>::type> g_test;
+	test_pack_stream(g,g_test,4096);
+
+	BOOST_REQUIRE_EQUAL(g_test.getGrid().size(0),sz[0]);
+	BOOST_REQUIRE_EQUAL(g_test.getGrid().size(1),sz[1]);
+	BOOST_REQUIRE_EQUAL(g_test.getGrid().size(2),sz[2]);
+
+	auto it = g.getIterator();
+
+	while (it.isNext())
+	{
+		auto key = it.get();
+
+		match &= g_test.template get<pt::x>(key) == g.template get<pt::x>(key);
+		match &= g_test.template get<pt::s>(key) == g.template get<pt::s>(key);
+
+		for (size_t j = 0 ; j < 3 ; j++)
+		{
+			match &= g_test.template get<pt::v>(key)[j] == g.template get<pt::v>(key)[j];
+
+			for (size_t k = 0 ; k < 3 ; k++)
+			{match &= g_test.template get<pt::t>(key)[j][k] == g.template get<pt::t>(key)[j][k];}
+		}
+
+		++it;
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+
+	// grid selected properties, chunk smaller than an element
+	grid_cpu<3,pt> g_test2;
+	test_pack_stream<pt::y,pt::t>(g,g_test2,7);
+
+	auto it2 = g.getIterator();
+
+	while (it2.isNext())
+	{
+		auto key = it2.get();
+
+		match &= g_test2.template get<pt::y>(key) == g.template get<pt::y>(key);
+		match &= g_test2.template get<pt::t>(key)[2][1] == g.template get<pt::t>(key)[2][1];
+
+		++it2;
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+}
+
+
+/*! \brief Pack a set of sub-grids with the parallel pack and one by one, and return both buffers
+ *
+ * \param g grid to pack
+ * \param subs sub-grids
+ * \param ser buffer of the sub-grids packed one by one
+ * \param par buffer of the parallel pack
+ *
+ */
+template<int ... prp, typename grid_type>
+void test_pack_parallel(grid_type & g, std::vector<grid_key_dx_iterator_sub<3>> & subs, std::vector<unsigned char> & ser, std::vector<unsigned char> & par)
+{
+	size_t req_ser = 0;
+	for (size_t k = 0 ; k < subs.size() ; k++)
+	{g.template packRequest<prp...>(subs[k],req_ser);}
+
+	std::vector<size_t> offsets;
+	size_t req_par = 0;
+	g.template packRequest<prp...>(subs,offsets,req_par);
+
+	BOOST_REQUIRE_EQUAL(req_ser,req_par);
+	BOOST_REQUIRE_EQUAL(offsets.size(),subs.size() + 1);
+
+	HeapMemory pmem;
+	ExtPreAlloc<HeapMemory> & mem = *(new ExtPreAlloc<HeapMemory>(req_ser,pmem));
+	mem.incRef();
+
+	Pack_stat sts;
+	for (size_t k = 0 ; k < subs.size() ; k++)
+	{
+		auto sub = subs[k];
+		g.template pack<prp...>(mem,sub,sts);
+	}
+
+	ser.resize(req_ser);
+	memcpy(&ser[0],mem.getPointerBase(),req_ser);
+
+	HeapMemory pmem2;
+	ExtPreAlloc<HeapMemory> & mem2 = *(new ExtPreAlloc<HeapMemory>(req_par,pmem2));
+	mem2.incRef();
+
+	Pack_stat sts2;
+	g.template pack<prp...>(mem2,subs,offsets,sts2);
+
+	BOOST_REQUIRE_EQUAL(sts.reqPack(),sts2.reqPack());
+
+	par.resize(req_par);
+	memcpy(&par[0],mem2.getPointerBase(),req_par);
+
+	mem.decRef();
+	delete &mem;
+	mem2.decRef();
+	delete &mem2;
+}
+
+BOOST_AUTO_TEST_CASE ( packer_parallel_sub_grid )
+{
+	typedef Point_test<float> pt;
+
+	size_t sz[] = {40,40,40};
+	grid_cpu<3,pt> g(sz);
+	g.setMemory();
+	fill_grid<3>(g);
+
+	std::vector<grid_key_dx_iterator_sub<3>> subs;
+	subs.push_back(grid_key_dx_iterator_sub<3>(g.getGrid(),{1,2,3},{30,25,20}));
+	subs.push_back(grid_key_dx_iterator_sub<3>(g.getGrid(),{0,0,0},{0,39,39}));
+	subs.push_back(grid_key_dx_iterator_sub<3>(g.getGrid(),{5,5,5},{4,5,5}));
+	subs.push_back(grid_key_dx_iterator_sub<3>(g.getGrid(),{7,3,9},{39,39,39}));
+
+	std::vector<unsigned char> ser;
+	std::vector<unsigned char> par;
+
+	// all the properties (row by row memcpy)
+	test_pack_parallel<pt::x,pt::y,pt::z,pt::s,pt::v,pt::t>(g,subs,ser,par);
+
+	BOOST_REQUIRE(ser.size() != 0);
+	BOOST_REQUIRE_EQUAL(memcmp(&ser[0],&par[0],ser.size()),0);
+
+	// selected properties (object by object)
+	test_pack_parallel<pt::x,pt::v>(g,subs,ser,par);
+
+	BOOST_REQUIRE_EQUAL(memcmp(&ser[0],&par[0],ser.size()),0);
+
+	// grid with memory_traits_inte layout, the parallel pack must produce the same buffer of the serial pack
+	grid_base<3,pt,HeapMemory,typename memory_traits_inte<pt>::type> gi(sz);
+	gi.setMemory();
+	fill_grid<3>(gi);
+
+	test_pack_parallel<pt::x,pt::y,pt::z,pt::s,pt::v,pt::t>(gi,subs,ser,par);
+
+	BOOST_REQUIRE(ser.size() != 0);
+	BOOST_REQUIRE_EQUAL(memcmp(&ser[0],&par[0],ser.size()),0);
+
+	test_pack_parallel<pt::x,pt::s>(gi,subs,ser,par);
+
+	BOOST_REQUIRE_EQUAL(memcmp(&ser[0],&par[0],ser.size()),0);
+
+	// unpack the sub-grids and check
+
+	std::vector<size_t> offsets;
+	size_t req = 0;
+	gi.template packRequest<pt::x,pt::s>(subs,offsets,req);
+
+	HeapMemory pmem;
+	ExtPreAlloc<HeapMemory> & mem = *(new ExtPreAlloc<HeapMemory>(req,pmem));
+	mem.incRef();
+
+	Pack_stat sts;
+	gi.template pack<pt::x,pt::s>(mem,subs,offsets,sts);
+
+	grid_cpu<3,pt> g_test(sz);
+	g_test.setMemory();
+
+	Unpack_stat ps;
+	int ctx = 0;
+	bool match = true;
+
+	for (size_t k = 0 ; k < subs.size() ; k++)
+	{
+		BOOST_REQUIRE_EQUAL(ps.getOffset(),offsets[k]);
+
+		auto sub = subs[k];
+		g_test.template unpack<pt::x,pt::s>(mem,sub,ps,ctx,rem_copy_opt::NONE_OPT);
+
+		sub.reset();
+		while (sub.isNext())
+		{
+			auto key = sub.get();
+
+			match &= g_test.template get<pt::x>(key) == g.template get<pt::x>(key);
+			match &= g_test.template get<pt::s>(key) == g.template get<pt::s>(key);
+
+			++sub;
+		}
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+
+	mem.decRef();
+	delete &mem;
+
+	// the parallel vector pack must produce the same stream of a serial unpack
+	openfpm::vector<pt> v = allocate_openfpm_fill(20000,1);
+
+	size_t req_v = 0;
+	Packer<decltype(v),HeapMemory>::packRequest<pt::x,pt::t>(v,req_v);
+
+	HeapMemory pmem_v;
+	ExtPreAlloc<HeapMemory> & mem_v = *(new ExtPreAlloc<HeapMemory>(req_v,pmem_v));
+	mem_v.incRef();
+
+	Pack_stat sts_v;
+	Packer<decltype(v),HeapMemory>::pack<pt::x,pt::t>(mem_v,v,sts_v);
+
+	Unpack_stat ps_v;
+	openfpm::vector<pt> v_test;
+	Unpacker<decltype(v),HeapMemory>::unpack<pt::x,pt::t>(mem_v,v_test,ps_v);
+
+	BOOST_REQUIRE_EQUAL(v_test.size(),v.size());
+
+	for (size_t i = 0 ; i < v.size() ; i++)
+	{
+		match &= v_test.template get<pt::x>(i) == v.template get<pt::x>(i);
+		match &= v_test.template get<pt::t>(i)[1][2] == v.template get<pt::t>(i)[1][2];
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+
+	mem_v.decRef();
+	delete &mem_v;
+}
+
+
+BOOST_AUTO_TEST_CASE ( packer_compress_test )
+{
+	// generic buffer, lossless codec
+	std::vector<unsigned char> raw(100000);
+	for (size_t i = 0 ; i < raw.size() ; i++)
+	{raw[i] = (i < 50000)?(i % 251 + i / 1000):((i*7919) >> 3) & 0xFF;}
+
+	Pack_stat sts_b;
+	std::vector<unsigned char> cmp;
+	pack_compress_buffer(raw.data(),raw.size(),cmp,sts_b);
+
+	std::vector<unsigned char> dcmp;
+	BOOST_REQUIRE_EQUAL(pack_decompress_buffer(cmp.data(),cmp.size(),dcmp),true);
+	BOOST_REQUIRE(dcmp == raw);
+	BOOST_REQUIRE_EQUAL(sts_b.getRawSize(),raw.size());
+	BOOST_REQUIRE_EQUAL(sts_b.getCompressedSize(),cmp.size());
+
+	// a buffer of zeros (like the background of a sparse grid)
+	std::vector<unsigned char> zero(100000,0);
+	cmp.clear();
+	Pack_stat sts_z;
+	pack_compress_buffer(zero.data(),zero.size(),cmp,sts_z);
+
+	BOOST_REQUIRE(sts_z.getCompressionRatio() > 100.0);
+	BOOST_REQUIRE_EQUAL(pack_decompress_buffer(cmp.data(),cmp.size(),dcmp),true);
+	BOOST_REQUIRE(dcmp == zero);
+
+	// a truncated buffer is detected
+	BOOST_REQUIRE_EQUAL(pack_decompress_buffer(cmp.data(),cmp.size() / 2,dcmp),false);
+
+	// vector with a lossy, a delta and a lossless property
+	typedef aggregate<float,size_t,double[3]> T;
+	openfpm::vector<T> v;
+
+	for (size_t i = 0 ; i < 10000 ; i++)
+	{
+		v.add();
+		v.last().template get<0>() = sin(0.01*i);
+		v.last().template get<1>() = 3*i + (i % 2);
+		v.last().template get<2>()[0] = 0.5*i;
+		v.last().template get<2>()[1] = -1.0;
+		v.last().template get<2>()[2] = cos(0.1*i);
+	}
+
+	pack_compress_opt opt;
+	opt.set(0,PACK_COMPRESS_ERROR_BOUND,1e-3).set(1,PACK_COMPRESS_DELTA);
+
+	std::vector<unsigned char> buf;
+	Pack_stat sts;
+	pack_compress(v,opt,buf,sts);
+
+	BOOST_REQUIRE(sts.getCompressionRatio() > 1.0);
+	BOOST_REQUIRE_EQUAL(sts.getCompressedSize(),buf.size());
+
+	openfpm::vector<T> v2;
+	Unpack_stat ps;
+	BOOST_REQUIRE_EQUAL(unpack_compress(v2,buf.data(),buf.size(),ps),true);
+	BOOST_REQUIRE_EQUAL(ps.getOffset(),buf.size());
+	BOOST_REQUIRE_EQUAL(v2.size(),v.size());
+
+	bool match = true;
+	for (size_t i = 0 ; i < v.size() ; i++)
+	{
+		match &= fabs(v2.template get<0>(i) - v.template get<0>(i)) <= 1e-3;
+		match &= v2.template get<1>(i) == v.template get<1>(i);
+		match &= v2.template get<2>(i)[0] == v.template get<2>(i)[0];
+		match &= v2.template get<2>(i)[1] == v.template get<2>(i)[1];
+		match &= v2.template get<2>(i)[2] == v.template get<2>(i)[2];
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+
+	// fixed rate quantization of a single property
+	pack_compress_opt opt_fr;
+	opt_fr.set(0,PACK_COMPRESS_FIXED_RATE,12);
+
+	buf.clear();
+	Pack_stat sts_fr;
+	pack_compress<0>(v,opt_fr,buf,sts_fr);
+
+	// 12 bits instead of 32 for each value
+	BOOST_REQUIRE(sts_fr.getCompressionRatio() > 2.5);
+
+	Unpack_stat ps_fr;
+	openfpm::vector<T> v3;
+	BOOST_REQUIRE_EQUAL(unpack_compress<0>(v3,buf.data(),buf.size(),ps_fr),true);
+
+	for (size_t i = 0 ; i < v.size() ; i++)
+	{match &= fabs(v3.template get<0>(i) - v.template get<0>(i)) <= 2.0 / 4095 / 2 + 1e-7;}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+
+	// error bound on float values where the rounding to float is not negligible
+	typedef aggregate<float,float> Tf;
+	openfpm::vector<Tf> vf;
+
+	for (size_t i = 0 ; i < 10000 ; i++)
+	{
+		vf.add();
+		vf.last().template get<0>() = 1000.0f + 0.0137f*i + 3.0f*sin(0.37*i);
+		vf.last().template get<1>() = -1500.0f + 0.29f*i;
+	}
+
+	pack_compress_opt opt_f;
+	opt_f.set(0,PACK_COMPRESS_ERROR_BOUND,1.5e-3).set(1,PACK_COMPRESS_ERROR_BOUND,4e-4);
+
+	buf.clear();
+	Pack_stat sts_f;
+	pack_compress(vf,opt_f,buf,sts_f);
+
+	BOOST_REQUIRE(sts_f.getCompressionRatio() > 1.0);
+
+	Unpack_stat ps_f;
+	openfpm::vector<Tf> vf2;
+	BOOST_REQUIRE_EQUAL(unpack_compress(vf2,buf.data(),buf.size(),ps_f),true);
+	BOOST_REQUIRE_EQUAL(vf2.size(),vf.size());
+
+	for (size_t i = 0 ; i < vf.size() ; i++)
+	{
+		match &= fabs((double)vf2.template get<0>(i) - (double)vf.template get<0>(i)) <= 1.5e-3;
+		match &= fabs((double)vf2.template get<1>(i) - (double)vf.template get<1>(i)) <= 4e-4;
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+
+	// an error smaller than the precision and not finite values are stored exactly
+	typedef aggregate<double,float,float> Tr;
+	openfpm::vector<Tr> vr;
+
+	for (size_t i = 0 ; i < 1000 ; i++)
+	{
+		vr.add();
+		vr.last().template get<0>() = 1e10 + 0.25*i;
+		vr.last().template get<1>() = (i == 10)?NAN:(float)(0.5*i);
+		vr.last().template get<2>() = (i == 20)?INFINITY:(float)(0.5*i);
+	}
+
+	pack_compress_opt opt_r;
+	opt_r.set(0,PACK_COMPRESS_ERROR_BOUND,1e-9).set(1,PACK_COMPRESS_ERROR_BOUND,1e-1).set(2,PACK_COMPRESS_FIXED_RATE,12);
+
+	buf.clear();
+	Pack_stat sts_r;
+	pack_compress(vr,opt_r,buf,sts_r);
+
+	Unpack_stat ps_r;
+	openfpm::vector<Tr> vr2;
+	BOOST_REQUIRE_EQUAL(unpack_compress(vr2,buf.data(),buf.size(),ps_r),true);
+	BOOST_REQUIRE_EQUAL(vr2.size(),vr.size());
+
+	for (size_t i = 0 ; i < vr.size() ; i++)
+	{
+		match &= vr2.template get<0>(i) == vr.template get<0>(i);
+		match &= (i == 10)?(std::isnan(vr2.template get<1>(i)) != 0):(vr2.template get<1>(i) == vr.template get<1>(i));
+		match &= vr2.template get<2>(i) == vr.template get<2>(i);
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+
+	// grid all the properties lossless, unpacked into a grid with memory_traits_inte layout
+	typedef Point_test<float> pt;
+
+	size_t sz[] = {16,17,9};
+	grid_cpu<3,pt> g(sz);
+	g.setMemory();
+	fill_grid<3>(g);
+
+	buf.clear();
+	Pack_stat sts_g;
+	pack_compress(g,pack_compress_opt(),buf,sts_g);
+
+	grid_base<3,pt,HeapMemory,typename memory_traits_inte<pt>::type> g2;
+	Unpack_stat ps_g;
+	BOOST_REQUIRE_EQUAL(unpack_compress(g2,buf.data(),buf.size(),ps_g),true);
+	BOOST_REQUIRE_EQUAL(g2.getGrid().size(1),sz[1]);
+
+	auto it = g.getIterator();
+
+	while (it.isNext())
+	{
+		auto key = it.get();
+
+		match &= g2.template get<pt::x>(key) == g.template get<pt::x>(key);
+		match &= g2.template get<pt::s>(key) == g.template get<pt::s>(key);
+
+		for (size_t j = 0 ; j < 3 ; j++)
+		{
+			match &= g2.template get<pt::v>(key)[j] == g.template get<pt::v>(key)[j];
+
+			for (size_t k = 0 ; k < 3 ; k++)
+			{match &= g2.template get<pt::t>(key)[j][k] == g.template get<pt::t>(key)[j][k];}
+		}
+
+		++it;
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+}
+
+BOOST_AUTO_TEST_CASE ( packer_checkpoint_test )
+{
+	typedef Point_test<float> pt;
+
+	// vector, save with memory_traits_lin and load with memory_traits_inte (the data section is bigger
+	// than CHECKPOINT_CONVERT_BUFFER, so it is converted in more pieces)
+	openfpm::vector<pt> v = allocate_openfpm_fill(300000,1);
+
+	BOOST_REQUIRE_EQUAL(v.save("test_checkpoint_vector"),true);
+
+	openfpm::vector<pt,HeapMemory,memory_traits_inte> vi;
+	BOOST_REQUIRE_EQUAL(vi.load("test_checkpoint_vector"),true);
+	BOOST_REQUIRE_EQUAL(vi.size(),v.size());
+
+	bool match = true;
+	for (size_t i = 0 ; i < v.size() ; i++)
+	{
+		match &= vi.template get<pt::x>(i) == v.template get<pt::x>(i);
+		match &= vi.template get<pt::s>(i) == v.template get<pt::s>(i);
+
+		for (size_t j = 0 ; j < 3 ; j++)
+		{
+			match &= vi.template get<pt::v>(i)[j] == v.template get<pt::v>(i)[j];
+
+			for (size_t k = 0 ; k < 3 ; k++)
+			{match &= vi.template get<pt::t>(i)[j][k] == v.template get<pt::t>(i)[j][k];}
+		}
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+
+	// save memory_traits_inte striped in 3 files and load back with memory_traits_lin
+	BOOST_REQUIRE_EQUAL(vi.save("test_checkpoint_vector_s",3),true);
+
+	openfpm::vector<pt> v2;
+	BOOST_REQUIRE_EQUAL(v2.load("test_checkpoint_vector_s"),true);
+	BOOST_REQUIRE_EQUAL(v2.size(),v.size());
+	BOOST_REQUIRE_EQUAL(memcmp(v2.getPointer(),v.getPointer(),v.size()*sizeof(pt::type)),0);
+
+	// a vector with different properties must refuse the checkpoint
+	openfpm::vector<aggregate<float,float>> vw;
+	BOOST_REQUIRE_EQUAL(vw.load("test_checkpoint_vector"),false);
+
+	// grid, save with memory_traits_lin and load with memory_traits_inte
+	size_t sz[] = {32,17,9};
+	grid_cpu<3,pt> g(sz);
+	g.setMemory();
+	fill_grid<3>(g);
+
+	BOOST_REQUIRE_EQUAL(g.save("test_checkpoint_grid",2),true);
+
+	grid_base<3,pt,HeapMemory,typename memory_traits_inte<pt>::type> gi;
+	BOOST_REQUIRE_EQUAL(gi.load("test_checkpoint_grid"),true);
+
+	for (size_t i = 0 ; i < 3 ; i++)
+	{BOOST_REQUIRE_EQUAL(gi.getGrid().size(i),sz[i]);}
+
+	auto it = g.getIterator();
+
+	while (it.isNext())
+	{
+		auto key = it.get();
+
+		match &= gi.template get<pt::x>(key) == g.template get<pt::x>(key);
+		match &= gi.template get<pt::s>(key) == g.template get<pt::s>(key);
+
+		for (size_t j = 0 ; j < 3 ; j++)
+		{
+			match &= gi.template get<pt::v>(key)[j] == g.template get<pt::v>(key)[j];
+
+			for (size_t k = 0 ; k < 3 ; k++)
+			{match &= gi.template get<pt::t>(key)[j][k] == g.template get<pt::t>(key)[j][k];}
+		}
+
+		++it;
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+
+	// and back to memory_traits_lin
+	BOOST_REQUIRE_EQUAL(gi.save("test_checkpoint_grid_i"),true);
+
+	grid_cpu<3,pt> g2;
+	BOOST_REQUIRE_EQUAL(g2.load("test_checkpoint_grid_i"),true);
+	BOOST_REQUIRE_EQUAL(memcmp(g2.getPointer(),g.getPointer(),g.size()*sizeof(pt::type)),0);
+
+	// a vector cannot load a grid checkpoint
+	BOOST_REQUIRE_EQUAL(v2.load("test_checkpoint_grid_i"),false);
+
+	remove("test_checkpoint_vector");
+	remove("test_checkpoint_grid_i");
+
+	for (size_t k = 0 ; k < 3 ; k++)
+	{remove(checkpoint_stripe_name("test_checkpoint_vector_s",k).c_str());}
+	remove("test_checkpoint_vector_s");
+
+	for (size_t k = 0 ; k < 2 ; k++)
+	{remove(checkpoint_stripe_name("test_checkpoint_grid",k).c_str());}
+	remove("test_checkpoint_grid");
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 
@@ -180,6 +180,158 @@ BOOST_AUTO_TEST_CASE( bm_test )
 
 }
 
+
+/*! \brief Pack throughput in GB/s
+ *
+ * \param bytes packed bytes at each repetition
+ * \param n_rep number of repetitions
+ * \param t timer
+ *
+ * \return the throughput
+ *
+ */
+static double bm_pack_throughput(size_t bytes, size_t n_rep, timer & t)
+{
+	return (double)bytes * n_rep / t.getwct() / 1e9;
+}
+
+BOOST_AUTO_TEST_CASE( bm_parallel_pack_test )
+{
+	typedef Point_test<float> pt;
+
+	size_t n_rep = 10;
+
+	// the 6 ghost layers (3 points thick) of a 96^3 grid
+	size_t sz[] = {96,96,96};
+	grid_cpu<3,pt> g(sz);
+	g.setMemory();
+	fill_grid<3>(g);
+
+	std::vector<grid_key_dx_iterator_sub<3>> subs;
+	for (size_t d = 0 ; d < 3 ; d++)
+	{
+		grid_key_dx<3> start({0,0,0});
+		grid_key_dx<3> stop({95,95,95});
+
+		stop.set_d(d,2);
+		subs.push_back(grid_key_dx_iterator_sub<3>(g.getGrid(),start,stop));
+
+		start.set_d(d,93);
+		stop.set_d(d,95);
+		subs.push_back(grid_key_dx_iterator_sub<3>(g.getGrid(),start,stop));
+	}
+
+	std::vector<size_t> offsets;
+	size_t req = 0;
+	g.template packRequest<pt::x,pt::v>(subs,offsets,req);
+
+	HeapMemory pmem;
+	pmem.allocate(req);
+
+	// sub-grids packed one by one
+	timer t_ser;
+	t_ser.start();
+
+	for (size_t r = 0 ; r < n_rep ; r++)
+	{
+		ExtPreAlloc<HeapMemory> & mem = *(new ExtPreAlloc<HeapMemory>(req,pmem));
+		mem.incRef();
+
+		Pack_stat sts;
+		for (size_t k = 0 ; k < subs.size() ; k++)
+		{
+			auto sub = subs[k];
+			g.template pack<pt::x,pt::v>(mem,sub,sts);
+		}
+
+		mem.decRef();
+		delete &mem;
+	}
+
+	t_ser.stop();
+
+	// parallel pack of all the sub-grids
+	timer t_par;
+	t_par.start();
+
+	for (size_t r = 0 ; r < n_rep ; r++)
+	{
+		ExtPreAlloc<HeapMemory> & mem = *(new ExtPreAlloc<HeapMemory>(req,pmem));
+		mem.incRef();
+
+		Pack_stat sts;
+		g.template pack<pt::x,pt::v>(mem,subs,offsets,sts);
+
+		mem.decRef();
+		delete &mem;
+	}
+
+	t_par.stop();
+
+	std::cout << "Grid sub-grids pack (" << req << " bytes) serial: " << bm_pack_throughput(req,n_rep,t_ser) << " GB/s "
+			  << " parallel (" << openfpm_omp_max_threads() << " threads): " << bm_pack_throughput(req,n_rep,t_par) << " GB/s" << std::endl;
+
+	// vector pack
+	openfpm::vector<pt> v = allocate_openfpm_fill(1000000,1);
+
+	size_t req_v = 0;
+	Packer<decltype(v),HeapMemory>::packRequest<pt::x,pt::v>(v,req_v);
+
+	HeapMemory pmem_v;
+	pmem_v.allocate(req_v);
+
+	timer t_v;
+	t_v.start();
+
+	for (size_t r = 0 ; r < n_rep ; r++)
+	{
+		ExtPreAlloc<HeapMemory> & mem = *(new ExtPreAlloc<HeapMemory>(req_v,pmem_v));
+		mem.incRef();
+
+		Pack_stat sts;
+		Packer<decltype(v),HeapMemory>::pack<pt::x,pt::v>(mem,v,sts);
+
+		mem.decRef();
+		delete &mem;
+	}
+
+	t_v.stop();
+
+	std::cout << "Vector pack (" << req_v << " bytes, " << openfpm_omp_max_threads() << " threads): " << bm_pack_throughput(req_v,n_rep,t_v) << " GB/s" << std::endl;
+}
+
+
+BOOST_AUTO_TEST_CASE( bm_compress_test )
+{
+	typedef aggregate<double,size_t> T;
+
+	openfpm::vector<T> v;
+	v.resize(1000000);
+
+	for (size_t i = 0 ; i < v.size() ; i++)
+	{
+		v.template get<0>(i) = sin(1e-4*i);
+		v.template get<1>(i) = 4*i;
+	}
+
+	pack_compress_opt opt_ll;
+
+	pack_compress_opt opt_ly;
+	opt_ly.set(0,PACK_COMPRESS_ERROR_BOUND,1e-6).set(1,PACK_COMPRESS_DELTA);
+
+	std::vector<unsigned char> buf;
+
+	Pack_stat sts_ll;
+	pack_compress(v,opt_ll,buf,sts_ll);
+
+	buf.clear();
+	Pack_stat sts_ly;
+	pack_compress(v,opt_ly,buf,sts_ly);
+
+	std::cout << "Vector compressed pack lossless ratio: " << sts_ll.getCompressionRatio() << " throughput: " << sts_ll.getCompressionThroughput() / 1e9 << " GB/s "
+			  << " lossy+delta ratio: " << sts_ly.getCompressionRatio() << " throughput: " << sts_ly.getCompressionThroughput() / 1e9 << " GB/s" << std::endl;
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 #endif /* OPENFPM_DATA_SRC_PACKER_UNPACKER_PACKER_UNPACKER_BENCHMARK_TEST_HPP_ */
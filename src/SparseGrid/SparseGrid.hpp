@@ -20,6 +20,7 @@
 #include "SparseGrid_iterator.hpp"
 #include "SparseGrid_iterator_block.hpp"
 #include "SparseGrid_conv_opt.hpp"
+#include "util/openmp_util.hpp"
 //#include "util/debug.hpp"
 // We do not want parallel writer
 
@@ -200,6 +201,208 @@ public:
 
 };
 
+template<typename T>
+struct copy_dense_row_impl
+{
+	template<unsigned int prop, typename chunks_type, typename dense_type>
+	static void to_dense(const chunks_type & chunks, size_t cnk, int sub0, const unsigned char * mask, dense_type & dense, size_t lin0, int n)
+	{
+		auto & src = chunks.template get<prop>(cnk);
+		auto & bck = chunks.template get<prop>(0);
+
+		if (mask == NULL)
+		{
+			for (int x = 0 ; x < n ; x++)
+			{dense.template get<prop>(lin0+x) = src[sub0+x];}
+		}
+		else
+		{
+			for (int x = 0 ; x < n ; x++)
+			{dense.template get<prop>(lin0+x) = (mask[x])?src[sub0+x]:bck[sub0+x];}
+		}
+	}
+
+	template<unsigned int prop, typename chunks_type, typename dense_type>
+	static void from_dense(chunks_type & chunks, size_t cnk, int sub0, const unsigned char * mask, const dense_type & dense, size_t lin0, int n)
+	{
+		auto & dst = chunks.template get<prop>(cnk);
+
+		if (mask == NULL)
+		{
+			for (int x = 0 ; x < n ; x++)
+			{dst[sub0+x] = dense.template get<prop>(lin0+x);}
+		}
+		else
+		{
+			for (int x = 0 ; x < n ; x++)
+			{dst[sub0+x] = (mask[x])?dense.template get<prop>(lin0+x):dst[sub0+x];}
+		}
+	}
+};
+
+template<typename T, unsigned int N1>
+struct copy_dense_row_impl<T[N1]>
+{
+	template<unsigned int prop, typename chunks_type, typename dense_type>
+	static void to_dense(const chunks_type & chunks, size_t cnk, int sub0, const unsigned char * mask, dense_type & dense, size_t lin0, int n)
+	{
+		auto & src = chunks.template get<prop>(cnk);
+		auto & bck = chunks.template get<prop>(0);
+
+		for (int x = 0 ; x < n ; x++)
+		{
+			bool e = (mask == NULL) || mask[x];
+
+			for (size_t i = 0 ; i < N1 ; i++)
+			{dense.template get<prop>(lin0+x)[i] = (e)?src[i][sub0+x]:bck[i][sub0+x];}
+		}
+	}
+
+	template<unsigned int prop, typename chunks_type, typename dense_type>
+	static void from_dense(chunks_type & chunks, size_t cnk, int sub0, const unsigned char * mask, const dense_type & dense, size_t lin0, int n)
+	{
+		auto & dst = chunks.template get<prop>(cnk);
+
+		for (int x = 0 ; x < n ; x++)
+		{
+			if (mask != NULL && mask[x] == 0)	{continue;}
+
+			for (size_t i = 0 ; i < N1 ; i++)
+			{dst[i][sub0+x] = dense.template get<prop>(lin0+x)[i];}
+		}
+	}
+};
+
+/*! \brief Copy a row of a chunk into a dense grid (the row of the dense grid is contiguous)
+ *
+ * \tparam T type of the properties
+ * \tparam chunks_type vector of chunks
+ * \tparam dense_type dense grid
+ * \tparam prp properties to copy
+ *
+ */
+template<typename T, typename chunks_type, typename dense_type, unsigned int ... prp>
+class copy_chunk_row_to_dense
+{
+	//! chunks
+	const chunks_type & chunks;
+
+	//! dense grid
+	dense_type & dense;
+
+	//! chunk
+	size_t cnk;
+
+	//! first element of the row in the chunk
+	int sub0;
+
+	//! mask of the row (NULL if all the points exist)
+	const unsigned char * mask;
+
+	//! first element of the row in the dense grid
+	size_t lin0;
+
+	//! number of elements in the row
+	int n;
+
+	//! convert the properties into an mpl vector
+	typedef typename to_boost_vmpl<prp...>::type v_prp;
+
+public:
+
+	copy_chunk_row_to_dense(const chunks_type & chunks, dense_type & dense, size_t cnk, int sub0, const unsigned char * mask, size_t lin0, int n)
+	:chunks(chunks),dense(dense),cnk(cnk),sub0(sub0),mask(mask),lin0(lin0),n(n)
+	{}
+
+	//! It call the copy function for each property
+	template<typename Tp>
+	inline void operator()(Tp& /*t*/) const
+	{
+		typedef typename boost::mpl::at<v_prp,boost::mpl::int_<Tp::value>>::type idx_type;
+		typedef typename boost::mpl::at<typename T::type,idx_type>::type prop_type;
+
+		copy_dense_row_impl<prop_type>::template to_dense<idx_type::value>(chunks,cnk,sub0,mask,dense,lin0,n);
+	}
+};
+
+/*! \brief Copy a row of a dense grid into a chunk
+ *
+ * \tparam T type of the properties
+ * \tparam chunks_type vector of chunks
+ * \tparam dense_type dense grid
+ * \tparam prp properties to copy
+ *
+ */
+template<typename T, typename chunks_type, typename dense_type, unsigned int ... prp>
+class copy_dense_row_to_chunk
+{
+	//! chunks
+	chunks_type & chunks;
+
+	//! dense grid
+	const dense_type & dense;
+
+	//! chunk
+	size_t cnk;
+
+	//! first element of the row in the chunk
+	int sub0;
+
+	//! points of the row to copy (NULL for all)
+	const unsigned char * mask;
+
+	//! first element of the row in the dense grid
+	size_t lin0;
+
+	//! number of elements in the row
+	int n;
+
+	//! convert the properties into an mpl vector
+	typedef typename to_boost_vmpl<prp...>::type v_prp;
+
+public:
+
+	copy_dense_row_to_chunk(chunks_type & chunks, const dense_type & dense, size_t cnk, int sub0, const unsigned char * mask, size_t lin0, int n)
+	:chunks(chunks),dense(dense),cnk(cnk),sub0(sub0),mask(mask),lin0(lin0),n(n)
+	{}
+
+	//! It call the copy function for each property
+	template<typename Tp>
+	inline void operator()(Tp& /*t*/) const
+	{
+		typedef typename boost::mpl::at<v_prp,boost::mpl::int_<Tp::value>>::type idx_type;
+		typedef typename boost::mpl::at<typename T::type,idx_type>::type prop_type;
+
+		copy_dense_row_impl<prop_type>::template from_dense<idx_type::value>(chunks,cnk,sub0,mask,dense,lin0,n);
+	}
+};
+
+/*! \brief Predicate for from_dense, a point become active if the absolute value of the property p is
+ *         bigger than a threshold
+ *
+ * \tparam p property
+ * \tparam prop_type type of the property
+ *
+ */
+template<unsigned int p, typename prop_type>
+struct dense_threshold
+{
+	//! threshold
+	prop_type th;
+
+	dense_threshold(prop_type th)
+	:th(th)
+	{}
+
+	template<typename dense_type>
+	inline bool operator()(const dense_type & dense, size_t lin) const
+	{
+		prop_type v = dense.template get<p>(lin);
+
+		return ((v < 0)?-v:v) > th;
+	}
+};
+
 template< template<typename,typename> class op,unsigned int dim, typename Tsrc,typename Tdst, unsigned int ... prp>
 class copy_sparse_to_sparse_op
 {
@@ -243,37 +446,55 @@ public:
 
 /*! \brief this class is a functor for "for_each" algorithm
  *
- * This class is a functor for "for_each" algorithm. For each
- * element of the boost::vector the operator() is called.
- * Is mainly used to copy a boost::mpl::vector into runtime array
+ * It copy the properties prp of one element of a vector into a point of a chunk. If the point
+ * already exist the value is merged with the operation op
  *
  */
-
-template<unsigned int dim, typename mpl_v>
-struct copy_sz
+template< template<typename,typename> class op, typename T, typename vector_type, typename chunks_type, unsigned int ... prp>
+class copy_bulk_to_sparse_op
 {
-	//! sz site_t
-	size_t (& sz)[dim];
+	//! source
+	const vector_type & src;
 
+	//! chunks of the destination
+	chunks_type & chunks;
 
-	/*! \brief constructor
-	 *
-	 * \param sz runtime sz to fill
-	 *
-	 */
-	inline copy_sz(size_t (& sz)[dim])
-	:sz(sz)
-	{
-	};
+	//! element in the source
+	size_t i_src;
+
+	//! destination chunk
+	size_t cnk;
+
+	//! element in the destination chunk
+	size_t sub_id;
+
+	//! true if the destination point exist
+	bool exist;
+
+	//! Convert the packed properties into an MPL vector
+	typedef typename to_boost_vmpl<prp...>::type v_prp;
+
+public:
+
+	copy_bulk_to_sparse_op(const vector_type & src, chunks_type & chunks, size_t i_src, size_t cnk, size_t sub_id, bool exist)
+	:src(src),chunks(chunks),i_src(i_src),cnk(cnk),sub_id(sub_id),exist(exist)
+	{}
 
 	//! It call the copy function for each property
-	template<typename T>
-	inline void operator()(T& t) const
+	template<typename Tp>
+	inline void operator()(Tp& /*t*/) const
 	{
-		sz[T::value] = boost::mpl::at<mpl_v,boost::mpl::int_<T::value>>::type::value;
+		typedef typename boost::mpl::at<v_prp,boost::mpl::int_<Tp::value>>::type idx_type;
+		typedef typename boost::mpl::at<typename T::type,idx_type>::type prop_type;
+		typedef typename std::remove_reference<decltype(get_selector<prop_type>::template get<idx_type::value>(chunks,cnk,sub_id))>::type copy_rtype;
+
+		if (exist == false)
+		{meta_copy_op<replace_,copy_rtype>::meta_copy_op_(src.template get<idx_type::value>(i_src),get_selector<prop_type>::template get<idx_type::value>(chunks,cnk,sub_id));}
+		else
+		{meta_copy_op<op,copy_rtype>::meta_copy_op_(src.template get<idx_type::value>(i_src),get_selector<prop_type>::template get<idx_type::value>(chunks,cnk,sub_id));}
 	}
-};
 
+};
 
 template<unsigned int N>
 struct load_mask_impl
@@ -371,6 +592,70 @@ inline Vc_type load_mask(unsigned char * mask_sum)
 	return v;
 }
 
+/*! \brief Read access to a sparse grid with a private chunk cache
+ *
+ * Accessors of the same sparse grid can be used concurrently by different threads, as long as
+ * nobody modify the sparse grid
+ *
+ * \tparam sgrid_type sparse grid
+ *
+ */
+template<typename sgrid_type>
+class sgrid_cpu_accessor
+{
+	//! sparse grid
+	const sgrid_type & sg;
+
+	//! chunk cache of this accessor
+	sgrid_chunk_cache<SGRID_CACHE> cc;
+
+public:
+
+	/*! \brief Constructor
+	 *
+	 * \param sg sparse grid
+	 *
+	 */
+	sgrid_cpu_accessor(const sgrid_type & sg)
+	:sg(sg)
+	{}
+
+	/*! \brief Get the reference of the selected element
+	 *
+	 * \param v1 grid_key that identify the element in the grid
+	 *
+	 * \return the reference of the element
+	 *
+	 */
+	template <unsigned int p>
+	inline auto get(const grid_key_dx<sgrid_type::dims> & v1) -> decltype(sg.template get<p>(v1,cc))
+	{
+		return sg.template get<p>(v1,cc);
+	}
+
+	/*! \brief Check if the point exist
+	 *
+	 * \param v1 grid_key that identify the element in the grid
+	 *
+	 * \return the true if the point exist
+	 *
+	 */
+	inline bool existPoint(const grid_key_dx<sgrid_type::dims> & v1)
+	{
+		return sg.existPoint(v1,cc);
+	}
+
+	/*! \brief Reset the cache
+	 *
+	 * The cache must be reset if the sparse grid change
+	 *
+	 */
+	inline void clear_cache()
+	{
+		cc.clear();
+	}
+};
+
 template<unsigned int dim,
 		 typename T,
 		 typename S,
@@ -380,14 +665,8 @@ template<unsigned int dim,
 		 typename chunking>
 class sgrid_cpu
 {
-	//! cache pointer
-	mutable size_t cache_pnt;
-
-	//! cache
-	mutable long int cache[SGRID_CACHE];
-
-	//! cached id
-	mutable long int cached_id[SGRID_CACHE];
+	//! cache of the last chunks accessed
+	mutable sgrid_chunk_cache<SGRID_CACHE> chunk_cache;
 
 	//! Map to convert from grid coordinates to chunk
 	tsl::hopscotch_map<size_t, size_t> map;
@@ -395,7 +674,8 @@ class sgrid_cpu
 	//! indicate which element in the chunk are really filled
 	openfpm::vector<cheader<dim>,S> header_inf;
 
-	openfpm::vector<mheader<chunking::size::value>,S> header_mask;
+	//! which elements in the chunks are set (one byte or one bit for each element, see sgrid_mheader)
+	openfpm::vector<typename sgrid_mheader<chunking>::type,S> header_mask;
 
 	//Definition of the chunks
 	typedef typename v_transform_two_v2<Ft_chunk,boost::mpl::int_<chunking::size::value>,typename T::type>::type chunk_def;
@@ -422,6 +702,21 @@ class sgrid_cpu
 
 	openfpm::vector<size_t> empty_v;
 
+	//! order kept for the chunks, with SGRID_ORDER_NONE the new chunks are appended
+	sgrid_order keep_order;
+
+	//! number of chunks (background included) that are in order
+	size_t n_ordered;
+
+	//! dead chunks, their slots are recycled by the next chunks created
+	openfpm::vector<size_t> free_v;
+
+	//! minimum number of dead chunks before the chunks are compacted
+	size_t compact_min;
+
+	//! minimum fraction of dead chunks before the chunks are compacted
+	double compact_frac;
+
 	//! bool that indicate if the NNlist is filled
 	bool findNN;
 
@@ -453,10 +748,10 @@ class sgrid_cpu
 	 *
 	 *
 	 */
-	template<unsigned int n_ele>
+	template<unsigned int n_ele, typename mask_type>
 	inline void remove_from_chunk(size_t sub_id,
 			 	 	 	 	 	  int & nele,
-								  unsigned char (& mask)[n_ele])
+								  mask_type & mask)
 	{
 		nele = (mask[sub_id])?nele-1:nele;
 
@@ -475,6 +770,8 @@ class sgrid_cpu
 		map.clear();
 		for (size_t i = 1 ; i < header_inf.size() ; i++)
 		{
+			if (is_dead(i) == true)	{continue;}
+
 			grid_key_dx<dim> kh = header_inf.get(i).pos;
 			grid_key_dx<dim> kl;
 
@@ -487,15 +784,89 @@ class sgrid_cpu
 		}
 	}
 
-	/*! \brief Eliminate empty chunks
+	/*! \brief Check if a chunk is dead (its slot can be recycled)
+	 *
+	 * \param i chunk
+	 *
+	 * \return true if the chunk is dead
+	 *
+	 */
+	inline bool is_dead(size_t i) const
+	{
+		return i != 0 && header_inf.get(i).pos.get(0) == std::numeric_limits<long int>::min();
+	}
+
+	/*! \brief Get a dead chunk to recycle
+	 *
+	 * In keep ordered mode the slots are not recycled, the dead chunks are eliminated by the compaction
+	 *
+	 * \param cnk recycled chunk
+	 *
+	 * \return true if there is a chunk to recycle
+	 *
+	 */
+	inline bool pop_free_chunk(size_t & cnk)
+	{
+		if (free_v.size() == 0 || keep_order != SGRID_ORDER_NONE)
+		{return false;}
+
+		cnk = free_v.last();
+		free_v.remove(free_v.size() - 1);
+
+		return true;
+	}
+
+	/*! \brief Create a chunk, recycling a dead chunk if possible
+	 *
+	 * \param lin_id linearized position of the chunk
+	 * \param kh position of the chunk (in chunks)
+	 *
+	 * \return the chunk created
+	 *
+	 */
+	inline size_t add_chunk(long int lin_id, const grid_key_dx<dim> & kh)
+	{
+		size_t cnk;
+
+		if (pop_free_chunk(cnk) == false)
+		{
+			cnk = chunks.size();
+
+			chunks.add();
+			header_inf.add();
+			header_mask.add();
+		}
+
+		map[lin_id] = cnk;
+
+		// the slot can be recycled, the list of neighborhood chunks must be reconstructed
+		findNN = false;
+
+		for (size_t i = 0 ; i < dim ; i++)
+		{header_inf.get(cnk).pos.set_d(i,kh.get(i));}
+		header_inf.get(cnk).nele = 0;
+
+		// set the mask to null
+		auto & h = header_mask.get(cnk).mask;
+
+		for (size_t i = 0 ; i < chunking::size::value ; i++)
+		{h[i] = 0;}
+
+		key_shift<dim,chunking>::cpos(header_inf.get(cnk).pos);
+
+		return cnk;
+	}
+
+	/*! \brief Retire the empty chunks
 	 *
-	 * \warning Because this operation is time consuming it perform the operation once
-	 *          we reach a critical size in the list of the empty chunks
+	 * The empty chunks are removed from the map and become dead, their slots are recycled by the next
+	 * chunks created. The chunks are compacted only when the dead chunks reach the thresholds
+	 * (see setCompactionThresholds)
 	 *
 	 */
 	inline void remove_empty()
 	{
-		if (empty_v.size() >= FLUSH_REMOVE)
+		if (empty_v.size() != 0)
 		{
 			// eliminate double entry
 
@@ -503,21 +874,31 @@ class sgrid_cpu
 			empty_v.unique();
 
 			// Because chunks can be refilled the empty list can contain chunks that are
-			// filled so before remove we have to check that they are really empty
+			// filled so before retire them we have to check that they are really empty
 
-			for (int i = empty_v.size() - 1 ; i >= 0  ; i--)
+			for (size_t i = 0 ; i < empty_v.size() ; i++)
 			{
-				if (header_inf.get(empty_v.get(i)).nele != 0)
-				{empty_v.remove(i);}
-			}
+				size_t cnk = empty_v.get(i);
 
-			header_inf.remove(empty_v);
-			header_mask.remove(empty_v);
-			chunks.remove(empty_v);
+				if (header_inf.get(cnk).nele != 0 || is_dead(cnk) == true)
+				{continue;}
 
-			// reconstruct map
+				grid_key_dx<dim> kh = header_inf.get(cnk).pos;
+				grid_key_dx<dim> kl;
 
-			reconstruct_map();
+				// shift the key
+				key_shift<dim,chunking>::shift(kh,kl);
+
+				auto fnd = map.find(g_sm_shift.LinId(kh));
+				if (fnd != map.end() && fnd->second == cnk)
+				{map.erase(fnd);}
+
+				for (size_t j = 0 ; j < dim ; j++)
+				{header_inf.get(cnk).pos.set_d(j,std::numeric_limits<long int>::min());}
+
+				free_v.add(cnk);
+				findNN = false;
+			}
 
 			empty_v.clear();
 
@@ -525,68 +906,196 @@ class sgrid_cpu
 
 			clear_cache();
 		}
-	}
 
-	/*! \brief add on cache
-	 *
-	 * \param lin_id linearized id
-	 * \param active_cnk active chunk
-	 *
-	 */
-	inline void add_on_cache(size_t lin_id, size_t active_cnk) const
-	{
-		// Add on cache the chunk
-		cache[cache_pnt] = lin_id;
-		cached_id[cache_pnt] = active_cnk;
-		cache_pnt++;
-		cache_pnt = (cache_pnt >= SGRID_CACHE)?0:cache_pnt;
+		if (free_v.size() != 0 && free_v.size() >= compact_min && free_v.size() >= compact_frac * header_inf.size())
+		{compact();}
 	}
 
-	/*! \brief reset the cache
+	/*! \brief Number of bits needed for the coordinates of the chunks
 	 *
+	 * \return the number of bits
 	 *
 	 */
-	inline void clear_cache()
+	size_t sfc_bits() const
 	{
-		cache_pnt = 0;
-		for (size_t i = 0 ; i < SGRID_CACHE ; i++)
-		{cache[i] = -1;}
+		size_t bits = 1;
+
+		for (size_t i = 0 ; i < dim ; i++)
+		{
+			while (((size_t)1 << bits) < g_sm_shift.size(i))
+			{bits++;}
+		}
+
+		return bits;
 	}
 
-	/*! \brief set the grid shift from size
+	/*! \brief Key of a chunk in the order ord
 	 *
-	 * \param sz size of the grid
-	 * \param g_sm_shift chunks grid size
+	 * \param i chunk
+	 * \param ord order
+	 * \param bits number of bits of the coordinates of the chunks
+	 *
+	 * \return the key
 	 *
 	 */
-	void set_g_shift_from_size(const size_t (& sz)[dim], grid_lin & g_sm_shift)
+	size_t chunk_order_key(size_t i, sgrid_order ord, size_t bits) const
 	{
-		grid_key_dx<dim> cs;
-		grid_key_dx<dim> unused;
-
-		for (size_t i = 0 ; i < dim ; i++)
-		{cs.set_d(i,sz[i]);}
+		if (is_dead(i) == true)
+		{return 0;}
 
-		key_shift<dim,chunking>::shift(cs,unused);
+		grid_key_dx<dim> kh = header_inf.get(i).pos;
+		grid_key_dx<dim> kl;
 
-		size_t sz_i[dim];
+		// shift the key
+		key_shift<dim,chunking>::shift(kh,kl);
 
-		for (size_t i = 0 ; i < dim ; i++)
-		{sz_i[i] = cs.get(i) + 1;}
+		if (ord == SGRID_ORDER_MORTON)
+		{return sgrid_sfc<dim>::morton(kh,bits);}
+		else if (ord == SGRID_ORDER_HILBERT)
+		{return sgrid_sfc<dim>::hilbert(kh,bits);}
 
-		g_sm_shift.setDimensions(sz_i);
+		return g_sm_shift.LinId(kh);
 	}
 
-	/*! \brief initialize
+	/*! \brief Move the chunks, the new chunk i is the old chunk prm.get(i)
+	 *
+	 * The chunks not in prm are eliminated
 	 *
+	 * \param prm permutation (the background chunk must remain the first)
 	 *
 	 */
-	void init()
+	void apply_chunk_permutation(const openfpm::vector<size_t> & prm)
 	{
-		findNN = false;
+		openfpm::vector<cheader<dim>,S> header_inf_tmp;
+		openfpm::vector<typename sgrid_mheader<chunking>::type,S> header_mask_tmp;
+		openfpm::vector<aggregate_bfv<chunk_def>,S,layout_base > chunks_tmp;
+
+		header_inf_tmp.resize(prm.size());
+		header_mask_tmp.resize(prm.size());
+		chunks_tmp.resize(prm.size());
+
+		long int n_cnk = prm.size();
+
+		#pragma omp parallel for schedule(static) if (n_cnk >= SGRID_OMP_MIN_CHUNKS)
+		for (long int i = 0 ; i < n_cnk ; i++)
+		{
+			chunks_tmp.get(i) = chunks.get(prm.get(i));
+			header_inf_tmp.get(i) = header_inf.get(prm.get(i));
+			header_mask_tmp.get(i) = header_mask.get(prm.get(i));
+		}
+
+		chunks_tmp.swap(chunks);
+		header_inf_tmp.swap(header_inf);
+		header_mask_tmp.swap(header_mask);
+
+		// the empty and the dead chunks follow the permutation
+
+		openfpm::vector<size_t> inv;
+		inv.resize(chunks_tmp.size());
+
+		for (size_t i = 0 ; i < inv.size() ; i++)
+		{inv.get(i) = (size_t)-1;}
+
+		for (size_t i = 0 ; i < prm.size() ; i++)
+		{inv.get(prm.get(i)) = i;}
+
+		for (long int i = empty_v.size() - 1 ; i >= 0 ; i--)
+		{
+			empty_v.get(i) = inv.get(empty_v.get(i));
+			if (empty_v.get(i) == (size_t)-1)	{empty_v.remove(i);}
+		}
+
+		for (long int i = free_v.size() - 1 ; i >= 0 ; i--)
+		{
+			free_v.get(i) = inv.get(free_v.get(i));
+			if (free_v.get(i) == (size_t)-1)	{free_v.remove(i);}
+		}
+
+		clear_cache();
+		reconstruct_map();
+
+		findNN = false;
+		NNlist.clear();
+	}
+
+	/*! \brief In keep ordered mode merge the new chunks into the order when they are enough
+	 *
+	 * \return true if the chunks has been moved
+	 *
+	 */
+	bool check_order()
+	{
+		if (keep_order == SGRID_ORDER_NONE)
+		{return false;}
+
+		size_t n_new = header_inf.size() - n_ordered;
+
+		if (n_new >= SGRID_ORDER_MERGE_MIN && n_new >= n_ordered / SGRID_ORDER_MERGE_FRACTION)
+		{
+			merge_ordered();
+			return true;
+		}
+
+		return false;
+	}
+
+	/*! \brief add on cache
+	 *
+	 * \param lin_id linearized id
+	 * \param active_cnk active chunk
+	 *
+	 */
+	inline void add_on_cache(size_t lin_id, size_t active_cnk) const
+	{
+		chunk_cache.add(lin_id,active_cnk);
+	}
+
+	/*! \brief reset the cache
+	 *
+	 *
+	 */
+	inline void clear_cache()
+	{
+		chunk_cache.clear();
+	}
+
+	/*! \brief set the grid shift from size
+	 *
+	 * \param sz size of the grid
+	 * \param g_sm_shift chunks grid size
+	 *
+	 */
+	void set_g_shift_from_size(const size_t (& sz)[dim], grid_lin & g_sm_shift)
+	{
+		grid_key_dx<dim> cs;
+		grid_key_dx<dim> unused;
+
+		for (size_t i = 0 ; i < dim ; i++)
+		{cs.set_d(i,sz[i]);}
+
+		key_shift<dim,chunking>::shift(cs,unused);
+
+		size_t sz_i[dim];
+
+		for (size_t i = 0 ; i < dim ; i++)
+		{sz_i[i] = cs.get(i) + 1;}
 
-		for (size_t i = 0 ; i < SGRID_CACHE ; i++)
-		{cache[i] = -1;}
+		g_sm_shift.setDimensions(sz_i);
+	}
+
+	/*! \brief initialize
+	 *
+	 *
+	 */
+	void init()
+	{
+		findNN = false;
+		keep_order = SGRID_ORDER_NONE;
+		n_ordered = 1;
+		compact_min = FLUSH_REMOVE;
+		compact_frac = SGRID_COMPACT_FRACTION;
+
+		chunk_cache.clear();
 
 		// fill pos_g
 
@@ -647,40 +1156,26 @@ class sgrid_cpu
 	 */
 	inline void find_active_chunk(const grid_key_dx<dim> & kh,size_t & active_cnk,bool & exist) const
 	{
-		long int lin_id = g_sm_shift.LinId(kh);
-
-		size_t id = 0;
-		for (size_t k = 0 ; k < SGRID_CACHE; k++)
-		{id += (cache[k] == lin_id)?k+1:0;}
-
-		if (id == 0)
-		{
-			// we do not have it in cache we check if we have it in the map
+		find_active_chunk(kh,active_cnk,exist,chunk_cache);
+	}
 
-			auto fnd = map.find(lin_id);
-			if (fnd == map.end())
-			{
-				exist = false;
-				active_cnk = 0;
-				return;
-			}
-			else
-			{active_cnk = fnd->second;}
+	/*! \brief Given a key return the chunk than contain that key, in case that chunk does not exist return the key of the
+	 *         background chunk
+	 *
+	 * \param v1 point to search
+	 * \param return active_chunk
+	 * \param return index inside the chunk
+	 * \param cc chunk cache to use
+	 *
+	 */
+	inline void find_active_chunk(const grid_key_dx<dim> & kh,size_t & active_cnk,bool & exist, sgrid_chunk_cache<SGRID_CACHE> & cc) const
+	{
+		long int lin_id = g_sm_shift.LinId(kh);
 
-			// Add on cache the chunk
-			cache[cache_pnt] = lin_id;
-			cached_id[cache_pnt] = active_cnk;
-			cache_pnt++;
-			cache_pnt = (cache_pnt >= SGRID_CACHE)?0:cache_pnt;
-		}
-		else
-		{
-			active_cnk = cached_id[id-1];
-			cache_pnt = id;
-			cache_pnt = (cache_pnt == SGRID_CACHE)?0:cache_pnt;
-		}
+		exist = cc.find(lin_id,map,active_cnk);
 
-		exist = true;
+		if (exist == false)
+		{active_cnk = 0;}
 	}
 
 	/*! Given a key v1 in coordinates it calculate the chunk position and the  position in the chunk
@@ -691,6 +1186,19 @@ class sgrid_cpu
 	 *
 	 */
 	inline void pre_get(const grid_key_dx<dim> & v1, size_t & active_cnk, size_t & sub_id, bool & exist) const
+	{
+		pre_get(v1,active_cnk,sub_id,exist,chunk_cache);
+	}
+
+	/*! Given a key v1 in coordinates it calculate the chunk position and the  position in the chunk
+	 *
+	 * \param v1 coordinates
+	 * \param chunk position
+	 * \param sub_id element id
+	 * \param cc chunk cache to use
+	 *
+	 */
+	inline void pre_get(const grid_key_dx<dim> & v1, size_t & active_cnk, size_t & sub_id, bool & exist, sgrid_chunk_cache<SGRID_CACHE> & cc) const
 	{
 		grid_key_dx<dim> kh = v1;
 		grid_key_dx<dim> kl;
@@ -698,11 +1206,95 @@ class sgrid_cpu
 		// shift the key
 		key_shift<dim,chunking>::shift(kh,kl);
 
-		find_active_chunk(kh,active_cnk,exist);
+		find_active_chunk(kh,active_cnk,exist,cc);
 
 		sub_id = sublin<dim,typename chunking::shift_c>::lin(kl);
 	}
 
+	/*! \brief Grid of the chunks that intersect the box [start,stop]
+	 *
+	 * \param start start point of the box
+	 * \param stop stop point of the box
+	 * \param g_c grid of the chunks
+	 * \param c_start position of the first chunk (in chunks)
+	 *
+	 */
+	void chunks_in_box(const grid_key_dx<dim> & start, const grid_key_dx<dim> & stop, grid_sm<dim,void> & g_c, grid_key_dx<dim> & c_start) const
+	{
+		grid_key_dx<dim> c_stop = stop;
+		grid_key_dx<dim> kl;
+
+		for (size_t i = 0 ; i < dim ; i++)
+		{c_start.set_d(i,start.get(i));}
+
+		// shift the keys
+		key_shift<dim,chunking>::shift(c_start,kl);
+		key_shift<dim,chunking>::shift(c_stop,kl);
+
+		size_t n_c[dim];
+
+		for (size_t i = 0 ; i < dim ; i++)
+		{n_c[i] = c_stop.get(i) - c_start.get(i) + 1;}
+
+		g_c.setDimensions(n_c);
+	}
+
+	/*! \brief Call func on every row (in x) of the chunk at position c_pos inside the box [start,stop]
+	 *
+	 * func is called with the element in the chunk of the first point of the row, the first point of the row
+	 * and the number of points in the row
+	 *
+	 * \param c_pos position of the chunk
+	 * \param start start point of the box
+	 * \param stop stop point of the box
+	 * \param func function to call
+	 *
+	 */
+	template<typename lambda_f>
+	inline void chunk_rows(const grid_key_dx<dim> & c_pos, const grid_key_dx<dim> & start, const grid_key_dx<dim> & stop, lambda_f func) const
+	{
+		long int lo[dim];
+		long int hi[dim];
+
+		for (size_t i = 0 ; i < dim ; i++)
+		{
+			lo[i] = std::max(start.get(i) - c_pos.get(i),(long int)0);
+			hi[i] = std::min(stop.get(i) - c_pos.get(i),(long int)sz_cnk[i] - 1);
+
+			if (lo[i] > hi[i])	{return;}
+		}
+
+		grid_key_dx<dim> lk;
+
+		for (size_t i = 0 ; i < dim ; i++)
+		{lk.set_d(i,lo[i]);}
+
+		while (true)
+		{
+			int sub0 = 0;
+			int stride = 1;
+
+			for (size_t i = 0 ; i < dim ; i++)
+			{
+				sub0 += lk.get(i)*stride;
+				stride *= sz_cnk[i];
+			}
+
+			func(sub0,c_pos + lk,hi[0] - lo[0] + 1);
+
+			size_t d = 1;
+			for ( ; d < dim ; d++)
+			{
+				if (lk.get(d) < hi[d])
+				{lk.set_d(d,lk.get(d)+1);break;}
+
+				lk.set_d(d,lo[d]);
+			}
+
+			if (d >= dim)	{break;}
+		}
+	}
+
 	/*! \brief Before insert data you have to do this
 	 *
 	 * \param v1 grid key where you want to insert data
@@ -723,11 +1315,7 @@ class sgrid_cpu
 
 		long int lin_id = g_sm_shift.LinId(kh);
 
-		size_t id = 0;
-		for (size_t k = 0 ; k < SGRID_CACHE; k++)
-		{id += (cache[k] == lin_id)?k+1:0;}
-
-		if (id == 0)
+		if (chunk_cache.get(lin_id,active_cnk) == false)
 		{
 			// we do not have it in cache we check if we have it in the map
 
@@ -736,22 +1324,7 @@ class sgrid_cpu
 			{
 				// we do not have it in the map create a chunk
 
-				map[lin_id] = chunks.size();
-				chunks.add();
-				header_inf.add();
-				header_inf.last().pos = kh;
-				header_inf.last().nele = 0;
-				header_mask.add();
-
-				// set the mask to null
-				auto & h = header_mask.last().mask;
-
-				for (size_t i = 0 ; i < chunking::size::value ; i++)
-				{h[i] = 0;}
-
-				key_shift<dim,chunking>::cpos(header_inf.last().pos);
-
-				active_cnk = chunks.size() - 1;
+				active_cnk = add_chunk(lin_id,kh);
 			}
 			else
 			{
@@ -761,16 +1334,7 @@ class sgrid_cpu
 			}
 
 			// Add on cache the chunk
-			cache[cache_pnt] = lin_id;
-			cached_id[cache_pnt] = active_cnk;
-			cache_pnt++;
-			cache_pnt = (cache_pnt >= SGRID_CACHE)?0:cache_pnt;
-		}
-		else
-		{
-			active_cnk = cached_id[id-1];
-			cache_pnt = id;
-			cache_pnt = (cache_pnt == SGRID_CACHE)?0:cache_pnt;
+			chunk_cache.add(lin_id,active_cnk);
 		}
 
 		sub_id = sublin<dim,typename chunking::shift_c>::lin(kl);
@@ -831,8 +1395,11 @@ public:
 	//! The object type the grid is storing
 	typedef T value_type;
 
+	//! header of the chunk mask
+	typedef typename sgrid_mheader<chunking>::type header_mask_type;
+
 	//! sub-grid iterator type
-	typedef grid_key_sparse_dx_iterator_sub<dim, chunking::size::value> sub_grid_iterator_type;
+	typedef grid_key_sparse_dx_iterator_sub<dim,chunking::size::value,header_mask_type> sub_grid_iterator_type;
 
 	//! Background type
 	typedef aggregate_bfv<chunk_def> background_type;
@@ -848,7 +1415,6 @@ public:
 	 *
 	 */
 	inline sgrid_cpu()
-	:cache_pnt(0)
 	{
 		init();
 	}
@@ -879,7 +1445,7 @@ public:
 	 *
 	 */
 	sgrid_cpu(const size_t (& sz)[dim])
-	:cache_pnt(0),g_sm(sz)
+	:g_sm(sz)
 	{
 		// calculate the chunks grid
 
@@ -1023,12 +1589,28 @@ public:
 	 */
 	template <unsigned int p>
 	inline auto get(const grid_key_dx<dim> & v1) const -> decltype(get_selector< typename boost::mpl::at<typename T::type,boost::mpl::int_<p>>::type >::template get_const<p>(chunks,0,0))
+	{
+		return get<p>(v1,chunk_cache);
+	}
+
+	/*! \brief Get the reference of the selected element using an external chunk cache
+	 *
+	 * Different threads can read the sparse grid concurrently if each one use its own cache (see accessor())
+	 *
+	 * \param v1 grid_key that identify the element in the grid
+	 * \param cc chunk cache
+	 *
+	 * \return the reference of the element
+	 *
+	 */
+	template <unsigned int p>
+	inline auto get(const grid_key_dx<dim> & v1, sgrid_chunk_cache<SGRID_CACHE> & cc) const -> decltype(get_selector< typename boost::mpl::at<typename T::type,boost::mpl::int_<p>>::type >::template get_const<p>(chunks,0,0))
 	{
 		bool exist;
 		size_t active_cnk;
 		size_t sub_id;
 
-		pre_get(v1,active_cnk,sub_id,exist);
+		pre_get(v1,active_cnk,sub_id,exist,cc);
 
 		if (exist == false)
 		{return get_selector< typename boost::mpl::at<typename T::type,boost::mpl::int_<p>>::type >::template get_const<p>(chunks,0,sub_id);}
@@ -1087,12 +1669,25 @@ public:
 	 *
 	 */
 	inline bool existPoint(const grid_key_dx<dim> & v1) const
+	{
+		return existPoint(v1,chunk_cache);
+	}
+
+	/*! \brief Check if the point exist using an external chunk cache
+	 *
+	 * \param v1 grid_key that identify the element in the grid
+	 * \param cc chunk cache
+	 *
+	 * \return the true if the point exist
+	 *
+	 */
+	inline bool existPoint(const grid_key_dx<dim> & v1, sgrid_chunk_cache<SGRID_CACHE> & cc) const
 	{
 		bool exist;
 		size_t active_cnk;
 		size_t sub_id;
 
-		pre_get(v1,active_cnk,sub_id,exist);
+		pre_get(v1,active_cnk,sub_id,exist,cc);
 
 		if (exist == false)
 		{return false;}
@@ -1106,6 +1701,30 @@ public:
 		return true;
 	}
 
+	/*! \brief Return an object to read the sparse grid with its own chunk cache
+	 *
+	 * The const get() use a cache shared by all the callers, so it cannot be called concurrently.
+	 * Every thread must create its own accessor to read concurrently
+	 *
+	 * \code{.cpp}
+	 * #pragma omp parallel
+	 * {
+	 *   auto acc = grid.accessor();
+	 *
+	 *   #pragma omp for
+	 *   for (size_t i = 0 ; i < keys.size() ; i++)
+	 *   {sum += acc.template get<0>(keys[i]);}
+	 * }
+	 * \endcode
+	 *
+	 * \return the accessor
+	 *
+	 */
+	sgrid_cpu_accessor<sgrid_cpu<dim,T,S,grid_lin,layout,layout_base,chunking>> accessor() const
+	{
+		return sgrid_cpu_accessor<sgrid_cpu<dim,T,S,grid_lin,layout,layout_base,chunking>>(*this);
+	}
+
 	/*! \brief Get the reference of the selected element
 	 *
 	 * \param v1 grid_key that identify the element in the grid
@@ -1148,10 +1767,10 @@ public:
 	 * \return return the domain iterator
 	 *
 	 */
-	grid_key_sparse_dx_iterator<dim,chunking::size::value>
+	grid_key_sparse_dx_iterator<dim,chunking::size::value,header_mask_type>
 	getIterator(size_t opt = 0) const
 	{
-		return grid_key_sparse_dx_iterator<dim,chunking::size::value>(&header_mask,&header_inf,&pos_chunk);
+		return grid_key_sparse_dx_iterator<dim,chunking::size::value,header_mask_type>(&header_mask,&header_inf,&pos_chunk);
 	}
 
 	/*! \brief Return an iterator over a sub-grid
@@ -1159,10 +1778,10 @@ public:
 	 * \return return an iterator over a sub-grid
 	 *
 	 */
-	grid_key_sparse_dx_iterator_sub<dim,chunking::size::value>
+	grid_key_sparse_dx_iterator_sub<dim,chunking::size::value,header_mask_type>
 	getIterator(const grid_key_dx<dim> & start, const grid_key_dx<dim> & stop, size_t opt = 0) const
 	{
-		return grid_key_sparse_dx_iterator_sub<dim,chunking::size::value>(header_mask,header_inf,pos_chunk,start,stop,sz_cnk);
+		return grid_key_sparse_dx_iterator_sub<dim,chunking::size::value,header_mask_type>(header_mask,header_inf,pos_chunk,start,stop,sz_cnk);
 	}
 
 	/*! \brief Return an iterator over a sub-grid
@@ -1181,6 +1800,83 @@ public:
 		return grid_key_sparse_dx_iterator_block_sub<dim,stencil_size,self,chunking>(*this,start,stop);
 	}
 
+	/*! \brief Call func on every block of a sub-grid, the blocks are distributed across threads
+	 *
+	 * Every thread work on its own copy of the block iterator, func(it) is called with the iterator
+	 * positioned on a block. func must write only in the chunk it.getChunkId()
+	 *
+	 * \tparam stencil size
+	 * \param start point
+	 * \param stop point
+	 * \param func function to call on every block
+	 *
+	 */
+	template<unsigned int stencil_size = 0, typename lambda_f>
+	void forEachBlock(const grid_key_dx<dim> & start, const grid_key_dx<dim> & stop, lambda_f func)
+	{
+		auto it_g = getBlockIterator<stencil_size>(start,stop);
+		long int n_cnk = header_inf.size();
+
+		#pragma omp parallel if (n_cnk >= SGRID_OMP_MIN_CHUNKS)
+		{
+			auto it = it_g;
+
+			#pragma omp for schedule(dynamic)
+			for (long int b = 1 ; b < n_cnk ; b += SGRID_OMP_CHUNK_BATCH)
+			{
+				it.setChunkRange(b,std::min(b + (long int)SGRID_OMP_CHUNK_BATCH,n_cnk));
+
+				while (it.isNext())
+				{
+					func(it);
+
+					++it;
+				}
+			}
+		}
+	}
+
+	/*! \brief Construct the list of the neighborhood chunks of every chunk
+	 *
+	 * For every chunk and every neighborhood chunk of NNType the list contain the id of the
+	 * neighborhood chunk or -1 if it does not exist. The chunks are processed in parallel
+	 *
+	 * \tparam NNType neighborhood
+	 *
+	 */
+	template<typename NNType = NNStar_c<dim>>
+	void construct_NNlist()
+	{
+		NNlist.resize(NNType::nNN * chunks.size());
+		long int n_cnk = header_inf.size();
+
+		#pragma omp parallel if (n_cnk >= SGRID_OMP_MIN_CHUNKS)
+		{
+			// every thread use its own cache
+			sgrid_chunk_cache<SGRID_CACHE> cc;
+
+			#pragma omp for schedule(static)
+			for (long int i = 0 ; i < n_cnk ; i++)
+			{
+				grid_key_dx<dim> pos = getChunkPos(i);
+
+				for (int k = 0 ; k < NNType::nNN ; k++)
+				{
+					grid_key_dx<dim> p = pos;
+					p.set_d(NNType::dir(k),p.get(NNType::dir(k)) + NNType::sign(k));
+
+					bool exist;
+					size_t r;
+					find_active_chunk(p,r,exist,cc);
+
+					NNlist.get(i*NNType::nNN + k) = (exist)?r:-1;
+				}
+			}
+		}
+
+		findNN = true;
+	}
+
 	/*! \brief Return the internal grid information
 	 *
 	 * Return the internal grid information
@@ -1235,14 +1931,70 @@ public:
 	void flush_remove()
 	{
 		remove_empty();
+
+		check_order();
 	}
 
-	/*! \brief Resize the grid
+	/*! \brief Eliminate the dead chunks from the chunk vector
 	 *
-	 * The old information is retained on the new grid if the new grid is bigger.
-	 * When smaller the data are cropped
+	 * The chunks are copied in parallel and the map is reconstructed. The chunk ids change, so iterators
+	 * and the list of the neighborhood chunks are invalidated
 	 *
-	 * \param sz reference to an array of dimension dim
+	 */
+	void compact()
+	{
+		if (free_v.size() == 0)
+		{return;}
+
+		openfpm::vector<size_t> prm;
+		size_t n_dead_ord = 0;
+
+		for (size_t i = 0 ; i < header_inf.size() ; i++)
+		{
+			if (is_dead(i) == false)
+			{prm.add(i);}
+			else if (i < n_ordered)
+			{n_dead_ord++;}
+		}
+
+		free_v.clear();
+		n_ordered -= n_dead_ord;
+
+		apply_chunk_permutation(prm);
+	}
+
+	/*! \brief Set when the chunks are compacted
+	 *
+	 * The removed chunks become dead and their slots are recycled by the next chunks created. The chunks
+	 * are compacted when the dead chunks are at least n_min and at least a fraction of all the chunks.
+	 * With n_min = std::numeric_limits<size_t>::max() the chunks are compacted only by compact()
+	 *
+	 * \param n_min minimum number of dead chunks (default FLUSH_REMOVE)
+	 * \param fraction minimum fraction of dead chunks (default SGRID_COMPACT_FRACTION)
+	 *
+	 */
+	void setCompactionThresholds(size_t n_min, double fraction)
+	{
+		compact_min = n_min;
+		compact_frac = fraction;
+	}
+
+	/*! \brief Return the number of dead chunks waiting to be recycled or compacted
+	 *
+	 * \return the number of dead chunks
+	 *
+	 */
+	size_t getDeadChunks() const
+	{
+		return free_v.size();
+	}
+
+	/*! \brief Resize the grid
+	 *
+	 * The old information is retained on the new grid if the new grid is bigger.
+	 * When smaller the data are cropped
+	 *
+	 * \param sz reference to an array of dimension dim
 	 *
 	 */
 	void resize(const size_t (& sz)[dim])
@@ -1450,7 +2202,7 @@ public:
 			}
 
 			// There are point to send. So we have to save the mask chunk
-			req += sizeof(header_mask.get(i).mask);
+			req += sizeof(mheader<chunking::size::value>);
 			// the chunk position
 			req += sizeof(header_inf.get(i).pos);
 			// and the number of element
@@ -1477,7 +2229,7 @@ public:
 	 *
 	 */
 	template<int ... prp> inline
-	void packRequest(grid_key_sparse_dx_iterator_sub<dim,chunking::size::value> & sub_it,
+	void packRequest(grid_key_sparse_dx_iterator_sub<dim,chunking::size::value,header_mask_type> & sub_it,
 					 size_t & req) const
 	{
 		grid_sm<dim,void> gs_cnk(sz_cnk);
@@ -1558,7 +2310,7 @@ public:
 				if (old_req != req)
 				{
 					// There are point to send. So we have to save the mask chunk
-					req += sizeof(header_mask.get(i));
+					req += sizeof(mheader<chunking::size::value>);
 					// the chunk position
 					req += sizeof(header_inf.get(i).pos);
 					// and the number of element
@@ -1578,7 +2330,7 @@ public:
 	 *
 	 */
 	template<int ... prp> void pack(ExtPreAlloc<S> & mem,
-									grid_key_sparse_dx_iterator_sub<dims,chunking::size::value> & sub_it,
+									grid_key_sparse_dx_iterator_sub<dims,chunking::size::value,header_mask_type> & sub_it,
 									Pack_stat & sts)
 	{
 		grid_sm<dim,void> gs_cnk(sz_cnk);
@@ -1631,7 +2383,7 @@ public:
 
 				unsigned char mask_to_pack[chunking::size::value];
 				memset(mask_to_pack,0,sizeof(mask_to_pack));
-				mem.allocate_nocheck(sizeof(header_mask.get(i)) + sizeof(header_inf.get(i).pos) + sizeof(header_inf.get(i).nele));
+				mem.allocate_nocheck(sizeof(mask_to_pack) + sizeof(header_inf.get(i).pos) + sizeof(header_inf.get(i).nele));
 
 				// here we get the pointer of the memory in case we have to pack the header
 				// and we also shift the memory pointer by an offset equal to the header
@@ -1681,7 +2433,7 @@ public:
 
 					 grid_key_dx<dim> pos = header_inf.get(i).pos - sub_it.getStart();
 
-					 Packer<decltype(header_mask.get(i).mask),S>::pack(mem,mask_to_pack,sts);
+					 Packer<decltype(mask_to_pack),S>::pack(mem,mask_to_pack,sts);
 					 Packer<decltype(header_inf.get(i).pos),S>::pack(mem,pos,sts);
 					 Packer<decltype(header_inf.get(i).nele),S>::pack(mem,header_inf.get(i).nele,sts);
 
@@ -1790,9 +2542,12 @@ public:
 
 		for (size_t i = 1 ; i < header_inf.size() ; i++)
 		{
-			auto & hm = header_mask.get(i);
 			auto & hc = header_inf.get(i);
 
+			// the mask is always packed with one byte for each element
+			mheader<chunking::size::value> mask_exp;
+			auto & hm = byte_mask(header_mask.get(i),mask_exp);
+
 			Packer<decltype(hm.mask),S>::pack(mem,hm.mask,sts);
 			Packer<decltype(hc.pos),S>::pack(mem,hc.pos,sts);
 			Packer<decltype(hc.nele),S>::pack(mem,hc.nele,sts);
@@ -1836,153 +2591,740 @@ public:
 			tot += header_inf.get(i).nele;
 		}
 
-		return tot;
+		return tot;
+	}
+
+	/*! \number of element inserted
+	 *
+	 * \warning this function is not as fast as the size in other structures
+	 *
+	 * \return the total number of elements inserted
+	 *
+	 */
+	size_t size_all() const
+	{
+		return header_inf.size() * vmpl_reduce_prod<typename chunking::type>::type::value;
+	}
+
+	/*! \brief Remove all the points in this region
+	 *
+	 * \param box_src box to kill the points
+	 *
+	 */
+	void remove(Box<dim,long int> & section_to_delete)
+	{
+		grid_sm<dim,void> gs_cnk(sz_cnk);
+
+		for (size_t i = 0 ; i < header_inf.size() ; i++)
+		{
+			auto & hm = header_mask.get(i);
+			auto & hc = header_inf.get(i);
+
+			Box<dim,size_t> bc;
+
+			for (size_t j = 0 ; j < dim ; j++)
+			{
+				bc.setLow(j,hc.pos.get(j));
+				bc.setHigh(j,hc.pos.get(j) + sz_cnk[j] - 1);
+			}
+
+			// now we intersect the chunk box with the box
+
+			Box<dim,size_t> inte;
+			bool stp = bc.Intersect(section_to_delete,inte);
+
+			if (stp == true)
+			{
+				// If it is intersect ok we have to check if there are points to pack
+				// we shift inte intp the chunk origin
+
+				inte -= header_inf.get(i).pos.toPoint();
+
+				// we iterate all the points
+
+				grid_key_dx_iterator_sub<dim,no_stencil,grid_sm<dim,void>> sit(gs_cnk,inte.getKP1(),inte.getKP2());
+
+				while (sit.isNext())
+				{
+					auto key = sit.get();
+
+					size_t sub_id = gs_cnk.LinId(key);
+
+					unsigned char swt = header_mask.get(i).mask[sub_id];
+
+					hc.nele = (swt)?hc.nele-1:hc.nele;
+					hm.mask[sub_id] = 0;
+
+					if (hc.nele == 0 && swt != 0)
+					{
+						// Add the chunks in the empty list
+						empty_v.add(i);
+					}
+
+					++sit;
+				}
+			}
+		}
+
+		remove_empty();
+	}
+
+	void copy_to(const self & grid_src,
+		         const Box<dim,size_t> & box_src,
+			     const Box<dim,size_t> & box_dst)
+	{
+/*		auto it = grid_src.getIterator(box_src.getKP1(),box_src.getKP2());
+
+		while (it.isNext())
+		{
+			auto key_src = it.get();
+			grid_key_dx<dim> key_dst = key_src + box_dst.getKP1();
+			key_dst -= box_src.getKP1();
+
+			typedef typename std::remove_const<typename std::remove_reference<decltype(grid_src)>::type>::type gcopy;
+
+			copy_sparse_to_sparse<dim,gcopy,gcopy> caps(grid_src,*this,key_src,key_dst);
+			boost::mpl::for_each_ref< boost::mpl::range_c<int,0,T::max_prop> >(caps);
+
+			++it;
+		}*/
+
+		auto it = grid_src.getIterator(box_src.getKP1(),box_src.getKP2());
+
+		while (it.isNext())
+		{
+			auto key_src = it.get();
+			grid_key_dx<dim> key_dst = key_src + box_dst.getKP1();
+			key_dst -= box_src.getKP1();
+			auto key_src_s = it.getKeyF();
+
+			typedef typename std::remove_const<typename std::remove_reference<decltype(grid_src)>::type>::type gcopy;
+
+			size_t pos_src_id = key_src_s.getPos();
+			size_t pos_dst_id;
+
+			///////// WARNING insert_o MUST be done before getBlock, otherwise if grid_src == *this, and insert_o produce a reallocation 
+			///////// block_src will be invalidated  //////
+			auto block_dst = this->insert_o(key_dst,pos_dst_id);
+
+			auto block_src = grid_src.getBlock(key_src_s);
+
+			copy_sparse_to_sparse_bb<dim,decltype(block_src),decltype(block_dst),T> caps(block_src,block_dst,pos_src_id,pos_dst_id);
+			boost::mpl::for_each_ref< boost::mpl::range_c<int,0,T::max_prop> >(caps);
+
+			++it;
+		}
+
+//		copy_remove_to_impl(grid_src,*this,box_src,box_dst);
+	}
+
+	template<template <typename,typename> class op, unsigned int ... prp >
+	void copy_to_op(const self & grid_src,
+		         const Box<dim,size_t> & box_src,
+			     const Box<dim,size_t> & box_dst)
+	{
+		auto it = grid_src.getIterator(box_src.getKP1(),box_src.getKP2());
+
+		while (it.isNext())
+		{
+			auto key_src = it.get();
+			grid_key_dx<dim> key_dst = key_src + box_dst.getKP1();
+			key_dst -= box_src.getKP1();
+
+			typedef typename std::remove_const<typename std::remove_reference<decltype(grid_src)>::type>::type gcopy;
+
+			copy_sparse_to_sparse_op<op,dim,gcopy,gcopy,prp ...> caps(grid_src,*this,key_src,key_dst);
+			boost::mpl::for_each_ref< boost::mpl::range_c<int,0,sizeof...(prp)> >(caps);
+
+			++it;
+		}
+	}
+
+	/*! \brief Insert many points at once
+	 *
+	 * The keys are sorted by chunk with a radix sort, all the missing chunks are created at once and
+	 * the chunks are filled in parallel. When a point already exist (or a key is repeated) the value is
+	 * merged with the operation op (replace_, add_, ...), keys repeated are merged in the order they
+	 * appear in keys
+	 *
+	 * \tparam op operation to merge values on existing points
+	 * \tparam prp properties to copy
+	 *
+	 * \param keys points to insert
+	 * \param values values to insert (one element for each key)
+	 *
+	 */
+	template<template <typename,typename> class op, unsigned int ... prp, typename vector_keys, typename vector_values>
+	void insert_bulk(const vector_keys & keys, const vector_values & values)
+	{
+		if (keys.size() != values.size())
+		{
+			std::cerr << "Error " << __FILE__ << ":" << __LINE__ << " the number of keys " << keys.size() << " does not match the number of values " << values.size() << std::endl;
+			return;
+		}
+
+		long int n = keys.size();
+
+		openfpm::vector<size_t> lin_id;
+		openfpm::vector<size_t> ids;
+		openfpm::vector<size_t> sub_ids;
+
+		lin_id.resize(n);
+		ids.resize(n);
+		sub_ids.resize(n);
+
+		#pragma omp parallel for schedule(static) if (n >= OPENFPM_OMP_MIN_ELEMENTS)
+		for (long int i = 0 ; i < n ; i++)
+		{
+			grid_key_dx<dim> kh = keys.get(i);
+			grid_key_dx<dim> kl;
+
+			// shift the key
+			key_shift<dim,chunking>::shift(kh,kl);
+
+			lin_id.get(i) = g_sm_shift.LinId(kh);
+			sub_ids.get(i) = sublin<dim,typename chunking::shift_c>::lin(kl);
+			ids.get(i) = i;
+		}
+
+		sgrid_radix_sort(lin_id,ids,g_sm_shift.size());
+
+		// segments of keys that fall in the same chunk
+
+		openfpm::vector<size_t> seg_start;
+		openfpm::vector<size_t> seg_cnk;
+
+		for (long int i = 0 ; i < n ; i++)
+		{
+			if (i == 0 || lin_id.get(i) != lin_id.get(i-1))
+			{seg_start.add(i);}
+		}
+		seg_start.add(n);
+
+		size_t n_seg = seg_start.size() - 1;
+		seg_cnk.resize(n_seg);
+
+		// find the chunks and create the missing ones with a single reservation
+
+		size_t n_old = chunks.size();
+		size_t n_new = 0;
+
+		openfpm::vector<size_t> seg_new;
+
+		for (size_t s = 0 ; s < n_seg ; s++)
+		{
+			long int lin = lin_id.get(seg_start.get(s));
+
+			auto fnd = map.find(lin);
+			if (fnd == map.end())
+			{
+				size_t cnk;
+
+				if (pop_free_chunk(cnk) == false)
+				{
+					cnk = n_old + n_new;
+					n_new++;
+				}
+
+				seg_cnk.get(s) = cnk;
+				map[lin] = cnk;
+				seg_new.add(s);
+			}
+			else
+			{seg_cnk.get(s) = fnd->second;}
+		}
+
+		chunks.resize(n_old + n_new);
+		header_inf.resize(n_old + n_new);
+		header_mask.resize(n_old + n_new);
+
+		if (seg_new.size() != 0)	{findNN = false;}
+
+		#pragma omp parallel for schedule(static) if (seg_new.size() >= SGRID_OMP_MIN_CHUNKS)
+		for (long int sn = 0 ; sn < (long int)seg_new.size() ; sn++)
+		{
+			size_t s = seg_new.get(sn);
+			size_t cnk = seg_cnk.get(s);
+
+			auto & hc = header_inf.get(cnk);
+			const auto & kp = keys.get(ids.get(seg_start.get(s)));
+
+			for (size_t d = 0 ; d < dim ; d++)
+			{hc.pos.set_d(d,kp.get(d));}
+			hc.nele = 0;
+
+			grid_key_dx<dim> kl;
+			key_shift<dim,chunking>::shift(hc.pos,kl);
+			key_shift<dim,chunking>::cpos(hc.pos);
+
+			auto & h = header_mask.get(cnk).mask;
+
+			for (size_t i = 0 ; i < chunking::size::value ; i++)
+			{h[i] = 0;}
+		}
+
+		// fill the chunks, every chunk is owned by one thread
+
+		#pragma omp parallel for schedule(dynamic,SGRID_OMP_CHUNK_BATCH) if (n_seg >= SGRID_OMP_MIN_CHUNKS)
+		for (long int s = 0 ; s < (long int)n_seg ; s++)
+		{
+			size_t cnk = seg_cnk.get(s);
+
+			auto & hc = header_inf.get(cnk);
+			auto & hm = header_mask.get(cnk);
+
+			for (size_t j = seg_start.get(s) ; j < seg_start.get(s+1) ; j++)
+			{
+				size_t i = ids.get(j);
+				size_t sub_id = sub_ids.get(i);
+
+				bool exist = hm.mask[sub_id] & 1;
+				hc.nele = (exist)?hc.nele:hc.nele + 1;
+				hm.mask[sub_id] |= 1;
+
+				copy_bulk_to_sparse_op<op,T,vector_values,decltype(chunks),prp ...> cbs(values,chunks,i,cnk,sub_id,exist);
+				boost::mpl::for_each_ref< boost::mpl::range_c<int,0,sizeof...(prp)> >(cbs);
+			}
+		}
+	}
+
+	/*! \brief Update the narrow band around the seeds
+	 *
+	 * The chunks at distance less or equal than width from the chunks containing the seeds are activated,
+	 * the distance is the number of steps on the chunk adjacency NNType (the same used for the list of
+	 * neighborhood chunks). The chunks outside the band are retired together with their points. The
+	 * retired chunks are removed from the map with a single flush and their slots are recycled by the
+	 * activated chunks, that are created with a single reservation and without points
+	 *
+	 * \tparam NNType chunk adjacency
+	 *
+	 * \param seeds points around which the band is constructed
+	 * \param width width of the band (in chunks)
+	 *
+	 */
+	template<typename NNType = NNStar_c<dim>, typename vector_keys>
+	void updateNarrowBand(const vector_keys & seeds, size_t width)
+	{
+		long int n = seeds.size();
+
+		// linearized positions of the chunks in the band (sorted)
+
+		openfpm::vector<size_t> band;
+		band.resize(n);
+
+		#pragma omp parallel for schedule(static) if (n >= OPENFPM_OMP_MIN_ELEMENTS)
+		for (long int i = 0 ; i < n ; i++)
+		{
+			grid_key_dx<dim> kh = seeds.get(i);
+			grid_key_dx<dim> kl;
+
+			// shift the key
+			key_shift<dim,chunking>::shift(kh,kl);
+
+			band.get(i) = g_sm_shift.LinId(kh);
+		}
+
+		band.sort();
+		band.unique();
+
+		// grow the band one layer of chunks at time
+
+		openfpm::vector<size_t> front = band;
+		openfpm::vector<size_t> nn;
+		openfpm::vector<size_t> merged;
+
+		for (size_t w = 0 ; w < width && front.size() != 0 ; w++)
+		{
+			long int n_f = front.size();
+			nn.resize(n_f*NNType::nNN);
+
+			#pragma omp parallel for schedule(static) if (n_f >= SGRID_OMP_MIN_CHUNKS)
+			for (long int i = 0 ; i < n_f ; i++)
+			{
+				grid_key_dx<dim> pos = g_sm_shift.InvLinId(front.get(i));
+
+				for (int k = 0 ; k < NNType::nNN ; k++)
+				{
+					size_t & r = nn.get(i*NNType::nNN + k);
+					long int c = pos.get(NNType::dir(k)) + NNType::sign(k);
+
+					if (c < 0 || c >= (long int)g_sm_shift.size(NNType::dir(k)))
+					{r = (size_t)-1;continue;}
+
+					grid_key_dx<dim> p = pos;
+					p.set_d(NNType::dir(k),c);
+
+					r = g_sm_shift.LinId(p);
+
+					// chunks already in the band are not part of the new layer
+					if (std::binary_search(band.begin(),band.end(),r) == true)
+					{r = (size_t)-1;}
+				}
+			}
+
+			nn.sort();
+			nn.unique();
+
+			if (nn.size() != 0 && nn.last() == (size_t)-1)
+			{nn.remove(nn.size() - 1);}
+
+			front.swap(nn);
+
+			merged.resize(band.size() + front.size());
+			std::merge(band.begin(),band.end(),front.begin(),front.end(),merged.begin());
+			band.swap(merged);
+		}
+
+		// retire the chunks outside the band
+
+		long int n_cnk = header_inf.size();
+		openfpm::vector<unsigned char> out;
+		out.resize(n_cnk);
+
+		#pragma omp parallel for schedule(static) if (n_cnk >= SGRID_OMP_MIN_CHUNKS)
+		for (long int i = 1 ; i < n_cnk ; i++)
+		{
+			out.get(i) = 0;
+
+			if (is_dead(i) == true)	{continue;}
+
+			grid_key_dx<dim> kh = header_inf.get(i).pos;
+			grid_key_dx<dim> kl;
+
+			// shift the key
+			key_shift<dim,chunking>::shift(kh,kl);
+
+			if (std::binary_search(band.begin(),band.end(),(size_t)g_sm_shift.LinId(kh)) == true)
+			{continue;}
+
+			header_inf.get(i).nele = 0;
+
+			auto & h = header_mask.get(i).mask;
+
+			for (size_t j = 0 ; j < chunking::size::value ; j++)
+			{h[j] = 0;}
+
+			out.get(i) = 1;
+		}
+
+		for (long int i = 1 ; i < n_cnk ; i++)
+		{
+			if (out.get(i) == 1)
+			{empty_v.add(i);}
+		}
+
+		remove_empty();
+
+		// activate the missing chunks
+
+		size_t n_old = chunks.size();
+		size_t n_new = 0;
+
+		openfpm::vector<size_t> act_lin;
+		openfpm::vector<size_t> act_cnk;
+
+		for (size_t i = 0 ; i < band.size() ; i++)
+		{
+			long int lin = band.get(i);
+
+			if (map.find(lin) != map.end())
+			{continue;}
+
+			size_t cnk;
+
+			if (pop_free_chunk(cnk) == false)
+			{
+				cnk = n_old + n_new;
+				n_new++;
+			}
+
+			map[lin] = cnk;
+			act_lin.add(lin);
+			act_cnk.add(cnk);
+		}
+
+		chunks.resize(n_old + n_new);
+		header_inf.resize(n_old + n_new);
+		header_mask.resize(n_old + n_new);
+
+		if (act_cnk.size() != 0)	{findNN = false;}
+
+		#pragma omp parallel for schedule(static) if (act_cnk.size() >= SGRID_OMP_MIN_CHUNKS)
+		for (long int i = 0 ; i < (long int)act_cnk.size() ; i++)
+		{
+			size_t cnk = act_cnk.get(i);
+
+			auto & hc = header_inf.get(cnk);
+			grid_key_dx<dim> kp = g_sm_shift.InvLinId(act_lin.get(i));
+
+			for (size_t d = 0 ; d < dim ; d++)
+			{hc.pos.set_d(d,kp.get(d));}
+			hc.nele = 0;
+
+			key_shift<dim,chunking>::cpos(hc.pos);
+
+			auto & h = header_mask.get(cnk).mask;
+
+			for (size_t j = 0 ; j < chunking::size::value ; j++)
+			{h[j] = 0;}
+		}
+
+		check_order();
+	}
+
+	/*! \brief Copy the points of the box into a dense grid
+	 *
+	 * The dense grid must have the size of the box, the point p of the sparse grid go in p - box.getKP1() of the
+	 * dense grid. The non existing points get the background value. The chunks that intersect the box are
+	 * processed in parallel, the full chunks and the non existing chunks are copied row by row as contiguous
+	 * blocks, only the rows of the partially filled chunks need the expansion of the mask
+	 *
+	 * \tparam prp properties to copy
+	 *
+	 * \param box box to copy
+	 * \param dense dense grid
+	 *
+	 */
+	template<unsigned int ... prp, typename dense_type>
+	void to_dense(const Box<dim,long int> & box, dense_type & dense) const
+	{
+		grid_key_dx<dim> start;
+		grid_key_dx<dim> stop;
+
+		for (size_t i = 0 ; i < dim ; i++)
+		{
+			if ((long int)dense.getGrid().size(i) != box.getHigh(i) - box.getLow(i) + 1 || box.getLow(i) < 0 || box.getHigh(i) >= (long int)g_sm.size(i))
+			{
+				std::cerr << "Error " << __FILE__ << ":" << __LINE__ << " the box must be inside the sparse grid and have the size of the dense grid" << std::endl;
+				return;
+			}
+
+			start.set_d(i,box.getLow(i));
+			stop.set_d(i,box.getHigh(i));
+		}
+
+		grid_sm<dim,void> g_c;
+		grid_key_dx<dim> c_start;
+		chunks_in_box(start,stop,g_c,c_start);
+
+		long int n_c = g_c.size();
+
+		#pragma omp parallel if (n_c >= SGRID_OMP_MIN_CHUNKS)
+		{
+			sgrid_chunk_cache<SGRID_CACHE> cc;
+			unsigned char mask[chunking::size::value];
+
+			#pragma omp for schedule(dynamic,SGRID_OMP_CHUNK_BATCH)
+			for (long int c = 0 ; c < n_c ; c++)
+			{
+				grid_key_dx<dim> kh = g_c.InvLinId(c) + c_start;
+
+				bool exist;
+				size_t cnk = getChunk(kh,exist,cc);
+
+				// the background chunk contain only background values
+				bool full = (exist == false) || header_inf.get(cnk).nele == chunking::size::value;
+
+				key_shift<dim,chunking>::cpos(kh);
+
+				chunk_rows(kh,start,stop,[&](int sub0, const grid_key_dx<dim> & p, int n)
+				{
+					grid_key_dx<dim> kd = p - start;
+
+					if (full == false)
+					{exist_sub_row(header_mask.get(cnk),sub0,n,mask);}
+
+					copy_chunk_row_to_dense<T,decltype(chunks),dense_type,prp...> cr(chunks,dense,cnk,sub0,(full)?NULL:mask,dense.getGrid().LinId(kd),n);
+					boost::mpl::for_each_ref< boost::mpl::range_c<int,0,sizeof...(prp)> >(cr);
+				});
+			}
+		}
 	}
 
-	/*! \number of element inserted
-	 *
-	 * \warning this function is not as fast as the size in other structures
+	/*! \brief Insert the points of a dense grid for which the predicate is true
 	 *
-	 * \return the total number of elements inserted
+	 * The point k of the dense grid go in origin + k of the sparse grid. The predicate is called as
+	 * pred(dense,lin) where lin is the linearized id of the point in the dense grid (see dense_threshold).
+	 * Existing points for which the predicate is false are not touched. The predicate is evaluated chunk by
+	 * chunk in parallel, the missing chunks are created with a single reservation and filled in parallel,
+	 * the rows of the chunks that become full are copied as contiguous blocks
 	 *
-	 */
-	size_t size_all() const
-	{
-		return header_inf.size() * vmpl_reduce_prod<typename chunking::type>::type::value;
-	}
-
-	/*! \brief Remove all the points in this region
+	 * \tparam prp properties to copy
 	 *
-	 * \param box_src box to kill the points
+	 * \param dense dense grid
+	 * \param pred predicate that select the points to insert
+	 * \param origin position of the dense grid in the sparse grid
 	 *
 	 */
-	void remove(Box<dim,long int> & section_to_delete)
+	template<unsigned int ... prp, typename dense_type, typename pred_type>
+	void from_dense(const dense_type & dense, pred_type pred, const grid_key_dx<dim> & origin)
 	{
-		grid_sm<dim,void> gs_cnk(sz_cnk);
+		grid_key_dx<dim> start = origin;
+		grid_key_dx<dim> stop;
 
-		for (size_t i = 0 ; i < header_inf.size() ; i++)
+		for (size_t i = 0 ; i < dim ; i++)
 		{
-			auto & hm = header_mask.get(i);
-			auto & hc = header_inf.get(i);
-
-			Box<dim,size_t> bc;
+			stop.set_d(i,origin.get(i) + dense.getGrid().size(i) - 1);
 
-			for (size_t j = 0 ; j < dim ; j++)
+			if (origin.get(i) < 0 || stop.get(i) >= (long int)g_sm.size(i))
 			{
-				bc.setLow(j,hc.pos.get(j));
-				bc.setHigh(j,hc.pos.get(j) + sz_cnk[j] - 1);
+				std::cerr << "Error " << __FILE__ << ":" << __LINE__ << " the dense grid must be inside the sparse grid" << std::endl;
+				return;
 			}
+		}
 
-			// now we intersect the chunk box with the box
+		grid_sm<dim,void> g_c;
+		grid_key_dx<dim> c_start;
+		chunks_in_box(start,stop,g_c,c_start);
 
-			Box<dim,size_t> inte;
-			bool stp = bc.Intersect(section_to_delete,inte);
+		long int n_c = g_c.size();
 
-			if (stp == true)
-			{
-				// If it is intersect ok we have to check if there are points to pack
-				// we shift inte intp the chunk origin
+		// evaluate the predicate, the active points are stored with the layout of the chunks
 
-				inte -= header_inf.get(i).pos.toPoint();
+		openfpm::vector<unsigned char> act;
+		openfpm::vector<size_t> n_act;
 
-				// we iterate all the points
+		act.resize(n_c*chunking::size::value);
+		n_act.resize(n_c);
 
-				grid_key_dx_iterator_sub<dim,no_stencil,grid_sm<dim,void>> sit(gs_cnk,inte.getKP1(),inte.getKP2());
+		#pragma omp parallel for schedule(dynamic,SGRID_OMP_CHUNK_BATCH) if (n_c >= SGRID_OMP_MIN_CHUNKS)
+		for (long int c = 0 ; c < n_c ; c++)
+		{
+			unsigned char * a = &act.get(c*chunking::size::value);
+			size_t na = 0;
 
-				while (sit.isNext())
+			for (size_t j = 0 ; j < chunking::size::value ; j++)
+			{a[j] = 0;}
+
+			grid_key_dx<dim> kh = g_c.InvLinId(c) + c_start;
+			key_shift<dim,chunking>::cpos(kh);
+
+			chunk_rows(kh,start,stop,[&](int sub0, const grid_key_dx<dim> & p, int n)
+			{
+				grid_key_dx<dim> kd = p - start;
+				size_t lin0 = dense.getGrid().LinId(kd);
+
+				for (int x = 0 ; x < n ; x++)
 				{
-					auto key = sit.get();
+					a[sub0+x] = pred(dense,lin0+x);
+					na += a[sub0+x];
+				}
+			});
 
-					size_t sub_id = gs_cnk.LinId(key);
+			n_act.get(c) = na;
+		}
 
-					unsigned char swt = header_mask.get(i).mask[sub_id];
+		// find the chunks and create the missing ones with a single reservation
 
-					hc.nele = (swt)?hc.nele-1:hc.nele;
-					hm.mask[sub_id] = 0;
+		size_t n_old = chunks.size();
+		size_t n_new = 0;
 
-					if (hc.nele == 0 && swt != 0)
-					{
-						// Add the chunks in the empty list
-						empty_v.add(i);
-					}
+		openfpm::vector<size_t> act_c;
+		openfpm::vector<size_t> act_cnk;
+		openfpm::vector<size_t> new_c;
 
-					++sit;
+		for (long int c = 0 ; c < n_c ; c++)
+		{
+			if (n_act.get(c) == 0)	{continue;}
+
+			grid_key_dx<dim> kh = g_c.InvLinId(c) + c_start;
+			long int lin = g_sm_shift.LinId(kh);
+
+			size_t cnk;
+			auto fnd = map.find(lin);
+
+			if (fnd == map.end())
+			{
+				if (pop_free_chunk(cnk) == false)
+				{
+					cnk = n_old + n_new;
+					n_new++;
 				}
+
+				map[lin] = cnk;
+				new_c.add(act_c.size());
 			}
+			else
+			{cnk = fnd->second;}
+
+			act_c.add(c);
+			act_cnk.add(cnk);
 		}
 
-		remove_empty();
-	}
+		chunks.resize(n_old + n_new);
+		header_inf.resize(n_old + n_new);
+		header_mask.resize(n_old + n_new);
 
-	void copy_to(const self & grid_src,
-		         const Box<dim,size_t> & box_src,
-			     const Box<dim,size_t> & box_dst)
-	{
-/*		auto it = grid_src.getIterator(box_src.getKP1(),box_src.getKP2());
+		if (new_c.size() != 0)	{findNN = false;}
 
-		while (it.isNext())
+		#pragma omp parallel for schedule(static) if (new_c.size() >= SGRID_OMP_MIN_CHUNKS)
+		for (long int i = 0 ; i < (long int)new_c.size() ; i++)
 		{
-			auto key_src = it.get();
-			grid_key_dx<dim> key_dst = key_src + box_dst.getKP1();
-			key_dst -= box_src.getKP1();
+			size_t k = new_c.get(i);
+			size_t cnk = act_cnk.get(k);
 
-			typedef typename std::remove_const<typename std::remove_reference<decltype(grid_src)>::type>::type gcopy;
+			auto & hc = header_inf.get(cnk);
+			grid_key_dx<dim> kp = g_c.InvLinId(act_c.get(k));
 
-			copy_sparse_to_sparse<dim,gcopy,gcopy> caps(grid_src,*this,key_src,key_dst);
-			boost::mpl::for_each_ref< boost::mpl::range_c<int,0,T::max_prop> >(caps);
+			for (size_t d = 0 ; d < dim ; d++)
+			{hc.pos.set_d(d,kp.get(d) + c_start.get(d));}
+			hc.nele = 0;
 
-			++it;
-		}*/
+			key_shift<dim,chunking>::cpos(hc.pos);
 
-		auto it = grid_src.getIterator(box_src.getKP1(),box_src.getKP2());
+			auto & h = header_mask.get(cnk).mask;
 
-		while (it.isNext())
-		{
-			auto key_src = it.get();
-			grid_key_dx<dim> key_dst = key_src + box_dst.getKP1();
-			key_dst -= box_src.getKP1();
-			auto key_src_s = it.getKeyF();
+			for (size_t j = 0 ; j < chunking::size::value ; j++)
+			{h[j] = 0;}
+		}
 
-			typedef typename std::remove_const<typename std::remove_reference<decltype(grid_src)>::type>::type gcopy;
+		// fill the chunks, every chunk is owned by one thread
 
-			size_t pos_src_id = key_src_s.getPos();
-			size_t pos_dst_id;
+		#pragma omp parallel for schedule(dynamic,SGRID_OMP_CHUNK_BATCH) if (act_c.size() >= SGRID_OMP_MIN_CHUNKS)
+		for (long int i = 0 ; i < (long int)act_c.size() ; i++)
+		{
+			size_t c = act_c.get(i);
+			size_t cnk = act_cnk.get(i);
+			unsigned char * a = &act.get(c*chunking::size::value);
+			bool full = n_act.get(c) == chunking::size::value;
 
-			///////// WARNING insert_o MUST be done before getBlock, otherwise if grid_src == *this, and insert_o produce a reallocation 
-			///////// block_src will be invalidated  //////
-			auto block_dst = this->insert_o(key_dst,pos_dst_id);
+			auto & hc = header_inf.get(cnk);
+			auto & hm = header_mask.get(cnk);
 
-			auto block_src = grid_src.getBlock(key_src_s);
+			chunk_rows(hc.pos,start,stop,[&](int sub0, const grid_key_dx<dim> & p, int n)
+			{
+				grid_key_dx<dim> kd = p - start;
 
-			copy_sparse_to_sparse_bb<dim,decltype(block_src),decltype(block_dst),T> caps(block_src,block_dst,pos_src_id,pos_dst_id);
-			boost::mpl::for_each_ref< boost::mpl::range_c<int,0,T::max_prop> >(caps);
+				for (int x = 0 ; x < n ; x++)
+				{
+					bool exist = hm.mask[sub0+x] & 1;
+					hc.nele = (exist == false && a[sub0+x])?hc.nele + 1:hc.nele;
+					hm.mask[sub0+x] |= a[sub0+x];
+				}
 
-			++it;
+				copy_dense_row_to_chunk<T,decltype(chunks),dense_type,prp...> cr(chunks,dense,cnk,sub0,(full)?NULL:&a[sub0],dense.getGrid().LinId(kd),n);
+				boost::mpl::for_each_ref< boost::mpl::range_c<int,0,sizeof...(prp)> >(cr);
+			});
 		}
-
-//		copy_remove_to_impl(grid_src,*this,box_src,box_dst);
 	}
 
-	template<template <typename,typename> class op, unsigned int ... prp >
-	void copy_to_op(const self & grid_src,
-		         const Box<dim,size_t> & box_src,
-			     const Box<dim,size_t> & box_dst)
+	/*! \brief Insert the points of a dense grid for which the predicate is true
+	 *
+	 * The point k of the dense grid go in the point k of the sparse grid
+	 *
+	 * \tparam prp properties to copy
+	 *
+	 * \param dense dense grid
+	 * \param pred predicate that select the points to insert
+	 *
+	 */
+	template<unsigned int ... prp, typename dense_type, typename pred_type>
+	void from_dense(const dense_type & dense, pred_type pred)
 	{
-		auto it = grid_src.getIterator(box_src.getKP1(),box_src.getKP2());
-
-		while (it.isNext())
-		{
-			auto key_src = it.get();
-			grid_key_dx<dim> key_dst = key_src + box_dst.getKP1();
-			key_dst -= box_src.getKP1();
-
-			typedef typename std::remove_const<typename std::remove_reference<decltype(grid_src)>::type>::type gcopy;
-
-			copy_sparse_to_sparse_op<op,dim,gcopy,gcopy,prp ...> caps(grid_src,*this,key_src,key_dst);
-			boost::mpl::for_each_ref< boost::mpl::range_c<int,0,sizeof...(prp)> >(caps);
+		grid_key_dx<dim> origin;
+		origin.zero();
 
-			++it;
-		}
+		from_dense<prp...>(dense,pred,origin);
 	}
 
 	/*! \brief Give a grid point it return the chunk containing that point. In case the point does not exist it return the
@@ -2003,6 +3345,25 @@ public:
 		return act_cnk;
 	}
 
+	/*! \brief Give a grid point it return the chunk containing that point. In case the point does not exist it return the
+	 *         background chunk. It use the chunk cache cc, so it can be called concurrently if every thread has its own cache
+	 *
+	 * \param v1 key
+	 * \param exist return true if the chunk exist
+	 * \param cc chunk cache to use
+	 *
+	 * \return the chunk containing that point
+	 *
+	 */
+	size_t getChunk(const grid_key_dx<dim> & v1, bool & exist, sgrid_chunk_cache<SGRID_CACHE> & cc) const
+	{
+		size_t act_cnk = chunks.size()-1;
+
+		find_active_chunk(v1,act_cnk,exist,cc);
+
+		return act_cnk;
+	}
+
 	/*! \brief Get the position of a chunk
 	 *
 	 * \param chunk_id
@@ -2023,19 +3384,25 @@ public:
 
 	/*! \brief apply a convolution using the stencil N
 	 *
+	 * Any dimension and any stencil shape with offsets not bigger than stencil_size are supported. In 3D star
+	 * stencils use the optimized face-neighborhood path
+	 *
+	 * \param stencil offsets of the stencil points
+	 * \param start point
+	 * \param stop point
+	 * \param func function to apply on every vector of points
 	 *
 	 */
 	template<unsigned int prop_src, unsigned int prop_dst, unsigned int stencil_size, unsigned int N, typename lambda_f, typename ... ArgsT >
-	void conv(int (& stencil)[N][dim], grid_key_dx<3> start, grid_key_dx<3> stop , lambda_f func, ArgsT ... args)
+	void conv(int (& stencil)[N][dim], grid_key_dx<dim> start, grid_key_dx<dim> stop , lambda_f func, ArgsT ... args)
 	{
-		NNlist.resize(NNStar_c<dim>::nNN * chunks.size());
+		// the chunks changed, the list of neighborhood chunks must be reconstructed
+		if (NNlist.size() != NNStar_c<dim>::nNN * chunks.size())	{findNN = false;}
 
 		if (findNN == false)
 		{conv_impl<dim>::template conv<false,NNStar_c<dim>,prop_src,prop_dst,stencil_size>(stencil,start,stop,*this,func);}
 		else
 		{conv_impl<dim>::template conv<true,NNStar_c<dim>,prop_src,prop_dst,stencil_size>(stencil,start,stop,*this,func);}
-
-		findNN = true;
 	}
 
 	/*! \brief apply a convolution from start to stop point using the function func and arguments args
@@ -2049,7 +3416,8 @@ public:
 	template<unsigned int prop_src, unsigned int prop_dst, unsigned int stencil_size, typename lambda_f, typename ... ArgsT >
 	void conv_cross(grid_key_dx<3> start, grid_key_dx<3> stop , lambda_f func, ArgsT ... args)
 	{
-		NNlist.resize(2*dim * chunks.size());
+		// the chunks changed, the list of neighborhood chunks must be reconstructed
+		if (NNlist.size() != NNStar_c<dim>::nNN * chunks.size())	{findNN = false;}
 
 		if (findNN == false)
 		{conv_impl<dim>::template conv_cross<false,prop_src,prop_dst,stencil_size>(start,stop,*this,func);}
@@ -2075,7 +3443,8 @@ public:
 			std::cout << __FILE__ << ":" << __LINE__ << " Error this function can be only used with the SOA version of the data-structure" << std::endl;
 		}
 
-		NNlist.resize(2*dim * chunks.size());
+		// the chunks changed, the list of neighborhood chunks must be reconstructed
+		if (NNlist.size() != NNStar_c<dim>::nNN * chunks.size())	{findNN = false;}
 
 		if (findNN == false)
 		{conv_impl<dim>::template conv_cross_ids<false,stencil_size,prop_type>(start,stop,*this,func);}
@@ -2092,7 +3461,8 @@ public:
 	template<unsigned int prop_src1, unsigned int prop_src2 ,unsigned int prop_dst1, unsigned int prop_dst2 ,unsigned int stencil_size, unsigned int N, typename lambda_f, typename ... ArgsT >
 	void conv2(int (& stencil)[N][dim], grid_key_dx<3> start, grid_key_dx<3> stop , lambda_f func, ArgsT ... args)
 	{
-		NNlist.resize(NNStar_c<dim>::nNN * chunks.size());
+		// the chunks changed, the list of neighborhood chunks must be reconstructed
+		if (NNlist.size() != NNStar_c<dim>::nNN * chunks.size())	{findNN = false;}
 
 		if (findNN == false)
 		{conv_impl<dim>::template conv2<false,NNStar_c<dim>,prop_src1,prop_src2,prop_dst1,prop_dst2,stencil_size>(stencil,start,stop,*this,func);}
@@ -2109,7 +3479,8 @@ public:
 	template<unsigned int prop_src1, unsigned int prop_src2 ,unsigned int prop_dst1, unsigned int prop_dst2 ,unsigned int stencil_size, typename lambda_f, typename ... ArgsT >
 	void conv_cross2(grid_key_dx<3> start, grid_key_dx<3> stop , lambda_f func, ArgsT ... args)
 	{
-		NNlist.resize(NNStar_c<dim>::nNN * chunks.size());
+		// the chunks changed, the list of neighborhood chunks must be reconstructed
+		if (NNlist.size() != NNStar_c<dim>::nNN * chunks.size())	{findNN = false;}
 
 		if (findNN == false)
 		{conv_impl<dim>::template conv_cross2<false,prop_src1,prop_src2,prop_dst1,prop_dst2,stencil_size>(start,stop,*this,func);}
@@ -2130,7 +3501,7 @@ public:
 	 */
 	template<unsigned int ... prp, typename S2,typename context_type>
 	void unpack(ExtPreAlloc<S2> & mem,
-				grid_key_sparse_dx_iterator_sub<dims,chunking::size::value> & sub_it,
+				grid_key_sparse_dx_iterator_sub<dims,chunking::size::value,header_mask_type> & sub_it,
 				Unpack_stat & ps,
 				context_type & context,
 				rem_copy_opt opt)
@@ -2160,7 +3531,7 @@ public:
 			auto & hc = header_inf_tmp.get(i);
 			auto & hm = header_mask_tmp.get(i);
 
-			Unpacker<typename std::remove_reference<decltype(header_mask.get(i).mask)>::type ,S2>::unpack(mem,hm.mask,ps);
+			Unpacker<typename std::remove_reference<decltype(hm.mask)>::type ,S2>::unpack(mem,hm.mask,ps);
 			Unpacker<typename std::remove_reference<decltype(header_inf.get(i).pos)>::type ,S2>::unpack(mem,hc.pos,ps);
 			Unpacker<typename std::remove_reference<decltype(header_inf.get(i).nele)>::type ,S2>::unpack(mem,hc.nele,ps);
 
@@ -2244,7 +3615,7 @@ public:
 	 */
 	template<template<typename,typename> class op, typename S2, unsigned int ... prp>
 	void unpack_with_op(ExtPreAlloc<S2> & mem,
-						grid_key_sparse_dx_iterator_sub<dim,chunking::size::value> & sub2,
+						grid_key_sparse_dx_iterator_sub<dim,chunking::size::value,header_mask_type> & sub2,
 						Unpack_stat & ps)
 	{
 		short unsigned int mask_it[chunking::size::value];
@@ -2316,10 +3687,10 @@ public:
 	 *
 	 */
 	template <typename stencil = no_stencil>
-	static grid_key_sparse_dx_iterator_sub<dim, chunking::size::value>
+	static grid_key_sparse_dx_iterator_sub<dim,chunking::size::value,header_mask_type>
 	type_of_subiterator()
 	{
-		return  grid_key_sparse_dx_iterator_sub<dim, chunking::size::value>();
+		return  grid_key_sparse_dx_iterator_sub<dim,chunking::size::value,header_mask_type>();
 	}
 
 	/*! \brief This is a meta-function return which type of sub iterator a grid produce
@@ -2327,10 +3698,10 @@ public:
 	 * \return the type of the sub-grid iterator
 	 *
 	 */
-	static grid_key_sparse_dx_iterator<dim, chunking::size::value>
+	static grid_key_sparse_dx_iterator<dim,chunking::size::value,header_mask_type>
 	type_of_iterator()
 	{
-		return  grid_key_sparse_dx_iterator<dim, chunking::size::value>();
+		return  grid_key_sparse_dx_iterator<dim,chunking::size::value,header_mask_type>();
 	}
 
 	/*! \brief Here we convert the linearized sparse key into the grid_key_dx
@@ -2357,13 +3728,7 @@ public:
 	 */
 	sgrid_cpu & operator=(const sgrid_cpu & sg)
 	{
-		cache_pnt = sg.cache_pnt;
-
-		for (size_t i = 0 ; i < SGRID_CACHE ; i++)
-		{
-			cache[i] = sg.cache[i];
-			cached_id[i] = sg.cached_id[i];
-		}
+		chunk_cache = sg.chunk_cache;
 
 		//! Map to convert from grid coordinates to chunk
 		map = sg.map;
@@ -2375,7 +3740,8 @@ public:
 
 		for (size_t i = 0 ; i < chunking::size::value ; i++)
 		{
-			pos_chunk[i] = sg.pos_chunk[i];
+			for (size_t j = 0 ; j < dim ; j++)
+			{pos_chunk[i].set_d(j,sg.pos_chunk[i].get(j));}
 		}
 
 
@@ -2384,72 +3750,164 @@ public:
 
 		empty_v = sg.empty_v;
 
+		keep_order = sg.keep_order;
+		n_ordered = sg.n_ordered;
+
+		free_v = sg.free_v;
+		compact_min = sg.compact_min;
+		compact_frac = sg.compact_frac;
+
 		return *this;
 	}
 
-	/*! \brief Reorder based on index
+	/*! \brief Reorder the chunks in memory
 	 *
+	 * With SGRID_ORDER_MORTON or SGRID_ORDER_HILBERT the neighborhood chunks are closer in memory than with
+	 * the linearized order of the chunk positions
+	 *
+	 * \param ord order of the chunks
 	 *
 	 */
-	void reorder()
+	void reorder(sgrid_order ord = SGRID_ORDER_LINEAR)
 	{
-		openfpm::vector<cheader<dim>,S> header_inf_tmp;
-		openfpm::vector<mheader<chunking::size::value>,S> header_mask_tmp;
-		openfpm::vector<aggregate_bfv<chunk_def>,S,layout_base > chunks_tmp;
+		if (ord == SGRID_ORDER_NONE)
+		{return;}
 
-		header_inf_tmp.resize(header_inf.size());
-		header_mask_tmp.resize(header_mask.size());
-		chunks_tmp.resize(chunks.size());
+		size_t bits = sfc_bits();
+		size_t n_cnk = header_inf.size();
 
-		struct pair_int
-		{
-			int id;
-			int pos;
+		openfpm::vector<size_t> key;
+		openfpm::vector<size_t> ids;
 
-			bool operator<(const pair_int & tmp) const
-			{
-				return id < tmp.id;
-			}
-		};
+		key.resize(n_cnk - 1);
+		ids.resize(n_cnk - 1);
 
-		openfpm::vector<pair_int> srt;
-		srt.resize(header_inf.size());
+		size_t max_key = 0;
 
-		for (int i = 0 ; i < header_inf.size() ; i++)
+		for (size_t i = 1 ; i < n_cnk ; i++)
 		{
-			grid_key_dx<dim> kh = header_inf.get(i).pos;
-			grid_key_dx<dim> kl;
+			key.get(i-1) = chunk_order_key(i,ord,bits);
+			ids.get(i-1) = i;
 
-			// shift the key
-			key_shift<dim,chunking>::shift(kh,kl);
+			max_key = std::max(max_key,key.get(i-1));
+		}
 
-			long int lin_id = g_sm_shift.LinId(kh);
+		sgrid_radix_sort(key,ids,max_key);
+
+		// the background chunk remain the first
+		openfpm::vector<size_t> prm;
+		prm.resize(n_cnk);
+		prm.get(0) = 0;
+
+		for (size_t i = 1 ; i < n_cnk ; i++)
+		{prm.get(i) = ids.get(i-1);}
+
+		apply_chunk_permutation(prm);
+
+		if (ord == keep_order)
+		{n_ordered = n_cnk;}
+	}
+
+	/*! \brief Keep the chunks ordered
+	 *
+	 * The chunks are reordered with ord. The chunks created later are merged into the order by merge_ordered(),
+	 * flush_remove() and updateNarrowBand() merge them when they are enough (see SGRID_ORDER_MERGE_MIN and
+	 * SGRID_ORDER_MERGE_FRACTION). Inserting points never move the chunks. SGRID_ORDER_NONE disable it
+	 *
+	 * \param ord order of the chunks
+	 *
+	 */
+	void setKeepOrdered(sgrid_order ord)
+	{
+		keep_order = ord;
+
+		reorder(ord);
+	}
+
+	/*! \brief Merge the chunks added after the last reorder into the ordered chunks
+	 *
+	 * The new chunks are sorted and merged with the ordered ones, the ordered chunks are not sorted again.
+	 * It does nothing if the keep ordered mode is not active (see setKeepOrdered)
+	 *
+	 * \warning the chunks are moved, iterators and block references are invalidated
+	 *
+	 */
+	void merge_ordered()
+	{
+		if (keep_order == SGRID_ORDER_NONE || n_ordered >= header_inf.size())
+		{return;}
 
-			srt.get(i).id = lin_id;
-			srt.get(i).pos = i;
+		size_t bits = sfc_bits();
+		size_t n_cnk = header_inf.size();
+
+		openfpm::vector<size_t> key_new;
+		openfpm::vector<size_t> id_new;
+
+		key_new.resize(n_cnk - n_ordered);
+		id_new.resize(n_cnk - n_ordered);
+
+		size_t max_key = 0;
+
+		for (size_t i = n_ordered ; i < n_cnk ; i++)
+		{
+			key_new.get(i - n_ordered) = chunk_order_key(i,keep_order,bits);
+			id_new.get(i - n_ordered) = i;
+
+			max_key = std::max(max_key,key_new.get(i - n_ordered));
 		}
 
-		srt.sort();
+		sgrid_radix_sort(key_new,id_new,max_key);
+
+		openfpm::vector<size_t> prm;
+		prm.resize(n_cnk);
+		prm.get(0) = 0;
+
+		size_t i = 1;
+		size_t j = 0;
+		size_t k = 1;
 
-		// now reoder
+		size_t key_i = (i < n_ordered)?chunk_order_key(i,keep_order,bits):0;
 
-		for (int i = 0 ; i < srt.size() ; i++)
+		while (i < n_ordered || j < key_new.size())
 		{
-			chunks_tmp.get(i) = chunks.get(srt.get(i).pos);
-			header_inf_tmp.get(i) = header_inf.get(srt.get(i).pos);
-			header_mask_tmp.get(i) = header_mask.get(srt.get(i).pos);
+			if (j >= key_new.size() || (i < n_ordered && key_i <= key_new.get(j)))
+			{
+				prm.get(k) = i;
+				i++;
+				key_i = (i < n_ordered)?chunk_order_key(i,keep_order,bits):0;
+			}
+			else
+			{
+				prm.get(k) = id_new.get(j);
+				j++;
+			}
+
+			k++;
 		}
 
-		chunks_tmp.swap(chunks);
-		header_inf_tmp.swap(header_inf);
-		header_mask_tmp.swap(header_mask);
+		apply_chunk_permutation(prm);
 
-		clear_cache();
-		reconstruct_map();
+		n_ordered = n_cnk;
+	}
 
-		empty_v.clear();
-		findNN = false;
-		NNlist.clear();
+	/*! \brief Return the order kept for the chunks
+	 *
+	 * \return the order
+	 *
+	 */
+	sgrid_order getKeepOrdered() const
+	{
+		return keep_order;
+	}
+
+	/*! \brief Return the number of chunks (background included) that are in order
+	 *
+	 * \return the number of ordered chunks
+	 *
+	 */
+	size_t getOrderedChunks() const
+	{
+		return n_ordered;
 	}
 
 	/*! \brief copy an sparse grid
@@ -2459,13 +3917,7 @@ public:
 	 */
 	sgrid_cpu & operator=(sgrid_cpu && sg)
 	{
-		cache_pnt = sg.cache_pnt;
-
-		for (size_t i = 0 ; i < SGRID_CACHE ; i++)
-		{
-			cache[i] = sg.cache[i];
-			cached_id[i] = sg.cached_id[i];
-		}
+		chunk_cache = sg.chunk_cache;
 
 		//! Map to convert from grid coordinates to chunk
 		map.swap(sg.map);
@@ -2477,7 +3929,8 @@ public:
 
 		for (size_t i = 0 ; i < chunking::size::value ; i++)
 		{
-			pos_chunk[i] = sg.pos_chunk[i];
+			for (size_t j = 0 ; j < dim ; j++)
+			{pos_chunk[i].set_d(j,sg.pos_chunk[i].get(j));}
 		}
 
 
@@ -2486,6 +3939,13 @@ public:
 
 		empty_v = sg.empty_v;
 
+		keep_order = sg.keep_order;
+		n_ordered = sg.n_ordered;
+
+		free_v = sg.free_v;
+		compact_min = sg.compact_min;
+		compact_frac = sg.compact_frac;
+
 		return *this;
 	}
 
@@ -2511,6 +3971,54 @@ public:
 
 		clear_cache();
 		reconstruct_map();
+
+		n_ordered = 1;
+		free_v.clear();
+		empty_v.clear();
+	}
+
+	/*! \brief Save the sparse grid in a checkpoint file
+	 *
+	 * The checkpoint store the points and the properties independently from the chunking, so it can be
+	 * loaded by a sparse grid with a different chunking or layout
+	 *
+	 * \note Packer_Unpacker/Checkpoint.hpp must be included to use save and load
+	 *
+	 * \param path file
+	 * \param n_stripe split the data in n_stripe files written in parallel
+	 *
+	 * \return true if succeed
+	 *
+	 */
+	bool save(const std::string & path, size_t n_stripe = 1) const
+	{
+		return checkpoint_call<T>::template save_sparse<dim>(path,*this,n_stripe);
+	}
+
+	/*! \brief Load the sparse grid from a checkpoint file
+	 *
+	 * The sparse grid is cleared and resized to the size stored in the checkpoint
+	 *
+	 * \note Packer_Unpacker/Checkpoint.hpp must be included to use save and load
+	 *
+	 * \param path file
+	 *
+	 * \return true if succeed
+	 *
+	 */
+	bool load(const std::string & path)
+	{
+		auto resize = [this](const std::vector<uint64_t> & sz)
+		{
+			size_t sz_[dim];
+			for (size_t i = 0 ; i < dim ; i++)
+			{sz_[i] = sz[i];}
+
+			this->clear();
+			this->resize(sz_);
+		};
+
+		return checkpoint_call<T>::template load_sparse<dim>(path,*this,resize);
 	}
 
 	/*! \brief This is an internal function to clear the cache
@@ -2605,7 +4113,7 @@ public:
 	 * \return the header data section of the chunks stored
 	 *
 	 */
-	openfpm::vector<mheader<chunking::size::value>> & private_get_header_mask()
+	openfpm::vector<header_mask_type,S> & private_get_header_mask()
 	{
 		return header_mask;
 	}
@@ -2645,7 +4153,7 @@ public:
 	 * \return the header data section of the chunks stored
 	 *
 	 */
-	const openfpm::vector<mheader<chunking::size::value>> & private_get_header_mask() const
+	const openfpm::vector<header_mask_type,S> & private_get_header_mask() const
 	{
 		return header_mask;
 	}
@@ -17,8 +17,231 @@ const static int cnk_mask = 2;
 //! sizeof the cache
 #define SGRID_CACHE 2
 
-//! When we have more that 1024 to remove remove them
+//! Default minimum number of dead chunks before the chunks are compacted (see setCompactionThresholds)
+#ifndef FLUSH_REMOVE
 #define FLUSH_REMOVE 1024
+#endif
+
+//! Default minimum fraction of dead chunks before the chunks are compacted (see setCompactionThresholds)
+#ifndef SGRID_COMPACT_FRACTION
+#define SGRID_COMPACT_FRACTION 0.0
+#endif
+
+//! Minimum number of chunks before an operation on the chunks run in parallel
+#ifndef SGRID_OMP_MIN_CHUNKS
+#define SGRID_OMP_MIN_CHUNKS 32
+#endif
+
+//! Number of consecutive chunks a thread take at once when the chunks are processed in parallel
+#ifndef SGRID_OMP_CHUNK_BATCH
+#define SGRID_OMP_CHUNK_BATCH 16
+#endif
+
+//! Minimum number of new chunks before they are merged into the order of the chunks (see setKeepOrdered)
+#ifndef SGRID_ORDER_MERGE_MIN
+#define SGRID_ORDER_MERGE_MIN 64
+#endif
+
+//! New chunks are merged into the order when they are more than the ordered chunks divided by this number
+#ifndef SGRID_ORDER_MERGE_FRACTION
+#define SGRID_ORDER_MERGE_FRACTION 8
+#endif
+
+//! Order of the chunks in memory
+enum sgrid_order
+{
+	SGRID_ORDER_NONE = 0,
+	SGRID_ORDER_LINEAR = 1,
+	SGRID_ORDER_MORTON = 2,
+	SGRID_ORDER_HILBERT = 3
+};
+
+/*! \brief Space filling curve keys of the chunk positions
+ *
+ * \tparam dim dimensionality
+ *
+ */
+template<unsigned int dim>
+struct sgrid_sfc
+{
+	/*! \brief Morton key, the bits of the coordinates are interleaved (x is the lowest)
+	 *
+	 * \param k position
+	 * \param bits number of bits of every coordinate
+	 *
+	 * \return the key
+	 *
+	 */
+	static size_t morton(const grid_key_dx<dim> & k, size_t bits)
+	{
+		size_t key = 0;
+
+		for (long int b = bits - 1 ; b >= 0 ; b--)
+		{
+			for (long int d = dim - 1 ; d >= 0 ; d--)
+			{key = (key << 1) | ((k.get(d) >> b) & 1);}
+		}
+
+		return key;
+	}
+
+	/*! \brief Hilbert key (J. Skilling, Programming the Hilbert curve, 2004)
+	 *
+	 * \param k position
+	 * \param bits number of bits of every coordinate
+	 *
+	 * \return the key
+	 *
+	 */
+	static size_t hilbert(const grid_key_dx<dim> & k, size_t bits)
+	{
+		size_t X[dim];
+
+		for (size_t i = 0 ; i < dim ; i++)
+		{X[i] = k.get(i);}
+
+		size_t M = (size_t)1 << (bits - 1);
+
+		// inverse undo
+		for (size_t Q = M ; Q > 1 ; Q >>= 1)
+		{
+			size_t P = Q - 1;
+
+			for (size_t i = 0 ; i < dim ; i++)
+			{
+				if (X[i] & Q)
+				{X[0] ^= P;}
+				else
+				{
+					size_t t = (X[0] ^ X[i]) & P;
+					X[0] ^= t;
+					X[i] ^= t;
+				}
+			}
+		}
+
+		// gray encode
+		for (size_t i = 1 ; i < dim ; i++)
+		{X[i] ^= X[i-1];}
+
+		size_t t = 0;
+		for (size_t Q = M ; Q > 1 ; Q >>= 1)
+		{
+			if (X[dim-1] & Q)
+			{t ^= Q - 1;}
+		}
+
+		for (size_t i = 0 ; i < dim ; i++)
+		{X[i] ^= t;}
+
+		size_t key = 0;
+
+		for (long int b = bits - 1 ; b >= 0 ; b--)
+		{
+			for (size_t i = 0 ; i < dim ; i++)
+			{key = (key << 1) | ((X[i] >> b) & 1);}
+		}
+
+		return key;
+	}
+};
+
+/*! \brief Cache of the last chunks accessed in a sparse grid
+ *
+ * The cache is modified by every access, threads that read the same sparse grid concurrently
+ * must use a different cache
+ *
+ * \tparam n_cache number of chunks cached
+ *
+ */
+template<unsigned int n_cache>
+struct sgrid_chunk_cache
+{
+	//! linearized id of the cached chunks
+	long int cache[n_cache];
+
+	//! id of the cached chunks
+	long int cached_id[n_cache];
+
+	//! next position to replace
+	size_t cache_pnt;
+
+	//! Constructor
+	sgrid_chunk_cache()
+	{
+		clear();
+	}
+
+	/*! \brief reset the cache
+	 *
+	 */
+	inline void clear()
+	{
+		cache_pnt = 0;
+		for (size_t i = 0 ; i < n_cache ; i++)
+		{cache[i] = -1;}
+	}
+
+	/*! \brief add a chunk on cache
+	 *
+	 * \param lin_id linearized id of the chunk
+	 * \param active_cnk id of the chunk
+	 *
+	 */
+	inline void add(long int lin_id, size_t active_cnk)
+	{
+		cache[cache_pnt] = lin_id;
+		cached_id[cache_pnt] = active_cnk;
+		cache_pnt++;
+		cache_pnt = (cache_pnt >= n_cache)?0:cache_pnt;
+	}
+
+	/*! \brief search a chunk in the cache
+	 *
+	 * \param lin_id linearized id of the chunk
+	 * \param active_cnk id of the chunk if found
+	 *
+	 * \return true if the chunk is in cache
+	 *
+	 */
+	inline bool get(long int lin_id, size_t & active_cnk)
+	{
+		size_t id = 0;
+		for (size_t k = 0 ; k < n_cache; k++)
+		{id += (cache[k] == lin_id)?k+1:0;}
+
+		if (id == 0)	{return false;}
+
+		active_cnk = cached_id[id-1];
+		cache_pnt = id;
+		cache_pnt = (cache_pnt == n_cache)?0:cache_pnt;
+
+		return true;
+	}
+
+	/*! \brief search a chunk in the cache, if not found search in the map and add it on cache
+	 *
+	 * \param lin_id linearized id of the chunk
+	 * \param map map from linearized id to chunk id
+	 * \param active_cnk id of the chunk if found
+	 *
+	 * \return true if the chunk exist
+	 *
+	 */
+	template<typename map_type>
+	inline bool find(long int lin_id, const map_type & map, size_t & active_cnk)
+	{
+		if (get(lin_id,active_cnk) == true)	{return true;}
+
+		auto fnd = map.find(lin_id);
+		if (fnd == map.end())	{return false;}
+
+		active_cnk = fnd->second;
+		add(lin_id,active_cnk);
+
+		return true;
+	}
+};
 
 template<typename T>
 struct encapsulated_type
@@ -41,12 +264,75 @@ struct Ft_chunk<n_ele,const T(&)[N1]>
 	typedef encapsulated_type<std::array<T,n_ele::value>[N1]> type;
 };
 
+/*! \brief this class is a functor for "for_each" algorithm
+ *
+ * This class is a functor for "for_each" algorithm. For each
+ * element of the boost::vector the operator() is called.
+ * Is mainly used to copy a boost::mpl::vector into runtime array
+ *
+ */
+
+template<unsigned int dim, typename mpl_v>
+struct copy_sz
+{
+	//! sz site_t
+	size_t (& sz)[dim];
+
+
+	/*! \brief constructor
+	 *
+	 * \param sz runtime sz to fill
+	 *
+	 */
+	inline copy_sz(size_t (& sz)[dim])
+	:sz(sz)
+	{
+	};
+
+	//! It call the copy function for each property
+	template<typename T>
+	inline void operator()(T& /*t*/) const
+	{
+		sz[T::value] = boost::mpl::at<mpl_v,boost::mpl::int_<T::value>>::type::value;
+	}
+};
+
+/*! \brief Star neighborhood of a chunk
+ *
+ * The neighborhood chunks are ordered from the last direction to the first, positive
+ * before negative (+z,-z,+y,-y,+x,-x in 3D)
+ *
+ */
 template<unsigned int dim>
 struct NNStar_c
 {
 	static const int nNN = 2*dim;
 
 	static const int is_cross = false;
+
+	/*! \brief direction of the neighborhood chunk k
+	 *
+	 * \param k neighborhood chunk
+	 *
+	 * \return the direction
+	 *
+	 */
+	static inline int dir(int k)
+	{
+		return dim - 1 - k/2;
+	}
+
+	/*! \brief +1 or -1 if the neighborhood chunk k is in the positive or negative direction
+	 *
+	 * \param k neighborhood chunk
+	 *
+	 * \return the sign
+	 *
+	 */
+	static inline int sign(int k)
+	{
+		return (k % 2 == 0)?1:-1;
+	}
 };
 
 /*! \brief this class is a functor for "for_each" algorithm
@@ -278,6 +564,22 @@ struct default_chunking<8>
 	typedef boost::mpl::int_<1024> size;
 };
 
+/*! \brief Chunking with the occupancy of the elements packed in bits
+ *
+ * The chunks store one bit for each element to indicate if it exist instead of one byte.
+ * The iteration find the elements set with count trailing zeros and the vectorized copies
+ * expand 8 bits at time
+ *
+ * \tparam chunking chunking (for example default_chunking<3>)
+ *
+ */
+template<typename chunking>
+struct bit_mask_chunking : public chunking
+{
+	//! the mask of the chunks is packed in bits
+	typedef boost::mpl::bool_<true> bit_mask;
+};
+
 template<unsigned int dim,
          typename T,
 		 typename S,
@@ -611,6 +913,56 @@ struct sublin<8,chunk>
 
 
 
+/*! \brief Sort the ids by key with a stable LSD radix sort on 8 bits digits
+ *
+ * The number of passes depend on max_key, chunk ids need typically two or three passes
+ *
+ * \param key keys to sort (sorted in output)
+ * \param id ids sorted together with the keys
+ * \param max_key biggest key
+ *
+ */
+template<typename vector_type>
+void sgrid_radix_sort(vector_type & key, vector_type & id, size_t max_key)
+{
+	vector_type key_tmp;
+	vector_type id_tmp;
+
+	key_tmp.resize(key.size());
+	id_tmp.resize(id.size());
+
+	size_t cnt[256];
+
+	for (size_t shift = 0 ; shift < 8*sizeof(size_t) && (max_key >> shift) != 0 ; shift += 8)
+	{
+		for (size_t i = 0 ; i < 256 ; i++)
+		{cnt[i] = 0;}
+
+		for (size_t i = 0 ; i < key.size() ; i++)
+		{cnt[(key.get(i) >> shift) & 0xFF]++;}
+
+		size_t sum = 0;
+		for (size_t i = 0 ; i < 256 ; i++)
+		{
+			size_t c = cnt[i];
+			cnt[i] = sum;
+			sum += c;
+		}
+
+		for (size_t i = 0 ; i < key.size() ; i++)
+		{
+			size_t & pos = cnt[(key.get(i) >> shift) & 0xFF];
+
+			key_tmp.get(pos) = key.get(i);
+			id_tmp.get(pos) = id.get(i);
+			pos++;
+		}
+
+		key.swap(key_tmp);
+		id.swap(id_tmp);
+	}
+}
+
 template<typename T>
 struct get_selector
 {
@@ -89,7 +89,30 @@ struct exist_sub_v_impl<8>
 	}
 };
 
+//! Select the expansion of the mask (byte mask or mask packed in bits)
+template<unsigned int v, bool is_bit>
+struct exist_sub_v_sel
+{
+	template<typename headerType>
+	static inline void exist(headerType & h, int sub_id, unsigned char * pmask)
+	{
+		exist_sub_v_impl<v>::exist(h,sub_id,pmask);
+	}
+};
+
+template<unsigned int v>
+struct exist_sub_v_sel<v,true>
+{
+	template<typename headerType>
+	static inline void exist(headerType & h, int sub_id, unsigned char * pmask)
+	{
+		h.mask.expand(pmask,sub_id,v);
+	}
+};
+
 /*! \brief Check if the point in the chunk exist (Vectorial form)
+ *
+ * With the mask packed in bits the bits are expanded into bytes
  *
  * \param h header
  * \param sub_id index of the sub-domain
@@ -100,7 +123,111 @@ struct exist_sub_v_impl<8>
 template<unsigned int v, typename headerType>
 inline void exist_sub_v(headerType & h, int sub_id, unsigned char * pmask)
 {
-	exist_sub_v_impl<v>::exist(h,sub_id,pmask);
+	exist_sub_v_sel<v,is_mheader_bit<headerType>::value>::exist(h,sub_id,pmask);
+}
+
+/*! \brief Check if the points [sub_id,sub_id+n) in the chunk exist
+ *
+ * \param h header
+ * \param sub_id index of the first point
+ * \param n number of points
+ * \param pmask output mask (1 if the point exist 0 otherwise)
+ *
+ */
+template<typename headerType>
+inline void exist_sub_row(headerType & h, int sub_id, int n, unsigned char * pmask)
+{
+	for (int i = 0 ; i < n ; i++)
+	{pmask[i] = exist_sub(h,sub_id+i);}
+}
+
+template<unsigned int n_ele>
+inline void exist_sub_row(const mheader_bit<n_ele> & h, int sub_id, int n, unsigned char * pmask)
+{
+	h.mask.expand(pmask,sub_id,n);
+}
+
+template<unsigned int n_ele>
+inline void exist_sub_row(mheader_bit<n_ele> & h, int sub_id, int n, unsigned char * pmask)
+{
+	h.mask.expand(pmask,sub_id,n);
+}
+
+//! Load sizeof(ret_type) elements of the chunk mask as bytes (byte mask or mask packed in bits)
+template<typename ret_type, bool is_bit>
+struct load_mask_bytes_impl
+{
+	template<typename header_vector>
+	static inline ret_type load(const header_vector & headers, long int cid, long int rel)
+	{
+		// rel can go outside the chunk, the headers are contiguous
+		ret_type r;
+		memcpy(&r,&headers.get(cid).mask[0] + rel,sizeof(ret_type));
+		return r;
+	}
+};
+
+template<typename ret_type>
+struct load_mask_bytes_impl<ret_type,true>
+{
+	template<typename header_vector>
+	static inline ret_type load(const header_vector & headers, long int cid, long int rel)
+	{
+		typedef typename std::remove_const<typename std::remove_reference<decltype(headers.get(0))>::type>::type header_type;
+		const long int n_ele = decltype(header_type::mask)::n_bits;
+
+		// element relative to the first chunk
+		long int g = cid*n_ele + rel;
+
+		ret_type r;
+		headers.get(g / n_ele).mask.expand((unsigned char *)&r,g % n_ele,sizeof(ret_type));
+		return r;
+	}
+};
+
+/*! \brief Load sizeof(ret_type) elements of the chunk mask as bytes
+ *
+ * The position is relative to the chunk cid and can fall in another chunk (like in the
+ * vectorized stencils), with the mask packed in bits the bits are expanded
+ *
+ * \tparam ret_type type loaded (unsigned char, short int, int, ...)
+ *
+ * \param headers headers of the chunk masks
+ * \param cid chunk
+ * \param rel position of the first element relative to the chunk cid
+ *
+ * \return the elements of the mask packed into ret_type
+ *
+ */
+template<typename ret_type, typename header_vector>
+inline ret_type load_mask_bytes(const header_vector & headers, long int cid, long int rel)
+{
+	typedef typename std::remove_const<typename std::remove_reference<decltype(headers.get(0))>::type>::type header_type;
+
+	return load_mask_bytes_impl<ret_type,is_mheader_bit<header_type>::value>::load(headers,cid,rel);
+}
+
+/*! \brief Return a mask with one byte for each element of the chunk
+ *
+ * The byte mask is returned as it is, the mask packed in bits is expanded into tmp
+ *
+ * \param h header
+ * \param tmp buffer for the expansion
+ *
+ * \return the byte mask
+ *
+ */
+template<unsigned int n_ele>
+inline const mheader<n_ele> & byte_mask(const mheader<n_ele> & h, mheader<n_ele> & /*tmp*/)
+{
+	return h;
+}
+
+template<unsigned int n_ele>
+inline const mheader<n_ele> & byte_mask(const mheader_bit<n_ele> & h, mheader<n_ele> & tmp)
+{
+	h.mask.expand(tmp.mask,0,n_ele);
+	return tmp;
 }
 
 
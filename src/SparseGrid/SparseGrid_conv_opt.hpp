@@ -63,14 +63,17 @@ struct ids_crs
 
 
 
+template<unsigned int dim>
+struct conv_gen_impl;
+
 template<unsigned int dim>
 struct conv_impl
 {
-	template<unsigned int prop_src, unsigned int prop_dst, unsigned int stencil_size , unsigned int N, typename SparseGridType, typename lambda_f, typename ... ArgsT >
-	void conv(int (& stencil)[N][3], grid_key_dx<3> & start, grid_key_dx<3> & stop, SparseGridType & grid , lambda_f func, ArgsT ... args)
+	template<bool findNN, typename NNtype, unsigned int prop_src, unsigned int prop_dst, unsigned int stencil_size , unsigned int N, typename SparseGridType, typename lambda_f, typename ... ArgsT >
+	static void conv(int (& stencil)[N][dim], grid_key_dx<dim> & start, grid_key_dx<dim> & stop, SparseGridType & grid , lambda_f func, ArgsT ... args)
 	{
-#ifndef __NVCC__
-		std::cout << __FILE__ << ":" << __LINE__ << " error conv operation not implemented for this dimension " << std::endl;
+#if !defined(__NVCC__) || defined(CUDA_ON_CPU) || defined(__HIP__)
+		conv_gen_impl<dim>::template conv<prop_src,prop_dst,stencil_size>(stencil,start,stop,grid,func,args...);
 #else
 		std::cout << __FILE__ << ":" << __LINE__ << " error conv is unsupported when compiled on NVCC " << std::endl;
 #endif
@@ -211,29 +214,400 @@ struct cross_stencil_v
 	Vc::Vector<prop_type> zp;
 };
 
+/*! \brief Vectorized convolution on the chunks of a sparse grid for any dimension and any stencil shape
+ *
+ * Every chunk is loaded into a buffer extended by stencil_size points on each side. Only the neighborhood
+ * chunks in the directions reached by the stencil are gathered into the border. The chunks are processed in parallel
+ *
+ */
+template<unsigned int dim>
+struct conv_gen_impl
+{
+	/*! \brief Check if every point of the stencil move along at most one direction
+	 *
+	 * \param stencil offsets of the stencil points
+	 *
+	 * \return true if the stencil reach only the face neighborhood chunks
+	 *
+	 */
+	template<unsigned int N>
+	static bool is_star(int (& stencil)[N][dim])
+	{
+		for (size_t s = 0 ; s < N ; s++)
+		{
+			int nz = 0;
+
+			for (size_t k = 0 ; k < dim ; k++)
+			{nz += (stencil[s][k] != 0);}
+
+			if (nz > 1)
+			{return false;}
+		}
+
+		return true;
+	}
+
+	/*! \brief Get the directions of the neighborhood chunks reached by the stencil
+	 *
+	 * \param stencil offsets of the stencil points
+	 * \param dirs directions, every component is -1, 0 or 1
+	 *
+	 */
+	template<unsigned int N>
+	static void stencil_directions(int (& stencil)[N][dim], openfpm::vector<grid_key_dx<dim>> & dirs)
+	{
+		size_t sz[dim];
+		for (size_t k = 0 ; k < dim ; k++)
+		{sz[k] = 3;}
+
+		grid_sm<dim,void> g3(sz);
+		grid_key_dx_iterator<dim> it(g3);
+
+		while (it.isNext())
+		{
+			auto key = it.get();
+
+			grid_key_dx<dim> d;
+			bool zero = true;
+
+			for (size_t k = 0 ; k < dim ; k++)
+			{
+				d.set_d(k,key.get(k) - 1);
+				zero &= (d.get(k) == 0);
+			}
+
+			for (size_t s = 0 ; s < N && zero == false ; s++)
+			{
+				bool reach = true;
+
+				for (size_t k = 0 ; k < dim ; k++)
+				{
+					if ((d.get(k) > 0 && stencil[s][k] <= 0) || (d.get(k) < 0 && stencil[s][k] >= 0))
+					{reach = false;}
+				}
+
+				if (reach == true)
+				{
+					dirs.add(d);
+					break;
+				}
+			}
+
+			++it;
+		}
+	}
+
+	/*! \brief Load into the buffer the part of a chunk that fall into the border in direction d
+	 *
+	 * Not existing points are filled with the background value and a zero mask
+	 *
+	 * \param grid sparse grid
+	 * \param cid chunk to load, -1 if the chunk does not exist
+	 * \param d direction of the chunk (zero for the chunk itself)
+	 * \param sz size of the chunk
+	 * \param str_c strides of the chunk
+	 * \param str_b strides of the buffer
+	 * \param bck background value
+	 * \param buf buffer
+	 * \param mask buffer mask
+	 *
+	 */
+	template<unsigned int prop, unsigned int stencil_size, typename prop_type, typename SparseGridType>
+	static void load_region(SparseGridType & grid, long int cid, const grid_key_dx<dim> & d,
+			                const size_t (& sz)[dim], const long int (& str_c)[dim], const long int (& str_b)[dim],
+			                prop_type bck, prop_type * buf, unsigned char * mask)
+	{
+		long int src[dim];
+		long int dst[dim];
+		long int n[dim];
+		long int r[dim];
+
+		for (size_t k = 0 ; k < dim ; k++)
+		{
+			if (d.get(k) == 0)
+			{src[k] = 0; dst[k] = stencil_size; n[k] = sz[k];}
+			else if (d.get(k) > 0)
+			{src[k] = 0; dst[k] = stencil_size + sz[k]; n[k] = stencil_size;}
+			else
+			{src[k] = sz[k] - stencil_size; dst[k] = 0; n[k] = stencil_size;}
+
+			r[k] = 0;
+		}
+
+		auto & data = grid.private_get_data();
+		auto & header_mask = grid.private_get_header_mask();
+
+		// iterate across the rows of the region
+		while (true)
+		{
+			long int ic = src[0];
+			long int ib = dst[0];
+
+			for (size_t k = 1 ; k < dim ; k++)
+			{
+				ic += (src[k] + r[k])*str_c[k];
+				ib += (dst[k] + r[k])*str_b[k];
+			}
+
+			if (cid < 0)
+			{
+				for (long int x = 0 ; x < n[0] ; x++)
+				{
+					buf[ib+x] = bck;
+					mask[ib+x] = 0;
+				}
+			}
+			else
+			{
+				auto & h = header_mask.get(cid);
+				auto & ref_block = data.template get<prop>(cid);
+
+				exist_sub_row(h,ic,n[0],&mask[ib]);
+
+				for (long int x = 0 ; x < n[0] ; x++)
+				{buf[ib+x] = (mask[ib+x] != 0)?(prop_type)ref_block[ic+x]:bck;}
+			}
+
+			size_t k = 1;
+			for ( ; k < dim ; k++)
+			{
+				r[k]++;
+				if (r[k] < n[k])	{break;}
+				r[k] = 0;
+			}
+
+			if (k >= dim)	{break;}
+		}
+	}
+
+	/*! \brief apply a convolution on the points from start to stop
+	 *
+	 * func receive the center point and the N stencil points of a vector of points along x, together with the
+	 * number of existing stencil points of every lane. The result is stored for the existing points
+	 *
+	 * \param stencil offsets of the stencil points (each component not bigger than stencil_size)
+	 * \param start point
+	 * \param stop point
+	 * \param grid sparse grid
+	 * \param func function to apply
+	 * \param args arguments of the function
+	 *
+	 */
+	template<unsigned int prop_src, unsigned int prop_dst, unsigned int stencil_size , unsigned int N, typename SparseGridType, typename lambda_f, typename ... ArgsT >
+	static void conv(int (& stencil)[N][dim], const grid_key_dx<dim> & start, const grid_key_dx<dim> & stop, SparseGridType & grid , lambda_f func, ArgsT ... args)
+	{
+		typedef typename boost::mpl::at<typename SparseGridType::value_type::type, boost::mpl::int_<prop_src>>::type prop_type;
+
+		const int vs = Vc::Vector<prop_type>::Size;
+
+		size_t sz[dim];
+		copy_sz<dim,typename SparseGridType::chunking_type::type> cpsz(sz);
+		boost::mpl::for_each_ref< boost::mpl::range_c<int,0,dim> >(cpsz);
+
+		// strides of the chunk and of the chunk extended by the border
+		long int str_c[dim];
+		long int str_b[dim];
+		long int n_b = 1;
+
+		for (size_t k = 0 ; k < dim ; k++)
+		{
+			if (stencil_size > sz[k])
+			{
+				std::cerr << "Error " << __FILE__ << ":" << __LINE__ << " stencil_size " << stencil_size << " is bigger than the chunk size " << sz[k] << std::endl;
+				return;
+			}
+
+			str_c[k] = (k == 0)?1:str_c[k-1]*sz[k-1];
+			str_b[k] = (k == 0)?1:str_b[k-1]*(sz[k-1] + 2*stencil_size);
+			n_b *= sz[k] + 2*stencil_size;
+		}
+
+		long int off[N];
+
+		for (size_t s = 0 ; s < N ; s++)
+		{
+			off[s] = 0;
+
+			for (size_t k = 0 ; k < dim ; k++)
+			{
+				if (std::abs(stencil[s][k]) > (int)stencil_size)
+				{
+					std::cerr << "Error " << __FILE__ << ":" << __LINE__ << " the stencil point " << s << " is out of stencil_size " << stencil_size << std::endl;
+					return;
+				}
+
+				off[s] += stencil[s][k]*str_b[k];
+			}
+		}
+
+		openfpm::vector<grid_key_dx<dim>> dirs;
+		stencil_directions(stencil,dirs);
+
+		auto & data = grid.private_get_data();
+		auto & header_inf = grid.private_get_header_inf();
+
+		prop_type bck = data.template get<prop_src>(0)[0];
+
+		long int n_cnk = header_inf.size();
+
+		#pragma omp parallel if (n_cnk >= SGRID_OMP_MIN_CHUNKS)
+		{
+			// padded by one vector, so the last row can be loaded unaligned
+			openfpm::vector<prop_type> buf_v;
+			openfpm::vector<unsigned char> mask_v;
+			buf_v.resize(n_b + vs);
+			mask_v.resize(n_b + vs);
+
+			prop_type * buf = &buf_v.get(0);
+			unsigned char * mask = &mask_v.get(0);
+
+			for (long int b = n_b ; b < n_b + vs ; b++)
+			{
+				buf[b] = bck;
+				mask[b] = 0;
+			}
+
+			sgrid_chunk_cache<SGRID_CACHE> cc;
+
+			#pragma omp for schedule(dynamic,SGRID_OMP_CHUNK_BATCH)
+			for (long int i = 1 ; i < n_cnk ; i++)
+			{
+				if (header_inf.get(i).nele == 0)	{continue;}
+
+				// part of the chunk inside start and stop
+				long int lo[dim];
+				long int hi[dim];
+				bool empty = false;
+
+				for (size_t k = 0 ; k < dim ; k++)
+				{
+					long int p = header_inf.get(i).pos.get(k);
+					lo[k] = std::max((long int)start.get(k) - p,0l);
+					hi[k] = std::min((long int)stop.get(k) - p,(long int)sz[k] - 1);
+
+					empty |= (lo[k] > hi[k]);
+				}
+
+				if (empty == true)	{continue;}
+
+				grid_key_dx<dim> zero;
+				zero.zero();
+
+				load_region<prop_src,stencil_size>(grid,i,zero,sz,str_c,str_b,bck,buf,mask);
+
+				grid_key_dx<dim> cpos = grid.getChunkPos(i);
+
+				for (size_t j = 0 ; j < dirs.size() ; j++)
+				{
+					bool exist;
+					size_t nid = grid.getChunk(cpos + dirs.get(j),exist,cc);
+
+					load_region<prop_src,stencil_size>(grid,(exist == true)?(long int)nid:-1,dirs.get(j),sz,str_c,str_b,bck,buf,mask);
+				}
+
+				auto & ref_dst = data.template get<prop_dst>(i);
+
+				long int r[dim];
+				for (size_t k = 0 ; k < dim ; k++)
+				{r[k] = lo[k];}
+
+				while (true)
+				{
+					long int ic = lo[0];
+					long int ib = lo[0] + stencil_size;
+
+					for (size_t k = 1 ; k < dim ; k++)
+					{
+						ic += r[k]*str_c[k];
+						ib += (r[k] + stencil_size)*str_b[k];
+					}
+
+					for (long int x = lo[0] ; x <= hi[0] ; x += vs)
+					{
+						Vc::Mask<prop_type> cmp;
+
+						for (int l = 0 ; l < vs ; l++)
+						{cmp[l] = (x+l <= hi[0] && mask[ib+l] != 0);}
+
+						// we do only if exist the point
+						if (Vc::none_of(cmp) == false)
+						{
+							Vc::Vector<prop_type> xs[N+1];
+							unsigned char mask_sum[vs];
+
+							xs[0] = Vc::Vector<prop_type>(&buf[ib],Vc::Unaligned);
+
+							for (int l = 0 ; l < vs ; l++)
+							{mask_sum[l] = 0;}
+
+							for (size_t s = 0 ; s < N ; s++)
+							{
+								xs[s+1] = Vc::Vector<prop_type>(&buf[ib+off[s]],Vc::Unaligned);
+
+								for (int l = 0 ; l < vs ; l++)
+								{mask_sum[l] += mask[ib+off[s]+l];}
+							}
+
+							auto res = func(xs, mask_sum, args ...);
+
+							for (int l = 0 ; l < vs ; l++)
+							{
+								if (cmp[l] == true)
+								{ref_dst[ic+l] = res[l];}
+							}
+						}
+
+						ic += vs;
+						ib += vs;
+					}
+
+					size_t k = 1;
+					for ( ; k < dim ; k++)
+					{
+						r[k]++;
+						if (r[k] <= hi[k])	{break;}
+						r[k] = lo[k];
+					}
+
+					if (k >= dim)	{break;}
+				}
+			}
+		}
+	}
+};
+
 template<>
 struct conv_impl<3>
 {
 	template<bool findNN, typename NNtype, unsigned int prop_src, unsigned int prop_dst, unsigned int stencil_size , unsigned int N, typename SparseGridType, typename lambda_f, typename ... ArgsT >
 	static void conv(int (& stencil)[N][3], grid_key_dx<3> & start, grid_key_dx<3> & stop, SparseGridType & grid , lambda_f func, ArgsT ... args)
 	{
-		auto it = grid.template getBlockIterator<stencil_size>(start,stop);
+		// the face neighborhood chunks are not enough for stencils that reach the edges or the corners
+		if (conv_gen_impl<3>::is_star(stencil) == false)
+		{
+			conv_gen_impl<3>::template conv<prop_src,prop_dst,stencil_size>(stencil,start,stop,grid,func,args...);
+			return;
+		}
 
-		typedef typename boost::mpl::at<typename SparseGridType::value_type::type, boost::mpl::int_<prop_src>>::type prop_type;
+		typedef decltype(grid.template getBlockIterator<stencil_size>(start,stop)) it_type;
+
+		if (findNN == false)	{grid.template construct_NNlist<NNtype>();}
 
-		unsigned char mask[decltype(it)::sizeBlockBord];
-		unsigned char mask_sum[decltype(it)::sizeBlockBord];
-		unsigned char mask_unused[decltype(it)::sizeBlock];
-		__attribute__ ((aligned (32))) prop_type block_bord_src[decltype(it)::sizeBlockBord];
-		__attribute__ ((aligned (32))) prop_type block_bord_dst[decltype(it)::sizeBlock];
+		typedef typename boost::mpl::at<typename SparseGridType::value_type::type, boost::mpl::int_<prop_src>>::type prop_type;
 
-		typedef typename boost::mpl::at<typename decltype(it)::stop_border_vmpl,boost::mpl::int_<0>>::type sz0;
-		typedef typename boost::mpl::at<typename decltype(it)::stop_border_vmpl,boost::mpl::int_<1>>::type sz1;
-		typedef typename boost::mpl::at<typename decltype(it)::stop_border_vmpl,boost::mpl::int_<2>>::type sz2;
+		typedef typename boost::mpl::at<typename it_type::stop_border_vmpl,boost::mpl::int_<0>>::type sz0;
+		typedef typename boost::mpl::at<typename it_type::stop_border_vmpl,boost::mpl::int_<1>>::type sz1;
+		typedef typename boost::mpl::at<typename it_type::stop_border_vmpl,boost::mpl::int_<2>>::type sz2;
 
-		while (it.isNext())
+		grid.template forEachBlock<stencil_size>(start,stop,[&](it_type & it)
 		{
-			it.template loadBlockBorder<prop_src,NNtype,findNN>(block_bord_src,mask);
+			unsigned char mask[it_type::sizeBlockBord];
+			unsigned char mask_sum[it_type::sizeBlockBord];
+			unsigned char mask_unused[it_type::sizeBlock];
+			__attribute__ ((aligned (32))) prop_type block_bord_src[it_type::sizeBlockBord];
+			__attribute__ ((aligned (32))) prop_type block_bord_dst[it_type::sizeBlock];
+
+			it.template loadBlockBorder<prop_src,NNtype,true>(block_bord_src,mask);
 
 			if (it.start_b(2) != stencil_size || it.start_b(1) != stencil_size || it.start_b(0) != stencil_size ||
 			    it.stop_b(2) != sz2::value+stencil_size || it.stop_b(1) != sz1::value+stencil_size || it.stop_b(0) != sz0::value+stencil_size)
@@ -241,7 +615,7 @@ struct conv_impl<3>
 				auto & header_mask = grid.private_get_header_mask();
 				auto & header_inf = grid.private_get_header_inf();
 
-				loadBlock_impl<prop_dst,0,3,typename decltype(it)::vector_blocks_exts_type, typename decltype(it)::vector_ext_type>::template loadBlock<decltype(it)::sizeBlock>(block_bord_dst,grid,it.getChunkId(),mask_unused);
+				loadBlock_impl<prop_dst,0,3,typename it_type::vector_blocks_exts_type, typename it_type::vector_ext_type>::template loadBlock<it_type::sizeBlock>(block_bord_dst,grid,it.getChunkId(),mask_unused);
 			}
 
 			// Sum the mask
@@ -341,28 +715,25 @@ struct conv_impl<3>
 			}
 
 			it.template storeBlock<prop_dst>(block_bord_dst);
-
-			++it;
-		}
+		});
 	}
 
 	template<bool findNN, unsigned int prop_src, unsigned int prop_dst, unsigned int stencil_size, typename SparseGridType, typename lambda_f, typename ... ArgsT >
 	static void conv_cross(grid_key_dx<3> & start, grid_key_dx<3> & stop, SparseGridType & grid , lambda_f func, ArgsT ... args)
 	{
-		auto it = grid.template getBlockIterator<1>(start,stop);
+		typedef decltype(grid.template getBlockIterator<1>(start,stop)) it_type;
+
+		if (findNN == false)	{grid.template construct_NNlist<NNStar_c<3>>();}
 
 		auto & datas = grid.private_get_data();
 		auto & headers = grid.private_get_header_mask();
-
-		typedef typename boost::mpl::at<typename decltype(it)::stop_border_vmpl,boost::mpl::int_<0>>::type sz0;
-		typedef typename boost::mpl::at<typename decltype(it)::stop_border_vmpl,boost::mpl::int_<1>>::type sz1;
-		typedef typename boost::mpl::at<typename decltype(it)::stop_border_vmpl,boost::mpl::int_<2>>::type sz2;
+		auto & NNlist = grid.private_get_nnlist();
 
 		typedef typename SparseGridType::chunking_type chunking;
 
 		typedef typename boost::mpl::at<typename SparseGridType::value_type::type, boost::mpl::int_<prop_src>>::type prop_type;
 
-		while (it.isNext())
+		grid.template forEachBlock<1>(start,stop,[&](it_type & it)
 		{
 			// Load
 			long int offset_jump[6];
@@ -370,32 +741,13 @@ struct conv_impl<3>
 			size_t cid = it.getChunkId();
 
 			auto chunk = datas.get(cid);
-			auto & mask = headers.get(cid);
-
-			bool exist;
-			grid_key_dx<3> p = grid.getChunkPos(cid) + grid_key_dx<3>({-1,0,0});
-			long int r = grid.getChunk(p,exist);
-			offset_jump[0] = (r-cid)*decltype(it)::sizeBlock;
-
-			p = grid.getChunkPos(cid) + grid_key_dx<3>({1,0,0});
-			r = grid.getChunk(p,exist);
-			offset_jump[1] = (r-cid)*decltype(it)::sizeBlock;
-
-			p = grid.getChunkPos(cid) + grid_key_dx<3>({0,-1,0});
-			r = grid.getChunk(p,exist);
-			offset_jump[2] = (r-cid)*decltype(it)::sizeBlock;
-
-			p = grid.getChunkPos(cid) + grid_key_dx<3>({0,1,0});
-			r = grid.getChunk(p,exist);
-			offset_jump[3] = (r-cid)*decltype(it)::sizeBlock;
-
-			p = grid.getChunkPos(cid) + grid_key_dx<3>({0,0,-1});
-			r = grid.getChunk(p,exist);
-			offset_jump[4] = (r-cid)*decltype(it)::sizeBlock;
 
-			p = grid.getChunkPos(cid) + grid_key_dx<3>({0,0,1});
-			r = grid.getChunk(p,exist);
-			offset_jump[5] = (r-cid)*decltype(it)::sizeBlock;
+			// neighborhood chunks (NNStar_c order +z,-z,+y,-y,+x,-x), the background chunk when it does not exist
+			for (int s = 0 ; s < 6 ; s++)
+			{
+				long int r = NNlist.template get<0>(cid*NNStar_c<3>::nNN + 5 - s);
+				offset_jump[s] = (((r == -1)?0:r) - (long int)cid)*it_type::sizeBlock;
+			}
 
 			// Load offset jumps
 
@@ -423,7 +775,7 @@ struct conv_impl<3>
 					for (int k = 0 ; k < sx::value ; k += Vc::Vector<prop_type>::Size)
 					{
 						// we do only id exist the point
-						if (*(typename data_il<Vc::Vector<prop_type>::Size>::type *)&mask.mask[s2] == 0) {s2 += Vc::Vector<prop_type>::Size; continue;}
+						if (load_mask_bytes<typename data_il<Vc::Vector<prop_type>::Size>::type>(headers,cid,s2) == 0) {s2 += Vc::Vector<prop_type>::Size; continue;}
 
 						data_il<Vc::Vector<prop_type>::Size> mxm;
 						data_il<Vc::Vector<prop_type>::Size> mxp;
@@ -455,19 +807,19 @@ struct conv_impl<3>
 
 						if (Vc::Vector<prop_type>::Size == 2 || Vc::Vector<prop_type>::Size == 4 || Vc::Vector<prop_type>::Size == 8)
 						{
-							mxm.i = *(typename data_il<Vc::Vector<prop_type>::Size>::type *)&mask.mask[s2];
+							mxm.i = load_mask_bytes<typename data_il<Vc::Vector<prop_type>::Size>::type>(headers,cid,s2);
 							mxm.i = mxm.i << 8;
-							mxm.i |= (typename data_il<Vc::Vector<prop_type>::Size>::type)mask.mask[sumxm];
+							mxm.i |= (typename data_il<Vc::Vector<prop_type>::Size>::type)load_mask_bytes<unsigned char>(headers,cid,sumxm);
 
-							mxp.i = *(typename data_il<Vc::Vector<prop_type>::Size>::type *)&mask.mask[s2];
+							mxp.i = load_mask_bytes<typename data_il<Vc::Vector<prop_type>::Size>::type>(headers,cid,s2);
 							mxp.i = mxp.i >> 8;
-							mxp.i |= ((typename data_il<Vc::Vector<prop_type>::Size>::type)mask.mask[sumxp]) << (Vc::Vector<prop_type>::Size - 1)*8;
+							mxp.i |= ((typename data_il<Vc::Vector<prop_type>::Size>::type)load_mask_bytes<unsigned char>(headers,cid,sumxp)) << (Vc::Vector<prop_type>::Size - 1)*8;
 
-							mym.i = *(typename data_il<Vc::Vector<prop_type>::Size>::type *)&mask.mask[sumym];
-							myp.i = *(typename data_il<Vc::Vector<prop_type>::Size>::type *)&mask.mask[sumyp];
+							mym.i = load_mask_bytes<typename data_il<Vc::Vector<prop_type>::Size>::type>(headers,cid,sumym);
+							myp.i = load_mask_bytes<typename data_il<Vc::Vector<prop_type>::Size>::type>(headers,cid,sumyp);
 
-							mzm.i = *(typename data_il<Vc::Vector<prop_type>::Size>::type *)&mask.mask[sumzm];
-							mzp.i = *(typename data_il<Vc::Vector<prop_type>::Size>::type *)&mask.mask[sumzp];
+							mzm.i = load_mask_bytes<typename data_il<Vc::Vector<prop_type>::Size>::type>(headers,cid,sumzm);
+							mzp.i = load_mask_bytes<typename data_il<Vc::Vector<prop_type>::Size>::type>(headers,cid,sumzp);
 						}
 						else
 						{
@@ -505,9 +857,7 @@ struct conv_impl<3>
 					}
 				}
 			}
-
-			++it;
-		}
+		});
 	}
 
 
@@ -517,25 +867,23 @@ struct conv_impl<3>
 			 typename SparseGridType, typename lambda_f, typename ... ArgsT >
 	static void conv2(int (& stencil)[N][3], grid_key_dx<3> & start, grid_key_dx<3> & stop, SparseGridType & grid , lambda_f func, ArgsT ... args)
 	{
-		auto it = grid.template getBlockIterator<stencil_size>(start,stop);
-
-		typedef typename boost::mpl::at<typename SparseGridType::value_type::type, boost::mpl::int_<prop_src1>>::type prop_type;
+		typedef decltype(grid.template getBlockIterator<stencil_size>(start,stop)) it_type;
 
-		unsigned char mask[decltype(it)::sizeBlockBord];
-		unsigned char mask_sum[decltype(it)::sizeBlockBord];
-		__attribute__ ((aligned (64))) prop_type block_bord_src1[decltype(it)::sizeBlockBord];
-		__attribute__ ((aligned (64))) prop_type block_bord_dst1[decltype(it)::sizeBlock+16];
-		__attribute__ ((aligned (64))) prop_type block_bord_src2[decltype(it)::sizeBlockBord];
-		__attribute__ ((aligned (64))) prop_type block_bord_dst2[decltype(it)::sizeBlock+16];
+		if (findNN == false)	{grid.template construct_NNlist<NNType>();}
 
-		typedef typename boost::mpl::at<typename decltype(it)::stop_border_vmpl,boost::mpl::int_<0>>::type sz0;
-		typedef typename boost::mpl::at<typename decltype(it)::stop_border_vmpl,boost::mpl::int_<1>>::type sz1;
-		typedef typename boost::mpl::at<typename decltype(it)::stop_border_vmpl,boost::mpl::int_<2>>::type sz2;
+		typedef typename boost::mpl::at<typename SparseGridType::value_type::type, boost::mpl::int_<prop_src1>>::type prop_type;
 
-		while (it.isNext())
+		grid.template forEachBlock<stencil_size>(start,stop,[&](it_type & it)
 		{
-			it.template loadBlockBorder<prop_src1,NNType,findNN>(block_bord_src1,mask);
-			it.template loadBlockBorder<prop_src2,NNType,findNN>(block_bord_src2,mask);
+			unsigned char mask[it_type::sizeBlockBord];
+			unsigned char mask_sum[it_type::sizeBlockBord];
+			__attribute__ ((aligned (64))) prop_type block_bord_src1[it_type::sizeBlockBord];
+			__attribute__ ((aligned (64))) prop_type block_bord_dst1[it_type::sizeBlock+16];
+			__attribute__ ((aligned (64))) prop_type block_bord_src2[it_type::sizeBlockBord];
+			__attribute__ ((aligned (64))) prop_type block_bord_dst2[it_type::sizeBlock+16];
+
+			it.template loadBlockBorder<prop_src1,NNType,true>(block_bord_src1,mask);
+			it.template loadBlockBorder<prop_src2,NNType,true>(block_bord_src2,mask);
 
 			// Sum the mask
 			for (int k = it.start_b(2) ; k < it.stop_b(2) ; k++)
@@ -641,28 +989,25 @@ struct conv_impl<3>
 
 			it.template storeBlock<prop_dst1>(block_bord_dst1);
 			it.template storeBlock<prop_dst2>(block_bord_dst2);
-
-			++it;
-		}
+		});
 	}
 
 	template<bool findNN, unsigned int prop_src1, unsigned int prop_src2, unsigned int prop_dst1, unsigned int prop_dst2, unsigned int stencil_size, typename SparseGridType, typename lambda_f, typename ... ArgsT >
 	static void conv_cross2(grid_key_dx<3> & start, grid_key_dx<3> & stop, SparseGridType & grid , lambda_f func, ArgsT ... args)
 	{
-		auto it = grid.template getBlockIterator<stencil_size>(start,stop);
+		typedef decltype(grid.template getBlockIterator<stencil_size>(start,stop)) it_type;
+
+		if (findNN == false)	{grid.template construct_NNlist<NNStar_c<3>>();}
 
 		auto & datas = grid.private_get_data();
 		auto & headers = grid.private_get_header_mask();
-
-		typedef typename boost::mpl::at<typename decltype(it)::stop_border_vmpl,boost::mpl::int_<0>>::type sz0;
-		typedef typename boost::mpl::at<typename decltype(it)::stop_border_vmpl,boost::mpl::int_<1>>::type sz1;
-		typedef typename boost::mpl::at<typename decltype(it)::stop_border_vmpl,boost::mpl::int_<2>>::type sz2;
+		auto & NNlist = grid.private_get_nnlist();
 
 		typedef typename SparseGridType::chunking_type chunking;
 
 		typedef typename boost::mpl::at<typename SparseGridType::value_type::type, boost::mpl::int_<prop_src1>>::type prop_type;
 
-		while (it.isNext())
+		grid.template forEachBlock<stencil_size>(start,stop,[&](it_type & it)
 		{
 			// Load
 			long int offset_jump[6];
@@ -670,32 +1015,13 @@ struct conv_impl<3>
 			size_t cid = it.getChunkId();
 
 			auto chunk = datas.get(cid);
-			auto & mask = headers.get(cid);
-
-			bool exist;
-			grid_key_dx<3> p = grid.getChunkPos(cid) + grid_key_dx<3>({-1,0,0});
-			long int r = grid.getChunk(p,exist);
-			offset_jump[0] = (r-cid)*decltype(it)::sizeBlock;
-
-			p = grid.getChunkPos(cid) + grid_key_dx<3>({1,0,0});
-			r = grid.getChunk(p,exist);
-			offset_jump[1] = (r-cid)*decltype(it)::sizeBlock;
-
-			p = grid.getChunkPos(cid) + grid_key_dx<3>({0,-1,0});
-			r = grid.getChunk(p,exist);
-			offset_jump[2] = (r-cid)*decltype(it)::sizeBlock;
-
-			p = grid.getChunkPos(cid) + grid_key_dx<3>({0,1,0});
-			r = grid.getChunk(p,exist);
-			offset_jump[3] = (r-cid)*decltype(it)::sizeBlock;
 
-			p = grid.getChunkPos(cid) + grid_key_dx<3>({0,0,-1});
-			r = grid.getChunk(p,exist);
-			offset_jump[4] = (r-cid)*decltype(it)::sizeBlock;
-
-			p = grid.getChunkPos(cid) + grid_key_dx<3>({0,0,1});
-			r = grid.getChunk(p,exist);
-			offset_jump[5] = (r-cid)*decltype(it)::sizeBlock;
+			// neighborhood chunks (NNStar_c order +z,-z,+y,-y,+x,-x), the background chunk when it does not exist
+			for (int s = 0 ; s < 6 ; s++)
+			{
+				long int r = NNlist.template get<0>(cid*NNStar_c<3>::nNN + 5 - s);
+				offset_jump[s] = (((r == -1)?0:r) - (long int)cid)*it_type::sizeBlock;
+			}
 
 			// Load offset jumps
 
@@ -723,7 +1049,7 @@ struct conv_impl<3>
 					for (int k = 0 ; k < sx::value ; k += Vc::Vector<prop_type>::Size)
 					{
 						// we do only id exist the point
-						if (*(typename data_il<Vc::Vector<prop_type>::Size>::type *)&mask.mask[s2] == 0) {s2 += Vc::Vector<prop_type>::Size; continue;}
+						if (load_mask_bytes<typename data_il<Vc::Vector<prop_type>::Size>::type>(headers,cid,s2) == 0) {s2 += Vc::Vector<prop_type>::Size; continue;}
 
 						data_il<4> mxm;
 						data_il<4> mxp;
@@ -757,19 +1083,19 @@ struct conv_impl<3>
 
 						if (Vc::Vector<prop_type>::Size == 1 || Vc::Vector<prop_type>::Size == 2 || Vc::Vector<prop_type>::Size == 4 || Vc::Vector<prop_type>::Size == 8)
 						{
-							mxm.i = *(typename data_il<Vc::Vector<prop_type>::Size>::type *)&mask.mask[s2];
+							mxm.i = load_mask_bytes<typename data_il<Vc::Vector<prop_type>::Size>::type>(headers,cid,s2);
 							mxm.i = mxm.i << 8;
-							mxm.i |= (typename data_il<Vc::Vector<prop_type>::Size>::type)mask.mask[sumxm];
+							mxm.i |= (typename data_il<Vc::Vector<prop_type>::Size>::type)load_mask_bytes<unsigned char>(headers,cid,sumxm);
 
-							mxp.i = *(typename data_il<Vc::Vector<prop_type>::Size>::type *)&mask.mask[s2];
+							mxp.i = load_mask_bytes<typename data_il<Vc::Vector<prop_type>::Size>::type>(headers,cid,s2);
 							mxp.i = mxp.i >> 8;
-							mxp.i |= ((typename data_il<Vc::Vector<prop_type>::Size>::type)mask.mask[sumxp]) << (Vc::Vector<prop_type>::Size - 1)*8;
+							mxp.i |= ((typename data_il<Vc::Vector<prop_type>::Size>::type)load_mask_bytes<unsigned char>(headers,cid,sumxp)) << (Vc::Vector<prop_type>::Size - 1)*8;
 
-							mym.i = *(typename data_il<Vc::Vector<prop_type>::Size>::type *)&mask.mask[sumym];
-							myp.i = *(typename data_il<Vc::Vector<prop_type>::Size>::type *)&mask.mask[sumyp];
+							mym.i = load_mask_bytes<typename data_il<Vc::Vector<prop_type>::Size>::type>(headers,cid,sumym);
+							myp.i = load_mask_bytes<typename data_il<Vc::Vector<prop_type>::Size>::type>(headers,cid,sumyp);
 
-							mzm.i = *(typename data_il<Vc::Vector<prop_type>::Size>::type *)&mask.mask[sumzm];
-							mzp.i = *(typename data_il<Vc::Vector<prop_type>::Size>::type *)&mask.mask[sumzp];
+							mzm.i = load_mask_bytes<typename data_il<Vc::Vector<prop_type>::Size>::type>(headers,cid,sumzm);
+							mzp.i = load_mask_bytes<typename data_il<Vc::Vector<prop_type>::Size>::type>(headers,cid,sumzp);
 						}
 
 						cs1.xm = cmd1;
@@ -819,26 +1145,23 @@ struct conv_impl<3>
 					}
 				}
 			}
-
-			++it;
-		}
+		});
 	}
 
 	template<bool findNN, unsigned int stencil_size, typename prop_type, typename SparseGridType, typename lambda_f, typename ... ArgsT >
 	static void conv_cross_ids(grid_key_dx<3> & start, grid_key_dx<3> & stop, SparseGridType & grid , lambda_f func, ArgsT ... args)
 	{
-		auto it = grid.template getBlockIterator<stencil_size>(start,stop);
+		typedef decltype(grid.template getBlockIterator<stencil_size>(start,stop)) it_type;
+
+		if (findNN == false)	{grid.template construct_NNlist<NNStar_c<3>>();}
 
 		auto & datas = grid.private_get_data();
 		auto & headers = grid.private_get_header_mask();
-
-		typedef typename boost::mpl::at<typename decltype(it)::stop_border_vmpl,boost::mpl::int_<0>>::type sz0;
-		typedef typename boost::mpl::at<typename decltype(it)::stop_border_vmpl,boost::mpl::int_<1>>::type sz1;
-		typedef typename boost::mpl::at<typename decltype(it)::stop_border_vmpl,boost::mpl::int_<2>>::type sz2;
+		auto & NNlist = grid.private_get_nnlist();
 
 		typedef typename SparseGridType::chunking_type chunking;
 
-		while (it.isNext())
+		grid.template forEachBlock<stencil_size>(start,stop,[&](it_type & it)
 		{
 			// Load
 			long int offset_jump[6];
@@ -846,32 +1169,13 @@ struct conv_impl<3>
 			size_t cid = it.getChunkId();
 
 			auto chunk = datas.get(cid);
-			auto & mask = headers.get(cid);
-
-			bool exist;
-			grid_key_dx<3> p = grid.getChunkPos(cid) + grid_key_dx<3>({-1,0,0});
-			long int r = grid.getChunk(p,exist);
-			offset_jump[0] = (r-cid)*decltype(it)::sizeBlock;
-
-			p = grid.getChunkPos(cid) + grid_key_dx<3>({1,0,0});
-			r = grid.getChunk(p,exist);
-			offset_jump[1] = (r-cid)*decltype(it)::sizeBlock;
-
-			p = grid.getChunkPos(cid) + grid_key_dx<3>({0,-1,0});
-			r = grid.getChunk(p,exist);
-			offset_jump[2] = (r-cid)*decltype(it)::sizeBlock;
-
-			p = grid.getChunkPos(cid) + grid_key_dx<3>({0,1,0});
-			r = grid.getChunk(p,exist);
-			offset_jump[3] = (r-cid)*decltype(it)::sizeBlock;
 
-			p = grid.getChunkPos(cid) + grid_key_dx<3>({0,0,-1});
-			r = grid.getChunk(p,exist);
-			offset_jump[4] = (r-cid)*decltype(it)::sizeBlock;
-
-			p = grid.getChunkPos(cid) + grid_key_dx<3>({0,0,1});
-			r = grid.getChunk(p,exist);
-			offset_jump[5] = (r-cid)*decltype(it)::sizeBlock;
+			// neighborhood chunks (NNStar_c order +z,-z,+y,-y,+x,-x), the background chunk when it does not exist
+			for (int s = 0 ; s < 6 ; s++)
+			{
+				long int r = NNlist.template get<0>(cid*NNStar_c<3>::nNN + 5 - s);
+				offset_jump[s] = (((r == -1)?0:r) - (long int)cid)*it_type::sizeBlock;
+			}
 
 			// Load offset jumps
 
@@ -898,7 +1202,7 @@ struct conv_impl<3>
 					for (int k = 0 ; k < sx::value ; k += Vc::Vector<prop_type>::Size)
 					{
 						// we do only id exist the point
-						if (*(int *)&mask.mask[s2] == 0) {s2 += Vc::Vector<prop_type>::Size; continue;}
+						if (load_mask_bytes<int>(headers,cid,s2) == 0) {s2 += Vc::Vector<prop_type>::Size; continue;}
 
 						data_il<4> mxm;
 						data_il<4> mxp;
@@ -930,35 +1234,35 @@ struct conv_impl<3>
 
                         if (Vc::Vector<prop_type>::Size == 2)
                         {
-                            mxm.i = *(short int *)&mask.mask[s2];
+                            mxm.i = load_mask_bytes<short int>(headers,cid,s2);
                             mxm.i = mxm.i << 8;
-                            mxm.i |= (short int)mask.mask[ids.sumdm[0]];
+                            mxm.i |= (short int)load_mask_bytes<unsigned char>(headers,cid,ids.sumdm[0]);
 
-                            mxp.i = *(short int *)&mask.mask[s2];
+                            mxp.i = load_mask_bytes<short int>(headers,cid,s2);
                             mxp.i = mxp.i >> 8;
-                            mxp.i |= ((short int)mask.mask[ids.sumdp[0]]) << (Vc::Vector<prop_type>::Size - 1)*8;
+                            mxp.i |= ((short int)load_mask_bytes<unsigned char>(headers,cid,ids.sumdp[0])) << (Vc::Vector<prop_type>::Size - 1)*8;
 
-                            mym.i = *(short int *)&mask.mask[ids.sumdm[1]];
-                            myp.i = *(short int *)&mask.mask[ids.sumdp[1]];
+                            mym.i = load_mask_bytes<short int>(headers,cid,ids.sumdm[1]);
+                            myp.i = load_mask_bytes<short int>(headers,cid,ids.sumdp[1]);
 
-                            mzm.i = *(short int *)&mask.mask[ids.sumdm[2]];
-                            mzp.i = *(short int *)&mask.mask[ids.sumdp[2]];
+                            mzm.i = load_mask_bytes<short int>(headers,cid,ids.sumdm[2]);
+                            mzp.i = load_mask_bytes<short int>(headers,cid,ids.sumdp[2]);
                         }
                         else if (Vc::Vector<prop_type>::Size == 4)
                         {
-                            mxm.i = *(int *)&mask.mask[s2];
+                            mxm.i = load_mask_bytes<int>(headers,cid,s2);
                             mxm.i = mxm.i << 8;
-                            mxm.i |= (int)mask.mask[ids.sumdm[0]];
+                            mxm.i |= (int)load_mask_bytes<unsigned char>(headers,cid,ids.sumdm[0]);
 
-                            mxp.i = *(int *)&mask.mask[s2];
+                            mxp.i = load_mask_bytes<int>(headers,cid,s2);
                             mxp.i = mxp.i >> 8;
-                            mxp.i |= ((int)mask.mask[ids.sumdp[0]]) << (Vc::Vector<prop_type>::Size - 1)*8;
+                            mxp.i |= ((int)load_mask_bytes<unsigned char>(headers,cid,ids.sumdp[0])) << (Vc::Vector<prop_type>::Size - 1)*8;
 
-                        	mym.i = *(int *)&mask.mask[ids.sumdm[1]];
-                            myp.i = *(int *)&mask.mask[ids.sumdp[1]];
+                        	mym.i = load_mask_bytes<int>(headers,cid,ids.sumdm[1]);
+                            myp.i = load_mask_bytes<int>(headers,cid,ids.sumdp[1]);
 
-                        	mzm.i = *(int *)&mask.mask[ids.sumdm[2]];
-                            mzp.i = *(int *)&mask.mask[ids.sumdp[2]];
+                        	mzm.i = load_mask_bytes<int>(headers,cid,ids.sumdm[2]);
+                            mzp.i = load_mask_bytes<int>(headers,cid,ids.sumdp[2]);
                         }
                         else
                         {
@@ -976,9 +1280,7 @@ struct conv_impl<3>
 					}
 				}
 			}
-
-			++it;
-		}
+		});
 	}
 
 };
@@ -8,6 +8,12 @@
 #ifndef OPENFPM_DATA_SRC_SPARSEGRID_SPARSEGRID_ITERATOR_HPP_
 #define OPENFPM_DATA_SRC_SPARSEGRID_SPARSEGRID_ITERATOR_HPP_
 
+#include "util/common.hpp"
+
+#ifdef __BMI2__
+#include <immintrin.h>
+#endif
+
 /*! \brief It store the position in space of the sparse grid
  *
  * linearized index
@@ -110,6 +116,79 @@ inline void fill_mask_box(short unsigned int (& mask_it)[n_ele],
 	}
 }
 
+template<unsigned int n_ele>
+class sgrid_bit_mask;
+
+/*! \brief This function fill the set of all non zero elements, the mask is packed in bits
+ *
+ * The elements set are found word by word with count trailing zeros
+ *
+ */
+template<unsigned int n_ele>
+inline void fill_mask(short unsigned int (& mask_it)[n_ele],
+		       const sgrid_bit_mask<n_ele> & mask,
+		       int & mask_nele)
+{
+	mask_nele = 0;
+
+	for (size_t i = 0 ; i < sgrid_bit_mask<n_ele>::n_words ; i++)
+	{
+		uint64_t w = mask.word(i);
+
+		while (w != 0)
+		{
+			mask_it[mask_nele] = i*64 + __builtin_ctzll(w);
+			mask_nele++;
+
+			w &= w - 1;
+		}
+	}
+}
+
+/*! \brief This function fill the set of all non zero elements, the mask is packed in bits
+ *
+ *
+ */
+template<unsigned int dim, unsigned int n_ele>
+inline void fill_mask_box(short unsigned int (& mask_it)[n_ele],
+		       const sgrid_bit_mask<n_ele> & mask,
+		       size_t & mask_nele,
+			   Box<dim,size_t> & bx,
+			   const grid_key_dx<dim> (& loc_grid)[n_ele])
+{
+	mask_nele = 0;
+
+	for (size_t i = 0 ; i < sgrid_bit_mask<n_ele>::n_words ; i++)
+	{
+		uint64_t w = mask.word(i);
+
+		while (w != 0)
+		{
+			size_t id = i*64 + __builtin_ctzll(w);
+			w &= w - 1;
+
+			bool is_inside = true;
+			// we check the point is inside inte
+			for (size_t j = 0 ; j < dim ; j++)
+			{
+				if (loc_grid[id].get(j) < (long int)bx.getLow(j) ||
+					loc_grid[id].get(j) > (long int)bx.getHigh(j))
+				{
+					is_inside = false;
+
+					break;
+				}
+			}
+
+			if (is_inside == true)
+			{
+				mask_it[mask_nele] = id;
+				mask_nele++;
+			}
+		}
+	}
+}
+
 /*! \brief This structure contain the information of a chunk
  *
  * \tparam dim dimensionality of the chunk
@@ -123,6 +202,209 @@ struct mheader
 	unsigned char mask[n_ele];
 };
 
+/*! \brief Occupancy of the elements of a chunk packed in bits (one bit for each element)
+ *
+ * It can be accessed like the byte mask of mheader, mask[i] return a reference to the bit
+ *
+ * \tparam n_ele number of elements in the chunk
+ *
+ */
+template<unsigned int n_ele>
+class sgrid_bit_mask
+{
+public:
+
+	//! number of elements
+	static const unsigned int n_bits = n_ele;
+
+	//! number of words
+	static const unsigned int n_words = (n_ele + 63) / 64;
+
+private:
+
+	//! bits
+	uint64_t bits[n_words];
+
+public:
+
+	//! Reference to a bit of the mask
+	class bit_ref
+	{
+		//! word containing the bit
+		uint64_t & w;
+
+		//! bit
+		uint64_t b;
+
+	public:
+
+		inline bit_ref(uint64_t & w, uint64_t b)
+		:w(w),b(b)
+		{}
+
+		inline operator unsigned char() const
+		{
+			return (w & b) != 0;
+		}
+
+		inline bit_ref & operator=(unsigned char v)
+		{
+			w = (v & 1)?(w | b):(w & ~b);
+			return *this;
+		}
+
+		inline bit_ref & operator=(const bit_ref & r)
+		{
+			return operator=((unsigned char)r);
+		}
+
+		inline bit_ref & operator|=(unsigned char v)
+		{
+			w = (v & 1)?(w | b):w;
+			return *this;
+		}
+
+		inline bit_ref & operator&=(unsigned char v)
+		{
+			w = (v & 1)?w:(w & ~b);
+			return *this;
+		}
+	};
+
+	inline bit_ref operator[](size_t i)
+	{
+		return bit_ref(bits[i >> 6],(uint64_t)1 << (i & 63));
+	}
+
+	inline unsigned char operator[](size_t i) const
+	{
+		return (bits[i >> 6] >> (i & 63)) & 1;
+	}
+
+	/*! \brief Return the word i of the mask
+	 *
+	 * \param i word
+	 *
+	 * \return the word
+	 *
+	 */
+	inline uint64_t word(size_t i) const
+	{
+		return bits[i];
+	}
+
+	/*! \brief Number of elements set
+	 *
+	 * \return the number of elements set
+	 *
+	 */
+	inline size_t count() const
+	{
+		size_t c = 0;
+
+		for (size_t i = 0 ; i < n_words ; i++)
+		{c += __builtin_popcountll(bits[i]);}
+
+		return c;
+	}
+
+	/*! \brief Expand the bits [start,start+n) into one byte (0 or 1) for each element
+	 *
+	 * 8 bits are expanded at time into a 64 bit word
+	 *
+	 * \param out output
+	 * \param start first element
+	 * \param n number of elements
+	 *
+	 */
+	inline void expand(unsigned char * out, size_t start, size_t n) const
+	{
+		size_t i = 0;
+
+		for ( ; i + 8 <= n ; i += 8)
+		{
+			size_t id = start + i;
+			uint64_t b = bits[id >> 6] >> (id & 63);
+
+			// the 8 bits can cross the word
+			if ((id & 63) > 56)	{b |= bits[(id >> 6) + 1] << (64 - (id & 63));}
+
+#ifdef __BMI2__
+			uint64_t e = _pdep_u64(b & 0xFF,0x0101010101010101ull);
+#else
+			uint64_t e = ((b & 0xFF) * 0x0101010101010101ull) & 0x8040201008040201ull;
+			e = ((e + 0x7F7F7F7F7F7F7F7Full) >> 7) & 0x0101010101010101ull;
+#endif
+
+			memcpy(&out[i],&e,sizeof(uint64_t));
+		}
+
+		for ( ; i < n ; i++)
+		{out[i] = operator[](start + i);}
+	}
+};
+
+/*! \brief This structure contain the information of a chunk, with the mask packed in bits
+ *
+ * \tparam n_ele number of elements in the chunk
+ *
+ */
+template<unsigned int n_ele>
+struct mheader_bit
+{
+	//! which elements in the chunks are set (one bit for each element)
+	sgrid_bit_mask<n_ele> mask;
+};
+
+/*! \brief Select the header of the chunk mask from the chunking
+ *
+ * It is mheader (one byte for each element) unless the chunking define bit_mask as true
+ *
+ * \tparam chunking chunking
+ *
+ */
+template<typename chunking, typename Sfinae = void>
+struct sgrid_mheader
+{
+	//! header
+	typedef mheader<chunking::size::value> type;
+};
+
+template<typename chunking>
+struct sgrid_mheader<chunking,typename Void<typename chunking::bit_mask>::type>
+{
+	//! header
+	typedef typename std::conditional<chunking::bit_mask::value,
+			                          mheader_bit<chunking::size::value>,
+			                          mheader<chunking::size::value>>::type type;
+};
+
+/*! \brief Indicate if the header of the chunk mask is packed in bits
+ *
+ * \tparam headerType header of the chunk mask
+ *
+ */
+template<typename headerType>
+struct is_mheader_bit
+{
+	//! false for one byte for each element
+	static const bool value = false;
+};
+
+template<unsigned int n_ele>
+struct is_mheader_bit<mheader_bit<n_ele>>
+{
+	//! packed in bits
+	static const bool value = true;
+};
+
+template<unsigned int n_ele>
+struct is_mheader_bit<const mheader_bit<n_ele>>
+{
+	//! packed in bits
+	static const bool value = true;
+};
+
 
 /*! \brief This structure contain the information of a chunk
  *
@@ -144,7 +426,7 @@ struct cheader
  *
  *
  */
-template<unsigned dim, unsigned int n_ele>
+template<unsigned dim, unsigned int n_ele, typename mheader_type = mheader<n_ele>>
 class grid_key_sparse_dx_iterator_sub
 {
 	const static int cnk_pos = 0;
@@ -152,7 +434,7 @@ class grid_key_sparse_dx_iterator_sub
 	const static int cnk_mask = 2;
 
 	//! It store the information of each chunk mask
-	const openfpm::vector<mheader<n_ele>> * header_mask;
+	const openfpm::vector<mheader_type> * header_mask;
 
 	//! it store the information of each chunk
 	const openfpm::vector<cheader<dim>> * header_inf;
@@ -230,7 +512,7 @@ public:
 	 */
 	grid_key_sparse_dx_iterator_sub()	{};
 
-	grid_key_sparse_dx_iterator_sub(const openfpm::vector<mheader<n_ele>> & header_mask,
+	grid_key_sparse_dx_iterator_sub(const openfpm::vector<mheader_type> & header_mask,
 			                    const openfpm::vector<cheader<dim>> & header_inf,
 								const grid_key_dx<dim> (& lin_id_pos)[n_ele],
 								const grid_key_dx<dim> & start,
@@ -258,7 +540,7 @@ public:
 	 * \param g_s_it grid_key_dx_iterator_sub
 	 *
 	 */
-	inline void reinitialize(const grid_key_sparse_dx_iterator_sub<dim,n_ele> & g_s_it)
+	inline void reinitialize(const grid_key_sparse_dx_iterator_sub<dim,n_ele,mheader_type> & g_s_it)
 	{
 		header_inf = g_s_it.header_inf;
 		header_mask = g_s_it.header_mask;
@@ -275,7 +557,7 @@ public:
 		memcpy(mask_it,g_s_it.mask_it,sizeof(short unsigned int)*n_ele);
 	}
 
-	inline grid_key_sparse_dx_iterator_sub<dim,n_ele> & operator++()
+	inline grid_key_sparse_dx_iterator_sub<dim,n_ele,mheader_type> & operator++()
 	{
 		mask_it_pnt++;
 
@@ -370,7 +652,7 @@ public:
 	 * \return header
 	 *
 	 */
-	const openfpm::vector<mheader<n_ele>> * private_get_header_mask() const
+	const openfpm::vector<mheader_type> * private_get_header_mask() const
 	{return header_mask;}
 
 	/*! \brief Return the private member lin_id_pos
@@ -421,11 +703,11 @@ public:
  *
  *
  */
-template<unsigned dim, unsigned int n_ele>
+template<unsigned dim, unsigned int n_ele, typename mheader_type = mheader<n_ele>>
 class grid_key_sparse_dx_iterator
 {
 	//! It store the information of each chunk
-	const openfpm::vector<mheader<n_ele>> * header_mask;
+	const openfpm::vector<mheader_type> * header_mask;
 
 	//! It store the information of each chunk
 	const openfpm::vector<cheader<dim>> * header_inf;
@@ -475,7 +757,7 @@ public:
 	 */
 	grid_key_sparse_dx_iterator()	{};
 
-	grid_key_sparse_dx_iterator(const openfpm::vector<mheader<n_ele>> * header_mask,
+	grid_key_sparse_dx_iterator(const openfpm::vector<mheader_type> * header_mask,
 							    const openfpm::vector<cheader<dim>> * header_inf,
 								const grid_key_dx<dim> (* lin_id_pos)[n_ele])
 	:header_mask(header_mask),header_inf(header_inf),lin_id_pos(lin_id_pos),chunk_id(1),mask_nele(0),mask_it_pnt(0)
@@ -483,7 +765,7 @@ public:
 		SelectValidAndFill_mask_it();
 	}
 
-	inline grid_key_sparse_dx_iterator<dim,n_ele> & operator++()
+	inline grid_key_sparse_dx_iterator<dim,n_ele,mheader_type> & operator++()
 	{
 		mask_it_pnt++;
 
@@ -511,7 +793,7 @@ public:
 	 * \param g_s_it grid_key_dx_iterator
 	 *
 	 */
-	inline void reinitialize(const grid_key_sparse_dx_iterator<dim,n_ele> & g_s_it)
+	inline void reinitialize(const grid_key_sparse_dx_iterator<dim,n_ele,mheader_type> & g_s_it)
 	{
 		header_mask = g_s_it.header_mask;
 		header_inf = g_s_it.header_inf;
@@ -531,7 +813,7 @@ public:
 	 * \param g_s_it grid_key_dx_iterator
 	 *
 	 */
-	inline void reinitialize(const grid_key_sparse_dx_iterator_sub<dim,n_ele> & g_s_it)
+	inline void reinitialize(const grid_key_sparse_dx_iterator_sub<dim,n_ele,mheader_type> & g_s_it)
 	{
 		header_mask = g_s_it.private_get_header_mask();
 		header_inf = g_s_it.private_get_header_inf();
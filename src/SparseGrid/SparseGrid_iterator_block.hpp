@@ -482,6 +482,9 @@ class grid_key_sparse_dx_iterator_block_sub
 	//! point to the actual chunk
 	size_t chunk_id;
 
+	//! stop the iteration at this chunk
+	size_t chunk_stop;
+
 	//! Starting point
 	grid_key_dx<dim> start_;
 
@@ -504,7 +507,7 @@ class grid_key_sparse_dx_iterator_block_sub
     openfpm::vector<grid_key_dx<dim>> block_skin;
 
     // chunk header container
-    mheader<SparseGridType::chunking_type::size::value> * hm;
+    typename SparseGridType::header_mask_type * hm;
     cheader<dim> * hc;
 
     // temporary buffer for Load border
@@ -522,7 +525,7 @@ class grid_key_sparse_dx_iterator_block_sub
 		auto & header = spg.private_get_header_inf();
 		auto & header_mask = spg.private_get_header_mask();
 
-		while (chunk_id < header.size())
+		while (chunk_id < chunk_end())
 		{
 			auto & mask = header_mask.get(chunk_id).mask;
 
@@ -540,6 +543,18 @@ class grid_key_sparse_dx_iterator_block_sub
 		}
 	}
 
+	/*! \brief Return the chunk where the iteration stop
+	 *
+	 * \return the chunk where the iteration stop
+	 *
+	 */
+	inline size_t chunk_end()
+	{
+		auto & header = spg.private_get_header_inf();
+
+		return (chunk_stop < header.size())?chunk_stop:header.size();
+	}
+
 public:
 
 	// we create first a vector with
@@ -568,7 +583,7 @@ public:
 	grid_key_sparse_dx_iterator_block_sub(SparseGridType & spg,
 								const grid_key_dx<dim> & start,
 								const grid_key_dx<dim> & stop)
-	:spg(spg),chunk_id(1),
+	:spg(spg),chunk_id(1),chunk_stop((size_t)-1),
 	 start_(start),stop_(stop)
 	{
 		// Create border coeficents
@@ -661,10 +676,11 @@ public:
 	 * \param g_s_it grid_key_dx_iterator_sub
 	 *
 	 */
-	inline void reinitialize(const grid_key_sparse_dx_iterator_sub<dim,vector_blocks_exts::size::value> & g_s_it)
+	inline void reinitialize(const grid_key_sparse_dx_iterator_sub<dim,vector_blocks_exts::size::value,typename SparseGridType::header_mask_type> & g_s_it)
 	{
 		spg = g_s_it.spg;
 		chunk_id = g_s_it.chunk_id;
+		chunk_stop = (size_t)-1;
 		start_ = g_s_it.start_;
 		stop_ = g_s_it.stop_;
 		bx = g_s_it.bx;
@@ -672,11 +688,9 @@ public:
 
 	inline grid_key_sparse_dx_iterator_block_sub<dim,stencil_size,SparseGridType,vector_blocks_exts> & operator++()
 	{
-		auto & header = spg.private_get_header_inf();
-
 		chunk_id++;
 
-		if (chunk_id < header.size())
+		if (chunk_id < chunk_end())
 		{
 			SelectValid();
 		}
@@ -684,6 +698,23 @@ public:
 		return *this;
 	}
 
+	/*! \brief Restrict the iteration to the chunks [start,stop)
+	 *
+	 * Used to split the iteration across threads, each thread work on a copy of the iterator
+	 * with a different range of chunks
+	 *
+	 * \param start first chunk
+	 * \param stop one past the last chunk
+	 *
+	 */
+	inline void setChunkRange(size_t start, size_t stop)
+	{
+		chunk_id = start;
+		chunk_stop = stop;
+
+		SelectValid();
+	}
+
 	/*! \brief Return true if there is a next grid point
 	 *
 	 * \return true if there is the next grid point
@@ -691,9 +722,7 @@ public:
 	 */
 	bool isNext()
 	{
-		auto & header = spg.private_get_header_inf();
-
-		return chunk_id < header.size();
+		return chunk_id < chunk_end();
 	}
 
 	/*! \brief Return the starting point for the iteration
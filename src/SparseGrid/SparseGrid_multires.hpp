@@ -0,0 +1,893 @@
+/*
+ * SparseGrid_multires.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Pietro Incardona
+ */
+
+#ifndef OPENFPM_DATA_SRC_SPARSEGRID_SPARSEGRID_MULTIRES_HPP_
+#define OPENFPM_DATA_SRC_SPARSEGRID_SPARSEGRID_MULTIRES_HPP_
+
+#include <vector>
+#include "SparseGrid.hpp"
+#include "util/copy_compare/meta_copy.hpp"
+
+/*! \brief Copy the properties of a point of a sparse grid into an element of a vector
+ *
+ * \tparam sgrid_type sparse grid
+ * \tparam vector_values vector of values
+ * \tparam prp properties to copy
+ *
+ */
+template<typename sgrid_type, typename vector_values, unsigned int ... prp>
+class copy_sparse_to_vector_cc
+{
+	//! source sparse grid
+	const sgrid_type & sg;
+
+	//! destination vector
+	vector_values & values;
+
+	//! point to copy
+	const grid_key_dx<sgrid_type::dims> & key;
+
+	//! element of the vector
+	size_t i;
+
+	//! chunk cache of the calling thread
+	sgrid_chunk_cache<SGRID_CACHE> & cc;
+
+	//! convert the properties into an mpl vector
+	typedef typename to_boost_vmpl<prp...>::type v_prp;
+
+public:
+
+	copy_sparse_to_vector_cc(const sgrid_type & sg,
+							 vector_values & values,
+							 const grid_key_dx<sgrid_type::dims> & key,
+							 size_t i,
+							 sgrid_chunk_cache<SGRID_CACHE> & cc)
+	:sg(sg),values(values),key(key),i(i),cc(cc)
+	{}
+
+	//! It call the copy function for each property
+	template<typename Tp>
+	inline void operator()(Tp& /*t*/) const
+	{
+		typedef typename boost::mpl::at<v_prp,boost::mpl::int_<Tp::value>>::type idx_type;
+		typedef typename std::remove_reference<decltype(values.template get<idx_type::value>(i))>::type copy_rtype;
+
+		meta_copy<copy_rtype>::meta_copy_(sg.template get<idx_type::value>(key,cc),values.template get<idx_type::value>(i));
+	}
+};
+
+/*! \brief Restrict one property of the children chunks into a coarse chunk
+ *
+ * For every point of the coarse chunk the values of the existing children are averaged
+ *
+ * \tparam n_ele number of elements in a chunk
+ * \tparam data_type vector of chunks
+ * \tparam prp properties to restrict
+ *
+ */
+template<unsigned int n_ele, typename data_type, unsigned int ... prp>
+class sgrid_mr_restrict
+{
+	//! coarse chunks
+	data_type & coarse;
+
+	//! fine chunks
+	data_type & fine;
+
+	//! coarse chunk
+	size_t c_cnk;
+
+	//! fine chunks of the 2^dim octants (-1 if the chunk does not exist)
+	const long int * f_cnk;
+
+	//! number of octants
+	size_t n_oct;
+
+	//! expanded masks of the children chunks
+	const unsigned char * f_mask;
+
+	//! mask of the coarse chunk
+	const unsigned char * c_mask;
+
+	//! number of children for every coarse point
+	const unsigned char * cnt;
+
+	//! coarse offset of every fine row for every octant
+	const int * row_c;
+
+	//! size of the chunk in x
+	size_t sx;
+
+	//! convert the properties into an mpl vector
+	typedef typename to_boost_vmpl<prp...>::type v_prp;
+
+public:
+
+	sgrid_mr_restrict(data_type & coarse, data_type & fine,
+					  size_t c_cnk, const long int * f_cnk, size_t n_oct,
+					  const unsigned char * f_mask, const unsigned char * c_mask, const unsigned char * cnt,
+					  const int * row_c, size_t sx)
+	:coarse(coarse),fine(fine),c_cnk(c_cnk),f_cnk(f_cnk),n_oct(n_oct),f_mask(f_mask),c_mask(c_mask),cnt(cnt),row_c(row_c),sx(sx)
+	{}
+
+	//! It restrict each property
+	template<typename Tp>
+	inline void operator()(Tp& /*t*/) const
+	{
+		typedef typename boost::mpl::at<v_prp,boost::mpl::int_<Tp::value>>::type idx_type;
+		typedef typename std::remove_const<typename std::remove_reference<decltype(coarse.template get<idx_type::value>(c_cnk)[0])>::type>::type prop_type;
+
+		static_assert(std::is_arithmetic<prop_type>::value,"Error the restriction require arithmetic properties");
+
+		prop_type sum[n_ele];
+
+		for (size_t i = 0 ; i < n_ele ; i++)
+		{sum[i] = 0;}
+
+		size_t n_rows = n_ele / sx;
+
+		for (size_t o = 0 ; o < n_oct ; o++)
+		{
+			if (f_cnk[o] < 0)	{continue;}
+
+			auto & fv = fine.template get<idx_type::value>(f_cnk[o]);
+			const unsigned char * fm = &f_mask[o*n_ele];
+			const int * rc = &row_c[o*n_rows];
+
+			for (size_t r = 0 ; r < n_rows ; r++)
+			{
+				prop_type * s = &sum[rc[r]];
+				size_t fb = r*sx;
+
+				// pairs of fine points in x go in the same coarse point
+				for (size_t x = 0 ; x < sx/2 ; x++)
+				{s[x] += fm[fb+2*x]*fv[fb+2*x] + fm[fb+2*x+1]*fv[fb+2*x+1];}
+			}
+		}
+
+		auto & cv = coarse.template get<idx_type::value>(c_cnk);
+
+		for (size_t i = 0 ; i < n_ele ; i++)
+		{cv[i] = (c_mask[i] && cnt[i])?sum[i] / (prop_type)cnt[i]:cv[i];}
+	}
+};
+
+/*! \brief Prolongate one property of a coarse chunk into a fine chunk
+ *
+ * Every existing fine point get the value of its parent (if the parent exist)
+ *
+ * \tparam n_ele number of elements in a chunk
+ * \tparam data_type vector of chunks
+ * \tparam prp properties to prolongate
+ *
+ */
+template<unsigned int n_ele, typename data_type, unsigned int ... prp>
+class sgrid_mr_prolongate
+{
+	//! coarse chunks
+	data_type & coarse;
+
+	//! fine chunks
+	data_type & fine;
+
+	//! coarse chunk
+	size_t c_cnk;
+
+	//! fine chunk
+	size_t f_cnk;
+
+	//! expanded mask of the fine chunk
+	const unsigned char * f_mask;
+
+	//! expanded mask of the coarse chunk
+	const unsigned char * c_mask;
+
+	//! coarse offset of every fine row
+	const int * rc;
+
+	//! size of the chunk in x
+	size_t sx;
+
+	//! convert the properties into an mpl vector
+	typedef typename to_boost_vmpl<prp...>::type v_prp;
+
+public:
+
+	sgrid_mr_prolongate(data_type & coarse, data_type & fine,
+						size_t c_cnk, size_t f_cnk,
+						const unsigned char * f_mask, const unsigned char * c_mask,
+						const int * rc, size_t sx)
+	:coarse(coarse),fine(fine),c_cnk(c_cnk),f_cnk(f_cnk),f_mask(f_mask),c_mask(c_mask),rc(rc),sx(sx)
+	{}
+
+	//! It prolongate each property
+	template<typename Tp>
+	inline void operator()(Tp& /*t*/) const
+	{
+		typedef typename boost::mpl::at<v_prp,boost::mpl::int_<Tp::value>>::type idx_type;
+
+		auto & fv = fine.template get<idx_type::value>(f_cnk);
+		auto & cv = coarse.template get<idx_type::value>(c_cnk);
+
+		size_t n_rows = n_ele / sx;
+
+		for (size_t r = 0 ; r < n_rows ; r++)
+		{
+			size_t fb = r*sx;
+			size_t cb = rc[r];
+
+			for (size_t x = 0 ; x < sx ; x++)
+			{fv[fb+x] = (f_mask[fb+x] & c_mask[cb+x/2])?cv[cb+x/2]:fv[fb+x];}
+		}
+	}
+};
+
+/*! \brief Multi-resolution sparse grid
+ *
+ * It is a hierarchy of sparse grids, the level 0 is the coarsest and every level l has 2^l times the
+ * points of the level 0 in each direction. The points are cell-centered, the parent of the point q at
+ * level l is the point q/2 at level l-1. Because the chunks of all the levels have the same size and
+ * are aligned, a coarse chunk is covered exactly by 2^dim fine chunks and a fine chunk is contained in
+ * one coarse chunk. The operators between the levels work chunk by chunk on the expanded masks
+ *
+ * \tparam dim dimensionality
+ * \tparam T type of the properties
+ * \tparam S memory
+ *
+ */
+template<unsigned int dim,
+		 typename T,
+		 typename S,
+		 typename grid_lin = grid_sm<dim,void>,
+		 typename layout = typename memory_traits_lin<T>::type,
+		 template<typename> class layout_base = memory_traits_lin,
+		 typename chunking = default_chunking<dim>>
+class sgrid_mr
+{
+public:
+
+	//! type of the levels
+	typedef sgrid_cpu<dim,T,S,grid_lin,layout,layout_base,chunking> level_type;
+
+private:
+
+	//! number of elements in a chunk
+	static const unsigned int n_ele = chunking::size::value;
+
+	//! number of octants
+	static const unsigned int n_oct = 1 << dim;
+
+	//! levels from the coarsest to the finest
+	std::vector<level_type> levels;
+
+	//! ghost points added at each level
+	std::vector<openfpm::vector<grid_key_dx<dim>>> ghost;
+
+	//! size of the chunk
+	size_t sz_cnk[dim];
+
+	//! For every octant and every row (in x) of a fine chunk the offset of the parent row in the coarse chunk
+	openfpm::vector<int> row_c;
+
+	/*! \brief Calculate the offsets of the parent rows
+	 *
+	 */
+	void init_rows()
+	{
+		grid_key_dx<dim> one;
+
+		for (size_t i = 0 ; i < dim ; i++)
+		{one.set_d(i,1);}
+
+		key_shift<dim,chunking>::cpos(one);
+
+		for (size_t i = 0 ; i < dim ; i++)
+		{
+			sz_cnk[i] = one.get(i);
+
+			if (sz_cnk[i] % 2 != 0)
+			{std::cerr << "Error " << __FILE__ << ":" << __LINE__ << " the chunk size must be even in every direction" << std::endl;}
+		}
+
+		size_t n_rows = n_ele / sz_cnk[0];
+		row_c.resize(n_oct*n_rows);
+
+		for (size_t o = 0 ; o < n_oct ; o++)
+		{
+			for (size_t r = 0 ; r < n_rows ; r++)
+			{
+				size_t rr = r;
+				size_t stride = sz_cnk[0];
+				long int off = ((o & 1)*sz_cnk[0]) / 2;
+
+				for (size_t d = 1 ; d < dim ; d++)
+				{
+					size_t f = rr % sz_cnk[d];
+					rr /= sz_cnk[d];
+
+					off += ((((o >> d) & 1)*sz_cnk[d] + f) / 2) * stride;
+					stride *= sz_cnk[d];
+				}
+
+				row_c.get(o*n_rows + r) = off;
+			}
+		}
+	}
+
+	/*! \brief Return the octant of the fine chunk in its parent chunk
+	 *
+	 * \param pos position of the fine chunk
+	 *
+	 * \return the octant
+	 *
+	 */
+	size_t octant(const grid_key_dx<dim> & pos) const
+	{
+		size_t o = 0;
+
+		for (size_t d = 0 ; d < dim ; d++)
+		{o |= ((pos.get(d) / sz_cnk[d]) & 1) << d;}
+
+		return o;
+	}
+
+	/*! \brief Collect the points of the level l that does not exist and are in the neighborhood of radius g
+	 *         of the points in set (the points in set included)
+	 *
+	 * \param l level
+	 * \param set points (linearized on the level l) around which the neighborhood is calculated
+	 * \param g radius
+	 * \param keys missing points
+	 *
+	 */
+	void missing_neighborhood(size_t l, const openfpm::vector<size_t> & set, size_t g, openfpm::vector<grid_key_dx<dim>> & keys)
+	{
+		auto & lv = levels[l];
+		const grid_lin & gl = lv.getGrid();
+
+		// offsets of the neighborhood
+
+		openfpm::vector<grid_key_dx<dim>> offs;
+
+		size_t sz_nn[dim];
+		for (size_t i = 0 ; i < dim ; i++)
+		{sz_nn[i] = 2*g+1;}
+
+		grid_sm<dim,void> g_nn(sz_nn);
+		grid_key_dx_iterator<dim> it(g_nn);
+
+		while (it.isNext())
+		{
+			grid_key_dx<dim> k = it.get();
+
+			for (size_t i = 0 ; i < dim ; i++)
+			{k.set_d(i,k.get(i) - g);}
+
+			offs.add(k);
+
+			++it;
+		}
+
+		size_t nth = openfpm_omp_max_threads();
+		std::vector<openfpm::vector<size_t>> cand(nth);
+
+		long int n = set.size();
+
+		#pragma omp parallel if (n >= OPENFPM_OMP_MIN_ELEMENTS)
+		{
+			size_t tid = openfpm_omp_thread_num();
+			auto & cl = cand[tid];
+			sgrid_chunk_cache<SGRID_CACHE> cc;
+
+			#pragma omp for schedule(static)
+			for (long int i = 0 ; i < n ; i++)
+			{
+				grid_key_dx<dim> p = gl.InvLinId(set.get(i));
+
+				for (size_t j = 0 ; j < offs.size() ; j++)
+				{
+					grid_key_dx<dim> q;
+
+					bool inside = true;
+					for (size_t d = 0 ; d < dim ; d++)
+					{
+						q.set_d(d,p.get(d) + offs.get(j).get(d));
+						inside &= q.get(d) >= 0 && q.get(d) < (long int)gl.size(d);
+					}
+
+					if (inside == false || lv.existPoint(q,cc) == true)	{continue;}
+
+					cl.add(gl.LinId(q));
+				}
+			}
+		}
+
+		openfpm::vector<size_t> lin;
+
+		for (size_t t = 0 ; t < nth ; t++)
+		{
+			for (size_t i = 0 ; i < cand[t].size() ; i++)
+			{lin.add(cand[t].get(i));}
+		}
+
+		lin.sort();
+		lin.unique();
+
+		keys.resize(lin.size());
+
+		for (size_t i = 0 ; i < lin.size() ; i++)
+		{
+			grid_key_dx<dim> k = gl.InvLinId(lin.get(i));
+
+			for (size_t d = 0 ; d < dim ; d++)
+			{keys.get(i).set_d(d,k.get(d));}
+		}
+	}
+
+	/*! \brief Set the values of the points from the values of the corresponding points of the level l_src and insert them
+	 *
+	 * When l_src is l the points must not exist, so they get the background value
+	 *
+	 * \param l level of the points
+	 * \param l_src level from where the values are taken (l or l-1)
+	 * \param keys points
+	 *
+	 */
+	template<unsigned int ... prp>
+	void insert_from(size_t l, size_t l_src, const openfpm::vector<grid_key_dx<dim>> & keys)
+	{
+		openfpm::vector<T> values;
+		values.resize(keys.size());
+
+		const level_type & src = levels[l_src];
+		long int n = keys.size();
+
+		#pragma omp parallel if (n >= OPENFPM_OMP_MIN_ELEMENTS)
+		{
+			sgrid_chunk_cache<SGRID_CACHE> cc;
+
+			#pragma omp for schedule(static)
+			for (long int i = 0 ; i < n ; i++)
+			{
+				grid_key_dx<dim> p = keys.get(i);
+
+				if (l != l_src)
+				{
+					for (size_t d = 0 ; d < dim ; d++)
+					{p.set_d(d,p.get(d) / 2);}
+				}
+
+				copy_sparse_to_vector_cc<level_type,openfpm::vector<T>,prp...> cp(src,values,p,i,cc);
+				boost::mpl::for_each_ref< boost::mpl::range_c<int,0,sizeof...(prp)> >(cp);
+			}
+		}
+
+		levels[l].template insert_bulk<replace_,prp...>(keys,values);
+	}
+
+	/*! \brief Set the values of the points from the values of their parents and insert them
+	 *
+	 * \param l level of the points
+	 * \param keys points
+	 *
+	 */
+	template<unsigned int ... prp>
+	void insert_from_parent(size_t l, const openfpm::vector<grid_key_dx<dim>> & keys)
+	{
+		insert_from<prp...>(l,(l == 0)?0:l-1,keys);
+	}
+
+	/*! \brief Check that l is a valid fine level
+	 *
+	 * \param l level
+	 *
+	 * \return true if the level l and the level l-1 exist
+	 *
+	 */
+	bool check_fine_level(size_t l) const
+	{
+		if (l == 0 || l >= levels.size())
+		{
+			std::cerr << "Error " << __FILE__ << ":" << __LINE__ << " the level " << l << " does not have a coarser level, the number of levels is " << levels.size() << std::endl;
+			return false;
+		}
+
+		return true;
+	}
+
+public:
+
+	//! Dimensionality of the grid
+	static const unsigned int dims = dim;
+
+	/*! \brief Constructor
+	 *
+	 * \param sz size of the coarsest level
+	 * \param n_levels number of levels
+	 *
+	 */
+	sgrid_mr(const size_t (& sz)[dim], size_t n_levels)
+	{
+		levels.resize(n_levels);
+		ghost.resize(n_levels);
+
+		for (size_t l = 0 ; l < n_levels ; l++)
+		{
+			size_t sz_l[dim];
+
+			for (size_t i = 0 ; i < dim ; i++)
+			{sz_l[i] = sz[i] << l;}
+
+			levels[l].resize(sz_l);
+		}
+
+		init_rows();
+	}
+
+	/*! \brief Get the number of levels
+	 *
+	 * \return the number of levels
+	 *
+	 */
+	size_t getNLevels() const
+	{
+		return levels.size();
+	}
+
+	/*! \brief Get the sparse grid of a level
+	 *
+	 * \param l level
+	 *
+	 * \return the sparse grid of the level l
+	 *
+	 */
+	level_type & getLevel(size_t l)
+	{
+		return levels[l];
+	}
+
+	/*! \brief Get the sparse grid of a level
+	 *
+	 * \param l level
+	 *
+	 * \return the sparse grid of the level l
+	 *
+	 */
+	const level_type & getLevel(size_t l) const
+	{
+		return levels[l];
+	}
+
+	/*! \brief Restrict the level l into the level l-1
+	 *
+	 * Every existing point of the level l-1 with at least one existing child get the average of the values of
+	 * its children. The coarse chunks are processed in parallel, each one gather its 2^dim children chunks
+	 *
+	 * \tparam prp properties to restrict
+	 *
+	 * \param l fine level
+	 *
+	 */
+	template<unsigned int ... prp>
+	void restriction(size_t l)
+	{
+		if (check_fine_level(l) == false)	{return;}
+
+		auto & lc = levels[l-1];
+		auto & lf = levels[l];
+
+		auto & hc_inf = lc.private_get_header_inf();
+		auto & hc_mask = lc.private_get_header_mask();
+		auto & hf_mask = lf.private_get_header_mask();
+		auto & dc = lc.private_get_data();
+		auto & df = lf.private_get_data();
+
+		size_t n_rows = n_ele / sz_cnk[0];
+		long int n_cnk = hc_inf.size();
+
+		#pragma omp parallel if (n_cnk >= SGRID_OMP_MIN_CHUNKS)
+		{
+			sgrid_chunk_cache<SGRID_CACHE> cc;
+
+			unsigned char f_mask[n_oct*n_ele];
+			unsigned char c_mask[n_ele];
+			unsigned char cnt[n_ele];
+			long int f_cnk[n_oct];
+
+			#pragma omp for schedule(dynamic,SGRID_OMP_CHUNK_BATCH)
+			for (long int i = 1 ; i < n_cnk ; i++)
+			{
+				if (hc_inf.get(i).nele == 0)	{continue;}
+
+				const grid_key_dx<dim> & pos = hc_inf.get(i).pos;
+
+				for (size_t j = 0 ; j < n_ele ; j++)
+				{cnt[j] = 0;}
+
+				bool any = false;
+
+				for (size_t o = 0 ; o < n_oct ; o++)
+				{
+					grid_key_dx<dim> fp;
+
+					for (size_t d = 0 ; d < dim ; d++)
+					{fp.set_d(d,2*pos.get(d) + ((o >> d) & 1)*sz_cnk[d]);}
+
+					// shift the key
+					grid_key_dx<dim> kl;
+					key_shift<dim,chunking>::shift(fp,kl);
+
+					bool exist;
+					f_cnk[o] = lf.getChunk(fp,exist,cc);
+
+					if (exist == false)
+					{f_cnk[o] = -1;continue;}
+
+					any = true;
+
+					unsigned char * fm = &f_mask[o*n_ele];
+					exist_sub_row(hf_mask.get(f_cnk[o]),0,n_ele,fm);
+
+					const int * rc = &row_c.get(o*n_rows);
+
+					for (size_t r = 0 ; r < n_rows ; r++)
+					{
+						unsigned char * cr = &cnt[rc[r]];
+						size_t fb = r*sz_cnk[0];
+
+						for (size_t x = 0 ; x < sz_cnk[0]/2 ; x++)
+						{cr[x] += fm[fb+2*x] + fm[fb+2*x+1];}
+					}
+				}
+
+				if (any == false)	{continue;}
+
+				exist_sub_row(hc_mask.get(i),0,n_ele,c_mask);
+
+				sgrid_mr_restrict<n_ele,typename std::remove_reference<decltype(dc)>::type,prp...>
+				rs(dc,df,i,f_cnk,n_oct,f_mask,c_mask,cnt,&row_c.get(0),sz_cnk[0]);
+
+				boost::mpl::for_each_ref< boost::mpl::range_c<int,0,sizeof...(prp)> >(rs);
+			}
+		}
+	}
+
+	/*! \brief Prolongate the level l-1 into the level l
+	 *
+	 * Every existing point of the level l get the value of its parent if the parent exist
+	 * (piecewise constant interpolation). The fine chunks are processed in parallel
+	 *
+	 * \tparam prp properties to prolongate
+	 *
+	 * \param l fine level
+	 *
+	 */
+	template<unsigned int ... prp>
+	void prolongation(size_t l)
+	{
+		if (check_fine_level(l) == false)	{return;}
+
+		auto & lc = levels[l-1];
+		auto & lf = levels[l];
+
+		auto & hf_inf = lf.private_get_header_inf();
+		auto & hc_mask = lc.private_get_header_mask();
+		auto & hf_mask = lf.private_get_header_mask();
+		auto & dc = lc.private_get_data();
+		auto & df = lf.private_get_data();
+
+		size_t n_rows = n_ele / sz_cnk[0];
+		long int n_cnk = hf_inf.size();
+
+		#pragma omp parallel if (n_cnk >= SGRID_OMP_MIN_CHUNKS)
+		{
+			sgrid_chunk_cache<SGRID_CACHE> cc;
+
+			unsigned char f_mask[n_ele];
+			unsigned char c_mask[n_ele];
+
+			#pragma omp for schedule(dynamic,SGRID_OMP_CHUNK_BATCH)
+			for (long int i = 1 ; i < n_cnk ; i++)
+			{
+				if (hf_inf.get(i).nele == 0)	{continue;}
+
+				const grid_key_dx<dim> & pos = hf_inf.get(i).pos;
+				grid_key_dx<dim> cp;
+
+				for (size_t d = 0 ; d < dim ; d++)
+				{cp.set_d(d,pos.get(d) / 2);}
+
+				// shift the key
+				grid_key_dx<dim> kl;
+				key_shift<dim,chunking>::shift(cp,kl);
+
+				bool exist;
+				size_t c_cnk = lc.getChunk(cp,exist,cc);
+
+				if (exist == false)	{continue;}
+
+				exist_sub_row(hf_mask.get(i),0,n_ele,f_mask);
+				exist_sub_row(hc_mask.get(c_cnk),0,n_ele,c_mask);
+
+				sgrid_mr_prolongate<n_ele,typename std::remove_reference<decltype(dc)>::type,prp...>
+				pr(dc,df,c_cnk,i,f_mask,c_mask,&row_c.get(octant(pos)*n_rows),sz_cnk[0]);
+
+				boost::mpl::for_each_ref< boost::mpl::range_c<int,0,sizeof...(prp)> >(pr);
+			}
+		}
+	}
+
+	/*! \brief Fill the ghost of the level l from the level l-1
+	 *
+	 * The points of the level l that does not exist and are at distance (in every direction) less or equal
+	 * than g from an existing point are created if their parent exist, and get the value of the parent.
+	 * The ghost points created by a previous call are removed before
+	 *
+	 * \tparam prp properties to fill
+	 *
+	 * \param l level
+	 * \param g size of the ghost
+	 *
+	 */
+	template<unsigned int ... prp>
+	void fillGhost(size_t l, size_t g)
+	{
+		if (check_fine_level(l) == false)	{return;}
+
+		clearGhost(l);
+
+		auto & lv = levels[l];
+		auto & lc = levels[l-1];
+		const grid_lin & gl = lv.getGrid();
+
+		// existing points
+
+		openfpm::vector<size_t> set;
+
+		auto it = lv.getIterator();
+
+		while (it.isNext())
+		{
+			set.add(gl.LinId(it.get()));
+
+			++it;
+		}
+
+		openfpm::vector<grid_key_dx<dim>> cand;
+		missing_neighborhood(l,set,g,cand);
+
+		// keep only the points with a parent
+
+		long int n = cand.size();
+		openfpm::vector<unsigned char> keep;
+		keep.resize(n);
+
+		#pragma omp parallel if (n >= OPENFPM_OMP_MIN_ELEMENTS)
+		{
+			sgrid_chunk_cache<SGRID_CACHE> cc;
+
+			#pragma omp for schedule(static)
+			for (long int i = 0 ; i < n ; i++)
+			{
+				grid_key_dx<dim> p = cand.get(i);
+
+				for (size_t d = 0 ; d < dim ; d++)
+				{p.set_d(d,p.get(d) / 2);}
+
+				keep.get(i) = lc.existPoint(p,cc);
+			}
+		}
+
+		auto & keys = ghost[l];
+
+		for (long int i = 0 ; i < n ; i++)
+		{
+			if (keep.get(i) == true)
+			{keys.add(cand.get(i));}
+		}
+
+		insert_from_parent<prp...>(l,keys);
+	}
+
+	/*! \brief Remove the ghost points of the level l
+	 *
+	 * \param l level
+	 *
+	 */
+	void clearGhost(size_t l)
+	{
+		auto & keys = ghost[l];
+
+		if (keys.size() == 0)	{return;}
+
+		for (size_t i = 0 ; i < keys.size() ; i++)
+		{levels[l].remove_no_flush(keys.get(i));}
+
+		levels[l].flush_remove();
+		keys.clear();
+	}
+
+	/*! \brief Get the ghost points of the level l
+	 *
+	 * \param l level
+	 *
+	 * \return the ghost points added by the last fillGhost
+	 *
+	 */
+	const openfpm::vector<grid_key_dx<dim>> & getGhost(size_t l) const
+	{
+		return ghost[l];
+	}
+
+	/*! \brief Enforce the 2:1 balance between the levels
+	 *
+	 * For every point q of the level l > 0 the points of the level l-1 at distance (in every direction) less
+	 * or equal than g from the parent of q are created. The levels are processed from the finest to the
+	 * coarsest, so the points created in one level propagate the balance to the coarser levels. Once all the
+	 * points exist the created points get the value of their parent going from the coarsest to the finest
+	 * level (the created points of the level 0 keep the background value), after that every level is
+	 * restricted on the coarser one
+	 *
+	 * \tparam prp properties to set on the created points
+	 *
+	 * \param g distance from the parent
+	 *
+	 */
+	template<unsigned int ... prp>
+	void balance(size_t g)
+	{
+		std::vector<openfpm::vector<grid_key_dx<dim>>> created(levels.size());
+
+		for (long int l = levels.size() - 1 ; l >= 1 ; l--)
+		{
+			auto & lf = levels[l];
+			const grid_lin & gc = levels[l-1].getGrid();
+
+			// parents of the points of the level l
+
+			openfpm::vector<size_t> parents;
+
+			auto it = lf.getIterator();
+
+			while (it.isNext())
+			{
+				grid_key_dx<dim> p = it.get();
+
+				for (size_t d = 0 ; d < dim ; d++)
+				{p.set_d(d,p.get(d) / 2);}
+
+				parents.add(gc.LinId(p));
+
+				++it;
+			}
+
+			parents.sort();
+			parents.unique();
+
+			auto & keys = created[l-1];
+			missing_neighborhood(l-1,parents,g,keys);
+
+			// create the points, the values are set later from the parents
+
+			if (keys.size() != 0)
+			{insert_from<prp...>(l-1,l-1,keys);}
+		}
+
+		for (size_t l = 1 ; l < levels.size() ; l++)
+		{
+			if (created[l].size() != 0)
+			{insert_from_parent<prp...>(l,created[l]);}
+		}
+
+		for (long int l = levels.size() - 1 ; l >= 1 ; l--)
+		{restriction<prp...>(l);}
+	}
+};
+
+
+#endif /* OPENFPM_DATA_SRC_SPARSEGRID_SPARSEGRID_MULTIRES_HPP_ */
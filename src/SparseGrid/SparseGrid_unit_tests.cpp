@@ -10,8 +10,14 @@
 #define BOOST_TEST_DYN_LINK
 #include <boost/test/unit_test.hpp>
 #include "SparseGrid/SparseGrid.hpp"
+#include "SparseGrid/SparseGrid_multires.hpp"
+#include "Packer_Unpacker/Checkpoint.hpp"
+#include "Grid/map_grid.hpp"
 #include "NN/CellList/CellDecomposer.hpp"
+#include "timer.hpp"
 #include <math.h>
+#include <random>
+#include <set>
 //#include "util/debug.hpp"
 
 BOOST_AUTO_TEST_SUITE( sparse_grid_test )
@@ -2431,5 +2437,1513 @@ BOOST_AUTO_TEST_CASE( sparse_testing_clear )
 	BOOST_REQUIRE_EQUAL(grid.template get<0>(keyzero),555.0);
 }
 
+BOOST_AUTO_TEST_CASE( sparse_grid_checkpoint )
+{
+	size_t sz[3] = {501,501,501};
+	size_t sz_cell[3] = {500,500,500};
+
+	sgrid_cpu<3,aggregate<double,int,float[3]>,HeapMemory> grid(sz);
+
+	CellDecomposer_sm<3, float, shift<3,float>> cdsm;
+
+	Box<3,float> domain({0.0,0.0,0.0},{1.0,1.0,1.0});
+
+	cdsm.setDimensions(domain, sz_cell, 0);
+
+	fill_sphere(grid,cdsm);
+
+	auto it = grid.getIterator();
+
+	while (it.isNext())
+	{
+		auto key = it.get();
+
+		for (size_t i = 0 ; i < 3 ; i++)
+		{grid.template insert<2>(key)[i] = key.get(i);}
+
+		++it;
+	}
+
+	BOOST_REQUIRE_EQUAL(grid.save("test_checkpoint_sparse",2),true);
+
+	// load in a sparse grid with a different layout
+	sgrid_soa<3,aggregate<double,int,float[3]>,HeapMemory> grid2;
+
+	BOOST_REQUIRE_EQUAL(grid2.load("test_checkpoint_sparse"),true);
+	BOOST_REQUIRE_EQUAL(grid2.size(),grid.size());
+
+	for (size_t i = 0 ; i < 3 ; i++)
+	{BOOST_REQUIRE_EQUAL(grid2.getGrid().size(i),sz[i]);}
+
+	bool match = true;
+	auto it_check = grid.getIterator();
+
+	while (it_check.isNext())
+	{
+		auto key = it_check.get();
+
+		match &= grid.template get<0>(key) == grid2.template get<0>(key);
+		match &= grid.template get<1>(key) == grid2.template get<1>(key);
+
+		for (size_t i = 0 ; i < 3 ; i++)
+		{match &= grid2.template get<2>(key)[i] == key.get(i);}
+
+		++it_check;
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+
+	for (size_t k = 0 ; k < 2 ; k++)
+	{remove(checkpoint_stripe_name("test_checkpoint_sparse",k).c_str());}
+	remove("test_checkpoint_sparse");
+}
+
+BOOST_AUTO_TEST_CASE( sparse_grid_concurrent_read )
+{
+	size_t sz[3] = {501,501,501};
+	size_t sz_cell[3] = {500,500,500};
+
+	sgrid_cpu<3,aggregate<double,int>,HeapMemory> grid(sz);
+
+	grid.getBackgroundValue().template get<0>() = -1.0;
+	grid.getBackgroundValue().template get<1>() = -1;
+
+	CellDecomposer_sm<3, float, shift<3,float>> cdsm;
+
+	Box<3,float> domain({0.0,0.0,0.0},{1.0,1.0,1.0});
+
+	cdsm.setDimensions(domain, sz_cell, 0);
+
+	fill_sphere(grid,cdsm);
+
+	// points inside and outside the sphere, visited in a scattered order
+	// so that consecutive reads hit different chunks
+	openfpm::vector<grid_key_dx<3>> keys;
+	auto it = grid.getIterator();
+
+	while (it.isNext())
+	{
+		auto key = it.get();
+		keys.add(key);
+
+		grid.template insert<1>(key) = key.get(0) + 501*key.get(1) + 501*501*key.get(2);
+
+		grid_key_dx<3> out({(long int)(500 - key.get(0)),(long int)key.get(1),(long int)(key.get(2) / 2)});
+		keys.add(out);
+
+		++it;
+	}
+
+	for (size_t i = 0 ; i < keys.size() ; i++)
+	{
+		size_t j = (i * 7919) % keys.size();
+
+		for (size_t k = 0 ; k < 3 ; k++)
+		{
+			long int tmp = keys.get(i).get(k);
+			keys.get(i).set_d(k,keys.get(j).get(k));
+			keys.get(j).set_d(k,tmp);
+		}
+	}
+
+	// serial reference
+	openfpm::vector<double> ref0(keys.size());
+	openfpm::vector<int> ref1(keys.size());
+	openfpm::vector<unsigned char> ref_ex(keys.size());
+
+	for (size_t i = 0 ; i < keys.size() ; i++)
+	{
+		ref0.get(i) = grid.template get<0>(keys.get(i));
+		ref1.get(i) = grid.template get<1>(keys.get(i));
+		ref_ex.get(i) = grid.existPoint(keys.get(i));
+	}
+
+	// many threads read the same grid, each with its own accessor
+	size_t n_err = 0;
+
+	for (size_t rep = 0 ; rep < 4 ; rep++)
+	{
+		#pragma omp parallel num_threads(8) reduction(+:n_err)
+		{
+			auto acc = grid.accessor();
+
+			#pragma omp for schedule(dynamic,64)
+			for (size_t i = 0 ; i < keys.size() ; i++)
+			{
+				n_err += acc.template get<0>(keys.get(i)) != ref0.get(i);
+				n_err += acc.template get<1>(keys.get(i)) != ref1.get(i);
+				n_err += acc.existPoint(keys.get(i)) != (bool)ref_ex.get(i);
+			}
+		}
+	}
+
+	BOOST_REQUIRE_EQUAL(n_err,0ul);
+}
+
+template<unsigned int prop_dst, bool findNN, typename it_type>
+void sparse_grid_block_laplacian(it_type & it)
+{
+	unsigned char mask[it_type::sizeBlockBord];
+	__attribute__ ((aligned (32))) double block_bord_src[it_type::sizeBlockBord];
+	__attribute__ ((aligned (32))) double block_bord_dst[it_type::sizeBlock];
+
+	it.template loadBlockBorder<0,NNStar_c<3>,findNN>(block_bord_src,mask);
+
+	for (int k = it.start_b(2) ; k < it.stop_b(2) ; k++)
+	{
+		for (int j = it.start_b(1) ; j < it.stop_b(1) ; j++)
+		{
+			for (int i = it.start_b(0) ; i < it.stop_b(0) ; i++)
+			{
+				int c = it.LinB(i,j,k);
+
+				if (mask[c] == false) {continue;}
+
+				// only the existing neighborhood points
+				int nn[6] = {(int)it.LinB(i+1,j,k),(int)it.LinB(i-1,j,k),(int)it.LinB(i,j+1,k),
+				             (int)it.LinB(i,j-1,k),(int)it.LinB(i,j,k+1),(int)it.LinB(i,j,k-1)};
+
+				double Lap = 0.0;
+				for (int s = 0 ; s < 6 ; s++)
+				{Lap += (mask[nn[s]])?block_bord_src[nn[s]] - block_bord_src[c]:0.0;}
+
+				block_bord_dst[it.LinB_off(i,j,k)] = Lap;
+			}
+		}
+	}
+
+	it.template storeBlock<prop_dst>(block_bord_dst);
+}
+
+BOOST_AUTO_TEST_CASE( sparse_grid_parallel_block_iterator )
+{
+	size_t sz[3] = {501,501,501};
+	size_t sz_cell[3] = {500,500,500};
+
+	sgrid_soa<3,aggregate<double,double,double>,HeapMemory> grid(sz);
+
+	grid.getBackgroundValue().template get<0>() = 0.0;
+
+	CellDecomposer_sm<3, float, shift<3,float>> cdsm;
+
+	Box<3,float> domain({0.0,0.0,0.0},{1.0,1.0,1.0});
+
+	cdsm.setDimensions(domain, sz_cell, 0);
+
+	fill_sphere_quad(grid,cdsm);
+
+	grid_key_dx<3> start({1,1,1});
+	grid_key_dx<3> stop({499,499,499});
+
+	// serial, the list of neighborhood chunks is filled by loadBlockBorder
+	grid.private_get_nnlist().resize(NNStar_c<3>::nNN * grid.private_get_header_inf().size());
+	auto it = grid.getBlockIterator<1>(start,stop);
+
+	openfpm::vector<size_t> blk_ser;
+
+	while (it.isNext())
+	{
+		sparse_grid_block_laplacian<1,false>(it);
+
+		blk_ser.add(it.getChunkId());
+		++it;
+	}
+
+	openfpm::vector<int> NNlist_ser = grid.private_get_nnlist();
+
+	// parallel
+	grid.construct_NNlist<NNStar_c<3>>();
+
+	BOOST_REQUIRE_EQUAL(grid.private_get_nnlist().size(),NNlist_ser.size());
+
+	// only the chunks visited by the serial iteration has the list filled
+	bool match = true;
+	for (size_t i = 0 ; i < blk_ser.size() ; i++)
+	{
+		for (size_t k = 0 ; k < NNStar_c<3>::nNN ; k++)
+		{
+			size_t id = blk_ser.get(i)*NNStar_c<3>::nNN + k;
+			match &= grid.private_get_nnlist().get(id) == NNlist_ser.get(id);
+		}
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+
+	openfpm::vector<size_t> visited(grid.private_get_header_inf().size());
+
+	grid.forEachBlock<1>(start,stop,[&](decltype(it) & itb)
+	{
+		sparse_grid_block_laplacian<2,true>(itb);
+
+		visited.get(itb.getChunkId()) += 1;
+	});
+
+	size_t n_blk_par = 0;
+	for (size_t i = 0 ; i < visited.size() ; i++)
+	{
+		match &= visited.get(i) <= 1;
+		n_blk_par += visited.get(i);
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+	BOOST_REQUIRE_EQUAL(n_blk_par,blk_ser.size());
+
+	auto it_check = grid.getIterator(start,stop);
+
+	while (it_check.isNext())
+	{
+		auto key = it_check.get();
+
+		match &= grid.template get<1>(key) == grid.template get<2>(key);
+
+		++it_check;
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+}
+
+template<unsigned int prop_src, unsigned int prop_dst, unsigned int prop_cnt, unsigned int N, unsigned int dim, typename grid_type>
+void sparse_grid_conv_naive(grid_type & grid, int (& stencil)[N][dim], grid_key_dx<dim> & start, grid_key_dx<dim> & stop)
+{
+	auto it = grid.getIterator(start,stop);
+
+	while (it.isNext())
+	{
+		auto p = it.get();
+
+		double sum = 0.0;
+		int cnt = 0;
+
+		for (size_t s = 0 ; s < N ; s++)
+		{
+			grid_key_dx<dim> q = p;
+
+			for (size_t k = 0 ; k < dim ; k++)
+			{q.set_d(k,p.get(k) + stencil[s][k]);}
+
+			sum += grid.template get<prop_src>(q);
+			cnt += grid.existPoint(q);
+		}
+
+		grid.template insert<prop_dst>(p) = sum - N*grid.template get<prop_src>(p);
+		grid.template insert<prop_cnt>(p) = cnt;
+
+		++it;
+	}
+}
+
+template<unsigned int stencil_size, unsigned int N, unsigned int dim, typename grid_type>
+bool sparse_grid_conv_check(grid_type & grid, int (& stencil)[N][dim], grid_key_dx<dim> & start, grid_key_dx<dim> & stop)
+{
+	sparse_grid_conv_naive<0,1,2>(grid,stencil,start,stop);
+
+	grid.template conv<0,3,stencil_size>(stencil,start,stop,[](Vc::double_v (& xs)[N+1], unsigned char *){
+		Vc::double_v sum = xs[1];
+
+		for (size_t s = 2 ; s < N+1 ; s++)
+		{sum += xs[s];}
+
+		return sum - (double)N*xs[0];
+	});
+
+	grid.template conv<0,4,stencil_size>(stencil,start,stop,[](Vc::double_v (&)[N+1], unsigned char * mask_sum){
+		return load_mask<Vc::double_v>(mask_sum);
+	});
+
+	bool match = true;
+	size_t n_in = 0;
+	size_t n_out = 0;
+
+	auto it = grid.getIterator();
+
+	while (it.isNext())
+	{
+		auto p = it.get();
+
+		bool inside = true;
+		for (size_t k = 0 ; k < dim ; k++)
+		{inside &= (p.get(k) >= start.get(k) && p.get(k) <= stop.get(k));}
+
+		if (inside == true)
+		{
+			match &= grid.template get<1>(p) == grid.template get<3>(p);
+			match &= grid.template get<2>(p) == grid.template get<4>(p);
+			n_in++;
+		}
+		else
+		{
+			// outside start stop nothing must be touched
+			match &= grid.template get<3>(p) == -1.0;
+			n_out++;
+		}
+
+		++it;
+	}
+
+	return match && n_in != 0 && n_out != 0;
+}
+
+BOOST_AUTO_TEST_CASE( sparse_grid_conv_generic_stencil )
+{
+	// 2D disk with a star stencil and with an asymmetric stencil
+
+	size_t sz2[2] = {400,400};
+
+	sgrid_soa<2,aggregate<double,double,double,double,double>,HeapMemory> grid2(sz2);
+	grid2.getBackgroundValue().template get<0>() = 0.0;
+
+	grid_sm<2,void> g2(sz2);
+	grid_key_dx_iterator<2> it2(g2);
+
+	while (it2.isNext())
+	{
+		auto p = it2.get();
+
+		long int dx = p.get(0) - 200;
+		long int dy = p.get(1) - 180;
+
+		if (dx*dx + dy*dy < 150*150 && (p.get(0) + 3*p.get(1)) % 7 != 0)
+		{
+			grid2.template insert<0>(p) = (p.get(0)*7 + p.get(1)*3) % 11;
+			grid2.template insert<3>(p) = -1.0;
+		}
+
+		++it2;
+	}
+
+	grid_key_dx<2> start2({2,2});
+	grid_key_dx<2> stop2({300,397});
+
+	int star2[4][2] = {{1,0},{-1,0},{0,1},{0,-1}};
+	int asym2[5][2] = {{2,0},{1,1},{0,-2},{-1,-1},{-2,1}};
+
+	BOOST_REQUIRE_EQUAL((sparse_grid_conv_check<1>(grid2,star2,start2,stop2)),true);
+	BOOST_REQUIRE_EQUAL((sparse_grid_conv_check<2>(grid2,asym2,start2,stop2)),true);
+
+	// 3D ball with the 27-point stencil
+
+	size_t sz3[3] = {128,128,128};
+
+	sgrid_soa<3,aggregate<double,double,double,double,double>,HeapMemory> grid3(sz3);
+	grid3.getBackgroundValue().template get<0>() = 0.0;
+
+	grid_sm<3,void> g3(sz3);
+	grid_key_dx_iterator<3> it3(g3);
+
+	while (it3.isNext())
+	{
+		auto p = it3.get();
+
+		long int dx = p.get(0) - 64;
+		long int dy = p.get(1) - 60;
+		long int dz = p.get(2) - 66;
+
+		if (dx*dx + dy*dy + dz*dz < 50*50 && (p.get(0) + p.get(1) + p.get(2)) % 5 != 0)
+		{
+			grid3.template insert<0>(p) = (p.get(0) + 2*p.get(1) + 3*p.get(2)) % 13;
+			grid3.template insert<3>(p) = -1.0;
+		}
+
+		++it3;
+	}
+
+	int box3[26][3];
+	int n = 0;
+
+	for (int k = -1 ; k <= 1 ; k++)
+	{
+		for (int j = -1 ; j <= 1 ; j++)
+		{
+			for (int i = -1 ; i <= 1 ; i++)
+			{
+				if (i == 0 && j == 0 && k == 0)	{continue;}
+
+				box3[n][0] = i;
+				box3[n][1] = j;
+				box3[n][2] = k;
+				n++;
+			}
+		}
+	}
+
+	grid_key_dx<3> start3({1,1,1});
+	grid_key_dx<3> stop3({100,126,126});
+
+	BOOST_REQUIRE_EQUAL((sparse_grid_conv_check<1>(grid3,box3,start3,stop3)),true);
+}
+
+BOOST_AUTO_TEST_CASE( sparse_grid_insert_bulk )
+{
+	size_t sz[3] = {512,512,512};
+
+	sgrid_cpu<3,aggregate<double,int>,HeapMemory> grid(sz);
+	sgrid_cpu<3,aggregate<double,int>,HeapMemory> grid_ref(sz);
+
+	// some points already exist
+
+	for (long int i = 0 ; i < 100 ; i++)
+	{
+		grid_key_dx<3> key({i,2*i,3*i});
+
+		grid.template insert<0>(key) = 1.0;
+		grid.template insert<1>(key) = 1;
+		grid_ref.template insert<0>(key) = 1.0;
+		grid_ref.template insert<1>(key) = 1;
+	}
+
+	// scattered points with repetitions
+
+	openfpm::vector<grid_key_dx<3>> keys;
+	openfpm::vector<aggregate<double,int>> values;
+
+	std::default_random_engine eg;
+	std::uniform_int_distribution<int> ud(0,511);
+
+	for (size_t i = 0 ; i < 200000 ; i++)
+	{
+		long int c = i/1000 % 100;
+
+		grid_key_dx<3> key = (i % 1000 == 0)?grid_key_dx<3>({c,2*c,3*c}):
+							 ((i % 10 == 0)?keys.get(i/2):grid_key_dx<3>({ud(eg),ud(eg),ud(eg)}));
+
+		keys.add(key);
+		values.add();
+		values.last().template get<0>() = i % 17;
+		values.last().template get<1>() = i % 13;
+	}
+
+	for (size_t i = 0 ; i < keys.size() ; i++)
+	{
+		if (grid_ref.existPoint(keys.get(i)) == true)
+		{grid_ref.template insert<0>(keys.get(i)) += values.template get<0>(i);}
+		else
+		{grid_ref.template insert<0>(keys.get(i)) = values.template get<0>(i);}
+
+		grid_ref.template insert<1>(keys.get(i)) = values.template get<1>(i);
+	}
+
+	// accumulate property 0 and replace property 1
+	grid.template insert_bulk<add_,0>(keys,values);
+	grid.template insert_bulk<replace_,1>(keys,values);
+
+	BOOST_REQUIRE_EQUAL(grid.size(),grid_ref.size());
+	BOOST_REQUIRE_EQUAL(grid.private_get_header_inf().size(),grid_ref.private_get_header_inf().size());
+
+	bool match = true;
+	auto it = grid_ref.getIterator();
+
+	while (it.isNext())
+	{
+		auto key = it.get();
+
+		match &= grid.existPoint(key);
+		match &= grid.template get<0>(key) == grid_ref.template get<0>(key);
+		match &= grid.template get<1>(key) == grid_ref.template get<1>(key);
+
+		++it;
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+
+	// the number of elements of every chunk must be consistent with the mask
+
+	auto & hi = grid.private_get_header_inf();
+	auto & hm = grid.private_get_header_mask();
+
+	for (size_t i = 1 ; i < hi.size() ; i++)
+	{
+		int cnt = 0;
+		for (size_t j = 0 ; j < default_chunking<3>::size::value ; j++)
+		{cnt += hm.get(i).mask[j] & 1;}
+
+		match &= cnt == hi.get(i).nele;
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+}
+
+template<unsigned int dim>
+bool sparse_grid_check_hilbert(size_t bits)
+{
+	size_t sz[dim];
+	for (size_t i = 0 ; i < dim ; i++)
+	{sz[i] = (size_t)1 << bits;}
+
+	grid_sm<dim,void> g(sz);
+	openfpm::vector<size_t> cells;
+	cells.resize(g.size());
+
+	grid_key_dx_iterator<dim> it(g);
+
+	bool match = true;
+
+	while (it.isNext())
+	{
+		auto key = it.get();
+		size_t h = sgrid_sfc<dim>::hilbert(key,bits);
+
+		match &= h < g.size();
+		if (match == false)	{return false;}
+
+		cells.get(h) = g.LinId(key);
+
+		++it;
+	}
+
+	// every cell is visited once and consecutive cells are neighborhood
+	for (size_t i = 1 ; i < cells.size() ; i++)
+	{
+		grid_key_dx<dim> c0 = g.InvLinId(cells.get(i-1));
+		grid_key_dx<dim> c1 = g.InvLinId(cells.get(i));
+
+		size_t dist = 0;
+		for (size_t k = 0 ; k < dim ; k++)
+		{dist += std::abs((long int)c1.get(k) - (long int)c0.get(k));}
+
+		match &= dist == 1;
+	}
+
+	return match;
+}
+
+template<typename grid_type>
+double sparse_grid_nn_chunk_distance(grid_type & grid)
+{
+	grid.template construct_NNlist<NNStar_c<3>>();
+
+	auto & NNlist = grid.private_get_nnlist();
+
+	double dist = 0.0;
+	size_t n = 0;
+
+	for (size_t i = 1 ; i < grid.private_get_header_inf().size() ; i++)
+	{
+		for (size_t k = 0 ; k < NNStar_c<3>::nNN ; k++)
+		{
+			int nn = NNlist.get(i*NNStar_c<3>::nNN + k);
+
+			if (nn < 0)	{continue;}
+
+			dist += std::abs((long int)nn - (long int)i);
+			n++;
+		}
+	}
+
+	return dist / n;
+}
+
+BOOST_AUTO_TEST_CASE( sparse_grid_reorder_sfc )
+{
+	BOOST_REQUIRE_EQUAL(sparse_grid_check_hilbert<2>(4),true);
+	BOOST_REQUIRE_EQUAL(sparse_grid_check_hilbert<3>(3),true);
+
+	size_t sz[3] = {512,512,512};
+
+	sgrid_soa<3,aggregate<double,double,double>,HeapMemory> grid(sz);
+	sgrid_soa<3,aggregate<double,double,double>,HeapMemory> grid_ko(sz);
+
+	grid.getBackgroundValue().template get<0>() = 0.0;
+	grid_ko.getBackgroundValue().template get<0>() = 0.0;
+	grid_ko.setKeepOrdered(SGRID_ORDER_MORTON);
+
+	// the chunks of a ball are created in random order
+
+	openfpm::vector<grid_key_dx<3>> cnks;
+
+	for (long int k = 0 ; k < 32 ; k++)
+	{
+		for (long int j = 0 ; j < 32 ; j++)
+		{
+			for (long int i = 0 ; i < 32 ; i++)
+			{cnks.add(grid_key_dx<3>({i*16,j*16,k*16}));}
+		}
+	}
+
+	std::default_random_engine eg;
+	std::shuffle(&cnks.get(0),&cnks.get(0) + cnks.size(),eg);
+
+	size_t sz_c[3] = {16,16,16};
+	grid_sm<3,void> g_c(sz_c);
+
+	for (size_t c = 0 ; c < cnks.size() ; c++)
+	{
+		grid_key_dx_iterator<3> it(g_c);
+
+		while (it.isNext())
+		{
+			grid_key_dx<3> key = cnks.get(c) + it.get();
+
+			long int dx = key.get(0) - 256;
+			long int dy = key.get(1) - 256;
+			long int dz = key.get(2) - 256;
+
+			if (dx*dx + dy*dy + dz*dz < 80*80)
+			{
+				grid.template insert<0>(key) = (key.get(0) + 2*key.get(1) + 3*key.get(2)) % 13;
+				grid_ko.template insert<0>(key) = (key.get(0) + 2*key.get(1) + 3*key.get(2)) % 13;
+			}
+
+			++it;
+		}
+	}
+
+	grid_key_dx<3> start({1,1,1});
+	grid_key_dx<3> stop({510,510,510});
+
+	int stencil[6][3] = {{1,0,0},{-1,0,0},{0,-1,0},{0,1,0},{0,0,-1},{0,0,1}};
+
+	// on the border the not existing points are undefined
+	auto lap = [](Vc::double_v (& xs)[7], unsigned char * mask_sum){
+		Vc::double_v Lap = xs[1] + xs[2] + xs[3] + xs[4] + xs[5] + xs[6] - 6.0*xs[0];
+
+		auto surround = load_mask<Vc::double_v>(mask_sum);
+
+		return Vc::iif(surround == 6.0,Lap,Vc::double_v(0.0));
+	};
+
+	double d_ins = sparse_grid_nn_chunk_distance(grid);
+
+	grid.conv<0,1,1>(stencil,start,stop,lap);
+
+	double d_ord[2];
+	sgrid_order ord[2] = {SGRID_ORDER_MORTON,SGRID_ORDER_HILBERT};
+
+	bool match = true;
+
+	for (size_t o = 0 ; o < 2 ; o++)
+	{
+		grid.reorder(ord[o]);
+
+		d_ord[o] = sparse_grid_nn_chunk_distance(grid);
+
+		grid.conv<0,2,1>(stencil,start,stop,lap);
+
+		auto it = grid.getIterator();
+
+		while (it.isNext())
+		{
+			auto key = it.get();
+
+			match &= grid.template get<1>(key) == grid.template get<2>(key);
+
+			++it;
+		}
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+	BOOST_REQUIRE(d_ord[0] < d_ins / 4);
+	BOOST_REQUIRE(d_ord[1] < d_ins / 4);
+
+	// keep ordered mode
+
+	size_t n_cnk = grid_ko.private_get_header_inf().size();
+
+	BOOST_REQUIRE_EQUAL(grid_ko.size(),grid.size());
+	BOOST_REQUIRE_EQUAL(n_cnk,grid.private_get_header_inf().size());
+
+	// inserting does not move the chunks, they are merged into the order only explicitly
+	BOOST_REQUIRE_EQUAL(grid_ko.getOrderedChunks(),1ul);
+
+	grid_ko.merge_ordered();
+
+	BOOST_REQUIRE_EQUAL(grid_ko.getOrderedChunks(),n_cnk);
+
+	auto it = grid.getIterator();
+
+	while (it.isNext())
+	{
+		auto key = it.get();
+
+		match &= grid_ko.existPoint(key);
+		match &= grid_ko.template get<0>(key) == grid.template get<0>(key);
+
+		++it;
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+
+	double d_ko = sparse_grid_nn_chunk_distance(grid_ko);
+	BOOST_REQUIRE(d_ko < d_ins / 2);
+}
+
+BOOST_AUTO_TEST_CASE( sparse_grid_chunk_recycle )
+{
+	size_t sz[3] = {256,256,256};
+
+	sgrid_cpu<3,aggregate<double>,HeapMemory> grid(sz);
+
+	// only explicit compaction
+	grid.setCompactionThresholds(std::numeric_limits<size_t>::max(),0.0);
+
+	// a slab moving along x, every step the slab is removed and inserted 16 points further
+
+	size_t n_cnk_max = 0;
+
+	for (size_t step = 0 ; step < 8 ; step++)
+	{
+		Box<3,long int> slab({(long int)step*16,0,0},{(long int)step*16+31,63,63});
+
+		if (step != 0)
+		{
+			Box<3,long int> old({(long int)(step-1)*16,0,0},{(long int)(step-1)*16+15,63,63});
+			grid.remove(old);
+		}
+
+		grid_key_dx_iterator_sub<3> it(grid.getGrid(),slab.getKP1(),slab.getKP2());
+
+		while (it.isNext())
+		{
+			auto key = it.get();
+
+			grid.template insert<0>(key) = key.get(0) + step;
+
+			++it;
+		}
+
+		n_cnk_max = std::max(n_cnk_max,grid.private_get_header_inf().size());
+	}
+
+	// the slab has 2*4*4 chunks, with the recycling the removed chunks are reused
+	BOOST_REQUIRE_EQUAL(n_cnk_max,2*4*4 + 1);
+	BOOST_REQUIRE_EQUAL(grid.size(),32*64*64);
+
+	auto check = [&]()
+	{
+		bool match = true;
+
+		auto it = grid.getIterator();
+		size_t cnt = 0;
+
+		while (it.isNext())
+		{
+			auto key = it.get();
+
+			match &= key.get(0) >= 7*16 && key.get(0) < 7*16+32;
+			match &= grid.template get<0>(key) == key.get(0) + 7;
+			cnt++;
+
+			++it;
+		}
+
+		// the points removed does not exist anymore
+		match &= grid.existPoint(grid_key_dx<3>({0,0,0})) == false;
+		match &= grid.existPoint(grid_key_dx<3>({6*16+5,3,3})) == false;
+		match &= grid.existPoint(grid_key_dx<3>({7*16+5,3,3})) == true;
+
+		return match && cnt == 32*64*64;
+	};
+
+	BOOST_REQUIRE_EQUAL(check(),true);
+
+	// remove a slab of chunks, they become dead and are eliminated by the compaction
+
+	Box<3,long int> half({7*16,0,0},{7*16+31,31,63});
+	grid.remove(half);
+
+	BOOST_REQUIRE_EQUAL(grid.getDeadChunks(),2*2*4);
+
+	size_t n_before = grid.private_get_header_inf().size();
+	grid.compact();
+
+	BOOST_REQUIRE_EQUAL(grid.getDeadChunks(),0ul);
+	BOOST_REQUIRE_EQUAL(grid.private_get_header_inf().size(),n_before - 2*2*4);
+	BOOST_REQUIRE_EQUAL(grid.size(),32*32*64);
+
+	bool match = true;
+	auto it = grid.getIterator();
+
+	while (it.isNext())
+	{
+		auto key = it.get();
+
+		match &= key.get(1) >= 32;
+		match &= grid.template get<0>(key) == key.get(0) + 7;
+
+		++it;
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+
+	// with the thresholds the compaction is automatic
+
+	grid.setCompactionThresholds(8,0.1);
+
+	Box<3,long int> quarter({7*16,32,0},{7*16+31,63,31});
+	grid.remove(quarter);
+
+	BOOST_REQUIRE_EQUAL(grid.getDeadChunks(),0ul);
+	BOOST_REQUIRE_EQUAL(grid.private_get_header_inf().size(),n_before - 2*2*4 - 2*2*2);
+	BOOST_REQUIRE_EQUAL(grid.size(),32*32*32);
+}
+
+BOOST_AUTO_TEST_CASE( sparse_grid_narrow_band )
+{
+	size_t sz[2] = {1024,1024};
+
+	sgrid_cpu<2,aggregate<double>,HeapMemory> grid(sz);
+
+	// chunks are 32x32, the dead chunks are never compacted
+	grid.setCompactionThresholds(std::numeric_limits<size_t>::max(),0.0);
+
+	auto circle = [](double cx, double cy, double r, openfpm::vector<grid_key_dx<2>> & seeds)
+	{
+		seeds.clear();
+
+		for (size_t i = 0 ; i < 2048 ; i++)
+		{
+			double a = 2.0*M_PI*i / 2048.0;
+			seeds.add(grid_key_dx<2>({(long int)(cx + r*cos(a)),(long int)(cy + r*sin(a))}));
+		}
+	};
+
+	// check that the live chunks are exactly the chunks at distance <= width from the seeds
+	auto check_band = [&](openfpm::vector<grid_key_dx<2>> & seeds, long int width)
+	{
+		std::set<std::pair<long int,long int>> seed_cnk;
+
+		for (size_t i = 0 ; i < seeds.size() ; i++)
+		{seed_cnk.insert(std::make_pair(seeds.get(i).get(0) / 32,seeds.get(i).get(1) / 32));}
+
+		std::set<std::pair<long int,long int>> expected;
+
+		for (long int i = 0 ; i < 32 ; i++)
+		{
+			for (long int j = 0 ; j < 32 ; j++)
+			{
+				for (auto & s : seed_cnk)
+				{
+					if (std::abs(s.first - i) + std::abs(s.second - j) <= width)
+					{expected.insert(std::make_pair(i,j));break;}
+				}
+			}
+		}
+
+		std::set<std::pair<long int,long int>> live;
+		auto & hi = grid.private_get_header_inf();
+
+		for (size_t i = 1 ; i < hi.size() ; i++)
+		{
+			if (hi.get(i).pos.get(0) == std::numeric_limits<long int>::min())	{continue;}
+
+			live.insert(std::make_pair(hi.get(i).pos.get(0) / 32,hi.get(i).pos.get(1) / 32));
+		}
+
+		return live == expected && live.size() + grid.getDeadChunks() + 1 == hi.size();
+	};
+
+	openfpm::vector<grid_key_dx<2>> seeds;
+
+	circle(400.0,400.0,200.0,seeds);
+	grid.updateNarrowBand(seeds,2);
+
+	BOOST_REQUIRE_EQUAL(check_band(seeds,2),true);
+	BOOST_REQUIRE_EQUAL(grid.size(),0ul);
+
+	// the new chunks does not have points, we fill the band on the seeds
+
+	for (size_t i = 0 ; i < seeds.size() ; i++)
+	{grid.template insert<0>(seeds.get(i)) = 1.0;}
+
+	size_t max_live = grid.private_get_header_inf().size() - 1;
+
+	// move the interface, the chunks that leave the band are retired with their points
+
+	for (size_t step = 1 ; step <= 4 ; step++)
+	{
+		circle(400.0 + step*40.0,400.0,200.0,seeds);
+		grid.updateNarrowBand(seeds,2);
+
+		BOOST_REQUIRE_EQUAL(check_band(seeds,2),true);
+
+		// the retired slots are recycled, the chunks grow only if the band grow
+		size_t live = grid.private_get_header_inf().size() - 1 - grid.getDeadChunks();
+		max_live = std::max(max_live,live);
+
+		BOOST_REQUIRE_EQUAL(grid.private_get_header_inf().size() - 1,max_live);
+	}
+
+	// the points surviving are in the band
+
+	bool match = true;
+	size_t cnt = 0;
+
+	auto it = grid.getIterator();
+
+	while (it.isNext())
+	{
+		auto key = it.get();
+
+		match &= grid.template get<0>(key) == 1.0;
+		cnt++;
+
+		++it;
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+	BOOST_REQUIRE_EQUAL(cnt,grid.size());
+	BOOST_REQUIRE(cnt != 0);
+
+	// a point far from the band is removed
+	BOOST_REQUIRE_EQUAL(grid.existPoint(grid_key_dx<2>({200,400})),false);
+
+	// width 0 activate only the chunks of the seeds
+
+	grid.updateNarrowBand(seeds,0);
+	BOOST_REQUIRE_EQUAL(check_band(seeds,0),true);
+}
+
+BOOST_AUTO_TEST_CASE( sparse_grid_bit_mask )
+{
+	size_t sz[3] = {128,128,128};
+
+	typedef aggregate<double,double,double> prop;
+
+	sgrid_soa<3,prop,HeapMemory> grid(sz);
+	sgrid_soa<3,prop,HeapMemory,grid_zm<3,void>,typename memory_traits_inte<prop>::type,memory_traits_inte,bit_mask_chunking<default_chunking<3>>> grid_b(sz);
+
+	BOOST_REQUIRE_EQUAL(sizeof(grid_b.private_get_header_mask().get(0)),sizeof(grid.private_get_header_mask().get(0)) / 8);
+
+	grid.getBackgroundValue().template get<0>() = 0.0;
+	grid_b.getBackgroundValue().template get<0>() = 0.0;
+
+	// a sphere shell with holes
+
+	std::default_random_engine eg(17);
+	std::uniform_real_distribution<double> ud(0.0,1.0);
+
+	grid_sm<3,void> g_f(sz);
+	grid_key_dx_iterator<3> it_f(g_f);
+
+	while (it_f.isNext())
+	{
+		auto key = it_f.get();
+
+		double r = sqrt((key.get(0) - 64.0)*(key.get(0) - 64.0) + (key.get(1) - 64.0)*(key.get(1) - 64.0) + (key.get(2) - 64.0)*(key.get(2) - 64.0));
+
+		if (r > 30.0 && r < 50.0 && ud(eg) < 0.9)
+		{
+			grid.template insert<0>(key) = key.get(0) + 2.0*key.get(1) + 3.0*key.get(2);
+			grid_b.template insert<0>(key) = key.get(0) + 2.0*key.get(1) + 3.0*key.get(2);
+		}
+
+		++it_f;
+	}
+
+	Box<3,long int> rm({0,0,0},{63,63,127});
+	grid.remove(rm);
+	grid_b.remove(rm);
+
+	BOOST_REQUIRE_EQUAL(grid.size(),grid_b.size());
+
+	// the bits set match the number of elements
+
+	size_t cnt_bits = 0;
+	for (size_t i = 1 ; i < grid_b.private_get_header_mask().size() ; i++)
+	{cnt_bits += grid_b.private_get_header_mask().get(i).mask.count();}
+
+	BOOST_REQUIRE_EQUAL(cnt_bits,grid_b.size());
+
+	// iterators
+
+	bool match = true;
+	size_t cnt = 0;
+
+	auto it = grid_b.getIterator();
+
+	while (it.isNext())
+	{
+		auto key = it.get();
+
+		match &= grid.existPoint(key);
+		match &= grid.template get<0>(key) == grid_b.template get<0>(key);
+		cnt++;
+
+		++it;
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+	BOOST_REQUIRE_EQUAL(cnt,grid.size());
+
+	grid_key_dx<3> start({10,40,20});
+	grid_key_dx<3> stop({100,90,110});
+
+	size_t cnt_s = 0;
+	size_t cnt_sb = 0;
+
+	auto it_s = grid.getIterator(start,stop);
+	while (it_s.isNext())	{cnt_s++;++it_s;}
+
+	auto it_sb = grid_b.getIterator(start,stop);
+	while (it_sb.isNext())
+	{
+		match &= grid.existPoint(it_sb.get());
+		cnt_sb++;
+		++it_sb;
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+	BOOST_REQUIRE_EQUAL(cnt_s,cnt_sb);
+
+	// convolutions
+
+	grid_key_dx<3> c_start({1,1,1});
+	grid_key_dx<3> c_stop({126,126,126});
+
+	auto lap_cross = [](Vc::double_v & cmd, cross_stencil_v<double> & s, unsigned char * mask_sum)
+	{
+		Vc::double_v Lap = s.xm + s.xp + s.ym + s.yp + s.zm + s.zp - 6.0*cmd;
+
+		Vc::Mask<double> surround;
+
+		for (int i = 0 ; i < Vc::double_v::Size ; i++)
+		{surround[i] = (mask_sum[i] == 6);}
+
+		return Vc::iif(surround,Lap,Vc::double_v(1.0));
+	};
+
+	grid.conv_cross<0,1,1>(c_start,c_stop,lap_cross);
+	grid_b.conv_cross<0,1,1>(c_start,c_stop,lap_cross);
+
+	int stencil[6][3] = {{1,0,0},{-1,0,0},{0,-1,0},{0,1,0},{0,0,-1},{0,0,1}};
+
+	auto lap = [](Vc::double_v (& xs)[7], unsigned char * mask_sum)
+	{
+		Vc::double_v Lap = xs[1] + xs[2] + xs[3] + xs[4] + xs[5] + xs[6] - 6.0*xs[0];
+
+		Vc::Mask<double> surround;
+
+		for (int i = 0 ; i < Vc::double_v::Size ; i++)
+		{surround[i] = (mask_sum[i] == 6);}
+
+		return Vc::iif(surround,Lap,Vc::double_v(1.0));
+	};
+
+	grid.template conv<0,2,1>(stencil,c_start,c_stop,lap);
+	grid_b.template conv<0,2,1>(stencil,c_start,c_stop,lap);
+
+	auto it_c = grid_b.getIterator(c_start,c_stop);
+
+	while (it_c.isNext())
+	{
+		auto key = it_c.get();
+
+		match &= grid.template get<1>(key) == grid_b.template get<1>(key);
+		match &= grid.template get<2>(key) == grid_b.template get<2>(key);
+
+		++it_c;
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+
+	// packed with one byte for each element, it can be unpacked in a grid with the byte mask
+
+	size_t req = 0;
+	grid_b.template packRequest<0>(req);
+
+	Pack_stat sts;
+	HeapMemory pmem;
+	pmem.allocate(req);
+	ExtPreAlloc<HeapMemory> & mem = *(new ExtPreAlloc<HeapMemory>(req,pmem));
+	mem.incRef();
+
+	grid_b.template pack<0>(mem,sts);
+
+	sgrid_soa<3,prop,HeapMemory> grid_u(sz);
+
+	Unpack_stat ps;
+	grid_u.template unpack<0>(mem,ps);
+
+	BOOST_REQUIRE_EQUAL(grid_u.size(),grid.size());
+
+	auto it_u = grid.getIterator();
+
+	while (it_u.isNext())
+	{
+		auto key = it_u.get();
+
+		match &= grid_u.existPoint(key);
+		match &= grid_u.template get<0>(key) == grid.template get<0>(key);
+
+		++it_u;
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+}
+
+BOOST_AUTO_TEST_CASE( sparse_grid_multires )
+{
+	size_t sz[2] = {32,32};
+
+	sgrid_mr<2,aggregate<double,double>,HeapMemory> mr(sz,3);
+
+	BOOST_REQUIRE_EQUAL(mr.getNLevels(),3ul);
+	BOOST_REQUIRE_EQUAL(mr.getLevel(2).getGrid().size(0),128ul);
+
+	// a disk on the finest level
+
+	auto & l2 = mr.getLevel(2);
+
+	for (long int i = 0 ; i < 128 ; i++)
+	{
+		for (long int j = 0 ; j < 128 ; j++)
+		{
+			if ((i-64)*(i-64) + (j-64)*(j-64) > 20*20)	{continue;}
+
+			grid_key_dx<2> key({i,j});
+
+			l2.template insert<0>(key) = 1.0;
+			l2.template insert<1>(key) = i;
+		}
+	}
+
+	size_t n_fine = l2.size();
+
+	mr.template balance<0,1>(1);
+
+	BOOST_REQUIRE_EQUAL(l2.size(),n_fine);
+	BOOST_REQUIRE(mr.getLevel(1).size() != 0);
+	BOOST_REQUIRE(mr.getLevel(0).size() != 0);
+
+	// 2:1 balance, the neighborhood of the parent of every point exist
+
+	bool match = true;
+
+	for (size_t l = 2 ; l >= 1 ; l--)
+	{
+		auto & lf = mr.getLevel(l);
+		auto & lc = mr.getLevel(l-1);
+
+		auto it = lf.getIterator();
+
+		while (it.isNext())
+		{
+			auto key = it.get();
+
+			for (long int i = -1 ; i <= 1 ; i++)
+			{
+				for (long int j = -1 ; j <= 1 ; j++)
+				{
+					long int x = key.get(0)/2 + i;
+					long int y = key.get(1)/2 + j;
+
+					if (x < 0 || y < 0 || x >= (long int)lc.getGrid().size(0) || y >= (long int)lc.getGrid().size(1))	{continue;}
+
+					grid_key_dx<2> p({x,y});
+					match &= lc.existPoint(p);
+				}
+			}
+
+			++it;
+		}
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+
+	// restriction average the children
+
+	auto & l1 = mr.getLevel(1);
+	size_t n_full = 0;
+
+	auto it1 = l1.getIterator();
+
+	while (it1.isNext())
+	{
+		auto key = it1.get();
+
+		size_t n_child = 0;
+
+		for (long int i = 0 ; i < 2 ; i++)
+		{
+			for (long int j = 0 ; j < 2 ; j++)
+			{
+				grid_key_dx<2> c({2*key.get(0)+i,2*key.get(1)+j});
+				n_child += l2.existPoint(c);
+			}
+		}
+
+		if (n_child != 0)	{match &= l1.template get<0>(key) == 1.0;}
+
+		if (n_child == 4)
+		{
+			match &= l1.template get<1>(key) == 2*key.get(0) + 0.5;
+			n_full++;
+		}
+
+		++it1;
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+	BOOST_REQUIRE(n_full != 0);
+
+	// the level 0 and the levels outside the hierarchy do not have a coarser level
+
+	size_t n_l1 = l1.size();
+
+	mr.template restriction<0>(0);
+	mr.template prolongation<0>(3);
+	mr.template fillGhost<0>(3,1);
+
+	BOOST_REQUIRE_EQUAL(l1.size(),n_l1);
+	BOOST_REQUIRE_EQUAL(l2.size(),n_fine);
+
+	// prolongation
+
+	it1 = l1.getIterator();
+
+	while (it1.isNext())
+	{
+		auto key = it1.get();
+
+		l1.template insert<0>(key) = 7.0 + key.get(0);
+
+		++it1;
+	}
+
+	mr.template prolongation<0>(2);
+
+	auto it2 = l2.getIterator();
+
+	while (it2.isNext())
+	{
+		auto key = it2.get();
+
+		match &= l2.template get<0>(key) == 7.0 + key.get(0)/2;
+
+		++it2;
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+
+	// ghost filled from the parent level
+
+	std::set<size_t> orig;
+
+	it2 = l2.getIterator();
+
+	while (it2.isNext())
+	{
+		orig.insert(l2.getGrid().LinId(it2.get()));
+		++it2;
+	}
+
+	for (size_t k = 0 ; k < 2 ; k++)
+	{
+		mr.template fillGhost<0>(2,2);
+
+		auto & gh = mr.getGhost(2);
+
+		BOOST_REQUIRE(gh.size() != 0);
+		BOOST_REQUIRE_EQUAL(l2.size(),n_fine + gh.size());
+
+		for (size_t i = 0 ; i < gh.size() ; i++)
+		{
+			auto key = gh.get(i);
+			grid_key_dx<2> p({key.get(0)/2,key.get(1)/2});
+
+			match &= orig.find(l2.getGrid().LinId(key)) == orig.end();
+			match &= l1.existPoint(p);
+			match &= l2.template get<0>(key) == 7.0 + key.get(0)/2;
+		}
+
+		// every point at distance 2 with a parent is filled
+
+		for (auto lin : orig)
+		{
+			grid_key_dx<2> key = l2.getGrid().InvLinId(lin);
+
+			for (long int i = -2 ; i <= 2 ; i++)
+			{
+				for (long int j = -2 ; j <= 2 ; j++)
+				{
+					grid_key_dx<2> q({key.get(0)+i,key.get(1)+j});
+					grid_key_dx<2> p({q.get(0)/2,q.get(1)/2});
+
+					if (l1.existPoint(p) == true)	{match &= l2.existPoint(q);}
+				}
+			}
+		}
+
+		BOOST_REQUIRE_EQUAL(match,true);
+	}
+
+	mr.clearGhost(2);
+
+	BOOST_REQUIRE_EQUAL(l2.size(),n_fine);
+}
+
+BOOST_AUTO_TEST_CASE( sparse_grid_dense_conversion )
+{
+	size_t sz[3] = {128,128,128};
+
+	sgrid_cpu<3,aggregate<double,float[3]>,HeapMemory> grid(sz);
+	grid.template setBackgroundValue<0>(-1.0);
+
+	// full chunks
+
+	for (long int i = 16 ; i < 48 ; i++)
+	{
+		for (long int j = 16 ; j < 48 ; j++)
+		{
+			for (long int k = 16 ; k < 48 ; k++)
+			{
+				grid_key_dx<3> key({i,j,k});
+
+				grid.template insert<0>(key) = i + 1000*j + 1000000*k;
+				grid.template insert<1>(key)[0] = i;
+				grid.template insert<1>(key)[1] = j;
+				grid.template insert<1>(key)[2] = k;
+			}
+		}
+	}
+
+	// partially filled chunks
+
+	std::default_random_engine eg;
+	std::uniform_int_distribution<int> ud(0,127);
+
+	for (size_t i = 0 ; i < 50000 ; i++)
+	{
+		grid_key_dx<3> key({ud(eg),ud(eg),ud(eg)});
+
+		grid.template insert<0>(key) = key.get(0) + 1000*key.get(1) + 1000000*key.get(2);
+		grid.template insert<1>(key)[0] = key.get(0);
+		grid.template insert<1>(key)[1] = key.get(1);
+		grid.template insert<1>(key)[2] = key.get(2);
+	}
+
+	Box<3,long int> box({5,10,0},{100,90,127});
+	size_t sz_d[3] = {96,81,128};
+
+	grid_cpu<3,aggregate<double,float[3]>> dense(sz_d);
+	dense.setMemory();
+
+	grid.template to_dense<0,1>(box,dense);
+
+	bool match = true;
+	size_t n_exist = 0;
+
+	grid_key_dx_iterator<3> it(dense.getGrid());
+
+	while (it.isNext())
+	{
+		auto kd = it.get();
+		grid_key_dx<3> key({kd.get(0)+5,kd.get(1)+10,kd.get(2)});
+
+		if (grid.existPoint(key) == true)
+		{
+			match &= dense.template get<0>(kd) == grid.template get<0>(key);
+			match &= dense.template get<1>(kd)[0] == key.get(0);
+			match &= dense.template get<1>(kd)[1] == key.get(1);
+			match &= dense.template get<1>(kd)[2] == key.get(2);
+			n_exist++;
+		}
+		else
+		{match &= dense.template get<0>(kd) == -1.0;}
+
+		++it;
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+	BOOST_REQUIRE(n_exist > 32*32*32);
+
+	// from dense with a threshold
+
+	size_t sz_d2[3] = {64,48,40};
+
+	grid_cpu<3,aggregate<double,float[3]>> dense2(sz_d2);
+	dense2.setMemory();
+
+	grid_key_dx_iterator<3> it2(dense2.getGrid());
+
+	while (it2.isNext())
+	{
+		auto kd = it2.get();
+
+		// the first chunk is full
+		if (kd.get(0) < 16 && kd.get(1) < 16 && kd.get(2) < 16)
+		{dense2.template get<0>(kd) = 100.0;}
+		else
+		{dense2.template get<0>(kd) = (double)((kd.get(0)*7 + kd.get(1)*3 + kd.get(2)) % 10) - 4.5;}
+
+		dense2.template get<1>(kd)[0] = kd.get(0);
+		dense2.template get<1>(kd)[1] = kd.get(1);
+		dense2.template get<1>(kd)[2] = kd.get(2);
+
+		++it2;
+	}
+
+	grid_key_dx<3> origin({16,0,32});
+
+	sgrid_cpu<3,aggregate<double,float[3]>,HeapMemory> grid2(sz);
+
+	// a point outside and a point inside that is not selected by the predicate
+	grid_key_dx<3> p_out({3,3,3});
+	grid_key_dx<3> p_in({16+17,1,32+1});
+	grid2.template insert<0>(p_out) = 5.0;
+	grid2.template insert<0>(p_in) = 77.0;
+
+	BOOST_REQUIRE(fabs(dense2.template get<0>(p_in - origin)) <= 2.0);
+
+	grid2.template from_dense<0,1>(dense2,dense_threshold<0,double>(2.0),origin);
+
+	size_t n_act = 0;
+
+	it2.reset();
+
+	while (it2.isNext())
+	{
+		auto kd = it2.get();
+		grid_key_dx<3> key = kd + origin;
+
+		bool act = fabs(dense2.template get<0>(kd)) > 2.0;
+		n_act += act;
+
+		if (act == true)
+		{
+			match &= grid2.existPoint(key);
+			match &= grid2.template get<0>(key) == dense2.template get<0>(kd);
+			match &= grid2.template get<1>(key)[0] == kd.get(0);
+			match &= grid2.template get<1>(key)[2] == kd.get(2);
+		}
+		else if (key != p_in)
+		{match &= grid2.existPoint(key) == false;}
+
+		++it2;
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+	BOOST_REQUIRE_EQUAL(grid2.size(),n_act + 2);
+	BOOST_REQUIRE_EQUAL(grid2.template get<0>(p_out),5.0);
+	BOOST_REQUIRE_EQUAL(grid2.template get<0>(p_in),77.0);
+
+	// round trip
+
+	Box<3,long int> box2({16,0,32},{16+63,47,32+39});
+	grid_cpu<3,aggregate<double,float[3]>> dense3(sz_d2);
+	dense3.setMemory();
+
+	grid2.template setBackgroundValue<0>(0.0);
+	grid2.template to_dense<0>(box2,dense3);
+
+	it2.reset();
+
+	while (it2.isNext())
+	{
+		auto kd = it2.get();
+
+		double v = dense2.template get<0>(kd);
+		double v_ref = (fabs(v) > 2.0)?v:0.0;
+
+		grid_key_dx<3> key = kd + origin;
+		if (key == p_in)	{v_ref = 77.0;}
+
+		match &= dense3.template get<0>(kd) == v_ref;
+
+		++it2;
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
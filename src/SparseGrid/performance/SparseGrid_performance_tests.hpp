@@ -0,0 +1,333 @@
+/*
+ * SparseGrid_performance_tests.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Pietro Incardona
+ */
+
+#ifndef OPENFPM_DATA_SRC_SPARSEGRID_PERFORMANCE_SPARSEGRID_PERFORMANCE_TESTS_HPP_
+#define OPENFPM_DATA_SRC_SPARSEGRID_PERFORMANCE_SPARSEGRID_PERFORMANCE_TESTS_HPP_
+
+#include "SparseGrid/SparseGrid.hpp"
+#include "util/stat/common_statistics.hpp"
+#include <random>
+
+// Property tree
+struct report_sparse_grid_tests
+{
+	boost::property_tree::ptree graphs;
+};
+
+report_sparse_grid_tests report_sparse_grid_funcs;
+
+/*! \brief Add the measures of one test to the report
+ *
+ * \param id id of the test in the report
+ * \param name name of the test
+ * \param times measures
+ *
+ */
+static inline void sparse_grid_performance_report(int id, const std::string & name, std::vector<double> & times)
+{
+	double mean;
+	double dev;
+	standard_deviation(times,mean,dev);
+
+	report_sparse_grid_funcs.graphs.put("performance.sparse_grid.set(" + std::to_string(id) + ").x.data.name",name);
+	report_sparse_grid_funcs.graphs.put("performance.sparse_grid.set(" + std::to_string(id) + ").y.data.mean",mean);
+	report_sparse_grid_funcs.graphs.put("performance.sparse_grid.set(" + std::to_string(id) + ").y.data.dev",dev);
+}
+
+/*! \brief Fill a ball of radius 80 in a 512^3 sparse grid, the chunks are created in random order
+ *
+ * \param grid sparse grid to fill
+ *
+ */
+template<typename grid_type>
+void sparse_grid_performance_fill_ball(grid_type & grid)
+{
+	openfpm::vector<grid_key_dx<3>> cnks;
+
+	for (long int k = 0 ; k < 32 ; k++)
+	{
+		for (long int j = 0 ; j < 32 ; j++)
+		{
+			for (long int i = 0 ; i < 32 ; i++)
+			{cnks.add(grid_key_dx<3>({i*16,j*16,k*16}));}
+		}
+	}
+
+	std::default_random_engine eg;
+	std::shuffle(&cnks.get(0),&cnks.get(0) + cnks.size(),eg);
+
+	size_t sz_c[3] = {16,16,16};
+	grid_sm<3,void> g_c(sz_c);
+
+	for (size_t c = 0 ; c < cnks.size() ; c++)
+	{
+		grid_key_dx_iterator<3> it(g_c);
+
+		while (it.isNext())
+		{
+			grid_key_dx<3> key = cnks.get(c) + it.get();
+
+			long int dx = key.get(0) - 256;
+			long int dy = key.get(1) - 256;
+			long int dz = key.get(2) - 256;
+
+			if (dx*dx + dy*dy + dz*dz < 80*80)
+			{grid.template insert<0>(key) = (key.get(0) + 2*key.get(1) + 3*key.get(2)) % 13;}
+
+			++it;
+		}
+	}
+}
+
+BOOST_AUTO_TEST_SUITE( sparse_grid_performance )
+
+BOOST_AUTO_TEST_CASE(sparse_grid_performance_conv_order)
+{
+	size_t sz[3] = {512,512,512};
+
+	sgrid_soa<3,aggregate<double,double>,HeapMemory> grid(sz);
+	grid.getBackgroundValue().template get<0>() = 0.0;
+
+	sparse_grid_performance_fill_ball(grid);
+
+	grid_key_dx<3> start({1,1,1});
+	grid_key_dx<3> stop({510,510,510});
+
+	int stencil[6][3] = {{1,0,0},{-1,0,0},{0,-1,0},{0,1,0},{0,0,-1},{0,0,1}};
+
+	auto lap = [](Vc::double_v (& xs)[7], unsigned char *){
+		return xs[1] + xs[2] + xs[3] + xs[4] + xs[5] + xs[6] - 6.0*xs[0];
+	};
+
+	// insertion order, Morton and Hilbert order of the chunks
+	const char * names[3] = {"SGrid_conv_ins","SGrid_conv_morton","SGrid_conv_hilbert"};
+	sgrid_order ord[3] = {SGRID_ORDER_NONE,SGRID_ORDER_MORTON,SGRID_ORDER_HILBERT};
+
+	for (size_t o = 0 ; o < 3 ; o++)
+	{
+		grid.reorder(ord[o]);
+
+		std::vector<double> times(N_STAT_SMALL + 1);
+
+		for (size_t i = 0 ; i < N_STAT_SMALL+1 ; i++)
+		{
+			timer t;
+			t.start();
+
+			grid.template conv<0,1,1>(stencil,start,stop,lap);
+
+			t.stop();
+
+			times[i] = t.getwct();
+		}
+
+		sparse_grid_performance_report(o,names[o],times);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(sparse_grid_performance_conv_generic_stencil)
+{
+	size_t sz[3] = {512,512,512};
+
+	sgrid_soa<3,aggregate<double,double>,HeapMemory> grid(sz);
+	grid.getBackgroundValue().template get<0>() = 0.0;
+
+	sparse_grid_performance_fill_ball(grid);
+
+	grid_key_dx<3> start({1,1,1});
+	grid_key_dx<3> stop({510,510,510});
+
+	// 27 points stencil
+
+	int box[26][3];
+	int n = 0;
+
+	for (int k = -1 ; k <= 1 ; k++)
+	{
+		for (int j = -1 ; j <= 1 ; j++)
+		{
+			for (int i = -1 ; i <= 1 ; i++)
+			{
+				if (i == 0 && j == 0 && k == 0)	{continue;}
+
+				box[n][0] = i;
+				box[n][1] = j;
+				box[n][2] = k;
+				n++;
+			}
+		}
+	}
+
+	// naive get for every point of the stencil
+
+	std::vector<double> times(N_STAT_SMALL + 1);
+
+	for (size_t i = 0 ; i < N_STAT_SMALL+1 ; i++)
+	{
+		timer t;
+		t.start();
+
+		auto it = grid.getIterator(start,stop);
+
+		while (it.isNext())
+		{
+			auto p = it.get();
+
+			double sum = 0.0;
+
+			for (size_t s = 0 ; s < 26 ; s++)
+			{
+				grid_key_dx<3> q = p;
+
+				for (size_t k = 0 ; k < 3 ; k++)
+				{q.set_d(k,p.get(k) + box[s][k]);}
+
+				sum += grid.template get<0>(q);
+			}
+
+			grid.template insert<1>(p) = sum - 26.0*grid.template get<0>(p);
+
+			++it;
+		}
+
+		t.stop();
+
+		times[i] = t.getwct();
+	}
+
+	sparse_grid_performance_report(3,"SGrid_conv27_naive",times);
+
+	// vectorized conv
+
+	for (size_t i = 0 ; i < N_STAT_SMALL+1 ; i++)
+	{
+		timer t;
+		t.start();
+
+		grid.template conv<0,1,1>(box,start,stop,[](Vc::double_v (& xs)[27], unsigned char *){
+			Vc::double_v sum = xs[1];
+
+			for (size_t s = 2 ; s < 27 ; s++)
+			{sum += xs[s];}
+
+			return sum - 26.0*xs[0];
+		});
+
+		t.stop();
+
+		times[i] = t.getwct();
+	}
+
+	sparse_grid_performance_report(4,"SGrid_conv27",times);
+}
+
+BOOST_AUTO_TEST_CASE(sparse_grid_performance_insert_bulk)
+{
+	size_t sz[3] = {512,512,512};
+
+	// scattered points with repetitions
+
+	openfpm::vector<grid_key_dx<3>> keys;
+	openfpm::vector<aggregate<double,int>> values;
+
+	std::default_random_engine eg;
+	std::uniform_int_distribution<int> ud(0,511);
+
+	for (size_t i = 0 ; i < 200000 ; i++)
+	{
+		grid_key_dx<3> key({ud(eg),ud(eg),ud(eg)});
+
+		if (i % 10 == 0 && i != 0)	{key = keys.get(i/2);}
+
+		keys.add(key);
+		values.add();
+		values.last().template get<0>() = i % 17;
+		values.last().template get<1>() = i % 13;
+	}
+
+	// insert one point at time
+
+	std::vector<double> times(N_STAT_SMALL + 1);
+
+	for (size_t i = 0 ; i < N_STAT_SMALL+1 ; i++)
+	{
+		sgrid_cpu<3,aggregate<double,int>,HeapMemory> grid(sz);
+
+		timer t;
+		t.start();
+
+		for (size_t j = 0 ; j < keys.size() ; j++)
+		{
+			if (grid.existPoint(keys.get(j)) == true)
+			{grid.template insert<0>(keys.get(j)) += values.template get<0>(j);}
+			else
+			{grid.template insert<0>(keys.get(j)) = values.template get<0>(j);}
+
+			grid.template insert<1>(keys.get(j)) = values.template get<1>(j);
+		}
+
+		t.stop();
+
+		times[i] = t.getwct();
+	}
+
+	sparse_grid_performance_report(5,"SGrid_insert",times);
+
+	// insert_bulk
+
+	for (size_t i = 0 ; i < N_STAT_SMALL+1 ; i++)
+	{
+		sgrid_cpu<3,aggregate<double,int>,HeapMemory> grid(sz);
+
+		timer t;
+		t.start();
+
+		grid.template insert_bulk<add_,0>(keys,values);
+		grid.template insert_bulk<replace_,1>(keys,values);
+
+		t.stop();
+
+		times[i] = t.getwct();
+	}
+
+	sparse_grid_performance_report(6,"SGrid_insert_bulk",times);
+}
+
+/////// THIS IS NOT A TEST IT WRITE THE PERFORMANCE RESULT ///////
+
+BOOST_AUTO_TEST_CASE(sparse_grid_performance_write_report)
+{
+	// Create a graphs
+
+	report_sparse_grid_funcs.graphs.put("graphs.graph(0).type","line");
+	report_sparse_grid_funcs.graphs.add("graphs.graph(0).title","Sparse grid 7 points conv in insertion/Morton/Hilbert order of the chunks, 27 points naive get and conv, insert and insert_bulk");
+	report_sparse_grid_funcs.graphs.add("graphs.graph(0).x.title","Tests");
+	report_sparse_grid_funcs.graphs.add("graphs.graph(0).y.title","Time seconds");
+	report_sparse_grid_funcs.graphs.add("graphs.graph(0).y.data(0).source","performance.sparse_grid.set(#).y.data.mean");
+	report_sparse_grid_funcs.graphs.add("graphs.graph(0).x.data(0).source","performance.sparse_grid.set(#).x.data.name");
+	report_sparse_grid_funcs.graphs.add("graphs.graph(0).y.data(0).title","Actual");
+	report_sparse_grid_funcs.graphs.add("graphs.graph(0).interpolation","lines");
+
+	boost::property_tree::xml_writer_settings<std::string> settings(' ', 4);
+	boost::property_tree::write_xml("sparse_grid_performance_funcs.xml", report_sparse_grid_funcs.graphs,std::locale(),settings);
+
+	GoogleChart cg;
+
+	std::string file_xml_ref(test_dir);
+	file_xml_ref += std::string("/openfpm_data/sparse_grid_performance_funcs_ref.xml");
+
+	StandardXMLPerformanceGraph("sparse_grid_performance_funcs.xml",file_xml_ref,cg);
+
+	addUpdateTime(cg,1,"data","sparse_grid_performance_funcs");
+	createCommitFile("data");
+
+	cg.write("sparse_grid_performance_funcs.html");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif /* OPENFPM_DATA_SRC_SPARSEGRID_PERFORMANCE_SPARSEGRID_PERFORMANCE_TESTS_HPP_ */
@@ -21,6 +21,7 @@
 #include "util/util_debug.hpp"
 #include "util/Pack_stat.hpp"
 #include "Grid/map_grid.hpp"
+#include "Packer_Unpacker/Checkpoint_fwd.hpp"
 #include "memory/HeapMemory.hpp"
 #include "vect_isel.hpp"
 #include "util/object_s_di.hpp"
@@ -40,6 +41,7 @@
 #include "util/cuda_util.hpp"
 #include "cuda/map_vector_cuda_ker.cuh"
 #include "map_vector_printers.hpp"
+#include "map_vector_parallel.hpp"
 
 namespace openfpm
 {
@@ -770,6 +772,10 @@ namespace openfpm
 				std::cerr << __FILE__ << ":" << __LINE__ << " error merge_prp: v.size()=" << v.size() << " must be the same as o_part.size()" << opart.size() << std::endl;
 
 #endif
+			// merge property by property if all the properties are arithmetic (memory_traits_inte only)
+			if (merge_prp_host_block<merge_prp_host_fast<S,T,layout_base2<S>,layout_base<T>,args...>::value>::template scatter<op,args...>(v,*this,opart) == true)
+			{return;}
+
 			//! Add the element of v
 			for (size_t i = 0 ; i < v.size() ; i++)
 			{
@@ -1037,6 +1043,16 @@ namespace openfpm
 		void merge_prp_v(const vector<S,M,layout_base2,gp,OPENFPM_NATIVE> & v,
 				         size_t start)
 		{
+#ifdef SE_CLASS1
+
+			if (start + v.size() > v_size)
+				std::cerr << "Error: " << __FILE__ << ":" << __LINE__ << " try to access element " << start+v.size()-1 << " but the vector has size " << size() << std::endl;
+
+#endif
+			// merge property by property if all the properties are arithmetic (memory_traits_inte only)
+			if (merge_prp_host_block<merge_prp_host_fast<S,T,layout_base2<S>,layout_base<T>,args...>::value>::template range<op,args...>(v,*this,start) == true)
+			{return;}
+
 			//! Add the element of v
 			for (size_t i = 0 ; i < v.size() ; i++)
 			{
@@ -1073,6 +1089,21 @@ namespace openfpm
 				  unsigned int ...args>
 		void add_prp(const vector<S,M,layout_base2,gp,impl> & v)
 		{
+			// copy property by property if all the properties are arithmetic (memory_traits_inte only)
+			if (impl == OPENFPM_NATIVE && merge_prp_host_fast<S,T,layout_base2<S>,layout_base<T>,args...>::value == true)
+			{
+				size_t old_sz = size();
+
+				if (old_sz + v.size() > base.size())
+				{reserve(grow_p::grow(base.size(),old_sz + v.size()));}
+
+				resize(old_sz + v.size());
+
+				merge_prp_host_block<impl == OPENFPM_NATIVE && merge_prp_host_fast<S,T,layout_base2<S>,layout_base<T>,args...>::value>::template range<replace_,args...>(v,*this,old_sz);
+
+				return;
+			}
+
 			//! Add the element of v
 			for (size_t i = 0 ; i < v.size() ; i++)
 			{
@@ -2129,13 +2160,88 @@ namespace openfpm
 		}
 
 		/*! \brief Return the pointer that store the data
+		 *
+		 * \tparam property from which take the pointer
 		 *
 		 * \return the pointer that store the data
 		 *
 		 */
 		template<unsigned int p = 0> const void * getPointer() const
 		{
-			return base.getPointer();
+			return base.template getPointer<p>();
+		}
+
+		/*! \brief Save the vector in a checkpoint file
+		 *
+		 * The checkpoint contain the description of the properties and the layout of the data, so it can be
+		 * loaded by a vector with a different layout (memory_traits_lin/memory_traits_inte)
+		 *
+		 * \note Packer_Unpacker/Checkpoint.hpp must be included to use save and load
+		 *
+		 * \param path file
+		 * \param n_stripe split the data in n_stripe files written in parallel
+		 *
+		 * \return true if succeed
+		 *
+		 */
+		bool save(const std::string & path, size_t n_stripe = 1) const
+		{
+			std::vector<uint64_t> sz({v_size});
+
+			return checkpoint_call<T>::template save_dense<layout_base<T>>(path,*this,CHECKPOINT_VECTOR,CHECKPOINT_ORDER_ROW,sz,v_size,base.size(),n_stripe);
+		}
+
+		/*! \brief Load the vector from a checkpoint file
+		 *
+		 * The vector is resized to the number of elements stored in the checkpoint
+		 *
+		 * \note Packer_Unpacker/Checkpoint.hpp must be included to use save and load
+		 *
+		 * \param path file
+		 *
+		 * \return true if succeed
+		 *
+		 */
+		bool load(const std::string & path)
+		{
+			auto resize = [this](const std::vector<uint64_t> & sz) -> size_t
+			{
+				this->resize(sz[0]);
+
+				return this->base.size();
+			};
+
+			return checkpoint_call<T>::template load_dense<layout_base<T>>(path,*this,CHECKPOINT_VECTOR,CHECKPOINT_ORDER_ROW,1,resize);
+		}
+
+		/*! \brief Property p of the vector as a grid expression
+		 *
+		 * \code{.cpp}
+		 * v.template prop<0>() = a * v.template prop<1>() + v.template prop<2>();
+		 * \endcode
+		 *
+		 * \tparam p property
+		 *
+		 * \return the grid expression
+		 *
+		 */
+		template<unsigned int p>
+		grid_expression_prop<p,1,self_type,grid_sm<1,void>> prop()
+		{
+			return grid_expression_prop<p,1,self_type,grid_sm<1,void>>(*this,grid_sm<1,void>(size()));
+		}
+
+		/*! \brief Property p of the vector as a read-only grid expression
+		 *
+		 * \tparam p property
+		 *
+		 * \return the grid expression
+		 *
+		 */
+		template<unsigned int p>
+		grid_expression_prop<p,1,const self_type,grid_sm<1,void>> prop() const
+		{
+			return grid_expression_prop<p,1,const self_type,grid_sm<1,void>>(*this,grid_sm<1,void>(size()));
 		}
 
 		/*! \brief This class has pointer inside
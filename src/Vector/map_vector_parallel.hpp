@@ -0,0 +1,594 @@
+/*
+ * map_vector_parallel.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Pietro Incardona
+ */
+
+#ifndef OPENFPM_DATA_SRC_VECTOR_MAP_VECTOR_PARALLEL_HPP_
+#define OPENFPM_DATA_SRC_VECTOR_MAP_VECTOR_PARALLEL_HPP_
+
+#include <type_traits>
+#include <vector>
+#include <tuple>
+#include <utility>
+#include <cstring>
+#include <boost/mpl/at.hpp>
+#include <boost/mpl/range_c.hpp>
+#include "util/openmp_util.hpp"
+#include "util/copy_compare/copy_general.hpp"
+#include "memory_ly/memory_conf.hpp"
+#include "util/variadic_to_vmpl.hpp"
+#include "util/for_each_ref.hpp"
+
+namespace openfpm
+{
+	/*! \brief Strided view on one property of an openfpm::vector
+	 *
+	 * It remove the encap indirection of get<p>(i). The stride is a compile-time constant,
+	 * for memory_traits_inte it is the size of the property (contiguous buffer, the loops
+	 * vectorize), for memory_traits_lin it is the size of the full aggregate
+	 *
+	 * \tparam prp property
+	 * \tparam vector_type openfpm::vector (const qualified for read-only access)
+	 *
+	 */
+	template<unsigned int prp, typename vector_type>
+	struct vector_prp_stream
+	{
+		//! vector without qualifiers
+		typedef typename std::remove_const<vector_type>::type vector_type_nc;
+
+		//! type of the object stored in the vector
+		typedef typename vector_type_nc::value_type value_type;
+
+		//! type of the property
+		typedef typename boost::mpl::at<typename value_type::type,boost::mpl::int_<prp>>::type prp_type_nc;
+
+		//! type of the property with the constness of the vector
+		typedef typename std::conditional<std::is_const<vector_type>::value,const prp_type_nc,prp_type_nc>::type prp_type;
+
+		//! byte type with the constness of the vector
+		typedef typename std::conditional<std::is_const<vector_type>::value,const unsigned char,unsigned char>::type byte_type;
+
+		static_assert(std::rank<prp_type_nc>::value == 0,"parallel vector algorithms work only on properties that are not arrays");
+
+		//! distance in byte between two consecutive elements
+		static const size_t stride = (is_layout_inte<typename vector_type_nc::layout_base_>::value)?sizeof(prp_type_nc):sizeof(typename value_type::type);
+
+		//! pointer to the property of the first element
+		byte_type * base;
+
+		/*! \brief Constructor
+		 *
+		 * \param v vector (must have at least one element)
+		 *
+		 */
+		vector_prp_stream(vector_type & v)
+		:base((byte_type *)&v.template get<prp>(0))
+		{}
+
+		/*! \brief Get the property of the element i
+		 *
+		 * \param i element
+		 *
+		 * \return reference to the property
+		 *
+		 */
+		inline prp_type & operator[](size_t i) const
+		{
+			return *(prp_type *)(base + i*stride);
+		}
+	};
+
+	/*! \brief Check if an operation is replace_
+	 *
+	 * \tparam op operation
+	 *
+	 */
+	template<template<typename,typename> class op>
+	struct is_op_replace
+	{
+		//! false in general
+		static const bool value = false;
+	};
+
+	/*! \brief Check if an operation is replace_
+	 *
+	 * Specialization for replace_
+	 *
+	 */
+	template<>
+	struct is_op_replace<replace_>
+	{
+		//! replace_ operation
+		static const bool value = true;
+	};
+
+	/*! \brief Check if the source property sp can be merged into the destination property dp
+	 *         with a block loop
+	 *
+	 * It is possible if the two properties are the same arithmetic type
+	 *
+	 * \tparam Tsrc source aggregate
+	 * \tparam Tdst destination aggregate
+	 * \tparam sp source property
+	 * \tparam dp destination property
+	 *
+	 */
+	template<typename Tsrc, typename Tdst, unsigned int sp, int dp>
+	struct merge_prp_host_prp_fast
+	{
+		//! source property type
+		typedef typename boost::mpl::at<typename Tsrc::type,boost::mpl::int_<sp>>::type stype;
+
+		//! destination property type
+		typedef typename boost::mpl::at<typename Tdst::type,boost::mpl::int_<dp>>::type dtype;
+
+		//! true if the block path can be used
+		static const bool value = std::is_same<stype,dtype>::value && std::is_arithmetic<stype>::value;
+	};
+
+	//! Pack of booleans
+	template<bool ... b>
+	struct merge_prp_bool_pack
+	{};
+
+	/*! \brief Check if all the properties can be merged with the block path
+	 *
+	 * \tparam Tsrc source aggregate
+	 * \tparam Tdst destination aggregate
+	 * \tparam seq index sequence of the source properties
+	 * \tparam prp destination properties
+	 *
+	 */
+	template<typename Tsrc, typename Tdst, typename seq, int ... prp>
+	struct merge_prp_host_fast_impl;
+
+	//! Check if all the properties can be merged with the block path
+	template<typename Tsrc, typename Tdst, unsigned int ... I, int ... prp>
+	struct merge_prp_host_fast_impl<Tsrc,Tdst,std::integer_sequence<unsigned int,I...>,prp...>
+	{
+		//! true if all the properties can use the block path
+		static const bool value = std::is_same<merge_prp_bool_pack<true,merge_prp_host_prp_fast<Tsrc,Tdst,I,prp>::value...>,
+		                                       merge_prp_bool_pack<merge_prp_host_prp_fast<Tsrc,Tdst,I,prp>::value...,true>>::value;
+	};
+
+	/*! \brief Check if all the properties can be merged with the block path
+	 *
+	 * Only memory_traits_inte vectors use the block path, with memory_traits_lin one pass for
+	 * each property read the full aggregate, and the element by element merge is faster
+	 *
+	 * \tparam Tsrc source aggregate
+	 * \tparam Tdst destination aggregate
+	 * \tparam layout_src layout of the source
+	 * \tparam layout_dst layout of the destination
+	 * \tparam prp destination properties
+	 *
+	 */
+	template<typename Tsrc, typename Tdst, typename layout_src, typename layout_dst, int ... prp>
+	struct merge_prp_host_fast
+	{
+		//! true if all the properties can use the block path
+		static const bool value = is_layout_inte<layout_src>::value && is_layout_inte<layout_dst>::value &&
+		                          merge_prp_host_fast_impl<Tsrc,Tdst,std::make_integer_sequence<unsigned int,sizeof...(prp)>,prp...>::value;
+	};
+
+	/*! \brief this class is a functor for "for_each" algorithm
+	 *
+	 * For each property it merge the source vector into the range [start,start+v_src.size())
+	 * of the destination vector. The properties are processed as blocks, with a memcpy
+	 * when the operation is replace_ and with a vectorized loop otherwise. The range is split
+	 * across threads
+	 *
+	 * \tparam op operation
+	 * \tparam vector_src source vector
+	 * \tparam vector_dst destination vector
+	 * \tparam prp destination properties
+	 *
+	 */
+	template<template<typename,typename> class op, typename vector_src, typename vector_dst, int ... prp>
+	struct merge_prp_host_range
+	{
+		//! Convert the packed properties into an MPL vector
+		typedef typename to_boost_vmpl<prp...>::type v_prp;
+
+		//! source vector
+		const vector_src & v_src;
+
+		//! destination vector
+		vector_dst & v_dst;
+
+		//! first element of the destination
+		size_t start;
+
+		/*! \brief Constructor
+		 *
+		 * \param v_src source vector
+		 * \param v_dst destination vector
+		 * \param start first element of the destination
+		 *
+		 */
+		merge_prp_host_range(const vector_src & v_src, vector_dst & v_dst, size_t start)
+		:v_src(v_src),v_dst(v_dst),start(start)
+		{}
+
+		//! It call the functor for each property
+		template<typename T>
+		void operator()(T& /*t*/)
+		{
+			typedef vector_prp_stream<T::value,const vector_src> stream_src;
+			typedef vector_prp_stream<boost::mpl::at<v_prp,boost::mpl::int_<T::value>>::type::value,vector_dst> stream_dst;
+			typedef typename stream_dst::prp_type_nc prp_type;
+
+			size_t n = v_src.size();
+
+			if (n == 0)	{return;}
+
+			stream_src src(v_src);
+			stream_dst dst(v_dst);
+
+			#pragma omp parallel if (n >= OPENFPM_OMP_MIN_ELEMENTS)
+			{
+				size_t lstart;
+				size_t lstop;
+				openfpm_omp_static_range(n,openfpm_omp_num_threads(),openfpm_omp_thread_num(),lstart,lstop);
+
+				if (is_op_replace<op>::value == true)
+				{
+					if (lstart < lstop)
+					{memcpy(&dst[start + lstart],&src[lstart],(lstop - lstart)*sizeof(prp_type));}
+				}
+				else
+				{
+					#pragma omp simd
+					for (size_t i = lstart ; i < lstop ; i++)
+					{op<prp_type,prp_type>::operation(dst[start + i],src[i]);}
+				}
+			}
+		}
+	};
+
+	/*! \brief this class is a functor for "for_each" algorithm
+	 *
+	 * For each property it merge the element i of the source vector into the element opart.get<0>(i)
+	 * of the destination vector. opart can contain the same index more than once, so the loop is
+	 * serial, but it run over the property buffers and not over encap objects
+	 *
+	 * \tparam op operation
+	 * \tparam vector_src source vector
+	 * \tparam vector_dst destination vector
+	 * \tparam vector_opart_type vector of the merging indexes
+	 * \tparam prp destination properties
+	 *
+	 */
+	template<template<typename,typename> class op, typename vector_src, typename vector_dst, typename vector_opart_type, int ... prp>
+	struct merge_prp_host_scatter
+	{
+		//! Convert the packed properties into an MPL vector
+		typedef typename to_boost_vmpl<prp...>::type v_prp;
+
+		//! source vector
+		const vector_src & v_src;
+
+		//! destination vector
+		vector_dst & v_dst;
+
+		//! merging indexes
+		const vector_opart_type & opart;
+
+		/*! \brief Constructor
+		 *
+		 * \param v_src source vector
+		 * \param v_dst destination vector
+		 * \param opart merging indexes
+		 *
+		 */
+		merge_prp_host_scatter(const vector_src & v_src, vector_dst & v_dst, const vector_opart_type & opart)
+		:v_src(v_src),v_dst(v_dst),opart(opart)
+		{}
+
+		//! It call the functor for each property
+		template<typename T>
+		void operator()(T& /*t*/)
+		{
+			typedef vector_prp_stream<T::value,const vector_src> stream_src;
+			typedef vector_prp_stream<boost::mpl::at<v_prp,boost::mpl::int_<T::value>>::type::value,vector_dst> stream_dst;
+			typedef typename stream_dst::prp_type_nc prp_type;
+
+			size_t n = v_src.size();
+
+			if (n == 0 || v_dst.size() == 0)	{return;}
+
+			stream_src src(v_src);
+			stream_dst dst(v_dst);
+
+			for (size_t i = 0 ; i < n ; i++)
+			{op<prp_type,prp_type>::operation(dst[opart.template get<0>(i)],src[i]);}
+		}
+	};
+
+	/*! \brief Select the block merge for merge_prp_v and add_prp
+	 *
+	 * In case the properties cannot be merged as blocks it does nothing and return false,
+	 * the caller fall back to the element by element merge
+	 *
+	 * \tparam is_fast true if all the properties can be merged as blocks
+	 *
+	 */
+	template<bool is_fast>
+	struct merge_prp_host_block
+	{
+		/*! \brief Merge v_src into the range [start,start+v_src.size()) of v_dst
+		 *
+		 * \param v_src source vector
+		 * \param v_dst destination vector
+		 * \param start first element of the destination
+		 *
+		 * \return false (not merged)
+		 *
+		 */
+		template<template<typename,typename> class op, unsigned int ... args, typename vector_src, typename vector_dst>
+		static bool range(const vector_src & /*v_src*/, vector_dst & /*v_dst*/, size_t /*start*/)
+		{
+			return false;
+		}
+
+		/*! \brief Merge the element i of v_src into the element opart.get<0>(i) of v_dst
+		 *
+		 * \param v_src source vector
+		 * \param v_dst destination vector
+		 * \param opart merging indexes
+		 *
+		 * \return false (not merged)
+		 *
+		 */
+		template<template<typename,typename> class op, unsigned int ... args, typename vector_src, typename vector_dst, typename vector_opart_type>
+		static bool scatter(const vector_src & /*v_src*/, vector_dst & /*v_dst*/, const vector_opart_type & /*opart*/)
+		{
+			return false;
+		}
+	};
+
+	/*! \brief Select the block merge for merge_prp_v and add_prp
+	 *
+	 * All the properties can be merged as blocks
+	 *
+	 */
+	template<>
+	struct merge_prp_host_block<true>
+	{
+		/*! \brief Merge v_src into the range [start,start+v_src.size()) of v_dst
+		 *
+		 * \param v_src source vector
+		 * \param v_dst destination vector
+		 * \param start first element of the destination
+		 *
+		 * \return true
+		 *
+		 */
+		template<template<typename,typename> class op, unsigned int ... args, typename vector_src, typename vector_dst>
+		static bool range(const vector_src & v_src, vector_dst & v_dst, size_t start)
+		{
+			merge_prp_host_range<op,vector_src,vector_dst,args...> mrg(v_src,v_dst,start);
+			boost::mpl::for_each_ref< boost::mpl::range_c<int,0,sizeof...(args)> >(mrg);
+
+			return true;
+		}
+
+		/*! \brief Merge the element i of v_src into the element opart.get<0>(i) of v_dst
+		 *
+		 * \param v_src source vector
+		 * \param v_dst destination vector
+		 * \param opart merging indexes
+		 *
+		 * \return true
+		 *
+		 */
+		template<template<typename,typename> class op, unsigned int ... args, typename vector_src, typename vector_dst, typename vector_opart_type>
+		static bool scatter(const vector_src & v_src, vector_dst & v_dst, const vector_opart_type & opart)
+		{
+			merge_prp_host_scatter<op,vector_src,vector_dst,vector_opart_type,args...> mrg(v_src,v_dst,opart);
+			boost::mpl::for_each_ref< boost::mpl::range_c<int,0,sizeof...(args)> >(mrg);
+
+			return true;
+		}
+	};
+
+	/*! \brief Call lamb(i) for each element of the vector in parallel
+	 *
+	 * Each thread get a contiguous range of elements (static schedule), so an initialization
+	 * done with for_each place the pages on the NUMA node of the thread that use them
+	 *
+	 * \param v vector
+	 * \param lamb lambda function with signature void(size_t i)
+	 *
+	 */
+	template<typename vector_type, typename lambda_type>
+	void for_each(vector_type & v, lambda_type lamb)
+	{
+		size_t n = v.size();
+
+		#pragma omp parallel if (n >= OPENFPM_OMP_MIN_ELEMENTS)
+		{
+			size_t start;
+			size_t stop;
+			openfpm_omp_static_range(n,openfpm_omp_num_threads(),openfpm_omp_thread_num(),start,stop);
+
+			for (size_t i = start ; i < stop ; i++)
+			{lamb(i);}
+		}
+	}
+
+	/*! \brief Apply lamb on the range [start,stop) of the source streams and store in dst
+	 *
+	 * \param dst destination stream
+	 * \param srcs tuple of source streams
+	 * \param lamb function to apply
+	 * \param start first element
+	 * \param stop one past the last element
+	 *
+	 */
+	template<typename dst_type, typename tuple_type, typename lambda_type, size_t ... I>
+	inline void transform_range(const dst_type & dst, const tuple_type & srcs, lambda_type & lamb, size_t start, size_t stop, std::index_sequence<I...>)
+	{
+		#pragma omp simd
+		for (size_t i = start ; i < stop ; i++)
+		{dst[i] = lamb(std::get<I>(srcs)[i]...);}
+	}
+
+	/*! \brief Apply lamb to the properties prp_src of each element and store the result in prp_dst
+	 *
+	 * v.get<prp_dst>(i) = lamb(v.get<prp_src>(i)...)
+	 *
+	 * \tparam prp_dst destination property
+	 * \tparam prp_src source properties
+	 *
+	 * \param v vector
+	 * \param lamb function that take the source properties and return the destination property
+	 *
+	 */
+	template<unsigned int prp_dst, unsigned int ... prp_src, typename vector_type, typename lambda_type>
+	void transform(vector_type & v, lambda_type lamb)
+	{
+		size_t n = v.size();
+
+		if (n == 0)	{return;}
+
+		vector_prp_stream<prp_dst,vector_type> dst(v);
+
+		#pragma omp parallel if (n >= OPENFPM_OMP_MIN_ELEMENTS)
+		{
+			size_t start;
+			size_t stop;
+			openfpm_omp_static_range(n,openfpm_omp_num_threads(),openfpm_omp_thread_num(),start,stop);
+
+			auto srcs = std::make_tuple(vector_prp_stream<prp_src,const vector_type>(v)...);
+
+			transform_range(dst,srcs,lamb,start,stop,std::make_index_sequence<sizeof...(prp_src)>());
+		}
+	}
+
+	/*! \brief Reduce the property prp of all the elements
+	 *
+	 * Each thread reduce its contiguous range, the partial results are combined in thread order
+	 *
+	 * \tparam prp property to reduce
+	 * \tparam op reduction operation (add_, max_, min_ ...)
+	 *
+	 * \param v vector
+	 * \param init initial value (identity of the operation)
+	 *
+	 * \return the reduced value
+	 *
+	 */
+	template<unsigned int prp, template<typename,typename> class op = add_, typename vector_type>
+	typename vector_prp_stream<prp,const vector_type>::prp_type_nc
+	reduce(const vector_type & v, typename vector_prp_stream<prp,const vector_type>::prp_type_nc init)
+	{
+		typedef typename vector_prp_stream<prp,const vector_type>::prp_type_nc prp_type;
+
+		size_t n = v.size();
+
+		if (n == 0)	{return init;}
+
+		vector_prp_stream<prp,const vector_type> src(v);
+
+		std::vector<prp_type> partial(openfpm_omp_max_threads(),init);
+		size_t nth_used = 1;
+
+		#pragma omp parallel if (n >= OPENFPM_OMP_MIN_ELEMENTS)
+		{
+			size_t nth = openfpm_omp_num_threads();
+			size_t tid = openfpm_omp_thread_num();
+
+			size_t start;
+			size_t stop;
+			openfpm_omp_static_range(n,nth,tid,start,stop);
+
+			prp_type red = init;
+
+			for (size_t i = start ; i < stop ; i++)
+			{op<prp_type,prp_type>::operation(red,src[i]);}
+
+			partial[tid] = red;
+
+			if (tid == 0)
+			{nth_used = nth;}
+		}
+
+		prp_type red = init;
+
+		for (size_t i = 0 ; i < nth_used ; i++)
+		{op<prp_type,prp_type>::operation(red,partial[i]);}
+
+		return red;
+	}
+
+	/*! \brief Inclusive scan of the property prp_src stored in prp_dst
+	 *
+	 * Each thread scan its contiguous range, than the totals of the ranges are scanned
+	 * and added to the range of the next threads
+	 *
+	 * \tparam prp_src property to scan
+	 * \tparam prp_dst property where to store the result (can be the same as prp_src)
+	 * \tparam op operation (must be associative and commutative, add_, max_, min_)
+	 *
+	 * \param v vector
+	 *
+	 */
+	template<unsigned int prp_src, unsigned int prp_dst = prp_src, template<typename,typename> class op = add_, typename vector_type>
+	void inclusive_scan(vector_type & v)
+	{
+		typedef typename vector_prp_stream<prp_dst,vector_type>::prp_type_nc prp_type;
+
+		size_t n = v.size();
+
+		if (n == 0)	{return;}
+
+		vector_prp_stream<prp_src,const vector_type> src(v);
+		vector_prp_stream<prp_dst,vector_type> dst(v);
+
+		std::vector<prp_type> total(openfpm_omp_max_threads());
+
+		#pragma omp parallel if (n >= OPENFPM_OMP_MIN_ELEMENTS)
+		{
+			size_t nth = openfpm_omp_num_threads();
+			size_t tid = openfpm_omp_thread_num();
+
+			size_t start;
+			size_t stop;
+			openfpm_omp_static_range(n,nth,tid,start,stop);
+
+			if (start < stop)
+			{
+				prp_type acc = src[start];
+				dst[start] = acc;
+
+				for (size_t i = start + 1 ; i < stop ; i++)
+				{
+					op<prp_type,prp_type>::operation(acc,src[i]);
+					dst[i] = acc;
+				}
+
+				total[tid] = acc;
+			}
+
+			#pragma omp barrier
+
+			if (tid != 0 && start < stop)
+			{
+				// threads with an empty range are always the last ones
+				prp_type offset = total[0];
+				for (size_t j = 1 ; j < tid ; j++)
+				{op<prp_type,prp_type>::operation(offset,total[j]);}
+
+				#pragma omp simd
+				for (size_t i = start ; i < stop ; i++)
+				{op<prp_type,prp_type>::operation(dst[i],offset);}
+			}
+		}
+	}
+}
+
+#endif /* OPENFPM_DATA_SRC_VECTOR_MAP_VECTOR_PARALLEL_HPP_ */
@@ -541,6 +541,120 @@ BOOST_AUTO_TEST_CASE(vector_performance_gpu_layout_vs_plain_array)
     report_vector_funcs.graphs.put("performance.vector_layout_gpu(1).y.data.dev",mean2_/(mean2*mean2)*dev2 + dev2_ / mean2 );
 }
 
+template<template<typename,typename> class op, typename vector_type, typename vector_opart_type>
+void merge_prp_v_element_by_element(vector_type & v_dst, const vector_type & v_src, const vector_opart_type & opart)
+{
+	for (size_t i = 0 ; i < v_src.size() ; i++)
+	{
+		object_s_di_op<op,decltype(v_src.get(i)),decltype(v_dst.get(0)),OBJ_ENCAP,0,1,2>(v_src.get(i),v_dst.get(opart.template get<0>(i)));
+	}
+}
+
+template<typename vector_type>
+void add_prp_element_by_element(vector_type & v_dst, const vector_type & v_src)
+{
+	for (size_t i = 0 ; i < v_src.size() ; i++)
+	{
+		v_dst.add();
+		object_s_di<decltype(v_src.get(i)),decltype(v_dst.get(0)),OBJ_ENCAP,0,1,2>(v_src.get(i),v_dst.get(v_dst.size()-1));
+	}
+}
+
+template<unsigned int impl, template<typename> class layout_base>
+void vector_performance_merge_impl(const std::string & name, int id)
+{
+	typedef aggregate<size_t,double,float> T;
+	typedef openfpm::vector<T,HeapMemory,layout_base> vector_type;
+
+	std::vector<double> times(N_STAT + 1);
+	std::vector<double> times_g(N_STAT + 1);
+
+	report_vector_funcs.graphs.put("performance.vector_merge(" + std::to_string(id) + ").funcs.nele",NADD);
+	report_vector_funcs.graphs.put("performance.vector_merge(" + std::to_string(id) + ").funcs.name",name);
+
+	vector_type v_src;
+	openfpm::vector<aggregate<unsigned int>> opart;
+
+	v_src.resize(NADD);
+	opart.resize(NADD);
+
+	for (size_t i = 0 ; i < NADD ; i++)
+	{
+		v_src.template get<0>(i) = i;
+		v_src.template get<1>(i) = 1.0;
+		v_src.template get<2>(i) = 2.0f;
+
+		// ghost-merge like pattern, mostly sequential indexes
+		opart.template get<0>(i) = (i % 16 == 0)?(NADD - 1 - i):i;
+	}
+
+	for (size_t i = 0 ; i < N_STAT+1 ; i++)
+	{
+		vector_type v_dst;
+		v_dst.resize(NADD);
+
+		timer tg;
+		tg.start();
+
+		if (impl == 0)
+		{merge_prp_v_element_by_element<add_>(v_dst,v_src,opart);}
+		else if (impl == 1)
+		{merge_prp_v_element_by_element<replace_>(v_dst,v_src,opart);}
+		else
+		{
+			v_dst.clear();
+			add_prp_element_by_element(v_dst,v_src);
+		}
+
+		tg.stop();
+
+		times_g[i] = tg.getwct();
+
+		v_dst.resize(NADD);
+
+		timer tga;
+		tga.start();
+
+		if (impl == 0)
+		{v_dst.template merge_prp_v<add_,T,HeapMemory,openfpm::grow_policy_double,layout_base,decltype(opart),0,1,2>(v_src,opart);}
+		else if (impl == 1)
+		{v_dst.template merge_prp_v<replace_,T,HeapMemory,openfpm::grow_policy_double,layout_base,decltype(opart),0,1,2>(v_src,opart);}
+		else
+		{
+			v_dst.clear();
+			v_dst.template add_prp<T,HeapMemory,openfpm::grow_policy_double,OPENFPM_NATIVE,layout_base,0,1,2>(v_src);
+		}
+
+		tga.stop();
+
+		times[i] = tga.getwct();
+	}
+
+	double mean;
+	double dev;
+	standard_deviation(times_g,mean,dev);
+
+	double mean_;
+	double dev_;
+	standard_deviation(times,mean_,dev_);
+
+	report_vector_funcs.graphs.put("performance.vector_merge(" + std::to_string(id) + ").y.data.mean",mean_/mean);
+
+	// Deviation od x/y = x/y^2 dy + 1/y dx
+
+	report_vector_funcs.graphs.put("performance.vector_merge(" + std::to_string(id) + ").y.data.dev",mean_/(mean*mean)*dev + dev_ / mean );
+}
+
+BOOST_AUTO_TEST_CASE(vector_performance_merge_prp_add_prp)
+{
+	vector_performance_merge_impl<0,memory_traits_lin>("merge_prp_v_add_lin",0);
+	vector_performance_merge_impl<1,memory_traits_lin>("merge_prp_v_replace_lin",1);
+	vector_performance_merge_impl<2,memory_traits_lin>("add_prp_lin",2);
+	vector_performance_merge_impl<0,memory_traits_inte>("merge_prp_v_add_inte",3);
+	vector_performance_merge_impl<1,memory_traits_inte>("merge_prp_v_replace_inte",4);
+	vector_performance_merge_impl<2,memory_traits_inte>("add_prp_inte",5);
+}
+
 BOOST_AUTO_TEST_CASE(vector_performance_write_report)
 {
 	// Create a graphs
@@ -572,6 +686,15 @@ BOOST_AUTO_TEST_CASE(vector_performance_write_report)
 	report_vector_funcs.graphs.add("graphs.graph(2).y.data(0).title","Actual");
 	report_vector_funcs.graphs.add("graphs.graph(2).interpolation","lines");
 
+	report_vector_funcs.graphs.put("graphs.graph(3).type","line");
+	report_vector_funcs.graphs.add("graphs.graph(3).title","Vector merge_prp_v/add_prp block vs element by element");
+	report_vector_funcs.graphs.add("graphs.graph(3).x.title","Operation");
+	report_vector_funcs.graphs.add("graphs.graph(3).y.title","Time ratio");
+	report_vector_funcs.graphs.add("graphs.graph(3).y.data(0).source","performance.vector_merge(#).y.data.mean");
+	report_vector_funcs.graphs.add("graphs.graph(3).x.data(0).source","performance.vector_merge(#).funcs.name");
+	report_vector_funcs.graphs.add("graphs.graph(3).y.data(0).title","Actual");
+	report_vector_funcs.graphs.add("graphs.graph(3).interpolation","lines");
+
 	boost::property_tree::xml_writer_settings<std::string> settings(' ', 4);
 	boost::property_tree::write_xml("vector_performance_funcs.xml", report_vector_funcs.graphs,std::locale(),settings);
 
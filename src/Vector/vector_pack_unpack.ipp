@@ -115,19 +115,17 @@ struct pack_simple_cond
 		dest.setMemory(mem);
 		dest.resize(obj.size());
 	
-		auto obj_it = obj.getIterator();
-	
-		while (obj_it.isNext())
+		// copy all the object in the send buffer
+		typedef encapc<1,typename vctr::value_type,typename vctr::layout_type > encap_src;
+		// destination object type
+		typedef encapc<1,prp_object,typename dtype::layout_type > encap_dst;
+
+		// each element (and each property of it) has its own place in the buffer, threads write disjoint regions
+		#pragma omp parallel for schedule(static) if (obj.size() >= OPENFPM_OMP_MIN_ELEMENTS)
+		for (size_t i = 0 ; i < obj.size() ; i++)
 		{
-			// copy all the object in the send buffer
-			typedef encapc<1,typename vctr::value_type,typename vctr::layout_type > encap_src;
-			// destination object type
-			typedef encapc<1,prp_object,typename dtype::layout_type > encap_dst;
-	
 			// Copy only the selected properties
-			object_si_d<encap_src,encap_dst,OBJ_ENCAP,prp...>(obj.get(obj_it.get()),dest.get(obj_it.get()));
-	
-			++obj_it;
+			object_si_d<encap_src,encap_dst,OBJ_ENCAP,prp...>(obj.get(i),dest.get(i));
 		}
 	
 		// Update statistic
@@ -155,14 +153,11 @@ struct pack_simple_cond<true, prp ...>
 		dest.setMemory(mem);
 		dest.resize(obj.size());
 	
-		auto obj_it = obj.getIterator();
-	
-		while (obj_it.isNext())
+		#pragma omp parallel for schedule(static) if (obj.size() >= OPENFPM_OMP_MIN_ELEMENTS)
+		for (size_t i = 0 ; i < obj.size() ; i++)
 		{
 			// Copy
-			dest.get(obj_it.get()) = obj.get(obj_it.get());
-	
-			++obj_it;
+			dest.get(i) = obj.get(i);
 		}
 	
 		// Update statistic
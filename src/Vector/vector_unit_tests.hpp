@@ -715,6 +715,19 @@ BOOST_AUTO_TEST_CASE( vector_memory_repr )
 	}
 }
 
+BOOST_AUTO_TEST_CASE( vector_const_pointer )
+{
+	openfpm::vector<aggregate<float,double[3]>,HeapMemory,memory_traits_inte> v;
+	v.resize(16);
+
+	const openfpm::vector<aggregate<float,double[3]>,HeapMemory,memory_traits_inte> & vc = v;
+
+	// the const version must return the pointer of the requested property
+	BOOST_REQUIRE(vc.template getPointer<0>() == v.template getPointer<0>());
+	BOOST_REQUIRE(vc.template getPointer<1>() == v.template getPointer<1>());
+	BOOST_REQUIRE(vc.template getPointer<1>() != vc.template getPointer<0>());
+}
+
 BOOST_AUTO_TEST_CASE( vector_std_utility )
 {
 	//! [Create add and access stl]
@@ -912,6 +925,184 @@ BOOST_AUTO_TEST_CASE( vector_cuda_to_kernel_recursive )
 	BOOST_REQUIRE_EQUAL(test,true);
 }
 
+template<typename vector_type>
+void test_vector_parallel_algorithms()
+{
+	vector_type v;
+	v.resize(100000);
+
+	openfpm::for_each(v,[&](size_t i){
+		v.template get<0>(i) = i;
+		v.template get<1>(i) = 2.0*i;
+		v.template get<2>(i) = 1;
+	});
+
+	openfpm::transform<1,0,1>(v,[](size_t a, double b){return a + b;});
+
+	bool match = true;
+	for (size_t i = 0 ; i < v.size() ; i++)
+	{match &= v.template get<1>(i) == 3.0*i;}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+
+	size_t sum = openfpm::reduce<0>(v,0);
+	BOOST_REQUIRE_EQUAL(sum,v.size()*(v.size()-1)/2);
+
+	double mx = openfpm::reduce<1,max_>(v,0.0);
+	BOOST_REQUIRE_EQUAL(mx,3.0*(v.size()-1));
+
+	openfpm::inclusive_scan<2>(v);
+	openfpm::inclusive_scan<0,0,max_>(v);
+
+	for (size_t i = 0 ; i < v.size() ; i++)
+	{
+		match &= v.template get<2>(i) == i+1;
+		match &= v.template get<0>(i) == i;
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+
+	// small vectors run serially
+
+	v.resize(7);
+	openfpm::inclusive_scan<0,2>(v);
+	BOOST_REQUIRE_EQUAL(v.template get<2>(6),21ul);
+	BOOST_REQUIRE_EQUAL(openfpm::reduce<0>(v,0),21ul);
+
+	v.resize(0);
+	BOOST_REQUIRE_EQUAL(openfpm::reduce<0>(v,5),5ul);
+}
+
+BOOST_AUTO_TEST_CASE( vector_parallel_algorithms )
+{
+	test_vector_parallel_algorithms<openfpm::vector<aggregate<size_t,double,size_t>>>();
+	test_vector_parallel_algorithms<openfpm::vector<aggregate<size_t,double,size_t>,HeapMemory,memory_traits_inte>>();
+}
+
+template<typename vector_type>
+void test_vector_expression()
+{
+	vector_type v;
+	v.resize(10000);
+
+	for (size_t i = 0 ; i < v.size() ; i++)
+	{
+		v.template get<1>(i) = i;
+		v.template get<2>(i) = 2.0*i;
+	}
+
+	v.template prop<0>() = 0.5 * (v.template prop<1>() + v.template prop<2>()) - 1.0;
+
+	bool match = true;
+	for (size_t i = 0 ; i < v.size() ; i++)
+	{match &= v.template get<0>(i) == 0.5 * (3.0*i) - 1.0;}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+
+	// empty vector
+	vector_type v2;
+	v2.template prop<0>() = v2.template prop<1>() * 2.0;
+}
+
+BOOST_AUTO_TEST_CASE( vector_expression )
+{
+	test_vector_expression<openfpm::vector<aggregate<double,double,double>>>();
+	test_vector_expression<openfpm::vector<aggregate<double,double,double>,HeapMemory,memory_traits_inte>>();
+}
+
+template<template<typename> class layout_base>
+void test_vector_merge_prp_block()
+{
+	typedef aggregate<size_t,double,float> T;
+	typedef openfpm::vector<T,HeapMemory,layout_base> vector_type;
+
+	vector_type v_src;
+	vector_type v_dst;
+	openfpm::vector<aggregate<unsigned int>> opart;
+
+	v_src.resize(10000);
+	v_dst.resize(20000);
+	opart.resize(10000);
+
+	for (size_t i = 0 ; i < v_dst.size() ; i++)
+	{
+		v_dst.template get<0>(i) = 1;
+		v_dst.template get<1>(i) = 1.0;
+		v_dst.template get<2>(i) = 1.0f;
+	}
+
+	for (size_t i = 0 ; i < v_src.size() ; i++)
+	{
+		v_src.template get<0>(i) = i;
+		v_src.template get<1>(i) = 2.0*i;
+		v_src.template get<2>(i) = 3.0f;
+
+		// two elements merge on the same destination
+		opart.template get<0>(i) = i / 2;
+	}
+
+	// merge scattered
+
+	v_dst.template merge_prp_v<add_,T,HeapMemory,openfpm::grow_policy_double,layout_base,decltype(opart),0,1,2>(v_src,opart);
+
+	bool match = true;
+	for (size_t i = 0 ; i < 5000 ; i++)
+	{
+		match &= v_dst.template get<0>(i) == 1 + 2*i + 2*i+1;
+		match &= v_dst.template get<1>(i) == 1.0 + 2.0*(2*i) + 2.0*(2*i+1);
+		match &= v_dst.template get<2>(i) == 7.0f;
+	}
+
+	match &= v_dst.template get<0>(5000) == 1;
+
+	BOOST_REQUIRE_EQUAL(match,true);
+
+	// merge on a range
+
+	v_dst.template merge_prp_v<replace_,T,HeapMemory,openfpm::grow_policy_double,layout_base,0,1,2>(v_src,10000);
+	v_dst.template merge_prp_v<max_,T,HeapMemory,openfpm::grow_policy_double,layout_base,0,1,2>(v_src,5000);
+
+	for (size_t i = 5000 ; i < 20000 ; i++)
+	{
+		size_t s1 = (i >= 10000)?i - 10000:0;
+		size_t s2 = (i < 15000)?i - 5000:0;
+		size_t v = (i >= 10000)?s1:1;
+		v = (i < 15000 && s2 > v)?s2:v;
+
+		match &= v_dst.template get<0>(i) == v;
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+
+	// add_prp
+
+	vector_type v_add;
+	v_add.add();
+	v_add.template get<0>(0) = 77;
+
+	v_add.template add_prp<T,HeapMemory,openfpm::grow_policy_double,OPENFPM_NATIVE,layout_base,0,1,2>(v_src);
+	v_add.template add_prp<T,HeapMemory,openfpm::grow_policy_double,OPENFPM_NATIVE,layout_base,0,1,2>(v_src);
+
+	BOOST_REQUIRE_EQUAL(v_add.size(),20001ul);
+	BOOST_REQUIRE_EQUAL(v_add.template get<0>(0),77ul);
+
+	for (size_t i = 0 ; i < v_src.size() ; i++)
+	{
+		match &= v_add.template get<0>(1+i) == i;
+		match &= v_add.template get<1>(1+i) == 2.0*i;
+		match &= v_add.template get<2>(1+i) == 3.0f;
+		match &= v_add.template get<0>(10001+i) == i;
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+}
+
+BOOST_AUTO_TEST_CASE( vector_merge_prp_block )
+{
+	test_vector_merge_prp_block<memory_traits_lin>();
+	test_vector_merge_prp_block<memory_traits_inte>();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 #endif
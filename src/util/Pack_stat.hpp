@@ -65,11 +65,20 @@ class Pack_stat
 	//! packing offset
 	size_t un_ele;
 
+	//! bytes given to the compression stage
+	size_t raw_sz;
+
+	//! bytes produced by the compression stage
+	size_t cmp_sz;
+
+	//! time spent in the compression stage (seconds)
+	double cmp_time;
+
 public:
 
 
 	inline Pack_stat()
-	:p_mark(0),un_ele(0)
+	:p_mark(0),un_ele(0),raw_sz(0),cmp_sz(0),cmp_time(0.0)
 	{}
 
 	/*! \brief Increment the request pointer
@@ -110,6 +119,64 @@ public:
 	{
 		return p_mark;
 	}
+
+	/*! \brief Add the result of a compression
+	 *
+	 * \param raw size in byte of the data before compression
+	 * \param cmp size in byte of the compressed data
+	 * \param time time spent to compress in seconds
+	 *
+	 */
+	inline void addCompression(size_t raw, size_t cmp, double time)
+	{
+		raw_sz += raw;
+		cmp_sz += cmp;
+		cmp_time += time;
+	}
+
+	/*! \brief Return the bytes given to the compression stage
+	 *
+	 * \return the size in byte
+	 *
+	 */
+	inline size_t getRawSize()
+	{
+		return raw_sz;
+	}
+
+	/*! \brief Return the bytes produced by the compression stage
+	 *
+	 * \return the size in byte
+	 *
+	 */
+	inline size_t getCompressedSize()
+	{
+		return cmp_sz;
+	}
+
+	/*! \brief Return the compression ratio (raw size / compressed size)
+	 *
+	 * \return the compression ratio, 1 if nothing has been compressed
+	 *
+	 */
+	inline double getCompressionRatio()
+	{
+		if (cmp_sz == 0)	{return 1.0;}
+
+		return (double)raw_sz / cmp_sz;
+	}
+
+	/*! \brief Return the throughput of the compression stage
+	 *
+	 * \return the throughput in byte/s of raw data, 0 if nothing has been compressed
+	 *
+	 */
+	inline double getCompressionThroughput()
+	{
+		if (cmp_time == 0.0)	{return 0.0;}
+
+		return raw_sz / cmp_time;
+	}
 };
 
 #endif /* SRC_PACK_STAT_HPP_ */
@@ -270,6 +270,108 @@ namespace openfpm
 		}
 
 
+		/*! \brief Return the high 64 bit of the product of two 64 bit integers
+		 *
+		 * \param a first operand
+		 * \param b second operand
+		 *
+		 * \return the high part of a*b
+		 *
+		 */
+		__device__ __host__ inline size_t mulhi_64(size_t a, size_t b)
+		{
+#ifdef __CUDA_ARCH__
+			return __umul64hi(a,b);
+#else
+			return (size_t)(((unsigned __int128)a * b) >> 64);
+#endif
+		}
+
+		/*! \brief Division by an invariant integer with a multiplication and shifts
+		 *
+		 * The magic numbers are the ones of the round-up method of Granlund and Montgomery (the same used by
+		 * libdivide), they are calculated once in init, for powers of two the division is a shift
+		 *
+		 * \code{.cpp}
+		 * fast_div fd;
+		 * fd.init(13);
+		 * size_t q = fd.div(1000);  // 76
+		 * \endcode
+		 *
+		 */
+		struct fast_div
+		{
+			//! magic multiplier (0 if the divisor is a power of two)
+			size_t m;
+
+			//! magic multiplier for numerators smaller than 2^32
+			unsigned int m32;
+
+			//! first shift
+			unsigned int sh1;
+
+			//! second shift (log2 of the divisor if it is a power of two)
+			unsigned int sh2;
+
+			/*! \brief Calculate the magic numbers for the divisor d
+			 *
+			 * \param d divisor
+			 *
+			 */
+			inline void init(size_t d)
+			{
+				if (d == 0 || (d & (d - 1)) == 0)
+				{
+					// power of two (0 leave the numerator unchanged)
+					m = 0;
+					m32 = 0;
+					sh1 = 0;
+					sh2 = (d == 0)?0:log2_64(d);
+					return;
+				}
+
+				// l = ceil(log2(d))
+				unsigned int l = log2_64(d - 1) + 1;
+
+				m = (size_t)((((unsigned __int128)(((size_t)1 << l) - d)) << 64) / d) + 1;
+				m32 = (d < ((size_t)1 << 32))?(unsigned int)(((((size_t)1 << l) - d) << 32) / d + 1):0;
+				sh1 = 1;
+				sh2 = l - 1;
+			}
+
+			/*! \brief Divide n by the divisor
+			 *
+			 * \param n numerator
+			 *
+			 * \return n / d
+			 *
+			 */
+			__device__ __host__ inline size_t div(size_t n) const
+			{
+				if (m == 0)	{return n >> sh2;}
+
+				size_t t1 = mulhi_64(m,n);
+				return (t1 + ((n - t1) >> sh1)) >> sh2;
+			}
+
+			/*! \brief Divide n by the divisor when the numerator and the divisor are smaller than 2^32
+			 *
+			 * It use only 32x32 bit multiplications and can be vectorized
+			 *
+			 * \param n numerator
+			 *
+			 * \return n / d
+			 *
+			 */
+			__device__ __host__ inline unsigned int div32(unsigned int n) const
+			{
+				if (m == 0)	{return n >> sh2;}
+
+				unsigned int t1 = ((size_t)m32 * n) >> 32;
+				return (t1 + ((n - t1) >> sh1)) >> sh2;
+			}
+		};
+
 #ifdef HAVE_LIBQUADMATH
 
 		/*! \brief floor math function
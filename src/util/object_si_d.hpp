@@ -12,6 +12,37 @@
 #include <boost/mpl/range_c.hpp>
 #include <boost/fusion/include/size.hpp>
 
+/*! \brief Copy one property from the source to the destination object
+ *
+ * When source and destination have a different layout (for example an interleaved grid packed into a
+ * linear buffer) the property types differ and the copy go through meta_copy_d
+ *
+ * \tparam stype type of the source property
+ * \tparam dtype type of the destination property
+ *
+ */
+template<typename stype, typename dtype, bool same = std::is_same<typename std::remove_const<stype>::type,
+																  typename std::remove_const<dtype>::type>::value>
+struct object_si_d_e_meta_copy_selector
+{
+	template<typename Tsrc, typename Tdst>
+	__device__ __host__ static inline void copy(const Tsrc & src, Tdst && dst)
+	{
+		meta_copy<stype>::meta_copy_(src,dst);
+	}
+};
+
+//! Partial specialization for a layout switch
+template<typename stype, typename dtype>
+struct object_si_d_e_meta_copy_selector<stype,dtype,false>
+{
+	template<typename Tsrc, typename Tdst>
+	__device__ __host__ static inline void copy(const Tsrc & src, Tdst && dst)
+	{
+		meta_copy_d<typename std::remove_const<stype>::type,dtype>::meta_copy_d_(src,dst);
+	}
+};
+
 /*! \brief this class is a functor for "for_each" algorithm
  *
  * This class is a functor for "for_each" algorithm. For each
@@ -51,11 +82,11 @@ struct object_si_d_e
     __device__ __host__ void operator()(T& t)
     {
     	typedef decltype(src.template get<boost::mpl::at<v_prp,boost::mpl::int_<T::value>>::type::value>()) stype;
+    	typedef decltype(dst.template get<T::value>()) dtype;
 
-    	// In case of layout switch use this
-    	//meta_copy_d<stype,dtype>::meta_copy_d_(src.template get<boost::mpl::at<v_prp,boost::mpl::int_<T::value>>::type::value>(),dst.template get<T::value>());
-
-    	meta_copy<typename std::remove_reference<stype>::type>::meta_copy_(src.template get<boost::mpl::at<v_prp,boost::mpl::int_<T::value>>::type::value>(),dst.template get<T::value>());
+    	object_si_d_e_meta_copy_selector<typename std::remove_reference<stype>::type,
+    									 typename std::remove_reference<dtype>::type>
+    	::copy(src.template get<boost::mpl::at<v_prp,boost::mpl::int_<T::value>>::type::value>(),dst.template get<T::value>());
     }
 };
 
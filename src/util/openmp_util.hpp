@@ -0,0 +1,89 @@
+/*
+ * openmp_util.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Pietro Incardona
+ */
+
+#ifndef OPENFPM_DATA_SRC_UTIL_OPENMP_UTIL_HPP_
+#define OPENFPM_DATA_SRC_UTIL_OPENMP_UTIL_HPP_
+
+#include <cstddef>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/*! \brief Minimum number of elements before a loop is distributed across threads
+ *
+ * Below this threshold the cost of waking up the thread team is bigger than the work
+ *
+ */
+#ifndef OPENFPM_OMP_MIN_ELEMENTS
+#define OPENFPM_OMP_MIN_ELEMENTS 4096
+#endif
+
+/*! \brief Return the number of threads inside the current parallel region (1 without OpenMP)
+ *
+ * \return the number of threads
+ *
+ */
+static inline int openfpm_omp_num_threads()
+{
+#ifdef _OPENMP
+	return omp_get_num_threads();
+#else
+	return 1;
+#endif
+}
+
+/*! \brief Return the maximum number of threads a parallel region can use (1 without OpenMP)
+ *
+ * \return the maximum number of threads
+ *
+ */
+static inline int openfpm_omp_max_threads()
+{
+#ifdef _OPENMP
+	return omp_get_max_threads();
+#else
+	return 1;
+#endif
+}
+
+/*! \brief Return the id of the calling thread (0 without OpenMP)
+ *
+ * \return the thread id
+ *
+ */
+static inline int openfpm_omp_thread_num()
+{
+#ifdef _OPENMP
+	return omp_get_thread_num();
+#else
+	return 0;
+#endif
+}
+
+/*! \brief Contiguous range [start,stop) assigned to thread tid out of nth
+ *
+ * Equivalent to schedule(static), but the range is known explicitly so that
+ * each thread can work on a contiguous block of memory
+ *
+ * \param n number of elements
+ * \param nth number of threads
+ * \param tid thread id
+ * \param start first element assigned to the thread
+ * \param stop one past the last element assigned to the thread
+ *
+ */
+static inline void openfpm_omp_static_range(size_t n, size_t nth, size_t tid, size_t & start, size_t & stop)
+{
+	size_t chunk = n / nth;
+	size_t rest = n % nth;
+
+	start = tid*chunk + ((tid < rest)?tid:rest);
+	stop = start + chunk + ((tid < rest)?1:0);
+}
+
+#endif /* OPENFPM_DATA_SRC_UTIL_OPENMP_UTIL_HPP_ */
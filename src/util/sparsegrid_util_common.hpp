@@ -20,7 +20,7 @@ struct sparse_grid_bck_wrapper_impl
     template<typename T>
     sparse_grid_bck_wrapper_impl<base> & operator=(T c)
     {
-        for (int i = 0; i < b.size() ; i++)
+        for (size_t i = 0; i < b.size() ; i++)
         {
             b[i] = c;
         }
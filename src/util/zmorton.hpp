@@ -10,6 +10,12 @@
 
 #include "Grid/grid_key.hpp"
 
+// with BMI2 the bits are interleaved with a single pdep/pext per coordinate
+#if defined(__BMI2__) && !defined(__CUDA_ARCH__)
+#include <immintrin.h>
+#define OPENFPM_ZMORTON_BMI2
+#endif
+
 template<typename T>
 inline __device__ __host__ size_t lin_zid(const grid_key_dx<1,T> & key)
 {
@@ -26,6 +32,12 @@ inline __device__ __host__ void invlin_zid(size_t lin, grid_key_dx<1,T> & key)
 template<typename T>
 inline __device__ __host__  size_t lin_zid(const grid_key_dx<2,T> & key)
 {
+#ifdef OPENFPM_ZMORTON_BMI2
+
+	return _pdep_u64(key.get(0),0x5555555555555555) | _pdep_u64(key.get(1),0xAAAAAAAAAAAAAAAA);
+
+#else
+
 	size_t x = key.get(0);
 	size_t y = key.get(1);
 
@@ -43,11 +55,20 @@ inline __device__ __host__  size_t lin_zid(const grid_key_dx<2,T> & key)
 	y = (y | (y << 1)) & 0x5555555555555555;
 
 	return x | (y << 1);
+
+#endif
 }
 
 template<typename T>
 inline __device__ __host__  void invlin_zid(size_t lin, grid_key_dx<2,T> & key)
 {
+#ifdef OPENFPM_ZMORTON_BMI2
+
+	key.set_d(0,_pext_u64(lin,0x5555555555555555));
+	key.set_d(1,_pext_u64(lin,0xAAAAAAAAAAAAAAAA));
+
+#else
+
 	size_t x = lin & 0x5555555555555555;
 	size_t y = (lin & 0xAAAAAAAAAAAAAAAA) >> 1;
 
@@ -65,6 +86,8 @@ inline __device__ __host__  void invlin_zid(size_t lin, grid_key_dx<2,T> & key)
 
 	key.set_d(0,x);
 	key.set_d(1,y);
+
+#endif
 }
 
 static const size_t S3[] = {2, 4, 8, 16, 32};
@@ -72,6 +95,14 @@ static const size_t S3[] = {2, 4, 8, 16, 32};
 template<typename T>
 inline __device__ __host__  size_t lin_zid(const grid_key_dx<3,T> & key)
 {
+#ifdef OPENFPM_ZMORTON_BMI2
+
+	return _pdep_u64(key.get(0),0x1249249249249249) |
+	       _pdep_u64(key.get(1),0x2492492492492492) |
+	       _pdep_u64(key.get(2),0x4924924924924924);
+
+#else
+
 	size_t x = key.get(0);
 	size_t z = key.get(2);
 	size_t y = key.get(1);
@@ -95,11 +126,21 @@ inline __device__ __host__  size_t lin_zid(const grid_key_dx<3,T> & key)
 	z = (z | (z << 2)) & 0x9249249249249249;
 
 	return x | (y << 1) | (z << 2);
+
+#endif
 }
 
 template<typename T>
 inline __device__ __host__  void invlin_zid(size_t lin, grid_key_dx<3,T> & key)
 {
+#ifdef OPENFPM_ZMORTON_BMI2
+
+	key.set_d(0,_pext_u64(lin,0x1249249249249249));
+	key.set_d(1,_pext_u64(lin,0x2492492492492492));
+	key.set_d(2,_pext_u64(lin,0x4924924924924924));
+
+#else
+
 	size_t x = lin & 0x9249249249249249;
 	size_t y = (lin >> 1) & 0x9249249249249249;
 	size_t z = (lin >> 2) & 0x9249249249249249;
@@ -125,6 +166,8 @@ inline __device__ __host__  void invlin_zid(size_t lin, grid_key_dx<3,T> & key)
 	key.set_d(0,x);
 	key.set_d(1,y);
 	key.set_d(2,z);
+
+#endif
 }
 
 #endif /* ZMORTON_HPP_ */